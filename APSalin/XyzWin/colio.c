@@ -0,0 +1,485 @@
+/*  @(#)colio.c         1.0  26/10/18  */
+static char *sccsid= "@(#)colio.c       1.0  26/10/18";
+/*
+ *  include files
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include "libgpsC.h"
+
+/*
+ *  function prototypes
+ */
+
+struct ellipsoid *colell( struct col_head *, struct ellipsoid * );
+void colinit( struct col_head *, int, char *, int, struct ellipsoid * );
+int colgethead( FILE *, struct col_head * );
+int colputhead( FILE *, struct col_head * );
+long colgetblk( FILE *, struct col_head *, int, char *, long );
+long colpack( struct col_head *, int, double **, char * );
+int colunpack( struct col_head *, char *, int, double ** );
+static void swap4( void * );
+static void swap8( void * );
+
+/*
+ *  global definitions and variables
+ */
+
+
+void colinit( struct col_head *hd, int ncol, char *names, int codec,
+              struct ellipsoid *ell )
+/********1*********2*********3*********4*********5*********6*********7*********
+ * name:            colinit
+ * version:         2610.18
+ * written by:      geoData
+ * purpose:         fills in the header of a new column file
+ *
+ * input parameters
+ * ----------------
+ * ncol             number of columns, <= MAX_col
+ * names            column names separated by commas, e.g. "X,Y,Z"; may
+ *                  be NULL or list fewer than ncol names
+ * codec            codec of every column
+ * ell              ellipsoid of the geodetic columns
+ *
+ * output parameters
+ * -----------------
+ * hd               header with nrow = 0; names longer than MAX_colname-1
+ *                  are cut, missing ones are "c1", "c2", ...
+ *
+ ********1*********2*********3*********4*********5*********6*********7*********
+ *:modification history
+ *:2610.18, GD, Creation
+ *:2610.18, GD, Ellipsoid and its name from the registry
+ ********1*********2*********3*********4*********5*********6*********7*********/
+
+{
+        char *ptr= names;
+        int i;
+        int k;
+
+        memset( hd, 0, sizeof(*hd) );
+        memcpy( hd->magic, COL_magic, sizeof(hd->magic) );
+        hd->order= COL_order;
+        hd->ncol= ncol < MAX_col ? ncol : MAX_col;
+        hd->A= ell->A;
+        hd->FL= ell->FL;
+        memcpy( hd->ellips, ell->name, sizeof(hd->ellips) );
+        for( i= 0; i < hd->ncol; i++ ) {
+                hd->codec[i]= codec;
+                for( k= 0; ptr != NULL && *ptr != '\0' && *ptr != ','; ptr++ )
+                        if( k < MAX_colname - 1 )
+                                hd->name[i][k++]= *ptr;
+                if( ptr != NULL && *ptr == ',' )
+                        ptr++;
+                if( k == 0 )
+                        sprintf( hd->name[i], "c%d", i + 1 );
+        }
+}
+
+
+struct ellipsoid *colell( struct col_head *hd, struct ellipsoid *custom )
+/********1*********2*********3*********4*********5*********6*********7*********
+ * name:            colell
+ * version:         2610.18
+ * written by:      geoData
+ * purpose:         the ellipsoid of the geodetic columns of a column file
+ *
+ * input parameters
+ * ----------------
+ * hd               header of the column file
+ *
+ * output parameters
+ * -----------------
+ * custom           filled in from A, FL of the header when its ellipsoid
+ *                  is not in the registry
+ *
+ * returns the registry entry named in the header if it has the same A
+ * and FL, else custom; NULL if A, FL of the header are not valid
+ *
+ ********1*********2*********3*********4*********5*********6*********7*********
+ *:modification history
+ *:2610.18, GD, Creation
+ ********1*********2*********3*********4*********5*********6*********7*********/
+
+{
+        struct ellipsoid *ell= ellfind( hd->ellips );
+
+        if( ell != NULL && ell->A == hd->A && ell->FL == hd->FL )
+                return( ell );
+        if( ellset( custom, hd->ellips[0] != '\0' ? hd->ellips : "custom",
+                    hd->A, hd->FL ) != 0 )
+                return( NULL );
+
+        return( custom );
+}
+
+
+int colputhead( FILE *fp, struct col_head *hd )
+/********1*********2*********3*********4*********5*********6*********7*********
+ * name:            colputhead
+ * version:         2610.18
+ * written by:      geoData
+ * purpose:         writes the header of a column file
+ *
+ * returns 0 on success, -1 on a write error
+ *
+ * comments:
+ * ------------------------------
+ * Written at the start of the file and, when the output can seek,
+ * again at the end with the final nrow.
+ *
+ ********1*********2*********3*********4*********5*********6*********7*********
+ *:modification history
+ *:2610.18, GD, Creation
+ ********1*********2*********3*********4*********5*********6*********7*********/
+
+{
+        struct col_head out= *hd;
+
+        out.swap= 0;
+        if( fwrite( &out, sizeof(out), 1, fp ) != 1 )
+                return( -1 );
+
+        return( 0 );
+}
+
+
+int colgethead( FILE *fp, struct col_head *hd )
+/********1*********2*********3*********4*********5*********6*********7*********
+ * name:            colgethead
+ * version:         2610.18
+ * written by:      geoData
+ * purpose:         reads and checks the header of a column file
+ *
+ * output parameters
+ * -----------------
+ * hd               the header, in this machine's byte order; swap is
+ *                  set if the file is in the other one
+ *
+ * returns 0 on success, -1 if fp is not a column file
+ *
+ ********1*********2*********3*********4*********5*********6*********7*********
+ *:modification history
+ *:2610.18, GD, Creation
+ ********1*********2*********3*********4*********5*********6*********7*********/
+
+{
+        int i;
+
+        if( fread( hd, sizeof(*hd), 1, fp ) != 1
+            || memcmp( hd->magic, COL_magic, sizeof(hd->magic) ) != 0 )
+                return( -1 );
+
+        hd->swap= 0;
+        if( hd->order != COL_order ) {
+                swap4( &hd->order );
+                if( hd->order != COL_order )
+                        return( -1 );
+                hd->swap= 1;
+                swap4( &hd->ncol );
+                swap8( &hd->nrow );
+                swap8( &hd->A );
+                swap8( &hd->FL );
+                for( i= 0; i < MAX_col; i++ )
+                        swap4( &hd->codec[i] );
+        }
+        if( hd->ncol < 1 || hd->ncol > MAX_col )
+                return( -1 );
+        for( i= 0; i < hd->ncol; i++ ) {
+                if( hd->codec[i] < COL_raw || hd->codec[i] > COL_xor )
+                        return( -1 );
+                hd->name[i][MAX_colname-1]= '\0';
+        }
+        hd->ellips[MAX_colname-1]= '\0';
+
+        return( 0 );
+}
+
+
+long colgetblk( FILE *fp, struct col_head *hd, int want, char *buf,
+                long size )
+/********1*********2*********3*********4*********5*********6*********7*********
+ * name:            colgetblk
+ * version:         2610.18
+ * written by:      geoData
+ * purpose:         reads the next block of a column file, keeping only
+ *                  its first want columns
+ *
+ * input parameters
+ * ----------------
+ * fp               column file, after the header
+ * hd               its header
+ * want             number of columns to keep; more than ncol keeps all
+ * size             size of buf [char]
+ *
+ * output parameters
+ * -----------------
+ * buf              the block as n, nbyte[0..want-1] (in this machine's
+ *                  byte order) and the coded columns, for colunpack
+ *
+ * returns the number of bytes in buf; 0 at end of file, -1 if the
+ * block is damaged, cut short or larger than buf
+ *
+ * comments:
+ * ------------------------------
+ * Only reads; the columns are decoded by colunpack so that can be done
+ * on the conversion threads.
+ *
+ ********1*********2*********3*********4*********5*********6*********7*********
+ *:modification history
+ *:2610.18, GD, Creation
+ ********1*********2*********3*********4*********5*********6*********7*********/
+
+{
+        char skip[4096];
+        int i;
+        int nb[MAX_col+1];
+        long len;
+        long k;
+
+        if( want > hd->ncol )
+                want= hd->ncol;
+        if( fread( nb, sizeof(int), 1, fp ) != 1 )
+                return( 0 );
+        if( fread( nb + 1, sizeof(int), hd->ncol, fp ) != (size_t)hd->ncol )
+                return( -1 );
+        if( hd->swap )
+                for( i= 0; i <= hd->ncol; i++ )
+                        swap4( &nb[i] );
+        if( nb[0] < 0 || nb[0] > MAX_chunk )
+                return( -1 );
+
+        len= (1 + want) * (long)sizeof(int);
+        for( i= 1; i <= hd->ncol; i++ ) {
+                if( nb[i] < 0 || nb[i] > 10 * MAX_chunk )
+                        return( -1 );
+                if( i <= want )
+                        len+= nb[i];
+        }
+        if( len > size )
+                return( -1 );
+
+        memcpy( buf, nb, (1 + want) * sizeof(int) );
+        len= (1 + want) * (long)sizeof(int);
+        for( i= 1; i <= hd->ncol; i++ )
+                if( i <= want ) {
+                        if( fread( buf + len, 1, nb[i], fp ) != (size_t)nb[i] )
+                                return( -1 );
+                        len+= nb[i];
+                } else
+                        for( k= nb[i]; k > 0; k-= sizeof(skip) )
+                                if( fread( skip, 1, k < (long)sizeof(skip) ?
+                                           k : (long)sizeof(skip), fp ) == 0 )
+                                        return( -1 );
+
+        return( len );
+}
+
+
+long colpack( struct col_head *hd, int n, double **col, char *buf )
+/********1*********2*********3*********4*********5*********6*********7*********
+ * name:            colpack
+ * version:         2610.18
+ * written by:      geoData
+ * purpose:         codes n rows of hd->ncol columns as one block
+ *
+ * input parameters
+ * ----------------
+ * hd               header; gives ncol and the codecs
+ * n                number of rows, <= MAX_chunk
+ * col[k][]         values of column k
+ *
+ * output parameters
+ * -----------------
+ * buf              the block, ready to write; at most
+ *                  (1 + ncol)*4 + 10*n*ncol bytes
+ *
+ * returns the number of bytes in buf
+ *
+ ********1*********2*********3*********4*********5*********6*********7*********
+ *:modification history
+ *:2610.18, GD, Creation
+ ********1*********2*********3*********4*********5*********6*********7*********/
+
+{
+        char *ptr;
+        int i;
+        int k;
+        int lz;
+        int nb;
+        int tz;
+        int64_t d;
+        uint64_t bits;
+        uint64_t prev;
+        uint64_t x;
+
+        memcpy( buf, &n, sizeof(int) );
+        ptr= buf + (1 + hd->ncol) * sizeof(int);
+        for( k= 0; k < hd->ncol; k++ ) {
+                char *start= ptr;
+
+                prev= 0;
+                if( hd->codec[k] == COL_raw ) {
+                        memcpy( ptr, col[k], n * sizeof(double) );
+                        ptr+= n * sizeof(double);
+                } else if( hd->codec[k] == COL_delta )
+                        for( i= 0; i < n; i++ ) {
+                                memcpy( &bits, &col[k][i], sizeof(bits) );
+                                d= (int64_t)(bits - prev);
+                                prev= bits;
+                                x= ((uint64_t)d << 1) ^ (uint64_t)(d >> 63);
+                                while( x >= 0x80 ) {
+                                        *ptr++= (char)(x | 0x80);
+                                        x>>= 7;
+                                }
+                                *ptr++= (char)x;
+                        }
+                else
+                        for( i= 0; i < n; i++ ) {
+                                memcpy( &bits, &col[k][i], sizeof(bits) );
+                                x= bits ^ prev;
+                                prev= bits;
+                                if( x == 0 ) {
+                                        *ptr++= 0;
+                                        continue;
+                                }
+                                lz= __builtin_clzll( x ) / 8;
+                                tz= __builtin_ctzll( x ) / 8;
+                                nb= 8 - lz - tz;
+                                *ptr++= (char)(tz << 4 | nb);
+                                for( x>>= 8*tz; nb > 0; nb--, x>>= 8 )
+                                        *ptr++= (char)x;
+                        }
+                nb= (int)(ptr - start);
+                memcpy( buf + (1 + k) * sizeof(int), &nb, sizeof(int) );
+        }
+
+        return( ptr - buf );
+}
+
+
+int colunpack( struct col_head *hd, char *buf, int ncol, double **col )
+/********1*********2*********3*********4*********5*********6*********7*********
+ * name:            colunpack
+ * version:         2610.18
+ * written by:      geoData
+ * purpose:         decodes a block read by colgetblk
+ *
+ * input parameters
+ * ----------------
+ * hd               header of the file
+ * buf              the block, as left by colgetblk
+ * ncol             number of columns in buf (colgetblk's want, at most
+ *                  hd->ncol)
+ *
+ * output parameters
+ * -----------------
+ * col[k][]         values of column k, k < ncol
+ *
+ * returns the number of rows; -1 if a column does not decode to
+ * exactly that many values, or a value of an XOR column has a header
+ * byte colpack cannot write (its bytes shifted past 64 bits)
+ *
+ ********1*********2*********3*********4*********5*********6*********7*********
+ *:modification history
+ *:2610.18, GD, Creation
+ *:2610.18, GD, Reject bad header bytes of XOR columns
+ ********1*********2*********3*********4*********5*********6*********7*********/
+
+{
+        unsigned char *end;
+        unsigned char *ptr;
+        int hb;
+        int i;
+        int k;
+        int n;
+        int nb[MAX_col];
+        int sh;
+        uint64_t bits;
+        uint64_t prev;
+        uint64_t x;
+
+        if( ncol > hd->ncol )
+                ncol= hd->ncol;
+        memcpy( &n, buf, sizeof(int) );
+        memcpy( nb, buf + sizeof(int), ncol * sizeof(int) );
+        ptr= (unsigned char *)buf + (1 + ncol) * sizeof(int);
+        for( k= 0; k < ncol; k++, ptr= end ) {
+                end= ptr + nb[k];
+                prev= 0;
+                if( hd->codec[k] == COL_raw ) {
+                        if( nb[k] != n * (int)sizeof(double) )
+                                return( -1 );
+                        memcpy( col[k], ptr, nb[k] );
+                        if( hd->swap )
+                                for( i= 0; i < n; i++ )
+                                        swap8( &col[k][i] );
+                        continue;
+                }
+                for( i= 0; i < n; i++ ) {
+                        if( ptr >= end )
+                                return( -1 );
+                        if( hd->codec[k] == COL_delta ) {
+                                x= 0;
+                                for( sh= 0; ptr < end && sh < 64; sh+= 7 ) {
+                                        x|= (uint64_t)(*ptr & 0x7F) << sh;
+                                        if( (*ptr++ & 0x80) == 0 )
+                                                break;
+                                }
+                                bits= prev + ((x >> 1) ^ (0 - (x & 1)));
+                        } else {
+                                hb= *ptr++;
+                                x= 0;
+                                if( hb != 0 ) {
+                                        if( (hb & 15) == 0 || (hb & 15) > 8
+                                            || (hb >> 4) + (hb & 15) > 8
+                                            || ptr + (hb & 15) > end )
+                                                return( -1 );
+                                        for( sh= 0; sh < 8*(hb & 15); sh+= 8 )
+                                                x|= (uint64_t)*ptr++ << sh;
+                                        x<<= 8*(hb >> 4);
+                                }
+                                bits= prev ^ x;
+                        }
+                        prev= bits;
+                        memcpy( &col[k][i], &bits, sizeof(bits) );
+                }
+                if( ptr != end )
+                        return( -1 );
+        }
+
+        return( n );
+}
+
+
+static void swap4( void *p )
+/********1*********2*********3*********4*********5*********6*********7*********
+ * purpose:         reverses the byte order of a 4 byte value
+ ********1*********2*********3*********4*********5*********6*********7*********/
+{
+        unsigned char *c= (unsigned char *)p;
+        unsigned char t;
+
+        t= c[0]; c[0]= c[3]; c[3]= t;
+        t= c[1]; c[1]= c[2]; c[2]= t;
+}
+
+
+static void swap8( void *p )
+/********1*********2*********3*********4*********5*********6*********7*********
+ * purpose:         reverses the byte order of an 8 byte value
+ ********1*********2*********3*********4*********5*********6*********7*********/
+{
+        unsigned char *c= (unsigned char *)p;
+        unsigned char t;
+        int i;
+
+        for( i= 0; i < 4; i++ ) {
+                t= c[i];
+                c[i]= c[7-i];
+                c[7-i]= t;
+        }
+}
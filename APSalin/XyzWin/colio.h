@@ -0,0 +1,93 @@
+/*  @(#)colio.h         1.0  26/10/18  */
+/********1*********2*********3*********4*********5*********6*********7*********
+ * name:            colio.h
+ * version:         2610.18
+ * written by:      geoData
+ * purpose:         binary columnar coordinate files
+ *
+ * global variables and constants
+ * ------------------------------
+ * COL_magic        first 8 bytes of a column file; the leading octal
+ *                  211 cannot start a text file of coordinates
+ * COL_order        byte order mark, written in the writer's order
+ * MAX_col          maximum number of columns
+ * MAX_colname      maximum length of a column name, with the '\0'
+ * COL_raw          column codec: float64 values as they are
+ * COL_delta        column codec: difference of successive bit patterns,
+ *                  zigzag, 7 bits per byte (LEB128)
+ * COL_xor          column codec: bit pattern XOR the previous one, with
+ *                  leading and trailing zero bytes dropped
+ *
+ * col_head, the file header:
+ *    magic         COL_magic
+ *    order         COL_order in the writer's byte order
+ *    ncol          number of columns
+ *    nrow          number of rows; -1 if the writer could not seek back
+ *                  to fill it in (output to a pipe)
+ *    A             semi-major axis of the ellipsoid of the geodetic
+ *                  columns [m]
+ *    FL            flattening of that ellipsoid [unitless]
+ *    ellips        name of the ellipsoid (ellips.h); "custom" or empty
+ *                  if it is not in the registry
+ *    name[]        column names, e.g. "X", "lat"
+ *    codec[]       column codecs, COL_raw, COL_delta or COL_xor
+ *    swap          set by colgethead: = 1 = the file is in the other
+ *                  byte order; not written
+ *
+ * comments:
+ * ------------------------------
+ * A column file is the header followed by blocks of at most MAX_chunk
+ * rows, each stored column by column:
+ *                  n  nbyte[0] .. nbyte[ncol-1]  col 0  ..  col ncol-1
+ * where n and nbyte[] are 4 byte ints and col k is nbyte[k] bytes of
+ * n values in codec[k].  A block of COL_raw columns is read straight
+ * into the xyz_chunk arrays; the other codecs are lossless and shrink
+ * smooth or gridded columns, where successive values share their sign,
+ * exponent and leading mantissa bits.  Delta and XOR bytes are little
+ * endian; raw values, n and nbyte[] are in the writer's order and are
+ * swapped on reading when swap is set.
+ *
+ ********1*********2*********3*********4*********5*********6*********7*********
+ *:modification history
+ *:2610.18, GD, Creation
+ *:2610.18, GD, Ellipsoid from the registry: colinit, colell
+ ********1*********2*********3*********4*********5*********6*********7*********/
+
+#ifndef colio_h
+#define colio_h
+
+#include <stdio.h>
+#include "ellips.h"
+
+#define COL_magic       "\211XYZCOL"
+#define COL_order       0x01020304
+#define MAX_col         ((int)32)
+#define MAX_colname     ((int)16)
+
+#define COL_raw         0
+#define COL_delta       1
+#define COL_xor         2
+
+struct col_head {
+        char   magic[8];
+        int    order;
+        int    ncol;
+        long long nrow;
+        double A;
+        double FL;
+        char   ellips[MAX_colname];
+        char   name[MAX_col][MAX_colname];
+        int    codec[MAX_col];
+        int    swap;
+        int    spare;
+};
+
+struct ellipsoid *colell( struct col_head *, struct ellipsoid * );
+void colinit( struct col_head *, int, char *, int, struct ellipsoid * );
+int colgethead( FILE *, struct col_head * );
+int colputhead( FILE *, struct col_head * );
+long colgetblk( FILE *, struct col_head *, int, char *, long );
+long colpack( struct col_head *, int, double **, char * );
+int colunpack( struct col_head *, char *, int, double ** );
+
+#endif /* colio_h */
@@ -0,0 +1,407 @@
+/*  @(#)cvtpool.c       1.0  26/10/18  */
+static char *sccsid= "@(#)cvtpool.c     1.0  26/10/18";
+/*
+ *  include files
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include "libgpsC.h"
+
+/*
+ *  function prototypes
+ */
+
+static int cvtseq( FILE *, FILE *, struct xyz_job * );
+static int nextchunk( FILE *, struct xyz_job *, struct xyz_chunk *,
+                      long * );
+static long dqtake( int );
+static long dqsteal( int );
+static void *worker( void * );
+static int flush_done( FILE * );
+
+/*
+ *  global definitions and variables
+ *
+ *  Chunk states: FREE -> QUEUED (read, in a deque) -> DONE (converted)
+ *  -> FREE (written).  Chunk number seq lives in slot seq % nslot.
+ */
+
+#define ST_free         0
+#define ST_queued       1
+#define ST_done         2
+
+/*
+ *  Each slot is one xyz_chunk, about 1.6 MB; MAX_slot bounds the memory
+ *  of the ring whatever the thread count
+ */
+
+#define MAX_slot        64
+
+struct deque {
+        pthread_mutex_t lock;
+        int head;
+        int count;
+        long *task;
+};
+
+static struct xyz_chunk *slot;
+static int *state;
+static int nslot;
+static int nworker;
+static struct deque *dq;
+static struct xyz_job *cjob;
+static struct xyz_map map;
+
+static pthread_mutex_t pool= PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t work= PTHREAD_COND_INITIALIZER;
+static pthread_cond_t done= PTHREAD_COND_INITIALIZER;
+static long pending;
+static int eof;
+static long nextout;
+
+
+int cvtfile( FILE *in, FILE *out, struct xyz_job *job, int nthr )
+/********1*********2*********3*********4*********5*********6*********7*********
+ * name:            cvtfile
+ * version:         2610.18
+ * written by:      geoData
+ * purpose:         converts every record of a stream on nthr threads,
+ *                  writing the output in input order
+ *
+ * input parameters
+ * ----------------
+ * in               input stream
+ * out              output stream
+ * job              conversion options
+ * nthr             number of conversion threads; <= 1 converts in the
+ *                  calling thread
+ *
+ * output parameters
+ * -----------------
+ * job              nread, nskip and nlong are updated
+ *
+ * returns 0 on success, -1 on a read error in a column file or a write
+ * error
+ *
+ * calls:
+ * ------------------------------
+ * cvtchunk         parses, converts and formats one chunk of records
+ * colgetblk        reads the next block of a column file
+ * getchunk         reads the next chunk of lines
+ * mapchunk         the next chunk of lines of a mapped file
+ * mapclose         unmaps the input
+ * mapopen          maps the input if it is a regular file
+ * putchunk         writes the formatted output of one chunk
+ *
+ * comments:
+ * ------------------------------
+ * The calling thread reads chunks of raw lines and deals them
+ * round-robin onto one deque per worker; it also writes converted
+ * chunks strictly in input order.  A worker takes the oldest chunk
+ * from its own deque and, when that is empty, steals the newest from
+ * another worker, so a worker held up by slow chunks (near-pole
+ * points, iterative solvers) does not leave the others idle.  At most
+ * 4*nthr chunks, and never more than MAX_slot, are in memory; past
+ * MAX_slot/2 threads the extra workers would only wait for a free
+ * slot, so no more than that are started.
+ *
+ * A regular file is mapped rather than read: the chunks then point
+ * into the mapping and the calling thread only finds where each chunk
+ * of lines ends.  A column file (job->colin) is read block by block
+ * and decoded on the workers.
+ *
+ * If the pool cannot be set up (no memory, or a worker thread cannot
+ * be started) the workers already running are stopped and the stream
+ * is converted in the calling thread; nothing has been read by then.
+ *
+ ********1*********2*********3*********4*********5*********6*********7*********
+ *:modification history
+ *:2610.18, GD, Creation
+ *:2610.18, GD, Read regular files through mmap
+ *:2610.18, GD, Column file input
+ *:2610.18, GD, Sum the lines and records too long, nlong
+ *:2610.18, GD, At most MAX_slot chunks and MAX_slot/2 workers
+ ********1*********2*********3*********4*********5*********6*********7*********/
+
+{
+        int err= 0;
+        int i;
+        int n;
+        long lineno= 0;
+        int nstart= 0;
+        long seq= 0;
+        pthread_t *tid;
+
+        map.base= NULL;
+        if( job->colin == NULL )
+                (void)mapopen( in, &map );
+        if( nthr <= 1 ) {
+                err= cvtseq( in, out, job );
+                mapclose( &map );
+                return( err );
+        }
+
+        (void)simd_level();
+
+        nslot= 4*nthr < MAX_slot ? 4*nthr : MAX_slot;
+        nworker= nthr < nslot/2 ? nthr : nslot/2;
+        slot= (struct xyz_chunk *)malloc( nslot*sizeof(struct xyz_chunk) );
+        state= (int *)calloc( nslot, sizeof(int) );
+        dq= (struct deque *)calloc( nworker, sizeof(struct deque) );
+        tid= (pthread_t *)malloc( nworker*sizeof(pthread_t) );
+        if( slot == NULL || state == NULL || dq == NULL || tid == NULL ) {
+                free( slot );
+                free( state );
+                free( dq );
+                free( tid );
+                err= cvtseq( in, out, job );
+                mapclose( &map );
+                return( err );
+        }
+        for( i= 0; i < nworker; i++ ) {
+                pthread_mutex_init( &dq[i].lock, NULL );
+                dq[i].task= (long *)malloc( nslot*sizeof(long) );
+                if( dq[i].task == NULL )
+                        err= -1;
+        }
+
+        cjob= job;
+        pending= 0;
+        eof= 0;
+        nextout= 0;
+        for( nstart= 0; err == 0 && nstart < nworker; nstart++ )
+                if( pthread_create( &tid[nstart], NULL, worker,
+                                    (void *)(long)nstart ) != 0 )
+                        break;
+        if( nstart < nworker )
+                err= -1;
+
+/*
+ *   read and deal out chunks; write what is done whenever the ring is full
+ */
+        for( seq= 0; err == 0; seq++ ) {
+                pthread_mutex_lock( &pool );
+                while( seq - nextout >= nslot && err == 0 ) {
+                        while( state[nextout % nslot] != ST_done )
+                                pthread_cond_wait( &done, &pool );
+                        err= flush_done( out );
+                }
+                pthread_mutex_unlock( &pool );
+                if( err != 0 )
+                        break;
+
+                n= nextchunk( in, job, &slot[seq % nslot], &lineno );
+                if( n <= 0 ) {
+                        err= n;
+                        break;
+                }
+
+                i= seq % nworker;
+                pthread_mutex_lock( &pool );
+                state[seq % nslot]= ST_queued;
+                pending++;
+                pthread_mutex_lock( &dq[i].lock );
+                dq[i].task[(dq[i].head + dq[i].count) % nslot]= seq;
+                dq[i].count++;
+                pthread_mutex_unlock( &dq[i].lock );
+                pthread_cond_signal( &work );
+                err= flush_done( out );
+                pthread_mutex_unlock( &pool );
+        }
+
+/*
+ *   drain: write the remaining chunks in order, then stop the workers
+ */
+        pthread_mutex_lock( &pool );
+        while( err == 0 && nextout < seq ) {
+                while( state[nextout % nslot] != ST_done )
+                        pthread_cond_wait( &done, &pool );
+                err= flush_done( out );
+        }
+        eof= 1;
+        pthread_cond_broadcast( &work );
+        pthread_mutex_unlock( &pool );
+
+        for( i= 0; i < nstart; i++ )
+                pthread_join( tid[i], NULL );
+
+        for( i= 0; i < nworker; i++ ) {
+                pthread_mutex_destroy( &dq[i].lock );
+                free( dq[i].task );
+        }
+        free( slot );
+        free( state );
+        free( dq );
+        free( tid );
+        if( nstart < nworker )
+                err= cvtseq( in, out, job );
+        mapclose( &map );
+
+        return( err );
+}
+
+
+static int cvtseq( FILE *in, FILE *out, struct xyz_job *job )
+/********1*********2*********3*********4*********5*********6*********7*********
+ * purpose:         single thread version of cvtfile
+ ********1*********2*********3*********4*********5*********6*********7*********/
+{
+        static struct xyz_chunk chk;
+        int n;
+        long lineno= 0;
+
+        while( (n= nextchunk( in, job, &chk, &lineno )) > 0 ) {
+                cvtchunk( job, &chk );
+                job->nread+= chk.n;
+                job->nskip+= chk.nskip;
+                job->nlong+= chk.nlong;
+                if( putchunk( out, &chk ) != 0 )
+                        return( -1 );
+        }
+
+        return( n );
+}
+
+
+static int nextchunk( FILE *in, struct xyz_job *job, struct xyz_chunk *chk,
+                      long *lineno )
+/********1*********2*********3*********4*********5*********6*********7*********
+ * purpose:         next chunk of lines, from the mapping if there is one,
+ *                  or next block of a column file; returns the number of
+ *                  lines or rows, 0 at end of file, -1 on a damaged
+ *                  column file
+ ********1*********2*********3*********4*********5*********6*********7*********/
+{
+        long len;
+
+        if( job->colin != NULL ) {
+                chk->first= *lineno + 1;
+                len= colgetblk( in, job->colin, 3, chk->raw, sizeof(chk->raw) );
+                if( len <= 0 )
+                        return( (int)len );
+                chk->text= chk->raw;
+                chk->ntext= len;
+                chk->nlong= 0;
+                memcpy( &chk->nline, chk->raw, sizeof(int) );
+                *lineno+= chk->nline;
+                return( chk->nline > 0 ? chk->nline : 1 );
+        }
+        if( map.base != NULL )
+                return( mapchunk( &map, chk, lineno ) );
+
+        return( getchunk( in, chk, lineno ) );
+}
+
+
+static int flush_done( FILE *out )
+/********1*********2*********3*********4*********5*********6*********7*********
+ * purpose:         writes every converted chunk that is next in input
+ *                  order; called with pool locked, which is released
+ *                  while writing so the workers can carry on
+ ********1*********2*********3*********4*********5*********6*********7*********/
+{
+        int err;
+        int k;
+
+        while( state[(k= nextout % nslot)] == ST_done ) {
+                pthread_mutex_unlock( &pool );
+                err= putchunk( out, &slot[k] );
+                cjob->nread+= slot[k].n;
+                cjob->nskip+= slot[k].nskip;
+                cjob->nlong+= slot[k].nlong;
+                pthread_mutex_lock( &pool );
+                if( err != 0 )
+                        return( -1 );
+                state[k]= ST_free;
+                nextout++;
+        }
+
+        return( 0 );
+}
+
+
+static long dqtake( int w )
+/********1*********2*********3*********4*********5*********6*********7*********
+ * purpose:         oldest chunk number from worker w's own deque; -1 if
+ *                  it is empty
+ ********1*********2*********3*********4*********5*********6*********7*********/
+{
+        long seq= -1;
+
+        pthread_mutex_lock( &dq[w].lock );
+        if( dq[w].count > 0 ) {
+                seq= dq[w].task[dq[w].head];
+                dq[w].head= (dq[w].head + 1) % nslot;
+                dq[w].count--;
+        }
+        pthread_mutex_unlock( &dq[w].lock );
+
+        return( seq );
+}
+
+
+static long dqsteal( int w )
+/********1*********2*********3*********4*********5*********6*********7*********
+ * purpose:         newest chunk number from the deque of any worker
+ *                  other than w; -1 if all are empty
+ ********1*********2*********3*********4*********5*********6*********7*********/
+{
+        int i;
+        int v;
+        long seq= -1;
+
+        for( i= 1; i < nworker && seq < 0; i++ ) {
+                v= (w + i) % nworker;
+                pthread_mutex_lock( &dq[v].lock );
+                if( dq[v].count > 0 ) {
+                        dq[v].count--;
+                        seq= dq[v].task[(dq[v].head + dq[v].count) % nslot];
+                }
+                pthread_mutex_unlock( &dq[v].lock );
+        }
+
+        return( seq );
+}
+
+
+static void *worker( void *arg )
+/********1*********2*********3*********4*********5*********6*********7*********
+ * purpose:         conversion thread: take, else steal, else sleep
+ ********1*********2*********3*********4*********5*********6*********7*********/
+{
+        int w= (int)(long)arg;
+        long seq;
+
+        for( ;; ) {
+                if( (seq= dqtake( w )) < 0 )
+                        seq= dqsteal( w );
+
+                if( seq >= 0 ) {
+                        pthread_mutex_lock( &pool );
+                        pending--;
+                        pthread_mutex_unlock( &pool );
+
+                        cvtchunk( cjob, &slot[seq % nslot] );
+
+                        pthread_mutex_lock( &pool );
+                        state[seq % nslot]= ST_done;
+                        pthread_cond_broadcast( &done );
+                        pthread_mutex_unlock( &pool );
+                        continue;
+                }
+
+                pthread_mutex_lock( &pool );
+                while( pending == 0 && eof == 0 )
+                        pthread_cond_wait( &work, &pool );
+                if( pending == 0 && eof != 0 ) {
+                        pthread_mutex_unlock( &pool );
+                        break;
+                }
+                pthread_mutex_unlock( &pool );
+        }
+
+        return( NULL );
+}
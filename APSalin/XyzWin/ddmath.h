@@ -0,0 +1,278 @@
+/*  @(#)ddmath.h        1.0  26/10/18  */
+/********1*********2*********3*********4*********5*********6*********7*********
+ * name:            ddmath.h
+ * version:         2610.18
+ * written by:      geoData
+ * purpose:         double-double arithmetic, scalar and AVX2 (4 lanes),
+ *                  for the reference conversions of xyz2plhdd.c
+ *
+ * global variables and constants
+ * ------------------------------
+ * DD_ntab          number of entries of the sine and cosine tables, one
+ *                  every 1/8 deg over [0, 90) deg
+ * DD_pihi, _pilo   pi as a double-double
+ *
+ * dd, one double-double: the value is hi + lo, |lo| <= ulp(hi)/2
+ *
+ * vdd, four double-doubles, one per lane
+ *
+ * dd_trig, the tables and constants of the reference conversions:
+ *    sh[], sl[]    sine of j/8 deg, j = 0..DD_ntab-1
+ *    ch[], cl[]    cosine of j/8 deg
+ *    d2r           pi/180
+ *    s3            -1/6, of the sine series
+ *    c4            1/24, of the cosine series
+ *
+ * functions
+ * ------------------------------
+ * ddadd:           dd + dd
+ * ddaddd:          dd + double
+ * dddiv:           dd / dd
+ * ddfast:          double + double, |a| >= |b|, exact, as a dd
+ * ddfoot:          whether a result of xyz2plhdd.c is the nearest foot
+ * ddmul:           dd * dd
+ * ddmuld:          dd * double
+ * ddneg:           -dd
+ * ddprod:          double * double, exact, as a dd (FMA)
+ * ddsum:           double + double, exact, as a dd
+ * ddtrig:          the dd_trig of xyz2plhdd.c, made on first use
+ * vdd...:          the same on vdd, AVX2 only (no vdddiv)
+ *
+ * comments:
+ * ------------------------------
+ * The error-free transforms are Knuth's two-sum and the FMA two-product;
+ * ddadd is the accurate (two two-sum) addition, which keeps the 106
+ * bits through the cancellation of a residual; ddmul drops lo*lo only.
+ * Each operation is good to a few units of 2^-106 of its result.
+ *
+ * As vmath.h, everything is static inline.  The scalar functions need
+ * fma() to be exact; a unit compiled without -mfma gets that of the C
+ * library, which is exact but slow.  The vdd functions are only for
+ * units compiled with -mavx2 -mfma.
+ *
+ * references:
+ * ------------------------------
+ * Dekker, T. J. (1971). "A floating-point technique for extending the
+ * available precision", Numerische Mathematik, v. 18, pp. 224-242.
+ *
+ * Hida, Y., X. S. Li and D. H. Bailey (2001). "Algorithms for
+ * quad-double precision floating point arithmetic", 15th IEEE
+ * Symposium on Computer Arithmetic, pp. 155-162.
+ *
+ ********1*********2*********3*********4*********5*********6*********7*********
+ *:modification history
+ *:2610.18, GD, Creation
+ *:2610.18, GD, ddfoot, the test of the nearest foot
+ ********1*********2*********3*********4*********5*********6*********7*********/
+
+#ifndef ddmath_h
+#define ddmath_h
+
+#include <math.h>
+
+#define DD_ntab         ((int)720)
+#define DD_pihi         ((double)3.141592653589793116e+00)
+#define DD_pilo         ((double)1.224646799147353207e-16)
+
+struct dd {
+        double hi;
+        double lo;
+};
+
+struct dd_trig {
+        double sh[DD_ntab];
+        double sl[DD_ntab];
+        double ch[DD_ntab];
+        double cl[DD_ntab];
+        struct dd d2r;
+        struct dd s3;
+        struct dd c4;
+};
+
+struct ellipsoid;
+
+int ddfoot( double *, double *, struct ellipsoid * );
+const struct dd_trig *ddtrig( void );
+
+static inline struct dd ddsum( double a, double b )
+{
+        struct dd r;
+        double v;
+
+        r.hi= a + b;
+        v= r.hi - a;
+        r.lo= (a - (r.hi - v)) + (b - v);
+
+        return( r );
+}
+
+static inline struct dd ddfast( double a, double b )
+{
+        struct dd r;
+
+        r.hi= a + b;
+        r.lo= b - (r.hi - a);
+
+        return( r );
+}
+
+static inline struct dd ddprod( double a, double b )
+{
+        struct dd r;
+
+        r.hi= a * b;
+        r.lo= fma( a, b, -r.hi );
+
+        return( r );
+}
+
+static inline struct dd ddneg( struct dd a )
+{
+        a.hi= -a.hi;
+        a.lo= -a.lo;
+
+        return( a );
+}
+
+static inline struct dd ddadd( struct dd a, struct dd b )
+{
+        struct dd s= ddsum( a.hi, b.hi );
+        struct dd t= ddsum( a.lo, b.lo );
+
+        s= ddfast( s.hi, s.lo + t.hi );
+
+        return( ddfast( s.hi, s.lo + t.lo ) );
+}
+
+static inline struct dd ddaddd( struct dd a, double b )
+{
+        struct dd s= ddsum( a.hi, b );
+
+        return( ddfast( s.hi, s.lo + a.lo ) );
+}
+
+static inline struct dd ddmul( struct dd a, struct dd b )
+{
+        struct dd p= ddprod( a.hi, b.hi );
+
+        p.lo+= a.hi*b.lo + a.lo*b.hi;
+
+        return( ddfast( p.hi, p.lo ) );
+}
+
+static inline struct dd ddmuld( struct dd a, double b )
+{
+        struct dd p= ddprod( a.hi, b );
+
+        p.lo= fma( a.lo, b, p.lo );
+
+        return( ddfast( p.hi, p.lo ) );
+}
+
+static inline struct dd dddiv( struct dd a, struct dd b )
+{
+        struct dd q;
+        struct dd r;
+        double q1;
+        double q2;
+
+        q1= a.hi / b.hi;
+        r= ddadd( a, ddneg( ddmuld( b, q1 ) ) );
+        q2= r.hi / b.hi;
+        r= ddadd( r, ddneg( ddmuld( b, q2 ) ) );
+        q= ddfast( q1, q2 );
+
+        return( ddaddd( q, r.hi / b.hi ) );
+}
+
+#ifdef __AVX2__
+
+#include <immintrin.h>
+
+struct vdd {
+        __m256d hi;
+        __m256d lo;
+};
+
+static inline struct vdd vddsum( __m256d a, __m256d b )
+{
+        struct vdd r;
+        __m256d v;
+
+        r.hi= _mm256_add_pd( a, b );
+        v= _mm256_sub_pd( r.hi, a );
+        r.lo= _mm256_add_pd( _mm256_sub_pd( a, _mm256_sub_pd( r.hi, v ) ),
+                             _mm256_sub_pd( b, v ) );
+
+        return( r );
+}
+
+static inline struct vdd vddfast( __m256d a, __m256d b )
+{
+        struct vdd r;
+
+        r.hi= _mm256_add_pd( a, b );
+        r.lo= _mm256_sub_pd( b, _mm256_sub_pd( r.hi, a ) );
+
+        return( r );
+}
+
+static inline struct vdd vddprod( __m256d a, __m256d b )
+{
+        struct vdd r;
+
+        r.hi= _mm256_mul_pd( a, b );
+        r.lo= _mm256_fmsub_pd( a, b, r.hi );
+
+        return( r );
+}
+
+static inline struct vdd vddneg( struct vdd a )
+{
+        __m256d m= _mm256_set1_pd( -0.0 );
+
+        a.hi= _mm256_xor_pd( a.hi, m );
+        a.lo= _mm256_xor_pd( a.lo, m );
+
+        return( a );
+}
+
+static inline struct vdd vddadd( struct vdd a, struct vdd b )
+{
+        struct vdd s= vddsum( a.hi, b.hi );
+        struct vdd t= vddsum( a.lo, b.lo );
+
+        s= vddfast( s.hi, _mm256_add_pd( s.lo, t.hi ) );
+
+        return( vddfast( s.hi, _mm256_add_pd( s.lo, t.lo ) ) );
+}
+
+static inline struct vdd vddaddd( struct vdd a, __m256d b )
+{
+        struct vdd s= vddsum( a.hi, b );
+
+        return( vddfast( s.hi, _mm256_add_pd( s.lo, a.lo ) ) );
+}
+
+static inline struct vdd vddmul( struct vdd a, struct vdd b )
+{
+        struct vdd p= vddprod( a.hi, b.hi );
+
+        p.lo= _mm256_add_pd( p.lo, _mm256_fmadd_pd( a.hi, b.lo,
+                                   _mm256_mul_pd( a.lo, b.hi ) ) );
+
+        return( vddfast( p.hi, p.lo ) );
+}
+
+static inline struct vdd vddmuld( struct vdd a, __m256d b )
+{
+        struct vdd p= vddprod( a.hi, b );
+
+        p.lo= _mm256_fmadd_pd( a.lo, b, p.lo );
+
+        return( vddfast( p.hi, p.lo ) );
+}
+
+#endif /* __AVX2__ */
+
+#endif /* ddmath_h */
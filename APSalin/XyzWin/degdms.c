@@ -1,20 +1,36 @@
-/*  @(#)degdms.c        1.1  98/12/08  */
-static char *sccsid= "@(#)degdms.c      1.1  98/12/08";
+/*  @(#)degdms.c        1.2  26/10/18  */
+static char *sccsid= "@(#)degdms.c      1.2  26/10/18";
 /*
  *  include files
  */
 
+#include <stdio.h>
+#include <math.h>
 
 /*
  *  function prototypes
  */
 
 void degdms( double, int *, int *, double * );
+void degdmsv( int, double *, int, int *, int *, double * );
+int dmsfmt( char *, int, double, int, int );
+static long long dmsround( double, int );
 
 /*
  *  global definitions and variables
+ *
+ *  MAX_dmsprec  most digits of the seconds for degdmsv, dmsfmt; the
+ *               angle in units of the last digit stays below 2^53
+ *  p10s[]       3600 * 10^prec, units of the last digit in a degree
  */
 
+#define MAX_dmsprec     9
+
+static const double p10s[MAX_dmsprec+1]= {
+        3.6e3, 3.6e4, 3.6e5, 3.6e6, 3.6e7, 3.6e8, 3.6e9, 3.6e10, 3.6e11,
+        3.6e12
+};
+
 
 
 
@@ -54,6 +70,7 @@ void degdms( double ddeg, int *deg, int *min, double *sec )
  ********1*********2*********3*********4*********5*********6*********7*********
  *:modification history
  *:9504.11, MSS, Creation
+ *:2610.18, GD,  see degdmsv, dmsfmt for rounded seconds
  ********1*********2*********3*********4*********5*********6*********7*********/
 
 {
@@ -71,3 +88,199 @@ void degdms( double ddeg, int *deg, int *min, double *sec )
         *sec= (ddeg-(double)(*min))*(double)60;
         *deg= sign*(*deg);
 }
+
+
+void degdmsv( int n, double *ddeg, int prec, int *deg, int *min,
+              double *sec )
+/********1*********2*********3*********4*********5*********6*********7*********
+ * name:            degdmsv
+ * version:         2610.18
+ * written by:      geoData
+ * purpose:         converts an array of decimal degrees to degrees,
+ *                  minutes and seconds rounded to prec decimals (batch)
+ *
+ * input parameters
+ * ----------------
+ * ddeg[]           n angles [deg]
+ * n                number of angles
+ * prec             digits of the seconds kept, clamped to 0 to
+ *                  MAX_dmsprec as in dmsfmt
+ *
+ * output parameters
+ * -----------------
+ * deg[], min[]     degrees and minutes; only the degree keeps the sign,
+ *                  as in degdms
+ * sec[]            seconds, a multiple of 10^-prec below 60
+ *
+ * calls:
+ * ------------------------------
+ * dmsround         |angle| in units of the last digit of the seconds
+ *
+ * comments:
+ * ------------------------------
+ * The angle is rounded once, to a whole number of 10^-prec seconds,
+ * and split by integer division, so seconds that would print as 60
+ * carry into the minutes and degrees.  degdms truncates instead, and
+ * 59.999999 seconds printed with "%8.5f" read 60.00000.  For an angle
+ * between -1 and 0 the sign is lost as in degdms; dmsfmt keeps it.
+ *
+ ********1*********2*********3*********4*********5*********6*********7*********
+ *:modification history
+ *:2610.18, GD, Creation
+ *:2610.18, GD, Clamp prec to 0 to MAX_dmsprec
+ ********1*********2*********3*********4*********5*********6*********7*********/
+
+{
+        double s10;
+        long long t;
+        long long u;
+        long long u60;
+        int i;
+
+        if( prec < 0 )
+                prec= 0;
+        if( prec > MAX_dmsprec )
+                prec= MAX_dmsprec;
+        s10= p10s[prec] / (double)3600;
+        u= (long long)p10s[prec];
+        u60= u / 60;
+
+        for( i= 0; i < n; i++ ) {
+                t= dmsround( ddeg[i], prec );
+                deg[i]= (int)( t / u );
+                min[i]= (int)( t % u / u60 );
+                sec[i]= (double)( t % u60 ) / s10;
+                if( ddeg[i] < 0 )
+                        deg[i]= -deg[i];
+        }
+}
+
+
+int dmsfmt( char *buf, int size, double ddeg, int wdeg, int prec )
+/********1*********2*********3*********4*********5*********6*********7*********
+ * name:            dmsfmt
+ * version:         2610.18
+ * written by:      geoData
+ * purpose:         formats decimal degrees as degrees, minutes, seconds,
+ *                  as snprintf( buf, size, "%*d %2d %*.*f", wdeg, deg,
+ *                  min, ws, prec, sec ) of the degdmsv values, where the
+ *                  width ws of the seconds is prec+3 (2 if prec is 0)
+ *
+ * input parameters
+ * ----------------
+ * ddeg             angle [deg]
+ * prec             digits of the seconds, 0 to MAX_dmsprec
+ * size             size of buf [char]
+ * wdeg             minimum width of the degrees, with their sign
+ *
+ * output parameters
+ * -----------------
+ * buf              the text, '\0' terminated
+ *
+ * returns the length of the text, not counting the '\0'
+ *
+ * calls:
+ * ------------------------------
+ * dmsround         |angle| in units of the last digit of the seconds
+ *
+ * comments:
+ * ------------------------------
+ * The digits are written from the integers of the rounded angle, with
+ * no floating point formatting.  The sign goes on the degrees, "-0"
+ * included, so -0.5 reads " -0 30  0.00000".  A NaN or infinite angle
+ * fills the same width with "%*f"; text that would not fit in buf goes
+ * to snprintf.
+ *
+ ********1*********2*********3*********4*********5*********6*********7*********
+ *:modification history
+ *:2610.18, GD, Creation
+ ********1*********2*********3*********4*********5*********6*********7*********/
+
+{
+        char dig[16];
+        char *p;
+        int d;
+        int k;
+        int len;
+        int m;
+        int nd= 0;
+        int neg= ddeg < 0;
+        int ws;
+        long long f;
+        long long s;
+        long long t;
+        long long u;
+        long long u60;
+
+        if( prec < 0 )
+                prec= 0;
+        if( prec > MAX_dmsprec )
+                prec= MAX_dmsprec;
+        ws= prec > 0 ? prec + 3 : 2;
+        if( !isfinite( ddeg ) )
+                return( snprintf( buf, size, "%*f", wdeg + 4 + ws, ddeg ) );
+
+        u= (long long)p10s[prec];
+        u60= u / 60;
+        t= dmsround( ddeg, prec );
+        d= (int)( t / u );
+        m= (int)( t % u / u60 );
+        s= t % u60;
+
+        for( k= d; k != 0 || nd == 0; k/= 10 )
+                dig[nd++]= '0' + k % 10;
+        len= ( wdeg > nd + neg ? wdeg : nd + neg ) + 4 + ws;
+        if( len >= size ) {
+                if( neg && d == 0 )
+                        return( snprintf( buf, size, "%*s %2d %*.*f", wdeg,
+                                          "-0", m, ws, prec,
+                                          (double)s * 60 / (double)u60 ) );
+                return( snprintf( buf, size, "%*d %2d %*.*f", wdeg,
+                                  neg ? -d : d, m, ws, prec,
+                                  (double)s * 60 / (double)u60 ) );
+        }
+
+        p= buf;
+        for( k= nd + neg; k < wdeg; k++ )
+                *p++= ' ';
+        if( neg )
+                *p++= '-';
+        while( nd > 0 )
+                *p++= dig[--nd];
+        *p++= ' ';
+        *p++= m < 10 ? ' ' : '0' + m / 10;
+        *p++= '0' + m % 10;
+        *p++= ' ';
+        f= s % ( u60 / 60 );
+        s/= u60 / 60;
+        *p++= s < 10 ? ' ' : '0' + (int)( s / 10 );
+        *p++= '0' + (int)( s % 10 );
+        if( prec > 0 ) {
+                *p++= '.';
+                for( k= prec - 1; k >= 0; k-- ) {
+                        p[k]= '0' + (int)( f % 10 );
+                        f/= 10;
+                }
+                p+= prec;
+        }
+        *p= '\0';
+
+        return( (int)( p - buf ) );
+}
+
+
+static long long dmsround( double ddeg, int prec )
+/********1*********2*********3*********4*********5*********6*********7*********
+ * purpose:         |ddeg| in units of 10^-prec seconds, rounded to
+ *                  nearest (even on a tie, as printf); the whole
+ *                  degrees are taken out first so the one rounding is
+ *                  of the fraction alone
+ ********1*********2*********3*********4*********5*********6*********7*********/
+
+{
+        double a= fabs( ddeg );
+        double w= floor( a );
+
+        return( (long long)w * (long long)p10s[prec]
+                + (long long)nearbyint( ( a - w ) * p10s[prec] ) );
+}
@@ -0,0 +1,217 @@
+/*  @(#)ellips.c        1.0  26/10/18  */
+static char *sccsid= "@(#)ellips.c      1.0  26/10/18";
+/*
+ *  include files
+ */
+
+#include <stdio.h>
+#include <ctype.h>
+#include <string.h>
+#include "physcon.h"
+#include "libgpsC.h"
+
+/*
+ *  function prototypes
+ */
+
+struct ellipsoid *ellfind( char * );
+void elllist( FILE * );
+struct ellipsoid *ellparse( char *, struct ellipsoid * );
+int ellset( struct ellipsoid *, char *, double, double );
+static int namecmp( char *, char * );
+
+/*
+ *  global definitions and variables
+ *
+ *  defs[]      defining values: name, A [m] and FL
+ *  ells[]      the registry, filled in from defs[] on first use
+ */
+
+#define MAX_ell         ((int)(sizeof(defs)/sizeof(defs[0])))
+
+static const struct {
+        char  *name;
+        double A;
+        double FL;
+} defs[]= {
+        { "GRS80",      GRS80_A,     GRS80_FL            },
+        { "WGS84",      WGS84_A,     WGS84_FL            },
+        { "INTL1924",   6378388.0,   ONE/297.0           },
+        { "BESSEL1841", 6377397.155, ONE/299.1528128     },
+        { "CLARKE1866", 6378206.4,   ONE/294.9786982     }
+};
+
+static struct ellipsoid ells[MAX_ell];
+static int nell= 0;
+
+
+int ellset( struct ellipsoid *ell, char *name, double A, double FL )
+/********1*********2*********3*********4*********5*********6*********7*********
+ * name:            ellset
+ * version:         2610.18
+ * written by:      geoData
+ * purpose:         fills in an ellipsoid and its derived constants
+ *
+ * input parameters
+ * ----------------
+ * name             name of the ellipsoid; cut to MAX_ellname-1 characters
+ * A                semi-major axis [m]
+ * FL               flattening [unitless]
+ *
+ * output parameters
+ * -----------------
+ * ell              the ellipsoid
+ *
+ * returns 0 on success, -1 unless A > 0 and 0 <= FL < 1
+ *
+ ********1*********2*********3*********4*********5*********6*********7*********
+ *:modification history
+ *:2610.18, GD, Creation
+ ********1*********2*********3*********4*********5*********6*********7*********/
+
+{
+        if( !(A > ZERO) || !(FL >= ZERO && FL < ONE) )
+                return( -1 );
+
+        memset( ell->name, 0, sizeof(ell->name) );
+        strncpy( ell->name, name, MAX_ellname - 1 );
+        ell->A= A;
+        ell->FL= FL;
+        ell->B= A * (ONE - FL);
+        ell->c= A*A - ell->B*ell->B;
+        ell->e2= (TWO - FL)*FL;
+        ell->funsq= (ONE - FL)*(ONE - FL);
+        ell->ep2= ell->e2 / ell->funsq;
+        ell->rA= ONE / A;
+        ell->rB= ONE / ell->B;
+
+        return( 0 );
+}
+
+
+struct ellipsoid *ellfind( char *name )
+/********1*********2*********3*********4*********5*********6*********7*********
+ * name:            ellfind
+ * version:         2610.18
+ * written by:      geoData
+ * purpose:         looks up a named ellipsoid in the registry
+ *
+ * input parameters
+ * ----------------
+ * name             name of the ellipsoid, upper or lower case
+ *
+ * returns the ellipsoid; NULL if name is not in the registry
+ *
+ * comments:
+ * ------------------------------
+ * The registry is filled in on the first call, so the first call must
+ * come before any conversion threads are started.  The entries are
+ * shared and must not be changed.
+ *
+ ********1*********2*********3*********4*********5*********6*********7*********
+ *:modification history
+ *:2610.18, GD, Creation
+ ********1*********2*********3*********4*********5*********6*********7*********/
+
+{
+        int i;
+
+        if( nell == 0 ) {
+                for( i= 0; i < MAX_ell; i++ )
+                        ellset( &ells[i], defs[i].name, defs[i].A,
+                                defs[i].FL );
+                nell= MAX_ell;
+        }
+
+        for( i= 0; i < nell; i++ )
+                if( namecmp( name, ells[i].name ) == 0 )
+                        return( &ells[i] );
+
+        return( NULL );
+}
+
+
+struct ellipsoid *ellparse( char *spec, struct ellipsoid *custom )
+/********1*********2*********3*********4*********5*********6*********7*********
+ * name:            ellparse
+ * version:         2610.18
+ * written by:      geoData
+ * purpose:         interprets an ellipsoid given on a command line
+ *
+ * input parameters
+ * ----------------
+ * spec             a registry name, e.g. "WGS84", or "A,FL" where FL
+ *                  greater than one is taken as the inverse flattening
+ *
+ * output parameters
+ * -----------------
+ * custom           filled in, named "custom", when spec is "A,FL"
+ *
+ * returns the ellipsoid (a registry entry or custom); NULL if spec is
+ * neither a known name nor a valid A,FL
+ *
+ ********1*********2*********3*********4*********5*********6*********7*********
+ *:modification history
+ *:2610.18, GD, Creation
+ ********1*********2*********3*********4*********5*********6*********7*********/
+
+{
+        char *end;
+        double A;
+        double FL;
+
+        if( strchr( spec, ',' ) == NULL )
+                return( ellfind( spec ) );
+
+        A= numscan( spec, &end );
+        if( end == spec || *end != ',' )
+                return( NULL );
+        spec= end + 1;
+        FL= numscan( spec, &end );
+        if( end == spec || *end != '\0' )
+                return( NULL );
+        if( FL > ONE )
+                FL= ONE / FL;
+        if( ellset( custom, "custom", A, FL ) != 0 )
+                return( NULL );
+
+        return( custom );
+}
+
+
+void elllist( FILE *fp )
+/********1*********2*********3*********4*********5*********6*********7*********
+ * name:            elllist
+ * version:         2610.18
+ * written by:      geoData
+ * purpose:         prints the registry, one ellipsoid per line
+ *
+ ********1*********2*********3*********4*********5*********6*********7*********
+ *:modification history
+ *:2610.18, GD, Creation
+ ********1*********2*********3*********4*********5*********6*********7*********/
+
+{
+        int i;
+
+        ellfind( "" );
+        for( i= 0; i < nell; i++ )
+                fprintf( fp, "  %-12s A= %.4f  1/f= %.9f\n", ells[i].name,
+                         ells[i].A, ONE / ells[i].FL );
+}
+
+
+static int namecmp( char *a, char *b )
+/********1*********2*********3*********4*********5*********6*********7*********
+ * purpose:         compares two names ignoring case; 0 if equal
+ ********1*********2*********3*********4*********5*********6*********7*********/
+{
+        while( *a != '\0'
+               && toupper( (unsigned char)*a )
+                  == toupper( (unsigned char)*b ) ) {
+                a++;
+                b++;
+        }
+
+        return( toupper( (unsigned char)*a ) - toupper( (unsigned char)*b ) );
+}
@@ -0,0 +1,104 @@
+/*  @(#)ellips.h        1.0  26/10/18  */
+/********1*********2*********3*********4*********5*********6*********7*********
+ * name:            ellips.h
+ * version:         2610.18
+ * written by:      geoData
+ * purpose:         named reference ellipsoids and their derived constants
+ *
+ * global variables and constants
+ * ------------------------------
+ * MAX_ellname      maximum length of an ellipsoid name, with the '\0'
+ * GRS80_A, _FL     GRS80 semi-major axis [m] and flattening, as emajor,
+ *                  eflat of physcon.h
+ * WGS84_A, _FL     WGS84 semi-major axis [m] and flattening
+ * BRK_rmin         least distance from the Z axis used for Borkowski's E,
+ *                  F, as a fraction of A; on the axis they are infinite
+ * BRK_rpol         polar cap of the Newton correction of Borkowski's t:
+ *                  distance from the Z axis below BRK_rpol*A, and
+ *                  B*|z| > 2*c so the point is clear of the evolute;
+ *                  nearer the axis and the centre, xyz2plhn
+ *
+ * ellipsoid, one reference ellipsoid:
+ *    name          e.g. "GRS80"; "custom" for one given as A, FL
+ *    A             semi-major axis [m]
+ *    FL            flattening [unitless]
+ *    B             semi-minor axis, A*(1-FL) [m]
+ *    c             A*A - B*B, the linear eccentricity squared [m^2]
+ *    e2            first eccentricity squared, (2-FL)*FL
+ *    ep2           second eccentricity squared, e2/(1-e2)
+ *    funsq         (1-FL)^2 = 1 - e2
+ *    rA            1/A [1/m]
+ *    rB            1/B [1/m]
+ *
+ * functions
+ * ------------------------------
+ * ellfind:         looks up a named ellipsoid in the registry
+ * elllist:         prints the registry
+ * ellparse:        a registry name or "A,FL" from a command line
+ * ellset:          fills in an ellipsoid and its derived constants
+ *
+ * comments:
+ * ------------------------------
+ * The derived constants are computed once, by ellset, with the same
+ * expressions the point routines used; xyz2plhe and plh2xyze with an
+ * ellipsoid therefore give the same results as xyz2plh and plh2xyz
+ * with its A and FL.
+ *
+ * GRS80 is emajor, eflat of physcon.h, i.e. 1/f = 298.257222101 cut
+ * to 14 decimals, so that the default output is unchanged.  The other
+ * flattenings are 1/(1/f) of the defining values.
+ *
+ * references:
+ * ------------------------------
+ * Moritz, H. (1980). "Geodetic Reference System 1980", Bulletin
+ * Geodesique, v. 54, pp. 395-405.
+ *
+ * NIMA (2000). "Department of Defense World Geodetic System 1984",
+ * TR8350.2, 3rd ed., amendment 1.
+ *
+ * Snyder, J. P. (1987). "Map Projections - A Working Manual", USGS
+ * Professional Paper 1395, table 1.
+ *
+ ********1*********2*********3*********4*********5*********6*********7*********
+ *:modification history
+ *:2610.18, GD, Creation
+ *:2610.18, GD, GRS80 and WGS84 defining values as constants, for the
+ *:              specialized kernels (xyz2plhs.c)
+ *:2610.18, GD, BRK_rmin, BRK_rpol for the Z axis and the poles
+ *:2610.18, GD, The core inside BRK_rpol goes to xyz2plhn
+ ********1*********2*********3*********4*********5*********6*********7*********/
+
+#ifndef ellips_h
+#define ellips_h
+
+#include <stdio.h>
+
+#define MAX_ellname     ((int)16)
+
+#define GRS80_A         ((double)6378137.0)
+#define GRS80_FL        ((double)0.00335281068118)
+#define WGS84_A         ((double)6378137.0)
+#define WGS84_FL        ((double)1.0/(double)298.257223563)
+
+#define BRK_rmin        ((double)1.0/(double)1099511627776.0)
+#define BRK_rpol        ((double)1.0/(double)64.0)
+
+struct ellipsoid {
+        char   name[MAX_ellname];
+        double A;
+        double FL;
+        double B;
+        double c;
+        double e2;
+        double ep2;
+        double funsq;
+        double rA;
+        double rB;
+};
+
+struct ellipsoid *ellfind( char * );
+void elllist( FILE * );
+struct ellipsoid *ellparse( char *, struct ellipsoid * );
+int ellset( struct ellipsoid *, char *, double, double );
+
+#endif /* ellips_h */
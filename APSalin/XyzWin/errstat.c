@@ -0,0 +1,317 @@
+/*  @(#)errstat.c       1.0  26/10/18  */
+static char *sccsid= "@(#)errstat.c     1.0  26/10/18";
+/*
+ *      include files
+ */
+
+#include <stdio.h>
+#include <math.h>
+#include "physcon.h"
+#include "errstat.h"
+
+/*
+ *      function prototypes
+ */
+
+static inline int esbin( double );
+static inline void esworst( ESDS *, double, long );
+
+/*
+ *      definitions and global variables
+ */
+
+
+
+void esinit( ESDS *es )
+/********1*********2*********3*********4*********5*********6*********7**
+ * Name:        esinit
+ * Version:     2610.18
+ * Author:      geoData
+ * Purpose:     Empties an error statistics data structure.
+ *
+ * Input:
+ * -----------
+ * es               ESDS
+ *
+ * Output:
+ * -----------
+ * es               no errors
+ *
+ ********1*********2*********3*********4*********5*********6*********7**
+ * Modification History:
+ * 2610.18, GD,  Creation
+ ********1*********2*********3*********4*********5*********6*********7*/
+{
+        int k;
+
+        es->SumErr= ZERO;
+        es->SumErr2= ZERO;
+        es->MaxAbs= ZERO;
+        es->Count= 0;
+        es->NonFinite= 0;
+        for( k= 0; k < ES_nbin; k++ )
+                es->Hist[k]= 0;
+        es->NWorst= 0;
+}
+
+
+static inline int esbin( double a )
+/********1*********2*********3*********4*********5*********6*********7**
+ * Purpose:     histogram bin of |error| a
+ ********1*********2*********3*********4*********5*********6*********7*/
+{
+        double t;
+
+        if( !( a > ZERO ) )
+                return( 0 );
+        t= ( log10( a ) - ES_lgmin ) * ES_bpd;
+        if( t < ZERO )
+                return( 0 );
+        if( t >= ES_nbin - 2 )
+                return( ES_nbin - 1 );
+        return( (int)t + 1 );
+}
+
+
+static inline void esworst( ESDS *es, double e, long id )
+/********1*********2*********3*********4*********5*********6*********7**
+ * Purpose:     enters error e of point id in the list of the largest
+ *              errors, if it belongs there
+ ********1*********2*********3*********4*********5*********6*********7*/
+{
+        double a= fabs( e );
+        int k;
+
+        if( es->NWorst == ES_nworst ) {
+                if( !( a > fabs( es->WorstErr[ES_nworst-1] ) ) )
+                        return;
+                k= ES_nworst - 1;
+        } else
+                k= es->NWorst++;
+        for( ; k > 0 && a > fabs( es->WorstErr[k-1] ); k-- ) {
+                es->WorstErr[k]= es->WorstErr[k-1];
+                es->WorstId[k]= es->WorstId[k-1];
+        }
+        es->WorstErr[k]= e;
+        es->WorstId[k]= id;
+}
+
+
+void esadd( ESDS *es, double e, long id )
+/********1*********2*********3*********4*********5*********6*********7**
+ * Name:        esadd
+ * Version:     2610.18
+ * Author:      geoData
+ * Purpose:     Adds one error to an error statistics data structure.
+ *
+ * Input:
+ * -----------
+ * e                error, in the caller's unit
+ * es               ESDS
+ * id               caller's number of the point, kept with the largest
+ *                  errors
+ *
+ * Output:
+ * -----------
+ * es               with e added
+ *
+ * Notes:
+ * -----------
+ * A NaN or infinite e is only counted, in NonFinite.
+ *
+ ********1*********2*********3*********4*********5*********6*********7**
+ * Modification History:
+ * 2610.18, GD,  Creation
+ ********1*********2*********3*********4*********5*********6*********7*/
+{
+        double a= fabs( e );
+
+        if( !isfinite( e ) ) {
+                es->NonFinite++;
+                return;
+        }
+        es->SumErr+= e;
+        es->SumErr2+= e*e;
+        if( a > es->MaxAbs )
+                es->MaxAbs= a;
+        es->Count++;
+        es->Hist[esbin( a )]++;
+        esworst( es, e, id );
+}
+
+
+void esaddv( ESDS *es, int n, double *e, long id0 )
+/********1*********2*********3*********4*********5*********6*********7**
+ * Name:        esaddv
+ * Version:     2610.18
+ * Author:      geoData
+ * Purpose:     Adds an array of errors to an error statistics data
+ *              structure.  Batch form of esadd.
+ *
+ * Input:
+ * -----------
+ * e[]              n errors, in the caller's unit
+ * es               ESDS
+ * id0              caller's number of the point of e[0]; e[i] is point
+ *                  id0 + i
+ * n                number of errors
+ *
+ * Output:
+ * -----------
+ * es               with e[0..n-1] added
+ *
+ * Notes:
+ * -----------
+ * The sums of the array are formed on their own and then added to
+ * those of es, so the rounding of a long run grows with the number of
+ * calls and the length of one array rather than with the number of
+ * points.  Errors no larger than the smallest of a full worst list are
+ * passed over with one compare.
+ *
+ ********1*********2*********3*********4*********5*********6*********7**
+ * Modification History:
+ * 2610.18, GD,  Creation
+ ********1*********2*********3*********4*********5*********6*********7*/
+{
+        double a;
+        double amax= es->MaxAbs;
+        double amin;
+        double s= ZERO;
+        double s2= ZERO;
+        long nbad= 0;
+        int i;
+
+        amin= es->NWorst == ES_nworst ? fabs( es->WorstErr[ES_nworst-1] )
+                                      : -ONE;
+        for( i= 0; i < n; i++ ) {
+                if( !isfinite( e[i] ) ) {
+                        nbad++;
+                        continue;
+                }
+                a= fabs( e[i] );
+                s+= e[i];
+                s2+= e[i]*e[i];
+                if( a > amax )
+                        amax= a;
+                es->Hist[esbin( a )]++;
+                if( a > amin ) {
+                        esworst( es, e[i], id0 + i );
+                        if( es->NWorst == ES_nworst )
+                                amin= fabs( es->WorstErr[ES_nworst-1] );
+                }
+        }
+        es->SumErr+= s;
+        es->SumErr2+= s2;
+        es->MaxAbs= amax;
+        es->Count+= n - nbad;
+        es->NonFinite+= nbad;
+}
+
+
+void esmerge( ESDS *es, ESDS *from )
+/********1*********2*********3*********4*********5*********6*********7**
+ * Name:        esmerge
+ * Version:     2610.18
+ * Author:      geoData
+ * Purpose:     Adds the errors of one error statistics data structure
+ *              to another, e.g. those of each thread to the total.
+ *
+ * Input:
+ * -----------
+ * es               ESDS
+ * from             ESDS to add; not changed
+ *
+ * Output:
+ * -----------
+ * es               as if every error of from had been added to it
+ *
+ * Notes:
+ * -----------
+ * Exact, apart from the rounding of the two sums: the worst list of
+ * the union is within the union of the two worst lists.
+ *
+ ********1*********2*********3*********4*********5*********6*********7**
+ * Modification History:
+ * 2610.18, GD,  Creation
+ ********1*********2*********3*********4*********5*********6*********7*/
+{
+        int k;
+
+        es->SumErr+= from->SumErr;
+        es->SumErr2+= from->SumErr2;
+        if( from->MaxAbs > es->MaxAbs )
+                es->MaxAbs= from->MaxAbs;
+        es->Count+= from->Count;
+        es->NonFinite+= from->NonFinite;
+        for( k= 0; k < ES_nbin; k++ )
+                es->Hist[k]+= from->Hist[k];
+        for( k= 0; k < from->NWorst; k++ )
+                esworst( es, from->WorstErr[k], from->WorstId[k] );
+}
+
+
+void esreport( FILE *fp, ESDS *es, char *unit )
+/********1*********2*********3*********4*********5*********6*********7**
+ * Name:        esreport
+ * Version:     2610.18
+ * Author:      geoData
+ * Purpose:     Prints the statistics of an error statistics data
+ *              structure: count, mean, rms, max |error|, the histogram
+ *              of |error| and the largest errors.
+ *
+ * Input:
+ * -----------
+ * es               ESDS
+ * fp               output stream
+ * unit             name of the unit of the errors, e.g. "m"
+ *
+ * Output:
+ * -----------
+ * the report, on fp; only the histogram bins from the first to the
+ * last occupied are printed
+ *
+ ********1*********2*********3*********4*********5*********6*********7**
+ * Modification History:
+ * 2610.18, GD,  Creation
+ ********1*********2*********3*********4*********5*********6*********7*/
+{
+        double n= es->Count > 0 ? (double)es->Count : ONE;
+        long cum= 0;
+        int k;
+        int k0;
+        int k1;
+
+        fprintf( fp, "    n %ld  mean %.4e  rms %.4e  max %.4e [%s]"
+                 "  non-finite %ld\n", es->Count, es->SumErr/n,
+                 sqrt( es->SumErr2/n ), es->MaxAbs, unit, es->NonFinite );
+        if( es->Count == 0 )
+                return;
+
+        for( k0= 0; es->Hist[k0] == 0; k0++ )
+                ;
+        for( k1= ES_nbin - 1; es->Hist[k1] == 0; k1-- )
+                ;
+        fprintf( fp, "    |error| [%s]           count        %%     cum %%\n",
+                 unit );
+        for( k= k0; k <= k1; k++ ) {
+                cum+= es->Hist[k];
+                if( k == 0 )
+                        fprintf( fp, "    %9s < %8.1e", "",
+                                 pow( 10.0, ES_lgmin ) );
+                else if( k == ES_nbin - 1 )
+                        fprintf( fp, "    %8.1e <= %8s", pow( 10.0,
+                                 ES_lgmin + (double)(k - 1)/ES_bpd ), "" );
+                else
+                        fprintf( fp, "    %8.1e .. %8.1e",
+                                 pow( 10.0, ES_lgmin + (double)(k - 1)/ES_bpd ),
+                                 pow( 10.0, ES_lgmin + (double)k/ES_bpd ) );
+                fprintf( fp, " %12ld %8.3f %8.3f\n", es->Hist[k],
+                         100.0*es->Hist[k]/n, 100.0*cum/n );
+        }
+
+        fprintf( fp, "    largest errors:" );
+        for( k= 0; k < es->NWorst; k++ )
+                fprintf( fp, "%s %ld: %.4e", k % 3 == 0 ? "\n     " : "",
+                         es->WorstId[k], es->WorstErr[k] );
+        fprintf( fp, "\n" );
+}
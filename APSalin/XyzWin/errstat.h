@@ -0,0 +1,83 @@
+/*  @(#)errstat.h       1.0  26/10/18  */
+/********1*********2*********3*********4*********5*********6*********7*********
+ * name:            errstat.h
+ * version:         2610.18
+ * written by:      geoData
+ * purpose:         streaming error statistics data structure
+ *
+ * global variables and constants
+ * ------------------------------
+ * ES_bpd           histogram bins per decade of |error|
+ * ES_lgmin         log10 of the lower edge of the first decade
+ * ES_nbin          number of histogram bins: bin 0 holds |error| below
+ *                  10^ES_lgmin (and 0), bin ES_nbin-1 those at or above
+ *                  10^(ES_lgmin + (ES_nbin-2)/ES_bpd)
+ * ES_nworst        number of largest errors kept
+ *
+ * ESDS, the error statistics data structure contains
+ *    SumErr          Sum of errors
+ *    SumErr2         Sum of errors * errors
+ *    MaxAbs          Largest |error|
+ *    Count           Number of finite errors
+ *    NonFinite       Number of errors that are NaN or infinite
+ *    Hist[]          Number of errors in each bin of log10 |error|
+ *    NWorst          Number of entries in Worst..[]
+ *    WorstErr[]      Largest errors, by decreasing |error|
+ *    WorstId[]       Caller's point number of each WorstErr[]
+ * An ESDS is set empty by esinit.
+ *
+ * functions
+ * ------------------------------
+ * esadd:           adds one error
+ * esaddv:          adds an array of errors
+ * esinit:          empties an ESDS
+ * esmerge:         adds the errors of one ESDS to another
+ * esreport:        prints mean, rms, max, histogram and worst points
+ *
+ * comments:
+ * ------------------------------
+ * The running sums of LRDS (linfit.h) applied to residuals rather than
+ * to data pairs.  Every member is a sum, a maximum or a bounded list,
+ * so the ESDS of separate threads or runs merge exactly into that of
+ * the whole, and one ESDS summarizes any number of points in constant
+ * space.  The histogram spans 1e-16 to 1e8 in the caller's unit at 4
+ * bins a decade.
+ *
+ * see also:
+ * ------------------------------
+ * linfit.h
+ *
+ ********1*********2*********3*********4*********5*********6*********7*********
+ *:modification history
+ *:2610.18, GD, Creation
+ ********1*********2*********3*********4*********5*********6*********7*********/
+
+#ifndef errstat_h
+#define errstat_h
+
+#include <stdio.h>
+
+#define ES_bpd          ((int)4)
+#define ES_lgmin        ((int)-16)
+#define ES_nbin         ((int)98)
+#define ES_nworst       ((int)10)
+
+typedef struct error_statistics_data_structure {
+        double SumErr;
+        double SumErr2;
+        double MaxAbs;
+        long   Count;
+        long   NonFinite;
+        long   Hist[ES_nbin];
+        int    NWorst;
+        double WorstErr[ES_nworst];
+        long   WorstId[ES_nworst];
+} ESDS;
+
+void esadd( ESDS *, double, long );
+void esaddv( ESDS *, int, double *, long );
+void esinit( ESDS * );
+void esmerge( ESDS *, ESDS * );
+void esreport( FILE *, ESDS *, char * );
+
+#endif /* errstat_h */
@@ -0,0 +1,585 @@
+/*  @(#)fastnum.c       1.0  26/10/18  */
+static char *sccsid= "@(#)fastnum.c     1.0  26/10/18";
+/*
+ *  include files
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <stdint.h>
+#include "libgpsC.h"
+
+/*
+ *  function prototypes
+ */
+
+double numscan( char *, char ** );
+int numfix( char *, int, double, int, int );
+int numshort( char *, int, double );
+static double lemire( uint64_t, int );
+
+/*
+ *  global definitions and variables
+ *
+ *  d100[]     "00" .. "99", two digits at a time for numfix
+ *  p10[]      exact powers of ten for the fast path, 1e0 .. 1e22
+ *  p128[]     10^q, q= MIN_q .. MAX_q, as a 128 bit mantissa with the
+ *             top bit set (hi, lo); truncated for q >= 0, rounded up
+ *             for q < 0, as in Lemire's tables
+ */
+
+#define MIN_q           (-64)
+#define MAX_q           64
+#define MAX_prec        27
+
+typedef unsigned __int128 u128;
+
+static const char d100[201]=
+        "00010203040506070809101112131415161718192021222324"
+        "25262728293031323334353637383940414243444546474849"
+        "50515253545556575859606162636465666768697071727374"
+        "75767778798081828384858687888990919293949596979899";
+
+static const double p10[23]= {
+        1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,
+        1e8,  1e9,  1e10, 1e11, 1e12, 1e13, 1e14, 1e15,
+        1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+static const uint64_t p128[MAX_q - MIN_q + 1][2]= {
+        { 0xa87fea27a539e9a5ULL, 0x3f2398d747b36224ULL },  /* -64 */
+        { 0xd29fe4b18e88640eULL, 0x8eec7f0d19a03aadULL },  /* -63 */
+        { 0x83a3eeeef9153e89ULL, 0x1953cf68300424acULL },  /* -62 */
+        { 0xa48ceaaab75a8e2bULL, 0x5fa8c3423c052dd7ULL },  /* -61 */
+        { 0xcdb02555653131b6ULL, 0x3792f412cb06794dULL },  /* -60 */
+        { 0x808e17555f3ebf11ULL, 0xe2bbd88bbee40bd0ULL },  /* -59 */
+        { 0xa0b19d2ab70e6ed6ULL, 0x5b6aceaeae9d0ec4ULL },  /* -58 */
+        { 0xc8de047564d20a8bULL, 0xf245825a5a445275ULL },  /* -57 */
+        { 0xfb158592be068d2eULL, 0xeed6e2f0f0d56712ULL },  /* -56 */
+        { 0x9ced737bb6c4183dULL, 0x55464dd69685606bULL },  /* -55 */
+        { 0xc428d05aa4751e4cULL, 0xaa97e14c3c26b886ULL },  /* -54 */
+        { 0xf53304714d9265dfULL, 0xd53dd99f4b3066a8ULL },  /* -53 */
+        { 0x993fe2c6d07b7fabULL, 0xe546a8038efe4029ULL },  /* -52 */
+        { 0xbf8fdb78849a5f96ULL, 0xde98520472bdd033ULL },  /* -51 */
+        { 0xef73d256a5c0f77cULL, 0x963e66858f6d4440ULL },  /* -50 */
+        { 0x95a8637627989aadULL, 0xdde7001379a44aa8ULL },  /* -49 */
+        { 0xbb127c53b17ec159ULL, 0x5560c018580d5d52ULL },  /* -48 */
+        { 0xe9d71b689dde71afULL, 0xaab8f01e6e10b4a6ULL },  /* -47 */
+        { 0x9226712162ab070dULL, 0xcab3961304ca70e8ULL },  /* -46 */
+        { 0xb6b00d69bb55c8d1ULL, 0x3d607b97c5fd0d22ULL },  /* -45 */
+        { 0xe45c10c42a2b3b05ULL, 0x8cb89a7db77c506aULL },  /* -44 */
+        { 0x8eb98a7a9a5b04e3ULL, 0x77f3608e92adb242ULL },  /* -43 */
+        { 0xb267ed1940f1c61cULL, 0x55f038b237591ed3ULL },  /* -42 */
+        { 0xdf01e85f912e37a3ULL, 0x6b6c46dec52f6688ULL },  /* -41 */
+        { 0x8b61313bbabce2c6ULL, 0x2323ac4b3b3da015ULL },  /* -40 */
+        { 0xae397d8aa96c1b77ULL, 0xabec975e0a0d081aULL },  /* -39 */
+        { 0xd9c7dced53c72255ULL, 0x96e7bd358c904a21ULL },  /* -38 */
+        { 0x881cea14545c7575ULL, 0x7e50d64177da2e54ULL },  /* -37 */
+        { 0xaa242499697392d2ULL, 0xdde50bd1d5d0b9e9ULL },  /* -36 */
+        { 0xd4ad2dbfc3d07787ULL, 0x955e4ec64b44e864ULL },  /* -35 */
+        { 0x84ec3c97da624ab4ULL, 0xbd5af13bef0b113eULL },  /* -34 */
+        { 0xa6274bbdd0fadd61ULL, 0xecb1ad8aeacdd58eULL },  /* -33 */
+        { 0xcfb11ead453994baULL, 0x67de18eda5814af2ULL },  /* -32 */
+        { 0x81ceb32c4b43fcf4ULL, 0x80eacf948770ced7ULL },  /* -31 */
+        { 0xa2425ff75e14fc31ULL, 0xa1258379a94d028dULL },  /* -30 */
+        { 0xcad2f7f5359a3b3eULL, 0x096ee45813a04330ULL },  /* -29 */
+        { 0xfd87b5f28300ca0dULL, 0x8bca9d6e188853fcULL },  /* -28 */
+        { 0x9e74d1b791e07e48ULL, 0x775ea264cf55347eULL },  /* -27 */
+        { 0xc612062576589ddaULL, 0x95364afe032a819eULL },  /* -26 */
+        { 0xf79687aed3eec551ULL, 0x3a83ddbd83f52205ULL },  /* -25 */
+        { 0x9abe14cd44753b52ULL, 0xc4926a9672793543ULL },  /* -24 */
+        { 0xc16d9a0095928a27ULL, 0x75b7053c0f178294ULL },  /* -23 */
+        { 0xf1c90080baf72cb1ULL, 0x5324c68b12dd6339ULL },  /* -22 */
+        { 0x971da05074da7beeULL, 0xd3f6fc16ebca5e04ULL },  /* -21 */
+        { 0xbce5086492111aeaULL, 0x88f4bb1ca6bcf585ULL },  /* -20 */
+        { 0xec1e4a7db69561a5ULL, 0x2b31e9e3d06c32e6ULL },  /* -19 */
+        { 0x9392ee8e921d5d07ULL, 0x3aff322e62439fd0ULL },  /* -18 */
+        { 0xb877aa3236a4b449ULL, 0x09befeb9fad487c3ULL },  /* -17 */
+        { 0xe69594bec44de15bULL, 0x4c2ebe687989a9b4ULL },  /* -16 */
+        { 0x901d7cf73ab0acd9ULL, 0x0f9d37014bf60a11ULL },  /* -15 */
+        { 0xb424dc35095cd80fULL, 0x538484c19ef38c95ULL },  /* -14 */
+        { 0xe12e13424bb40e13ULL, 0x2865a5f206b06fbaULL },  /* -13 */
+        { 0x8cbccc096f5088cbULL, 0xf93f87b7442e45d4ULL },  /* -12 */
+        { 0xafebff0bcb24aafeULL, 0xf78f69a51539d749ULL },  /* -11 */
+        { 0xdbe6fecebdedd5beULL, 0xb573440e5a884d1cULL },  /* -10 */
+        { 0x89705f4136b4a597ULL, 0x31680a88f8953031ULL },  /* -9 */
+        { 0xabcc77118461cefcULL, 0xfdc20d2b36ba7c3eULL },  /* -8 */
+        { 0xd6bf94d5e57a42bcULL, 0x3d32907604691b4dULL },  /* -7 */
+        { 0x8637bd05af6c69b5ULL, 0xa63f9a49c2c1b110ULL },  /* -6 */
+        { 0xa7c5ac471b478423ULL, 0x0fcf80dc33721d54ULL },  /* -5 */
+        { 0xd1b71758e219652bULL, 0xd3c36113404ea4a9ULL },  /* -4 */
+        { 0x83126e978d4fdf3bULL, 0x645a1cac083126eaULL },  /* -3 */
+        { 0xa3d70a3d70a3d70aULL, 0x3d70a3d70a3d70a4ULL },  /* -2 */
+        { 0xccccccccccccccccULL, 0xcccccccccccccccdULL },  /* -1 */
+        { 0x8000000000000000ULL, 0x0000000000000000ULL },  /* 0 */
+        { 0xa000000000000000ULL, 0x0000000000000000ULL },  /* 1 */
+        { 0xc800000000000000ULL, 0x0000000000000000ULL },  /* 2 */
+        { 0xfa00000000000000ULL, 0x0000000000000000ULL },  /* 3 */
+        { 0x9c40000000000000ULL, 0x0000000000000000ULL },  /* 4 */
+        { 0xc350000000000000ULL, 0x0000000000000000ULL },  /* 5 */
+        { 0xf424000000000000ULL, 0x0000000000000000ULL },  /* 6 */
+        { 0x9896800000000000ULL, 0x0000000000000000ULL },  /* 7 */
+        { 0xbebc200000000000ULL, 0x0000000000000000ULL },  /* 8 */
+        { 0xee6b280000000000ULL, 0x0000000000000000ULL },  /* 9 */
+        { 0x9502f90000000000ULL, 0x0000000000000000ULL },  /* 10 */
+        { 0xba43b74000000000ULL, 0x0000000000000000ULL },  /* 11 */
+        { 0xe8d4a51000000000ULL, 0x0000000000000000ULL },  /* 12 */
+        { 0x9184e72a00000000ULL, 0x0000000000000000ULL },  /* 13 */
+        { 0xb5e620f480000000ULL, 0x0000000000000000ULL },  /* 14 */
+        { 0xe35fa931a0000000ULL, 0x0000000000000000ULL },  /* 15 */
+        { 0x8e1bc9bf04000000ULL, 0x0000000000000000ULL },  /* 16 */
+        { 0xb1a2bc2ec5000000ULL, 0x0000000000000000ULL },  /* 17 */
+        { 0xde0b6b3a76400000ULL, 0x0000000000000000ULL },  /* 18 */
+        { 0x8ac7230489e80000ULL, 0x0000000000000000ULL },  /* 19 */
+        { 0xad78ebc5ac620000ULL, 0x0000000000000000ULL },  /* 20 */
+        { 0xd8d726b7177a8000ULL, 0x0000000000000000ULL },  /* 21 */
+        { 0x878678326eac9000ULL, 0x0000000000000000ULL },  /* 22 */
+        { 0xa968163f0a57b400ULL, 0x0000000000000000ULL },  /* 23 */
+        { 0xd3c21bcecceda100ULL, 0x0000000000000000ULL },  /* 24 */
+        { 0x84595161401484a0ULL, 0x0000000000000000ULL },  /* 25 */
+        { 0xa56fa5b99019a5c8ULL, 0x0000000000000000ULL },  /* 26 */
+        { 0xcecb8f27f4200f3aULL, 0x0000000000000000ULL },  /* 27 */
+        { 0x813f3978f8940984ULL, 0x4000000000000000ULL },  /* 28 */
+        { 0xa18f07d736b90be5ULL, 0x5000000000000000ULL },  /* 29 */
+        { 0xc9f2c9cd04674edeULL, 0xa400000000000000ULL },  /* 30 */
+        { 0xfc6f7c4045812296ULL, 0x4d00000000000000ULL },  /* 31 */
+        { 0x9dc5ada82b70b59dULL, 0xf020000000000000ULL },  /* 32 */
+        { 0xc5371912364ce305ULL, 0x6c28000000000000ULL },  /* 33 */
+        { 0xf684df56c3e01bc6ULL, 0xc732000000000000ULL },  /* 34 */
+        { 0x9a130b963a6c115cULL, 0x3c7f400000000000ULL },  /* 35 */
+        { 0xc097ce7bc90715b3ULL, 0x4b9f100000000000ULL },  /* 36 */
+        { 0xf0bdc21abb48db20ULL, 0x1e86d40000000000ULL },  /* 37 */
+        { 0x96769950b50d88f4ULL, 0x1314448000000000ULL },  /* 38 */
+        { 0xbc143fa4e250eb31ULL, 0x17d955a000000000ULL },  /* 39 */
+        { 0xeb194f8e1ae525fdULL, 0x5dcfab0800000000ULL },  /* 40 */
+        { 0x92efd1b8d0cf37beULL, 0x5aa1cae500000000ULL },  /* 41 */
+        { 0xb7abc627050305adULL, 0xf14a3d9e40000000ULL },  /* 42 */
+        { 0xe596b7b0c643c719ULL, 0x6d9ccd05d0000000ULL },  /* 43 */
+        { 0x8f7e32ce7bea5c6fULL, 0xe4820023a2000000ULL },  /* 44 */
+        { 0xb35dbf821ae4f38bULL, 0xdda2802c8a800000ULL },  /* 45 */
+        { 0xe0352f62a19e306eULL, 0xd50b2037ad200000ULL },  /* 46 */
+        { 0x8c213d9da502de45ULL, 0x4526f422cc340000ULL },  /* 47 */
+        { 0xaf298d050e4395d6ULL, 0x9670b12b7f410000ULL },  /* 48 */
+        { 0xdaf3f04651d47b4cULL, 0x3c0cdd765f114000ULL },  /* 49 */
+        { 0x88d8762bf324cd0fULL, 0xa5880a69fb6ac800ULL },  /* 50 */
+        { 0xab0e93b6efee0053ULL, 0x8eea0d047a457a00ULL },  /* 51 */
+        { 0xd5d238a4abe98068ULL, 0x72a4904598d6d880ULL },  /* 52 */
+        { 0x85a36366eb71f041ULL, 0x47a6da2b7f864750ULL },  /* 53 */
+        { 0xa70c3c40a64e6c51ULL, 0x999090b65f67d924ULL },  /* 54 */
+        { 0xd0cf4b50cfe20765ULL, 0xfff4b4e3f741cf6dULL },  /* 55 */
+        { 0x82818f1281ed449fULL, 0xbff8f10e7a8921a4ULL },  /* 56 */
+        { 0xa321f2d7226895c7ULL, 0xaff72d52192b6a0dULL },  /* 57 */
+        { 0xcbea6f8ceb02bb39ULL, 0x9bf4f8a69f764490ULL },  /* 58 */
+        { 0xfee50b7025c36a08ULL, 0x02f236d04753d5b4ULL },  /* 59 */
+        { 0x9f4f2726179a2245ULL, 0x01d762422c946590ULL },  /* 60 */
+        { 0xc722f0ef9d80aad6ULL, 0x424d3ad2b7b97ef5ULL },  /* 61 */
+        { 0xf8ebad2b84e0d58bULL, 0xd2e0898765a7deb2ULL },  /* 62 */
+        { 0x9b934c3b330c8577ULL, 0x63cc55f49f88eb2fULL },  /* 63 */
+        { 0xc2781f49ffcfa6d5ULL, 0x3cbf6b71c76b25fbULL }   /* 64 */
+};
+
+
+double numscan( char *s, char **end )
+/********1*********2*********3*********4*********5*********6*********7*********
+ * name:            numscan
+ * version:         2610.18
+ * written by:      geoData
+ * purpose:         converts a decimal number to double, correctly rounded
+ *
+ * input parameters
+ * ----------------
+ * s                text starting with [+-]digits[.digits][(e|E)[+-]digits]
+ *
+ * output parameters
+ * -----------------
+ * end              first character after the number; s if there is none
+ *
+ * returns the value; 0 if there is no number
+ *
+ * calls:
+ * ------------------------------
+ * lemire           19 digit decimal mantissa and exponent to double
+ * strtod           only for numbers the fast paths cannot settle
+ *
+ * comments:
+ * ------------------------------
+ * A drop-in replacement for strtod() on the files read here, in the
+ * spirit of C++ from_chars: no allocation, no locale (the decimal point
+ * is always '.'), no leading white space, no hex, inf or nan.
+ *
+ * Up to 19 significant digits are kept in a 64 bit integer w and the
+ * value is w * 10^q.  If w < 2^53 and |q| <= 22 one exact multiply or
+ * divide gives the correctly rounded result (Clinger).  Otherwise the
+ * Eisel-Lemire method takes the product of w with a 128 bit 10^q.  When
+ * digits beyond the 19th were dropped, w and w+1 must round to the same
+ * double, else - as for q outside MIN_q..MAX_q, subnormals and
+ * overflow - the number goes to strtod().  The 18 decimal files of
+ * geo_4277_Points and Output never need it.
+ *
+ * references:
+ * ------------------------------
+ * Clinger, W. D. (1990). "How to read floating point numbers
+ * accurately", PLDI '90, 92-101.
+ *
+ * Lemire, D. (2021). "Number parsing at a gigabyte per second",
+ * Software: Practice and Experience 51(8), 1700-1727.
+ *
+ ********1*********2*********3*********4*********5*********6*********7*********
+ *:modification history
+ *:2610.18, GD, Creation
+ ********1*********2*********3*********4*********5*********6*********7*********/
+
+{
+        char *p= s;
+        double v;
+        double v1;
+        int any= 0;
+        int drop= 0;
+        int ex;
+        int eneg;
+        int nd= 0;
+        int neg= 0;
+        int q= 0;
+        uint64_t w= 0;
+
+        if( *p == '+' || *p == '-' )
+                neg= *p++ == '-';
+/*
+ *   integer part, then fraction; leading zeros are not significant
+ */
+        while( *p == '0' ) {
+                p++;
+                any= 1;
+        }
+        for( ; *p >= '0' && *p <= '9'; p++, any= 1 )
+                if( nd < 19 ) {
+                        w= 10*w + (*p - '0');
+                        nd++;
+                } else {
+                        q++;
+                        drop|= *p != '0';
+                }
+        if( *p == '.' ) {
+                p++;
+                if( nd == 0 )
+                        for( ; *p == '0'; p++, any= 1 )
+                                q--;
+                for( ; *p >= '0' && *p <= '9'; p++, any= 1 )
+                        if( nd < 19 ) {
+                                w= 10*w + (*p - '0');
+                                nd++;
+                                q--;
+                        } else
+                                drop|= *p != '0';
+        }
+        if( any == 0 ) {
+                if( end != NULL )
+                        *end= s;
+                return( 0.0 );
+        }
+/*
+ *   exponent; an 'e' not followed by digits is not part of the number
+ */
+        if( *p == 'e' || *p == 'E' ) {
+                char *e= p + 1;
+
+                eneg= 0;
+                if( *e == '+' || *e == '-' )
+                        eneg= *e++ == '-';
+                if( *e >= '0' && *e <= '9' ) {
+                        for( ex= 0; *e >= '0' && *e <= '9'; e++ )
+                                if( ex < 100000 )
+                                        ex= 10*ex + (*e - '0');
+                        q+= eneg ? -ex : ex;
+                        p= e;
+                }
+        }
+        if( end != NULL )
+                *end= p;
+
+        if( w == 0 )
+                return( neg ? -0.0 : 0.0 );
+/*
+ *   exact fast path, else Eisel-Lemire, else strtod
+ */
+        if( drop == 0 && w <= ((uint64_t)1 << 53) && q >= -22 && q <= 22 )
+                v= q < 0 ? (double)w / p10[-q] : (double)w * p10[q];
+        else {
+                v= lemire( w, q );
+                if( drop != 0 && v >= 0.0 ) {
+                        v1= lemire( w + 1, q );
+                        if( v1 != v )
+                                v= -1.0;
+                }
+                if( v < 0.0 )
+                        return( strtod( s, NULL ) );
+        }
+
+        return( neg ? -v : v );
+}
+
+
+static double lemire( uint64_t w, int q )
+/********1*********2*********3*********4*********5*********6*********7*********
+ * purpose:         w * 10^q rounded to nearest even, for w != 0; returns
+ *                  -1 if q is out of the table or the result is subnormal
+ *                  or infinite
+ ********1*********2*********3*********4*********5*********6*********7*********/
+{
+        const uint64_t *t;
+        double v;
+        int lz;
+        int p2;
+        int up;
+        u128 pr;
+        u128 pr2;
+        uint64_t bits;
+        uint64_t hi;
+        uint64_t lo;
+        uint64_t m;
+
+        if( q < MIN_q || q > MAX_q )
+                return( -1.0 );
+        t= p128[q - MIN_q];
+
+        lz= __builtin_clzll( w );
+        w<<= lz;
+/*
+ *   w * 10^q to 55 significant bits; the low word of 10^q only matters
+ *   when the bits below them are all ones
+ */
+        pr= (u128)w * t[0];
+        hi= (uint64_t)(pr >> 64);
+        lo= (uint64_t)pr;
+        if( (hi & 0x1FF) == 0x1FF ) {
+                pr2= (u128)w * t[1];
+                lo+= (uint64_t)(pr2 >> 64);
+                if( (uint64_t)(pr2 >> 64) > lo )
+                        hi++;
+        }
+
+        up= (int)(hi >> 63);
+        m= hi >> (up + 9);
+        p2= (int)((((152170 + 65536) * q) >> 16) + 63) + up - lz + 1023;
+        if( p2 <= 0 )
+                return( -1.0 );
+/*
+ *   round half to even: an exact tie can only occur for -4 <= q <= 23
+ */
+        if( lo <= 1 && q >= -4 && q <= 23 && (m & 3) == 1
+            && (m << (up + 9)) == hi )
+                m&= ~(uint64_t)1;
+        m+= m & 1;
+        m>>= 1;
+        if( m >= ((uint64_t)2 << 52) ) {
+                m= (uint64_t)1 << 52;
+                p2++;
+        }
+        if( p2 >= 2047 )
+                return( -1.0 );
+
+        bits= (m & ~((uint64_t)1 << 52)) | ((uint64_t)p2 << 52);
+        memcpy( &v, &bits, sizeof(v) );
+
+        return( v );
+}
+
+
+int numfix( char *buf, int size, double v, int width, int prec )
+/********1*********2*********3*********4*********5*********6*********7*********
+ * name:            numfix
+ * version:         2610.18
+ * written by:      geoData
+ * purpose:         formats a double in fixed point, exactly as
+ *                  snprintf( buf, size, "%*.*f", width, prec, v )
+ *
+ * input parameters
+ * ----------------
+ * size             size of buf [char]
+ * v                value
+ * width            minimum field width, right justified with blanks
+ * prec             digits after the decimal point
+ *
+ * output parameters
+ * -----------------
+ * buf              the text, '\0' terminated
+ *
+ * returns the length of the text, not counting the '\0'
+ *
+ * comments:
+ * ------------------------------
+ * The double is m * 2^e exactly, so v * 10^prec = m * 5^prec * 2^(e+prec)
+ * is an integer shift of m * 5^prec, which fits in 128 bits for prec <=
+ * MAX_prec.  The shift rounds half to even on the exact remainder, as
+ * glibc's printf does, so the digits are those of printf.  Values
+ * needing more than 128 bits (|v| above about 1e38 / 10^prec), NaN,
+ * infinity and text that would not fit in buf go to snprintf().
+ *
+ ********1*********2*********3*********4*********5*********6*********7*********
+ *:modification history
+ *:2610.18, GD, Creation
+ ********1*********2*********3*********4*********5*********6*********7*********/
+
+{
+        static const uint64_t p5[MAX_prec+1]= {
+                1ULL, 5ULL, 25ULL, 125ULL, 625ULL, 3125ULL, 15625ULL,
+                78125ULL, 390625ULL, 1953125ULL, 9765625ULL, 48828125ULL,
+                244140625ULL, 1220703125ULL, 6103515625ULL,
+                30517578125ULL, 152587890625ULL, 762939453125ULL,
+                3814697265625ULL, 19073486328125ULL, 95367431640625ULL,
+                476837158203125ULL, 2384185791015625ULL,
+                11920928955078125ULL, 59604644775390625ULL,
+                298023223876953125ULL, 1490116119384765625ULL,
+                7450580596923828125ULL
+        };
+        char dig[48];
+        char *p;
+        int e;
+        int k;
+        int len;
+        int nd= 0;
+        int neg;
+        int sh;
+        uint64_t bits;
+        uint64_t m;
+        uint64_t q64;
+        u128 half;
+        u128 mn;
+        u128 q;
+
+        if( !isfinite( v ) || prec < 0 || prec > MAX_prec )
+                return( snprintf( buf, size, "%*.*f", width, prec, v ) );
+
+        memcpy( &bits, &v, sizeof(bits) );
+        neg= (int)(bits >> 63);
+        e= (int)((bits >> 52) & 0x7FF);
+        m= bits & (((uint64_t)1 << 52) - 1);
+        if( e == 0 )
+                e= -1074;
+        else {
+                m|= (uint64_t)1 << 52;
+                e-= 1075;
+        }
+/*
+ *   q= round( m * 5^prec * 2^(e+prec) )
+ */
+        mn= (u128)m * p5[prec];
+        sh= e + prec;
+        if( sh >= 0 ) {
+                if( sh > 127 || (mn >> (127 - sh)) != 0 )
+                        return( snprintf( buf, size, "%*.*f", width, prec,
+                                          v ) );
+                q= mn << sh;
+        } else if( -sh >= 128 )
+                q= 0;
+        else {
+                sh= -sh;
+                q= mn >> sh;
+                half= (u128)1 << (sh - 1);
+                mn-= q << sh;
+                if( mn > half || (mn == half && (q & 1) != 0) )
+                        q++;
+        }
+/*
+ *   digits, least significant first; at least one before the point
+ */
+        while( (q >> 64) != 0 ) {
+                dig[nd++]= '0' + (int)(q % 10);
+                q/= 10;
+        }
+        for( q64= (uint64_t)q; q64 >= 100 || nd + 2 <= prec; q64/= 100 ) {
+                k= 2*(int)(q64 % 100);
+                dig[nd++]= d100[k+1];
+                dig[nd++]= d100[k];
+        }
+        for( ; q64 != 0 || nd <= prec; q64/= 10 )
+                dig[nd++]= '0' + (int)(q64 % 10);
+
+        len= neg + nd + (prec > 0);
+        if( (width > len ? width : len) >= size )
+                return( snprintf( buf, size, "%*.*f", width, prec, v ) );
+
+        p= buf;
+        for( ; width > len; width-- )
+                *p++= ' ';
+        if( neg )
+                *p++= '-';
+        while( nd > prec )
+                *p++= dig[--nd];
+        if( prec > 0 ) {
+                *p++= '.';
+                while( nd > 0 )
+                        *p++= dig[--nd];
+        }
+        *p= '\0';
+
+        return( (int)(p - buf) );
+}
+
+
+int numshort( char *buf, int size, double v )
+/********1*********2*********3*********4*********5*********6*********7*********
+ * name:            numshort
+ * version:         2610.18
+ * written by:      geoData
+ * purpose:         formats a double with the fewest decimals that read
+ *                  back to the same double
+ *
+ * input parameters
+ * ----------------
+ * size             size of buf [char]
+ * v                value
+ *
+ * output parameters
+ * -----------------
+ * buf              the text, '\0' terminated
+ *
+ * returns the length of the text, not counting the '\0'
+ *
+ * calls:
+ * ------------------------------
+ * numfix           fixed point formatting
+ * numscan          decimal to double
+ *
+ * comments:
+ * ------------------------------
+ * Fixed point, never an exponent, for 1e-5 <= |v| < 1e17: report files
+ * keep their columns readable and numscan(numshort(v)) == v always.
+ * Other values, NaN and infinity are written with "%.17g", which also
+ * reads back exactly.
+ *
+ ********1*********2*********3*********4*********5*********6*********7*********
+ *:modification history
+ *:2610.18, GD, Creation
+ ********1*********2*********3*********4*********5*********6*********7*********/
+
+{
+        char tmp[64];
+        double a= fabs( v );
+        int k;
+        int len= 0;
+        int prec;
+
+        if( v == 0.0 )
+                return( numfix( buf, size, v, 0, 0 ) );
+        if( !( a >= 1e-5 && a < 1e17 ) )
+                return( snprintf( buf, size, "%.17g", v ) );
+/*
+ *   k ~ decimal exponent of the leading digit; 17 significant digits
+ *   always suffice
+ */
+        k= (int)floor( log10( a ) );
+        for( prec= k < 0 ? -k - 1 : 0; prec <= 17 - k && prec <= MAX_prec;
+             prec++ ) {
+                len= numfix( tmp, sizeof(tmp), v, 0, prec );
+                if( numscan( tmp, NULL ) == v )
+                        break;
+        }
+        if( len >= size )
+                return( snprintf( buf, size, "%.17g", v ) );
+        memcpy( buf, tmp, len + 1 );
+
+        return( len );
+}
@@ -0,0 +1,253 @@
+/*  @(#)fltmath.h       1.0  26/10/18  */
+/********1*********2*********3*********4*********5*********6*********7*********
+ * name:            fltmath.h
+ * version:         2610.18
+ * written by:      geoData
+ * purpose:         single precision elementary functions, scalar and
+ *                  AVX2 (8 x float), and the origin constants of the
+ *                  float conversions of xyz2plhf.c
+ *
+ * global variables and constants
+ * ------------------------------
+ * FLT_dmax         largest offset from the origin the float conversions
+ *                  are for [m]
+ * FLT_erel         their error bound, as a fraction of the offset
+ *
+ * flt_org, an origin (tile centre) of the float conversions, made by
+ * fltorg in double and rounded once:
+ *    sl0, cl0      sine, cosine of its longitude
+ *    sp0, cp0      sine, cosine of its latitude
+ *    w0            sqrt(1 - e2*sp0^2)
+ *    n0            N, the prime vertical radius [m]
+ *    nh0           N + h [m]
+ *    ne0           N*(1 - e2) + h [m]
+ *    mh0           M + h, M the meridian radius [m]
+ *    p0            (N + h)*cp0, its distance from the Z axis [m]
+ *    h0            h [m]
+ *    ae2           A*e2 [m]
+ *    e2, ome2      e2 and 1 - e2
+ *
+ * functions
+ * ------------------------------
+ * fatan2:          arc tangent of y/x in (-pi, pi] [rad]
+ * fltorg:          the flt_org of an origin, in xyz2plhf.c
+ * fsincos:         sine and cosine of an angle [rad]
+ * vfatan2:         fatan2 on 8 lanes, AVX2 only
+ * vfblend:         m ? a : b, lane by lane
+ * vfconst:         broadcast a float
+ * vfsincos:        fsincos on 8 lanes, AVX2 only
+ *
+ * comments:
+ * ------------------------------
+ * The single precision Cephes functions, as vmath.h has the double
+ * ones: fsincos reduces by pi/2 in three parts and uses the sinf/cosf
+ * polynomials on [-pi/4, pi/4]; fatan2 the atanf reduction and
+ * polynomial.  Both are good to about 2 ulp for the arguments met in
+ * xyz2plhf.c (angles of at most a few rad).
+ *
+ * As vmath.h, everything but fltorg is static inline.  The vf
+ * functions are only for units compiled with -mavx2 -mfma.
+ *
+ * references:
+ * ------------------------------
+ * Moshier, S. L. (1989). "Methods and Programs for Mathematical
+ * Functions", Ellis Horwood (Cephes library, sinf.c, atanf.c).
+ *
+ ********1*********2*********3*********4*********5*********6*********7*********
+ *:modification history
+ *:2610.18, GD, Creation
+ ********1*********2*********3*********4*********5*********6*********7*********/
+
+#ifndef fltmath_h
+#define fltmath_h
+
+#include <math.h>
+
+#define FLT_dmax        ((double)1.0e6)
+#define FLT_erel        ((double)6.0e-7)
+#define FLT_pio2_1      ((float)1.5703125)
+#define FLT_pio2_2      ((float)4.837512969970703125e-4)
+#define FLT_pio2_3      ((float)7.54978995489188216e-8)
+#define FLT_pio2        ((float)1.5707963267948966)
+#define FLT_pio4        ((float)0.78539816339744831)
+#define FLT_pi          ((float)3.1415926535897932)
+
+struct ellipsoid;
+
+struct flt_org {
+        float  sl0;
+        float  cl0;
+        float  sp0;
+        float  cp0;
+        float  w0;
+        float  n0;
+        float  nh0;
+        float  ne0;
+        float  mh0;
+        float  p0;
+        float  h0;
+        float  ae2;
+        float  e2;
+        float  ome2;
+};
+
+void fltorg( double *, struct flt_org *, struct ellipsoid * );
+
+static inline void fsincos( float x, float *s, float *c )
+{
+        float r;
+        float sr;
+        float cr;
+        float z;
+        float k= nearbyintf( x * (float)0.63661977236758134 );
+        int q= (int)k;
+
+        r= ((x - k*FLT_pio2_1) - k*FLT_pio2_2) - k*FLT_pio2_3;
+        z= r*r;
+        sr= ((-1.9515295891e-4f*z + 8.3321608736e-3f)*z - 1.6666654611e-1f)
+            *z*r + r;
+        cr= ((2.443315711809948e-5f*z - 1.388731625493765e-3f)*z
+             + 4.166664568298827e-2f)*z*z - 0.5f*z + 1.0f;
+
+        switch( q & 3 ) {
+        case 0:
+                *s= sr;
+                *c= cr;
+                break;
+        case 1:
+                *s= cr;
+                *c= -sr;
+                break;
+        case 2:
+                *s= -sr;
+                *c= -cr;
+                break;
+        default:
+                *s= -cr;
+                *c= sr;
+                break;
+        }
+}
+
+static inline float fatan2( float y, float x )
+{
+        float ax= fabsf( x );
+        float ay= fabsf( y );
+        float a;
+        float t;
+        float z;
+
+        t= ax > ay ? ax : ay;
+        t= t > 0.0f ? ( ax > ay ? ay : ax ) / t : 0.0f;
+/*
+ *   atanf of t in [0, 1]: reduce to |t| <= tan(pi/8)
+ */
+        a= 0.0f;
+        if( t > 0.4142135623730950f ) {
+                a= FLT_pio4;
+                t= (t - 1.0f) / (t + 1.0f);
+        }
+        z= t*t;
+        a+= (((8.05374449538e-2f*z - 1.38776856032e-1f)*z
+              + 1.99777106478e-1f)*z - 3.33329491539e-1f)*z*t + t;
+
+        if( ay > ax )
+                a= FLT_pio2 - a;
+        if( x < 0.0f )
+                a= FLT_pi - a;
+
+        return( copysignf( a, y ) );
+}
+
+#ifdef __AVX2__
+
+#include <immintrin.h>
+
+#define vfconst( c )    _mm256_set1_ps( (float)(c) )
+
+static inline __m256 vfblend( __m256 m, __m256 a, __m256 b )
+{
+        return( _mm256_blendv_ps( b, a, m ) );
+}
+
+static inline void vfsincos( __m256 x, __m256 *s, __m256 *c )
+{
+        __m256 k;
+        __m256 r;
+        __m256 sr;
+        __m256 cr;
+        __m256 sw;
+        __m256 z;
+        __m256i q;
+
+        k= _mm256_round_ps( _mm256_mul_ps( x, vfconst( 0.63661977236758134 ) ),
+                            _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC );
+        r= _mm256_fnmadd_ps( k, vfconst( FLT_pio2_1 ), x );
+        r= _mm256_fnmadd_ps( k, vfconst( FLT_pio2_2 ), r );
+        r= _mm256_fnmadd_ps( k, vfconst( FLT_pio2_3 ), r );
+        z= _mm256_mul_ps( r, r );
+        sr= _mm256_fmadd_ps( vfconst( -1.9515295891e-4 ), z,
+                             vfconst( 8.3321608736e-3 ) );
+        sr= _mm256_fmadd_ps( sr, z, vfconst( -1.6666654611e-1 ) );
+        sr= _mm256_fmadd_ps( _mm256_mul_ps( sr, z ), r, r );
+        cr= _mm256_fmadd_ps( vfconst( 2.443315711809948e-5 ), z,
+                             vfconst( -1.388731625493765e-3 ) );
+        cr= _mm256_fmadd_ps( cr, z, vfconst( 4.166664568298827e-2 ) );
+        cr= _mm256_fmadd_ps( _mm256_mul_ps( cr, z ), z,
+                             _mm256_fnmadd_ps( vfconst( 0.5 ), z,
+                                               vfconst( 1.0 ) ) );
+/*
+ *   quadrant q: odd q takes cos r, sin r; then bit 1 of q negates the
+ *   sine, bit 1 of q + 1 the cosine
+ */
+        q= _mm256_cvtps_epi32( k );
+        sw= _mm256_castsi256_ps( _mm256_cmpeq_epi32(
+                _mm256_and_si256( q, _mm256_set1_epi32( 1 ) ),
+                _mm256_set1_epi32( 1 ) ) );
+        *s= vfblend( sw, cr, sr );
+        *c= vfblend( sw, sr, cr );
+        *s= _mm256_xor_ps( *s, _mm256_castsi256_ps( _mm256_slli_epi32(
+                _mm256_and_si256( q, _mm256_set1_epi32( 2 ) ), 30 ) ) );
+        *c= _mm256_xor_ps( *c, _mm256_castsi256_ps( _mm256_slli_epi32(
+                _mm256_and_si256( _mm256_add_epi32( q, _mm256_set1_epi32( 1 ) ),
+                                  _mm256_set1_epi32( 2 ) ), 30 ) ) );
+}
+
+static inline __m256 vfatan2( __m256 y, __m256 x )
+{
+        __m256 ax= _mm256_andnot_ps( vfconst( -0.0 ), x );
+        __m256 ay= _mm256_andnot_ps( vfconst( -0.0 ), y );
+        __m256 hi= _mm256_max_ps( ax, ay );
+        __m256 lo= _mm256_min_ps( ax, ay );
+        __m256 a;
+        __m256 mid;
+        __m256 p;
+        __m256 t;
+        __m256 z;
+
+        t= _mm256_div_ps( lo, vfblend( _mm256_cmp_ps( hi, vfconst( 0.0 ),
+                                                      _CMP_EQ_OQ ),
+                                       vfconst( 1.0 ), hi ) );
+        mid= _mm256_cmp_ps( t, vfconst( 0.4142135623730950 ), _CMP_GT_OQ );
+        a= _mm256_and_ps( mid, vfconst( FLT_pio4 ) );
+        t= vfblend( mid, _mm256_div_ps( _mm256_sub_ps( t, vfconst( 1.0 ) ),
+                                        _mm256_add_ps( t, vfconst( 1.0 ) ) ),
+                    t );
+        z= _mm256_mul_ps( t, t );
+        p= _mm256_fmadd_ps( vfconst( 8.05374449538e-2 ), z,
+                            vfconst( -1.38776856032e-1 ) );
+        p= _mm256_fmadd_ps( p, z, vfconst( 1.99777106478e-1 ) );
+        p= _mm256_fmadd_ps( p, z, vfconst( -3.33329491539e-1 ) );
+        a= _mm256_add_ps( a, _mm256_fmadd_ps( _mm256_mul_ps( p, z ), t, t ) );
+
+        a= vfblend( _mm256_cmp_ps( ay, ax, _CMP_GT_OQ ),
+                    _mm256_sub_ps( vfconst( FLT_pio2 ), a ), a );
+        a= vfblend( _mm256_cmp_ps( x, vfconst( 0.0 ), _CMP_LT_OQ ),
+                    _mm256_sub_ps( vfconst( FLT_pi ), a ), a );
+
+        return( _mm256_or_ps( a, _mm256_and_ps( y, vfconst( -0.0 ) ) ) );
+}
+
+#endif /* __AVX2__ */
+
+#endif /* fltmath_h */
@@ -21,12 +21,33 @@
  * astrol:           computes the basic astronomical mean longitudes
  * blank:            returns location of first non-"white space" character
  * check_olt:        Search for Darwinian tidal ID in string
+ * colell:           ellipsoid of the geodetic columns of a column file
+ * colgetblk:        reads the next block of a column file
+ * colgethead:       reads and checks the header of a column file
+ * colinit:          fills in the header of a new column file
+ * colpack:          codes rows of columns as one column file block
+ * colputhead:       writes the header of a column file
+ * colunpack:        decodes a column file block
+ * cvtchunk:         converts and formats one chunk of records
+ * cvtfile:          converts every record of a stream, multi-threaded
  * dayhms:           converts decimal days to hours, minutes, and seconds
  * degdms:           convert decimal degrees to degrees, minutes, seconds
+ * degdmsv:          degdms on arrays, seconds rounded (batch)
+ * dmsfmt:           formats decimal degrees as deg, min, sec text
  * moments:          Calculates a mean, second moment, and variance
+ * esadd:            adds one error to an error statistics data structure
+ * esaddv:           esadd on an array of errors (batch)
+ * esinit:           empties an error statistics data structure
+ * esmerge:          adds one error statistics data structure to another
+ * esreport:         prints count, mean, rms, max, histogram, worst errors
+ * ellfind:          looks up a named ellipsoid in the registry
+ * elllist:          prints the registry of ellipsoids
+ * ellparse:         a registry name or "A,FL" from a command line
+ * ellset:           fills in an ellipsoid and its derived constants
  * dow:              converts the modified Julian date to the day of week
  * flip_double:      reverse byte order in a double variable
  * flip_long:        reverse byte order in a long variable
+ * getchunk:         reads the next chunk of records from a stream
  * gpswk:            converts modified Julian date to the GPS week
  * grid_olt:         returns location in grid storage vector
  * hmsday:           converts hours, minutes, and seconds to decimal days
@@ -43,17 +64,62 @@
  * initialize_OLT:   initialize ocean loading type data structures
  * intrp_olt:        interpolates a value from a grid of data.
  * linfit:           performs linear fit using gamma Q minimization.
+ * lrwadd:           adds a data pair to a sliding window linear fit
+ * lrwaddv:          lrwadd on an array of windows (batch)
+ * lrwdel:           removes a data pair from a sliding window linear fit
+ * lrwdelv:          lrwdel on an array of windows (batch)
+ * lrwfit:           fits the data pairs of a sliding window
+ * lrwfitv:          lrwfit on an array of windows (batch)
+ * lrwinit:          empties a sliding window linear fit
  * load_olt:         loads array with data from files of harmonic constants.
  * lpsec:            Sets UTC-TAI and GPS-UTC for the input MJD.
+ * mapchunk:         the next chunk of records of a mapped file
+ * mapclose:         unmaps a file mapped by mapopen
+ * mapopen:          maps the rest of an input stream into memory
  * mjdyd:            Converts modified Julian date to year and day-of-year.
  * mjdymd:           converts modified Julian day to Gregorian calendar date
  * month_name:       converts month number to ASCII name
  * neu2xyz:          Convert local north, east, up vector to X, Y, Z
+ * neu2xyzv:         neu2xyz on arrays, by the frame of a station (batch)
+ * neufree:          frees a cache of station frames
+ * neuget:           the north, east, up frame of a station, cached
+ * neuinit:          makes an empty cache of station frames
+ * neuset:           fills in the north, east, up frame of a station
+ * nlscan:           finds the end of the n-th line of a buffer
  * nod:              This subroutine evaluates the nutation series and
  * nonwhitespace:    returns pointer to first non-"white space" character
+ * numfix:           fixed point formatting of a double, as "%*.*f"
+ * numscan:          decimal text to double, locale independent
+ * numshort:         shortest fixed point text that reads back exactly
+ * oltclose:         frees an ocean-loading grid store
+ * oltinit:          makes an empty ocean-loading grid store
+ * oltintrpv:        interpolates every tide of a grid store at many
+ *                   stations (batch)
+ * oltopen:          maps an ocean-loading grid store file into memory
+ * oltset:           fills one tide of a grid store from amp, phs grids
+ * oltwrite:         writes an ocean-loading grid store file
  * plh2xyz:          converts elliptic lat, lon, hgt to geocentric X, Y, Z
+ * plh2xyz_grs80:    plh2xyz with GRS80 compiled in (also _wgs84)
+ * plh2xyzdd:        plh2xyze to double-double precision (reference)
+ * plh2xyzddv:       plh2xyzdd on arrays (batch)
+ * plh2xyze:         plh2xyz on a registry ellipsoid
+ * plh2xyzf:         plh2xyze in float, as offsets from an origin
+ * plh2xyzfv:        plh2xyzf on arrays (batch)
+ * plh2xyzov:        plh2xyzv for the outputs in a mask, and r
+ * plh2xyzs:         plh2xyzv by a kernel compiled for the ellipsoid
+ * plh2xyzv:         converts arrays of lat, lon, hgt to X, Y, Z (batch)
+ * plhmfree:         frees a memo made by plhminit
+ * plhminit:         makes an empty memo of X, Y, Z -> lat, lon, hgt
+ * plhmstat:         counts of a memo's lookups
+ * putchunk:         writes the formatted output of one chunk
  * read_olt:         Reads an ASCII file of gridded values
  * ReceiverSearch:   Search directory for latest, by modification date, file
+ * siclose:          unmaps a station information file mapped by siopen
+ * sifind:           the record of a station in force at an epoch
+ * sigetA:           decodes an antenna record of a mapped file
+ * sigetC:           decodes a coordinates record of a mapped file
+ * simd_level:       vector instruction level usable by the batch kernels
+ * siopen:           maps and indexes a station information file
  * scanrcvrinfo:     reads and interprets receiver info;
  *                   fill receiver info basic storage variables
  * defaultrcvrinfo:  fill receiver info storage variables with
@@ -68,6 +134,28 @@
  * tchkeps:          compares two times to within some user defined uncertainty
  * whitespace:       returns pointer to first "white space" character
  * xyz2neu:          Convert geocentric X, Y, Z vector to local north, east, up
+ * xyz2neup:         X, Y, Z positions to north, east, up from a station
+ * xyz2neuv:         xyz2neu on arrays, by the frame of a station (batch)
+ * xyz2plh_grs80:    xyz2plh with GRS80 compiled in (also _wgs84)
+ * xyz2plhd:         xyz2plhv by the cheapest solver meeting a tolerance
+ * xyz2plhdd:        xyz2plhe to double-double precision (reference)
+ * xyz2plhddv:       xyz2plhdd on arrays (batch)
+ * xyz2plhe:         xyz2plh on a registry ellipsoid
+ * xyz2plhf:         xyz2plhe in float, as offsets from an origin
+ * xyz2plhfv:        xyz2plhf on arrays (batch)
+ * xyz2plhh:         X, Y, Z to lat, lon, hgt by one Halley correction
+ * xyz2plhhc:        xyz2plhh iterated to convergence
+ * xyz2plhhcv:       xyz2plhhc on arrays (batch)
+ * xyz2plhhv:        xyz2plhh on arrays (batch)
+ * xyz2plhm:         xyz2plhe through a memo of repeat stations
+ * xyz2plhmv:        xyz2plhm on arrays (batch)
+ * xyz2plhn:         X, Y, Z to lat, lon, hgt by the nearest point, bisection
+ * xyz2plhov:        xyz2plhv for the outputs in a mask
+ * xyz2plhs:         xyz2plhv by a kernel compiled for the ellipsoid
+ * xyz2plht:         X, Y, Z to lat, lon, hgt by trilateration
+ * xyz2plhtk:        xyz2plht stopped after k corrections
+ * xyz2plhtv:        xyz2plht on arrays (batch)
+ * xyz2plhv:         converts arrays of X, Y, Z to lat, lon, hgt (batch)
  * ydymd:            Converts year and day-of-year to calandar date.
  * ymdmjd:           conerts year, month, and day to the modified Julian date
  * ymdyd:            Converts calandar date to year and day-of-year.
@@ -77,6 +165,12 @@
  * ------------------------------
  * olt.h            grids and related variables related to ocean-loading
  * sidata.h         data structures used for I/O to station info files
+ * xyzbat.h         batch (file/stream) coordinate conversion
+ * colio.h          binary columnar coordinate files
+ * ellips.h         named reference ellipsoids
+ * errstat.h        streaming error statistics
+ * topo.h           north, east, up frames of stations
+ * plhmemo.h        memo of conversions of repeat stations
  *
  * references:
  * ------------------------------
@@ -96,6 +190,12 @@
 #include "olt.h"
 #include "sidata.h"
 #include "linfit.h"
+#include "errstat.h"
+#include "xyzbat.h"
+#include "colio.h"
+#include "ellips.h"
+#include "topo.h"
+#include "plhmemo.h"
 
 void PlateMotionModel( char *, double *, double * );
 int AntennaSearch( char * );
@@ -104,6 +204,13 @@ int defaultantinfo( );
 void getAntOffsets( char *, double *, double * );
 int blank( char * );
 void degdms( double, int *, int *, double * );
+void degdmsv( int, double *, int, int *, int *, double * );
+int dmsfmt( char *, int, double, int, int );
+void esadd( ESDS *, double, long );
+void esaddv( ESDS *, int, double *, long );
+void esinit( ESDS * );
+void esmerge( ESDS *, ESDS * );
+void esreport( FILE *, ESDS *, char * );
 double gam_ln( double );
 void gam_cf( double *, double, double, double * );
 double gam_ln( double );
@@ -129,13 +236,39 @@ void initialize_T( struct common_data_info *, struct offset * );
 double gam_q( double, double );
 int linfit( double, double, double, LRDS *,
         double *, double *, double *, double *, double *, double * );
+void lrwadd( LRWS *, double, double, double );
+int lrwaddv( int, LRWS *, double *, double *, double * );
+void lrwdel( LRWS *, double, double, double );
+int lrwdelv( int, LRWS *, double *, double *, double * );
+int lrwfit( LRWS *, double *, double *, double *, double *, double * );
+int lrwfitv( int, LRWS *, double *, double *, double *, double *, double * );
+void lrwinit( LRWS *, int );
 long ymdmjd( int, int, int );
 void mjdyd( long, int *, int * );
 void mjdymd( long, int *, int *, int * );
 void neu2xyz( double, double, double, double, double,
         double *, double *, double * );
 char *nonwhitespace( char * );
+int numfix( char *, int, double, int, int );
+double numscan( char *, char ** );
+int numshort( char *, int, double );
 void plh2xyz( double *, double *, double , double );
+void plh2xyz_grs80( double *, double * );
+void plh2xyz_wgs84( double *, double * );
+void plh2xyzdd( double *, double *, struct ellipsoid * );
+void plh2xyzddv( int, double *, double *, double *,
+        double *, double *, double *,
+        double *, double *, double *, struct ellipsoid * );
+void plh2xyze( double *, double *, struct ellipsoid * );
+void plh2xyzf( double *, float *, float *, struct ellipsoid * );
+void plh2xyzfv( int, double *, float *, float *, float *,
+        float *, float *, float *, struct ellipsoid * );
+void plh2xyzov( int, int, double *, double *, double *,
+        double *, double *, double *, double *, struct ellipsoid * );
+int plh2xyzs( int, double *, double *, double *,
+        double *, double *, double *, struct ellipsoid * );
+void plh2xyzv( int, double *, double *, double *,
+        double *, double *, double *, struct ellipsoid * );
 void reformat( char *, int *, int * );
 int ReceiverSearch( char * );
 int scanrcvrinfo( char * );
@@ -148,5 +281,35 @@ char *whitespace( char * );
 void xyz2neu( double, double, double, double, double,
         double *, double *, double * );
 void xyz2plh( double *, double *, double, double );
+void xyz2plh_grs80( double *, double * );
+void xyz2plh_wgs84( double *, double * );
+int xyz2plhd( int, double *, double *, double *,
+        double *, double *, double *, struct ellipsoid *, double, double );
+void xyz2plhdd( double *, double *, struct ellipsoid * );
+void xyz2plhddv( int, double *, double *, double *,
+        double *, double *, double *,
+        double *, double *, double *, struct ellipsoid * );
+void xyz2plhe( double *, double *, struct ellipsoid * );
+void xyz2plhf( double *, float *, float *, struct ellipsoid * );
+void xyz2plhfv( int, double *, float *, float *, float *,
+        float *, float *, float *, struct ellipsoid * );
+void xyz2plhh( double *, double *, struct ellipsoid * );
+int xyz2plhhc( double *, double *, struct ellipsoid * );
+void xyz2plhhcv( int, double *, double *, double *,
+        double *, double *, double *, struct ellipsoid * );
+void xyz2plhhv( int, double *, double *, double *,
+        double *, double *, double *, struct ellipsoid * );
+void xyz2plhn( double *, double *, double, double );
+void xyz2plhov( int, int, double *, double *, double *,
+        double *, double *, double *, struct ellipsoid * );
+int xyz2plhs( int, double *, double *, double *,
+        double *, double *, double *, struct ellipsoid * );
+void xyz2plht( double *, double *, struct ellipsoid * );
+void xyz2plhtk( double *, double *, struct ellipsoid *, int );
+void xyz2plhtv( int, double *, double *, double *,
+        double *, double *, double *, struct ellipsoid * );
+void xyz2plhv( int, double *, double *, double *,
+        double *, double *, double *, struct ellipsoid * );
+int simd_level( void );
 
 #endif /* libgpsC_h */
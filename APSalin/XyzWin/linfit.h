@@ -22,6 +22,18 @@
  *                    = 1 = normal operation
  * Count should be initialized to zero (0).
  *
+ * LRWS, the linear regression window structure, for a fit over a
+ * sliding window of data pairs, contains
+ *    SumWgt          Sum of weights
+ *    MeanInd         Weighted mean of independent variables
+ *    MeanDep         Weighted mean of dependent variables
+ *    M2Ind           Sum of weight * (independent - MeanInd)^2
+ *    M2IndDep        Sum of weight * (independent - MeanInd)
+ *                                  * (dependent - MeanDep)
+ *    M2Dep           Sum of weight * (dependent - MeanDep)^2
+ *    Count           Number of data pairs in the window
+ *    Mode            as LRDS
+ * An LRWS is initialized by lrwinit.
  *
  * include files:
  * ------------------------------
@@ -31,6 +43,11 @@
  *
  * comments:
  * ------------------------------
+ * LRDS accumulates raw sums, which lose the slope to cancellation when
+ * the independent variable is far from zero (e.g. MJD) and cannot drop
+ * a pair.  LRWS keeps the means and the sums of products about them
+ * (Welford's updates, weighted), so a pair is added or removed in
+ * O(1) and the fit keeps its precision for any offset of the data.
  *
  * see also:
  * ------------------------------
@@ -38,9 +55,13 @@
  * Numerical Recipes (Cambridge, UK: Cambridge University Press),
  * Sec 14.2.
  *
+ * Welford, BP  1962, Note on a method for calculating corrected sums
+ * of squares and products, Technometrics, 4, 419-420.
+ *
  ********1*********2*********3*********4*********5*********6*********7*********
  *:Modification History
  *:0004.09, MSS, Creation
+ *:2610.18, GD,  Add LRWS, sliding window fit (lrwin.c)
  ********1*********2*********3*********4*********5*********6*********7*********/
 #ifndef linfit_h
 #  define linfit_h
@@ -65,11 +86,29 @@
       int Mode;
    } LRDS;
 
+   typedef struct linear_regression_window_structure {
+      double SumWgt;
+      double MeanInd;
+      double MeanDep;
+      double M2Ind;
+      double M2IndDep;
+      double M2Dep;
+      int Count;
+      int Mode;
+   } LRWS;
+
 /*
  *  function prototypes
  */
 
 int linfit( double, double, double, LRDS *,
    double *, double *, double *, double *, double *, double * );
+void lrwadd( LRWS *, double, double, double );
+int lrwaddv( int, LRWS *, double *, double *, double * );
+void lrwdel( LRWS *, double, double, double );
+int lrwdelv( int, LRWS *, double *, double *, double * );
+int lrwfit( LRWS *, double *, double *, double *, double *, double * );
+int lrwfitv( int, LRWS *, double *, double *, double *, double *, double * );
+void lrwinit( LRWS *, int );
 
 #endif
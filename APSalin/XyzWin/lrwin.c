@@ -0,0 +1,332 @@
+/*  @(#)lrwin.c         1.0  26/10/18  */
+static char *sccsid= "@(#)lrwin.c       1.0  26/10/18";
+/*
+ *      include files
+ */
+
+#include <stdlib.h>
+#include <math.h>
+#include "physcon.h"
+#include "linfit.h"
+
+/*
+ *      function prototypes
+ */
+
+void lrwadd( LRWS *, double, double, double );
+int lrwaddv( int, LRWS *, double *, double *, double * );
+void lrwdel( LRWS *, double, double, double );
+int lrwdelv( int, LRWS *, double *, double *, double * );
+int lrwfit( LRWS *, double *, double *, double *, double *, double * );
+int lrwfitv( int, LRWS *, double *, double *, double *, double *, double * );
+void lrwinit( LRWS *, int );
+
+/*
+ *      definitions and global variables
+ */
+
+
+
+void lrwinit( LRWS *lrw, int mode )
+/********1*********2*********3*********4*********5*********6*********7**
+ * Name:        lrwinit
+ * Version:     2610.18
+ * Author:      geoData
+ * Purpose:     Empties a linear regression window structure.
+ *
+ * Input:
+ * -----------
+ * mode             = 0 = standard deviations unavailable; every pair
+ *                        has weight 1 and sig is not used
+ *                  = 1 = pairs weighted by 1/sig^2
+ *
+ * Output:
+ * -----------
+ * lrw              no data pairs
+ *
+ ********1*********2*********3*********4*********5*********6*********7**
+ * Modification History:
+ * 2610.18, GD,  Creation
+ ********1*********2*********3*********4*********5*********6*********7*/
+{
+        lrw->SumWgt= ZERO;
+        lrw->MeanInd= ZERO;
+        lrw->MeanDep= ZERO;
+        lrw->M2Ind= ZERO;
+        lrw->M2IndDep= ZERO;
+        lrw->M2Dep= ZERO;
+        lrw->Count= 0;
+        lrw->Mode= mode;
+}
+
+
+void lrwadd( LRWS *lrw, double x, double y, double sig )
+/********1*********2*********3*********4*********5*********6*********7**
+ * Name:        lrwadd
+ * Version:     2610.18
+ * Author:      geoData
+ * Purpose:     Adds a data pair to a linear regression window.
+ *
+ * Input:
+ * -----------
+ * lrw              window
+ * sig              standard deviation of y (Mode 1)
+ * x                independent variable
+ * y                dependent variable
+ *
+ * Output:
+ * -----------
+ * lrw              with (x, y) added
+ *
+ * Notes:
+ * -----------
+ * Welford's update: the means move by w/W of the new point's
+ * deviation, and each sum of products gains w times the deviation
+ * from the old mean times that from the new one.
+ *
+ ********1*********2*********3*********4*********5*********6*********7**
+ * Modification History:
+ * 2610.18, GD,  Creation
+ ********1*********2*********3*********4*********5*********6*********7*/
+{
+        double w= lrw->Mode == 1 ? ONE / (sig*sig) : ONE;
+        double dx= x - lrw->MeanInd;
+        double dy= y - lrw->MeanDep;
+        double r;
+
+        lrw->SumWgt+= w;
+        lrw->Count++;
+        r= w / lrw->SumWgt;
+        lrw->MeanInd+= r*dx;
+        lrw->MeanDep+= r*dy;
+        lrw->M2Ind+= w*dx*( x - lrw->MeanInd );
+        lrw->M2IndDep+= w*dx*( y - lrw->MeanDep );
+        lrw->M2Dep+= w*dy*( y - lrw->MeanDep );
+}
+
+
+void lrwdel( LRWS *lrw, double x, double y, double sig )
+/********1*********2*********3*********4*********5*********6*********7**
+ * Name:        lrwdel
+ * Version:     2610.18
+ * Author:      geoData
+ * Purpose:     Removes a data pair from a linear regression window.
+ *
+ * Input:
+ * -----------
+ * lrw              window holding (x, y)
+ * sig              standard deviation of y, as given to lrwadd
+ * x                independent variable, as given to lrwadd
+ * y                dependent variable, as given to lrwadd
+ *
+ * Output:
+ * -----------
+ * lrw              with (x, y) removed
+ *
+ * Notes:
+ * -----------
+ * The reverse of lrwadd, with the deviations taken from the current
+ * means.  Removing the last pair empties the window exactly, so the
+ * rounding of one window does not carry into the next.  The sums of
+ * squares are kept from going negative by rounding.
+ *
+ ********1*********2*********3*********4*********5*********6*********7**
+ * Modification History:
+ * 2610.18, GD,  Creation
+ ********1*********2*********3*********4*********5*********6*********7*/
+{
+        double w= lrw->Mode == 1 ? ONE / (sig*sig) : ONE;
+        double dx= x - lrw->MeanInd;
+        double dy= y - lrw->MeanDep;
+        double r;
+
+        if( lrw->Count <= 1 ) {
+                lrwinit( lrw, lrw->Mode );
+                return;
+        }
+        lrw->SumWgt-= w;
+        lrw->Count--;
+        r= w / lrw->SumWgt;
+        lrw->MeanInd-= r*dx;
+        lrw->MeanDep-= r*dy;
+        lrw->M2Ind-= w*dx*( x - lrw->MeanInd );
+        lrw->M2IndDep-= w*dx*( y - lrw->MeanDep );
+        lrw->M2Dep-= w*dy*( y - lrw->MeanDep );
+        if( lrw->M2Ind < ZERO )
+                lrw->M2Ind= ZERO;
+        if( lrw->M2Dep < ZERO )
+                lrw->M2Dep= ZERO;
+}
+
+
+int lrwfit( LRWS *lrw, double *a, double *b, double *siga, double *sigb,
+            double *chi2 )
+/********1*********2*********3*********4*********5*********6*********7**
+ * Name:        lrwfit
+ * Version:     2610.18
+ * Author:      geoData
+ * Purpose:     Fits y = a + b*x to the data pairs of a linear
+ *              regression window.
+ *
+ * Input:
+ * -----------
+ * lrw              window
+ *
+ * Output:
+ * -----------
+ * a, b             intercept and slope
+ * siga, sigb       their standard deviations
+ * chi2             chi-square of the fit; in Mode 0 the sum of the
+ *                  squared residuals
+ * returns          0, or -1 if the window has fewer than two distinct
+ *                  x (a, b, ... are then NaN)
+ *
+ * Notes:
+ * -----------
+ * Numerical Recipes' fit (Sec 14.2) about the means: b = M2IndDep /
+ * M2Ind, a = MeanDep - b*MeanInd.  In Mode 0 the standard deviations
+ * are scaled by sqrt(chi2/(Count-2)) as linfit does.  Unlike linfit
+ * no goodness of fit Q is formed.
+ *
+ ********1*********2*********3*********4*********5*********6*********7**
+ * Modification History:
+ * 2610.18, GD,  Creation
+ ********1*********2*********3*********4*********5*********6*********7*/
+{
+        double s;
+
+        if( lrw->Count < 2 || !( lrw->M2Ind > ZERO ) ) {
+                *a= *b= *siga= *sigb= *chi2= NAN;
+                return( -1 );
+        }
+        *b= lrw->M2IndDep / lrw->M2Ind;
+        *a= lrw->MeanDep - *b * lrw->MeanInd;
+        *chi2= lrw->M2Dep - *b * lrw->M2IndDep;
+        if( *chi2 < ZERO )
+                *chi2= ZERO;
+        *sigb= sqrt( ONE / lrw->M2Ind );
+        *siga= sqrt( ONE / lrw->SumWgt
+                     + lrw->MeanInd * lrw->MeanInd / lrw->M2Ind );
+        if( lrw->Mode == 0 && lrw->Count > 2 ) {
+                s= sqrt( *chi2 / (lrw->Count - 2) );
+                *siga*= s;
+                *sigb*= s;
+        }
+
+        return( 0 );
+}
+
+
+int lrwaddv( int n, LRWS *lrw, double *x, double *y, double *sig )
+/********1*********2*********3*********4*********5*********6*********7**
+ * Name:        lrwaddv
+ * Version:     2610.18
+ * Author:      geoData
+ * Purpose:     Adds one data pair to each of an array of linear
+ *              regression windows, e.g. the position of the day of
+ *              every station.  Batch form of lrwadd.
+ *
+ * Input:
+ * -----------
+ * lrw[]            n windows
+ * n                number of windows
+ * sig[]            standard deviation of each y; NULL in Mode 0
+ * x[], y[]         data pair of each window; a NaN x or y (no data)
+ *                  leaves the window as it is
+ *
+ * Output:
+ * -----------
+ * lrw[]            with the pairs added
+ * returns          number of pairs added
+ *
+ ********1*********2*********3*********4*********5*********6*********7**
+ * Modification History:
+ * 2610.18, GD,  Creation
+ ********1*********2*********3*********4*********5*********6*********7*/
+{
+        int i;
+        int m= 0;
+
+        for( i= 0; i < n; i++ )
+                if( !isnan( x[i] ) && !isnan( y[i] ) ) {
+                        lrwadd( &lrw[i], x[i], y[i],
+                                sig != NULL ? sig[i] : ONE );
+                        m++;
+                }
+
+        return( m );
+}
+
+
+int lrwdelv( int n, LRWS *lrw, double *x, double *y, double *sig )
+/********1*********2*********3*********4*********5*********6*********7**
+ * Name:        lrwdelv
+ * Version:     2610.18
+ * Author:      geoData
+ * Purpose:     Removes one data pair from each of an array of linear
+ *              regression windows, e.g. the day leaving the window of
+ *              every station.  Batch form of lrwdel.
+ *
+ * Input:
+ * -----------
+ * as lrwaddv, with the pairs given to it
+ *
+ * Output:
+ * -----------
+ * lrw[]            with the pairs removed
+ * returns          number of pairs removed
+ *
+ ********1*********2*********3*********4*********5*********6*********7**
+ * Modification History:
+ * 2610.18, GD,  Creation
+ ********1*********2*********3*********4*********5*********6*********7*/
+{
+        int i;
+        int m= 0;
+
+        for( i= 0; i < n; i++ )
+                if( !isnan( x[i] ) && !isnan( y[i] ) ) {
+                        lrwdel( &lrw[i], x[i], y[i],
+                                sig != NULL ? sig[i] : ONE );
+                        m++;
+                }
+
+        return( m );
+}
+
+
+int lrwfitv( int n, LRWS *lrw, double *a, double *b, double *siga,
+             double *sigb, double *chi2 )
+/********1*********2*********3*********4*********5*********6*********7**
+ * Name:        lrwfitv
+ * Version:     2610.18
+ * Author:      geoData
+ * Purpose:     Fits every one of an array of linear regression windows.
+ *              Batch form of lrwfit.
+ *
+ * Input:
+ * -----------
+ * lrw[]            n windows
+ * n                number of windows
+ *
+ * Output:
+ * -----------
+ * a[], b[], siga[], sigb[], chi2[]  as lrwfit, for each window; NaN
+ *                  for one that cannot be fitted
+ * returns          number of windows fitted
+ *
+ ********1*********2*********3*********4*********5*********6*********7**
+ * Modification History:
+ * 2610.18, GD,  Creation
+ ********1*********2*********3*********4*********5*********6*********7*/
+{
+        int i;
+        int m= 0;
+
+        for( i= 0; i < n; i++ )
+                if( lrwfit( &lrw[i], &a[i], &b[i], &siga[i], &sigb[i],
+                            &chi2[i] ) == 0 )
+                        m++;
+
+        return( m );
+}
@@ -25,6 +25,28 @@
  * wrap             = 0 if grid does not wrap in longitude
  *                  = 1 otherwise
  *
+ * OLT_magic        first 8 bytes of a grid store file
+ * OLT_order        byte order mark, written in the writer's order
+ *
+ * olt_head, the header of a grid store (and of its file):
+ *    magic         OLT_magic
+ *    order         OLT_order in the writer's byte order
+ *    ntide         number of tides, <= MAX_tides
+ *    nx, ny        number of grid longitudes, latitudes
+ *    wrap          = 1 = the grid wraps in longitude
+ *    lonmin        longitude of grid column 0 [deg]
+ *    latmin        latitude of grid row 0 [deg]
+ *    dx, dy        grid spacing in longitude, latitude [deg]
+ *    id[]          tide names, as gridded_data.id
+ *
+ * olt_store, all tides of a set of grids, laid out for interpolation:
+ *    hd            header
+ *    cell[]        amp*cos(phs), amp*sin(phs) of every tide, by cell:
+ *                  cell[((iy*nx + ix)*ntide + k)*2 + 0..1]; NaN where
+ *                  the grid is undefined
+ *    map           base of the file mapping; NULL if cell is on the heap
+ *    size          length of the mapping [char]
+ *
  * functions
  * ------------------------------
  * astrol()         computes the basic astronomical mean longitudes
@@ -34,6 +56,12 @@
  * init_olt()       initialization for perth2
  * load_olt()       load a multiple sets of gridded data
  * read_olt()       reads an ASCII file of gridded values
+ * oltclose()       frees a grid store
+ * oltinit()        makes an empty grid store
+ * oltintrpv()      interpolates every tide at many stations (batch)
+ * oltopen()        maps a grid store file into memory
+ * oltset()         fills one tide of a grid store from amp, phs grids
+ * oltwrite()       writes a grid store file
  *
  *
  * include files:
@@ -44,12 +72,19 @@
  *
  * comments:
  * ------------------------------
+ * gridded_data keeps each tide's amplitude and phase grids in their own
+ * heap arrays, so one station touches 2*ntide scattered cache lines per
+ * corner.  olt_store keeps the tides of a cell together, so the four
+ * corners of a station are four runs of 2*ntide doubles.  A store file
+ * is the header, padded to OLT_hsize bytes, then cell[] as it is in
+ * memory; oltopen maps it, and the grids are ready without parsing.
  *
  *
  ********1*********2*********3*********4*********5*********6*********7*********
  *:modification history
  *:9705.31, MSS, Creation.
  *:9810.20, MSS, Remove variable typing from header.
+ *:2610.18, GD,  Add olt_store, interleaved grids and their files.
  ********1*********2*********3*********4*********5*********6*********7*********/
 
 #ifndef olt_h
@@ -61,6 +96,9 @@
 #define three_sixty ((double)360.0)
 #define MAX_grids ((int)8)
 #define MAX_tides ((int)26)
+#define OLT_magic "\211OLTGRD"
+#define OLT_order 0x01020304
+#define OLT_hsize ((int)512)
 
 struct gridded_data {
   char id[16];
@@ -68,6 +106,28 @@ struct gridded_data {
   double *phs;
 };
 
+struct olt_head {
+  char magic[8];
+  int order;
+  int ntide;
+  int nx;
+  int ny;
+  int wrap;
+  int spare;
+  double lonmin;
+  double latmin;
+  double dx;
+  double dy;
+  char id[MAX_tides][16];
+};
+
+struct olt_store {
+  struct olt_head hd;
+  double *cell;
+  void *map;
+  long size;
+};
+
 double *read_olt( char *, FILE * );
 char *check_olt( char * );
 int grid_olt( int, int );
@@ -75,5 +135,13 @@ int init_olt( FILE *, char * );
 int intrp_olt( double, double, double *, double *, char ** );
 int load_olt( FILE * );
 void astrol( double, double * );
+void oltclose( struct olt_store * );
+int oltinit( struct olt_store *, int, char (*)[16], int, int,
+             double, double, double, double, int );
+int oltintrpv( struct olt_store *, int, double *, double *,
+               double *, double * );
+int oltopen( struct olt_store *, char * );
+int oltset( struct olt_store *, int, double *, double *, double );
+int oltwrite( struct olt_store *, char * );
 
 #endif /* olt_h */
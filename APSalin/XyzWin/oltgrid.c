@@ -0,0 +1,506 @@
+/*  @(#)oltgrid.c       1.0  26/10/18  */
+static char *sccsid= "@(#)oltgrid.c     1.0  26/10/18";
+/*
+ *  include files
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include "physcon.h"
+#include "olt.h"
+
+/*
+ *  function prototypes
+ */
+
+void oltclose( struct olt_store * );
+int oltinit( struct olt_store *, int, char (*)[16], int, int,
+             double, double, double, double, int );
+int oltintrpv( struct olt_store *, int, double *, double *,
+               double *, double * );
+int oltopen( struct olt_store *, char * );
+int oltset( struct olt_store *, int, double *, double *, double );
+int oltwrite( struct olt_store *, char * );
+static int oltcell( struct olt_head *, double, double, long *, double * );
+static void swap4( void * );
+static void swap8( void * );
+
+/*
+ *  definitions and global variables
+ */
+
+
+
+int oltinit( struct olt_store *store, int ntide, char (*id)[16], int nx,
+             int ny, double lonmin, double latmin, double dx, double dy,
+             int wrap )
+/********1*********2*********3*********4*********5*********6*********7*********
+ * name:            oltinit
+ * version:         2610.18
+ * written by:      geoData
+ * purpose:         makes an empty grid store on the heap
+ *
+ * input parameters
+ * ----------------
+ * dx, dy           grid spacing in longitude, latitude [deg]
+ * id[]             ntide tide names, e.g. "M2"
+ * latmin           latitude of grid row 0 [deg]
+ * lonmin           longitude of grid column 0 [deg]
+ * ntide            number of tides, 1 to MAX_tides
+ * nx, ny           number of grid longitudes, latitudes
+ * wrap             = 1 = the grid wraps in longitude; column nx-1 is
+ *                  then next to column 0
+ *
+ * output parameters
+ * -----------------
+ * store            every cell undefined; filled by oltset
+ *
+ * returns 0, or -1 on a bad size or no memory
+ *
+ ********1*********2*********3*********4*********5*********6*********7*********
+ *:modification history
+ *:2610.18, GD, Creation
+ ********1*********2*********3*********4*********5*********6*********7*********/
+
+{
+        long i;
+        long n;
+
+        memset( store, 0, sizeof(*store) );
+        if( ntide < 1 || ntide > MAX_tides || nx < 2 || ny < 2
+            || !( dx > ZERO ) || !( dy > ZERO ) )
+                return( -1 );
+
+        memcpy( store->hd.magic, OLT_magic, sizeof(store->hd.magic) );
+        store->hd.order= OLT_order;
+        store->hd.ntide= ntide;
+        store->hd.nx= nx;
+        store->hd.ny= ny;
+        store->hd.wrap= wrap;
+        store->hd.lonmin= lonmin;
+        store->hd.latmin= latmin;
+        store->hd.dx= dx;
+        store->hd.dy= dy;
+        for( i= 0; i < ntide; i++ ) {
+                strncpy( store->hd.id[i], id[i], sizeof(store->hd.id[i]) - 1 );
+                store->hd.id[i][sizeof(store->hd.id[i]) - 1]= '\0';
+        }
+
+        n= (long)nx * ny * ntide * 2;
+        store->cell= (double *)malloc( n * sizeof(double) );
+        if( store->cell == NULL )
+                return( -1 );
+        for( i= 0; i < n; i++ )
+                store->cell[i]= NAN;
+
+        return( 0 );
+}
+
+
+int oltset( struct olt_store *store, int k, double *amp, double *phs,
+            double undef )
+/********1*********2*********3*********4*********5*********6*********7*********
+ * name:            oltset
+ * version:         2610.18
+ * written by:      geoData
+ * purpose:         fills one tide of a grid store
+ *
+ * input parameters
+ * ----------------
+ * amp[], phs[]     amplitude and phase [deg] of tide k at each grid
+ *                  point, by rows: amp[iy*nx + ix], as read_olt gives
+ * k                tide number, 0 to ntide-1
+ * store            made by oltinit
+ * undef            amplitude or phase of an undefined grid point (land)
+ *
+ * output parameters
+ * -----------------
+ * store            cell[] of tide k
+ *
+ * returns the number of defined grid points, or -1 on a bad k
+ *
+ ********1*********2*********3*********4*********5*********6*********7*********
+ *:modification history
+ *:2610.18, GD, Creation
+ ********1*********2*********3*********4*********5*********6*********7*********/
+
+{
+        int ntide= store->hd.ntide;
+        long i;
+        long n= (long)store->hd.nx * store->hd.ny;
+        long m= 0;
+        double *c;
+
+        if( k < 0 || k >= ntide || store->map != NULL )
+                return( -1 );
+
+        for( i= 0; i < n; i++ ) {
+                c= store->cell + (i*ntide + k)*2;
+                if( amp[i] == undef || phs[i] == undef ) {
+                        c[0]= c[1]= NAN;
+                } else {
+                        c[0]= amp[i] * cos( phs[i] * deg_to_rad );
+                        c[1]= amp[i] * sin( phs[i] * deg_to_rad );
+                        m++;
+                }
+        }
+
+        return( (int)m );
+}
+
+
+int oltwrite( struct olt_store *store, char *path )
+/********1*********2*********3*********4*********5*********6*********7*********
+ * name:            oltwrite
+ * version:         2610.18
+ * written by:      geoData
+ * purpose:         writes a grid store file
+ *
+ * input parameters
+ * ----------------
+ * path             name of the file
+ * store            filled grid store
+ *
+ * returns 0, or -1 if the file could not be written
+ *
+ * comments:
+ * ------------------------------
+ * The header is padded with zeros to OLT_hsize bytes so cell[] starts
+ * on a cache line and page offset of the mapping.
+ *
+ ********1*********2*********3*********4*********5*********6*********7*********
+ *:modification history
+ *:2610.18, GD, Creation
+ ********1*********2*********3*********4*********5*********6*********7*********/
+
+{
+        char pad[OLT_hsize];
+        long n= (long)store->hd.nx * store->hd.ny * store->hd.ntide * 2;
+        FILE *fp;
+        int ok;
+
+        if( (fp= fopen( path, "wb" )) == NULL )
+                return( -1 );
+
+        memset( pad, 0, sizeof(pad) );
+        memcpy( pad, &store->hd, sizeof(store->hd) );
+        ok= fwrite( pad, sizeof(pad), 1, fp ) == 1
+            && fwrite( store->cell, sizeof(double), (size_t)n, fp )
+               == (size_t)n;
+        if( fclose( fp ) != 0 )
+                ok= 0;
+
+        return( ok ? 0 : -1 );
+}
+
+
+int oltopen( struct olt_store *store, char *path )
+/********1*********2*********3*********4*********5*********6*********7*********
+ * name:            oltopen
+ * version:         2610.18
+ * written by:      geoData
+ * purpose:         maps a grid store file into memory
+ *
+ * input parameters
+ * ----------------
+ * path             name of the file, written by oltwrite
+ *
+ * output parameters
+ * -----------------
+ * store            hd and cell[] of the file
+ *
+ * returns 0, or -1 if the file cannot be opened or is not a grid store
+ *
+ * comments:
+ * ------------------------------
+ * cell[] is used in place, read only, and the pages a run touches are
+ * the only ones read from disk.  A file of the other byte order is
+ * copied to the heap and swapped.  The header is held to the limits
+ * of oltinit, and its size to that of the file.
+ *
+ ********1*********2*********3*********4*********5*********6*********7*********
+ *:modification history
+ *:2610.18, GD, Creation
+ *:2610.18, GD, Check dx, dy; compare the size without overflow
+ ********1*********2*********3*********4*********5*********6*********7*********/
+
+{
+        struct olt_head *hd= &store->hd;
+        struct stat st;
+        FILE *fp;
+        void *base;
+        long i;
+        long n;
+        int swap= 0;
+
+        memset( store, 0, sizeof(*store) );
+        if( (fp= fopen( path, "rb" )) == NULL )
+                return( -1 );
+        if( fstat( fileno( fp ), &st ) != 0 || st.st_size < OLT_hsize
+            || fread( hd, sizeof(*hd), 1, fp ) != 1
+            || memcmp( hd->magic, OLT_magic, sizeof(hd->magic) ) != 0 ) {
+                fclose( fp );
+                return( -1 );
+        }
+
+        if( hd->order != OLT_order ) {
+                swap4( &hd->order );
+                if( hd->order != OLT_order ) {
+                        fclose( fp );
+                        return( -1 );
+                }
+                swap= 1;
+                swap4( &hd->ntide );
+                swap4( &hd->nx );
+                swap4( &hd->ny );
+                swap4( &hd->wrap );
+                swap8( &hd->lonmin );
+                swap8( &hd->latmin );
+                swap8( &hd->dx );
+                swap8( &hd->dy );
+        }
+
+/*
+ *   the cells must fill the rest of the file exactly; compared by
+ *   division, as nx*ny*ntide*2 of a damaged header can overflow
+ */
+        n= (long)( st.st_size - OLT_hsize ) / (long)sizeof(double);
+        if( hd->ntide < 1 || hd->ntide > MAX_tides || hd->nx < 2 || hd->ny < 2
+            || !( hd->dx > ZERO ) || !( hd->dy > ZERO )
+            || (long)( st.st_size - OLT_hsize ) % (long)sizeof(double) != 0
+            || n % ( 2L * hd->ntide * hd->ny ) != 0
+            || n / ( 2L * hd->ntide * hd->ny ) != hd->nx ) {
+                fclose( fp );
+                return( -1 );
+        }
+
+        base= mmap( NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE,
+                    fileno( fp ), 0 );
+        fclose( fp );
+        if( base == MAP_FAILED )
+                return( -1 );
+
+        if( swap ) {
+                store->cell= (double *)malloc( n * sizeof(double) );
+                if( store->cell != NULL ) {
+                        memcpy( store->cell, (char *)base + OLT_hsize,
+                                n * sizeof(double) );
+                        for( i= 0; i < n; i++ )
+                                swap8( &store->cell[i] );
+                }
+                munmap( base, (size_t)st.st_size );
+                return( store->cell != NULL ? 0 : -1 );
+        }
+
+        (void)madvise( base, (size_t)st.st_size, MADV_RANDOM );
+        store->map= base;
+        store->size= (long)st.st_size;
+        store->cell= (double *)( (char *)base + OLT_hsize );
+
+        return( 0 );
+}
+
+
+void oltclose( struct olt_store *store )
+/********1*********2*********3*********4*********5*********6*********7*********
+ * name:            oltclose
+ * version:         2610.18
+ * written by:      geoData
+ * purpose:         frees a grid store made by oltinit or oltopen
+ *
+ ********1*********2*********3*********4*********5*********6*********7*********
+ *:modification history
+ *:2610.18, GD, Creation
+ ********1*********2*********3*********4*********5*********6*********7*********/
+
+{
+        if( store->map != NULL )
+                munmap( store->map, (size_t)store->size );
+        else
+                free( store->cell );
+        store->cell= NULL;
+        store->map= NULL;
+        store->size= 0;
+}
+
+
+int oltintrpv( struct olt_store *store, int n, double *lat, double *lon,
+               double *amp, double *phs )
+/********1*********2*********3*********4*********5*********6*********7*********
+ * name:            oltintrpv
+ * version:         2610.18
+ * written by:      geoData
+ * purpose:         interpolates every tide of a grid store at an array
+ *                  of stations
+ *
+ * input parameters
+ * ----------------
+ * lat[], lon[]     latitude and longitude of n stations [deg]
+ * n                number of stations
+ * store            grid store
+ *
+ * output parameters
+ * -----------------
+ * amp[], phs[]     amplitude and phase [deg, 0 to 360] of tide k at
+ *                  station i in [i*ntide + k]; NaN outside the grid or
+ *                  where all four corners are undefined
+ *
+ * returns the number of stations inside the grid
+ *
+ * calls:
+ * ------------------------------
+ * oltcell          grid cell and bilinear weights of a station
+ *
+ * comments:
+ * ------------------------------
+ * Bilinear in the in-phase and quadrature parts amp*cos(phs) and
+ * amp*sin(phs), so a phase that crosses 0/360 between corners needs
+ * no care.  Undefined corners (land) are left out and the weights of
+ * the others scaled up to 1, as intrp_olt does near the coast.  The
+ * tides of a corner are adjacent, so a station reads four runs of
+ * 2*ntide doubles.
+ *
+ ********1*********2*********3*********4*********5*********6*********7*********
+ *:modification history
+ *:2610.18, GD, Creation
+ ********1*********2*********3*********4*********5*********6*********7*********/
+
+{
+        int ntide= store->hd.ntide;
+        int i;
+        int j;
+        int k;
+        int m= 0;
+        long off[4];
+        double w[4];
+        double *c;
+        double *a;
+        double *p;
+        double si;
+        double sq;
+        double sw;
+
+        for( i= 0; i < n; i++ ) {
+                a= amp + (long)i*ntide;
+                p= phs + (long)i*ntide;
+                if( oltcell( &store->hd, lat[i], lon[i], off, w ) != 0 ) {
+                        for( k= 0; k < ntide; k++ )
+                                a[k]= p[k]= NAN;
+                        continue;
+                }
+                m++;
+
+                for( k= 0; k < ntide; k++ ) {
+                        si= sq= sw= ZERO;
+                        for( j= 0; j < 4; j++ ) {
+                                c= store->cell + (off[j] + k)*2;
+                                if( !isnan( c[0] ) ) {
+                                        si+= w[j] * c[0];
+                                        sq+= w[j] * c[1];
+                                        sw+= w[j];
+                                }
+                        }
+                        if( sw > ZERO ) {
+                                si/= sw;
+                                sq/= sw;
+                                a[k]= sqrt( si*si + sq*sq );
+                                p[k]= atan2( sq, si ) * rad_to_deg;
+                                if( p[k] < ZERO )
+                                        p[k]+= three_sixty;
+                        } else {
+                                a[k]= p[k]= NAN;
+                        }
+                }
+        }
+
+        return( m );
+}
+
+
+static int oltcell( struct olt_head *hd, double lat, double lon,
+                    long *off, double *w )
+/********1*********2*********3*********4*********5*********6*********7*********
+ * purpose:         cell offsets (in tides) of the four corners around a
+ *                  station and their bilinear weights; returns -1 if
+ *                  the station is outside the grid
+ ********1*********2*********3*********4*********5*********6*********7*********/
+
+{
+        double fx;
+        double fy;
+        long ix0;
+        long ix1;
+        long iy;
+
+        fy= ( lat - hd->latmin ) / hd->dy;
+        if( !( fy >= ZERO && fy <= hd->ny - 1 ) )
+                return( -1 );
+        fx= fmod( lon - hd->lonmin, three_sixty );
+        if( fx < ZERO )
+                fx+= three_sixty;
+        fx/= hd->dx;
+
+        iy= (long)fy;
+        if( iy >= hd->ny - 1 )
+                iy= hd->ny - 2;
+        ix0= (long)fx;
+        if( hd->wrap ) {
+                if( ix0 >= hd->nx )
+                        ix0= hd->nx - 1;
+                ix1= ix0 + 1 < hd->nx ? ix0 + 1 : 0;
+        } else {
+                if( !( fx <= hd->nx - 1 ) )
+                        return( -1 );
+                if( ix0 >= hd->nx - 1 )
+                        ix0= hd->nx - 2;
+                ix1= ix0 + 1;
+        }
+        fx-= ix0;
+        fy-= iy;
+
+        off[0]= ( iy*hd->nx + ix0 ) * hd->ntide;
+        off[1]= ( iy*hd->nx + ix1 ) * hd->ntide;
+        off[2]= ( (iy + 1)*hd->nx + ix0 ) * hd->ntide;
+        off[3]= ( (iy + 1)*hd->nx + ix1 ) * hd->ntide;
+        w[0]= ( ONE - fx ) * ( ONE - fy );
+        w[1]= fx * ( ONE - fy );
+        w[2]= ( ONE - fx ) * fy;
+        w[3]= fx * fy;
+
+        return( 0 );
+}
+
+
+static void swap4( void *p )
+/********1*********2*********3*********4*********5*********6*********7*********
+ * purpose:         reverses the byte order of a 4 byte value
+ ********1*********2*********3*********4*********5*********6*********7*********/
+{
+        unsigned char *c= (unsigned char *)p;
+        unsigned char t;
+
+        t= c[0]; c[0]= c[3]; c[3]= t;
+        t= c[1]; c[1]= c[2]; c[2]= t;
+}
+
+
+static void swap8( void *p )
+/********1*********2*********3*********4*********5*********6*********7*********
+ * purpose:         reverses the byte order of an 8 byte value
+ ********1*********2*********3*********4*********5*********6*********7*********/
+{
+        unsigned char *c= (unsigned char *)p;
+        unsigned char t;
+        int i;
+
+        for( i= 0; i < 4; i++ ) {
+                t= c[i];
+                c[i]= c[7-i];
+                c[7-i]= t;
+        }
+}
@@ -6,12 +6,14 @@ static char *sccsid= "@(#)plh2xyz.c     1.1  98/12/08";
 
 #include <math.h>
 #include "physcon.h"
+#include "ellips.h"
 
 /*
  *  function prototypes
  */
 
 void plh2xyz( double *, double *, double , double );
+void plh2xyze( double *, double *, struct ellipsoid * );
 
 /*
  *  global definitions and variables
@@ -99,3 +101,51 @@ void plh2xyz( double *plh, double *xyz, double A, double FL )
         xyz[0]= xyz[0] * cos( lon_rad );
         xyz[2]= g2 * sin_lat;
 }
+
+
+void plh2xyze( double *plh, double *xyz, struct ellipsoid *ell )
+/********1*********2*********3*********4*********5*********6*********7*********
+ * name:            plh2xyze
+ * version:         2610.18
+ * written by:      geoData
+ * purpose:         converts elliptic lat, lon, hgt to geocentric X, Y, Z
+ *                  on a registry ellipsoid
+ *
+ * input parameters
+ * ----------------
+ * ell              ellipsoid, with its derived constants (ellset)
+ * plh[]            as plh2xyz [deg, deg, m]
+ *
+ * output parameters
+ * -----------------
+ * xyz[]            geocentric Cartesian coordinates [m]
+ *
+ * comments:
+ * ------------------------------
+ * plh2xyz with flatfn and funsq taken from the ellipsoid (e2, funsq);
+ * the results are identical.
+ *
+ ********1*********2*********3*********4*********5*********6*********7*********
+ *:modification history
+ *:2610.18, GD, Creation
+ ********1*********2*********3*********4*********5*********6*********7*********/
+
+{
+        double g1;
+        double g2;
+        double lat_rad= deg_to_rad * plh[0];
+        double lon_rad= deg_to_rad * plh[1];
+        double sin_lat;
+
+
+        sin_lat= sin( lat_rad );
+
+        g1= ell->A / sqrt( ONE - ell->e2*sin_lat*sin_lat );
+        g2= g1*ell->funsq + plh[2];
+        g1= g1 + plh[2];
+
+        xyz[0]= g1 * cos( lat_rad );
+        xyz[1]= xyz[0] * sin( lon_rad );
+        xyz[0]= xyz[0] * cos( lon_rad );
+        xyz[2]= g2 * sin_lat;
+}
@@ -0,0 +1,271 @@
+/*  @(#)plh2xyza.c      1.0  26/10/18  */
+static char *sccsid= "@(#)plh2xyza.c    1.0  26/10/18";
+/*
+ *  include files
+ */
+
+#include <math.h>
+#include "physcon.h"
+#include "libgpsC.h"
+#include "vmath.h"
+
+/*
+ *  function prototypes
+ */
+
+void plh2xyzov_avx2( int, int, double *, double *, double *,
+                     double *, double *, double *, double *,
+                     struct ellipsoid * );
+void plh2xyzv_avx2( int, double *, double *, double *,
+                    double *, double *, double *, struct ellipsoid * );
+
+/*
+ *  global definitions and variables
+ */
+
+
+#ifdef __AVX2__
+
+static inline void xyzkern( int, double *, double *, double *,
+                            double *, double *, double *, double *,
+                            struct ellipsoid *, const int );
+
+
+void plh2xyzv_avx2( int n, double *lat, double *lon, double *hgt,
+                    double *x, double *y, double *z,
+                    struct ellipsoid *ell )
+/********1*********2*********3*********4*********5*********6*********7*********
+ * name:            plh2xyzv_avx2
+ * version:         2610.18
+ * written by:      geoData
+ * purpose:         AVX2 kernel of plh2xyzv; four points at a time
+ *
+ * input parameters
+ * ----------------
+ * see plh2xyzv
+ *
+ * output parameters
+ * -----------------
+ * see plh2xyzv
+ *
+ * comments:
+ * ------------------------------
+ * This file must be compiled with -mavx2 -mfma.  It is only called
+ * after simd_level() has checked the processor.  One vsincos call per
+ * angle replaces the separate sin and cos calls of plh2xyz.
+ *
+ ********1*********2*********3*********4*********5*********6*********7*********
+ *:modification history
+ *:2610.18, GD, Creation
+ *:2610.18, GD, Ellipsoid from the registry rather than A, FL
+ *:2610.18, GD, Body moved to xyzkern, shared with plh2xyzov_avx2
+ ********1*********2*********3*********4*********5*********6*********7*********/
+
+{
+        xyzkern( n, lat, lon, hgt, x, y, z, NULL, ell, OUT_xyz );
+}
+
+
+void plh2xyzov_avx2( int n, int mask, double *lat, double *lon, double *hgt,
+                     double *x, double *y, double *z, double *r,
+                     struct ellipsoid *ell )
+/********1*********2*********3*********4*********5*********6*********7*********
+ * name:            plh2xyzov_avx2
+ * version:         2610.18
+ * written by:      geoData
+ * purpose:         AVX2 kernel of plh2xyzov; plh2xyzv_avx2 computing only
+ *                  the outputs in mask
+ *
+ * input parameters
+ * ----------------
+ * see plh2xyzov
+ *
+ * output parameters
+ * -----------------
+ * see plh2xyzov
+ *
+ * comments:
+ * ------------------------------
+ * One copy of xyzkern per mask.  Without X and Y the vsincos of the
+ * longitude is left out, and with Z alone the cos of the latitude is
+ * not used.  What is computed is computed as by plh2xyzv_avx2, so
+ * the results are identical.
+ *
+ ********1*********2*********3*********4*********5*********6*********7*********
+ *:modification history
+ *:2610.18, GD, Creation
+ ********1*********2*********3*********4*********5*********6*********7*********/
+
+{
+#define XYZ_case( m )   case m: \
+        xyzkern( n, lat, lon, hgt, x, y, z, r, ell, m ); break
+
+        switch( mask & (OUT_xyz | OUT_r) ) {
+        XYZ_case( 1 );
+        XYZ_case( 2 );
+        XYZ_case( 3 );
+        XYZ_case( 4 );
+        XYZ_case( 5 );
+        XYZ_case( 6 );
+        XYZ_case( 7 );
+        XYZ_case( 8 );
+        XYZ_case( 9 );
+        XYZ_case( 10 );
+        XYZ_case( 11 );
+        XYZ_case( 12 );
+        XYZ_case( 13 );
+        XYZ_case( 14 );
+        XYZ_case( 15 );
+        }
+
+#undef XYZ_case
+}
+
+
+static inline void xyzkern( int n, double *lat, double *lon, double *hgt,
+                            double *x, double *y, double *z, double *r,
+                            struct ellipsoid *ell, const int mask )
+/********1*********2*********3*********4*********5*********6*********7*********
+ * purpose:         the kernel of plh2xyzv_avx2 for the outputs in mask
+ *                  (r is g1, before the longitude).  Called with a
+ *                  constant mask, what is not wanted drops out; those
+ *                  arrays are not touched and may be NULL.
+ ********1*********2*********3*********4*********5*********6*********7*********/
+
+{
+        double bh[4];
+        double blat[4];
+        double blon[4];
+        double br[4];
+        double bx[4];
+        double by[4];
+        double bz[4];
+        int i;
+        int k;
+        int lanes;
+        __m256d vA= vconst( ell->A );
+        __m256d flatfn= vconst( ell->e2 );
+        __m256d funsq= vconst( ell->funsq );
+        __m256d clat;
+        __m256d clon;
+        __m256d g1;
+        __m256d g2;
+        __m256d h;
+        __m256d slat;
+        __m256d slon;
+
+        for( i= 0; i < n; i+= 4 ) {
+                lanes= n - i < 4 ? n - i : 4;
+                if( lanes == 4 ) {
+                        vsincos( _mm256_mul_pd( vconst( deg_to_rad ),
+                                 _mm256_loadu_pd( lat + i ) ), &slat, &clat );
+                        if( mask & (OUT_x | OUT_y) )
+                                vsincos( _mm256_mul_pd( vconst( deg_to_rad ),
+                                         _mm256_loadu_pd( lon + i ) ),
+                                         &slon, &clon );
+                        h= _mm256_loadu_pd( hgt + i );
+                } else {
+                        for( k= 0; k < 4; k++ ) {
+                                blat[k]= k < lanes ? lat[i+k] : ZERO;
+                                blon[k]= k < lanes && mask & (OUT_x | OUT_y)
+                                         ? lon[i+k] : ZERO;
+                                bh[k]= k < lanes ? hgt[i+k] : ZERO;
+                        }
+                        vsincos( _mm256_mul_pd( vconst( deg_to_rad ),
+                                 _mm256_loadu_pd( blat ) ), &slat, &clat );
+                        if( mask & (OUT_x | OUT_y) )
+                                vsincos( _mm256_mul_pd( vconst( deg_to_rad ),
+                                         _mm256_loadu_pd( blon ) ),
+                                         &slon, &clon );
+                        h= _mm256_loadu_pd( bh );
+                }
+
+                g1= _mm256_div_pd( vA, _mm256_sqrt_pd( _mm256_fnmadd_pd(
+                        _mm256_mul_pd( flatfn, slat ), slat,
+                        vconst( ONE ) ) ) );
+                g2= _mm256_fmadd_pd( g1, funsq, h );
+                g1= _mm256_mul_pd( _mm256_add_pd( g1, h ), clat );
+
+                if( lanes == 4 ) {
+                        if( mask & OUT_x )
+                                _mm256_storeu_pd( x + i,
+                                                  _mm256_mul_pd( g1, clon ) );
+                        if( mask & OUT_y )
+                                _mm256_storeu_pd( y + i,
+                                                  _mm256_mul_pd( g1, slon ) );
+                        if( mask & OUT_z )
+                                _mm256_storeu_pd( z + i,
+                                                  _mm256_mul_pd( g2, slat ) );
+                        if( mask & OUT_r )
+                                _mm256_storeu_pd( r + i, g1 );
+                } else {
+                        if( mask & (OUT_x | OUT_y) ) {
+                                _mm256_storeu_pd( bx,
+                                                  _mm256_mul_pd( g1, clon ) );
+                                _mm256_storeu_pd( by,
+                                                  _mm256_mul_pd( g1, slon ) );
+                        }
+                        _mm256_storeu_pd( bz, _mm256_mul_pd( g2, slat ) );
+                        _mm256_storeu_pd( br, g1 );
+                        for( k= 0; k < lanes; k++ ) {
+                                if( mask & OUT_x )
+                                        x[i+k]= bx[k];
+                                if( mask & OUT_y )
+                                        y[i+k]= by[k];
+                                if( mask & OUT_z )
+                                        z[i+k]= bz[k];
+                                if( mask & OUT_r )
+                                        r[i+k]= br[k];
+                        }
+                }
+        }
+}
+
+#else
+
+void plh2xyzv_avx2( int n, double *lat, double *lon, double *hgt,
+                    double *x, double *y, double *z,
+                    struct ellipsoid *ell )
+{
+        double plh[3];
+        double xyz[3];
+        int i;
+
+        for( i= 0; i < n; i++ ) {
+                plh[0]= lat[i];
+                plh[1]= lon[i];
+                plh[2]= hgt[i];
+                plh2xyze( plh, xyz, ell );
+                x[i]= xyz[0];
+                y[i]= xyz[1];
+                z[i]= xyz[2];
+        }
+}
+
+
+void plh2xyzov_avx2( int n, int mask, double *lat, double *lon, double *hgt,
+                     double *x, double *y, double *z, double *r,
+                     struct ellipsoid *ell )
+{
+        double g1;
+        double g2;
+        double sin_lat;
+        int i;
+
+        for( i= 0; i < n; i++ ) {
+                sin_lat= sin( deg_to_rad * lat[i] );
+                g1= ell->A / sqrt( ONE - ell->e2*sin_lat*sin_lat );
+                g2= g1*ell->funsq + hgt[i];
+                g1= (g1 + hgt[i]) * cos( deg_to_rad * lat[i] );
+                if( mask & OUT_x )
+                        x[i]= g1 * cos( deg_to_rad * lon[i] );
+                if( mask & OUT_y )
+                        y[i]= g1 * sin( deg_to_rad * lon[i] );
+                if( mask & OUT_z )
+                        z[i]= g2 * sin_lat;
+                if( mask & OUT_r )
+                        r[i]= g1;
+        }
+}
+
+#endif /* __AVX2__ */
@@ -0,0 +1,246 @@
+/*  @(#)plh2xyzv.c      1.0  26/10/18  */
+static char *sccsid= "@(#)plh2xyzv.c    1.0  26/10/18";
+/*
+ *  include files
+ */
+
+#include <math.h>
+#include "physcon.h"
+#include "libgpsC.h"
+
+/*
+ *  function prototypes
+ */
+
+void plh2xyzov( int, int, double *, double *, double *,
+                double *, double *, double *, double *, struct ellipsoid * );
+void plh2xyzov_avx2( int, int, double *, double *, double *,
+                     double *, double *, double *, double *,
+                     struct ellipsoid * );
+void plh2xyzv( int, double *, double *, double *,
+               double *, double *, double *, struct ellipsoid * );
+void plh2xyzv_avx2( int, double *, double *, double *,
+                    double *, double *, double *, struct ellipsoid * );
+static inline void xyzokern( int, double *, double *, double *,
+                             double *, double *, double *, double *,
+                             struct ellipsoid *, const int );
+
+/*
+ *  global definitions and variables
+ */
+
+
+void plh2xyzv( int n, double *lat, double *lon, double *hgt,
+               double *x, double *y, double *z, struct ellipsoid *ell )
+/********1*********2*********3*********4*********5*********6*********7*********
+ * name:            plh2xyzv
+ * version:         2610.18
+ * written by:      geoData
+ * purpose:         converts arrays of elliptic lat, lon, hgt to geocentric
+ *                  X, Y, Z; batch, structure-of-arrays form of plh2xyz
+ *
+ * input parameters
+ * ----------------
+ * ell              ellipsoid, with its derived constants (ellset)
+ * n                number of points
+ * lat[], lon[]     geodetic latitude and longitude east of Greenwich
+ *                  [degrees]
+ * hgt[]            height above the ellipsoid [m]
+ *
+ * output parameters
+ * -----------------
+ * x[], y[], z[]    geocentric Cartesian coordinates [m]
+ *
+ * calls:
+ * ------------------------------
+ * plh2xyzs         GRS80 and WGS84 kernels (xyz2plhs.c)
+ * plh2xyzv_avx2    AVX2 kernel (plh2xyza.c)
+ * simd_level       vector instruction level of this processor
+ *
+ * comments:
+ * ------------------------------
+ * The ellipsoid terms (2-f)f and (1-f)^2 come from the ellipsoid
+ * rather than being computed for each point, and each output is
+ * written once.  With
+ * AVX2 and FMA the points go four at a time through plh2xyzv_avx2 with
+ * a vector sincos; otherwise GRS80 and WGS84 go through the kernels
+ * compiled for them (plh2xyzs) and other ellipsoids through the loop
+ * below.  Both are plh2xyz with the same order of operations and so
+ * give identical results.
+ * The output arrays may not overlap the input ones.
+ *
+ * Compared to plh2xyz on geo_4277_Points/fi_lam_h(4277).txt the AVX2
+ * kernel gives X, Y and Z within 3 ulp of max(|X|, |Y|, |Z|).
+ *
+ * see also:
+ * ------------------------------
+ * plh2xyz, xyz2plhv
+ *
+ ********1*********2*********3*********4*********5*********6*********7*********
+ *:modification history
+ *:2610.18, GD, Creation
+ *:2610.18, GD, Ellipsoid from the registry rather than A, FL
+ *:2610.18, GD, Specialized scalar kernels for GRS80 and WGS84
+ ********1*********2*********3*********4*********5*********6*********7*********/
+
+{
+        double A= ell->A;
+        double flatfn= ell->e2;
+        double funsq= ell->funsq;
+        double g1;
+        double g2;
+        double lat_rad;
+        double lon_rad;
+        double sin_lat;
+        int i;
+
+        if( simd_level() >= 1 ) {
+                plh2xyzv_avx2( n, lat, lon, hgt, x, y, z, ell );
+                return;
+        }
+        if( plh2xyzs( n, lat, lon, hgt, x, y, z, ell ) == 0 )
+                return;
+
+        for( i= 0; i < n; i++ ) {
+                lat_rad= deg_to_rad * lat[i];
+                lon_rad= deg_to_rad * lon[i];
+                sin_lat= sin( lat_rad );
+
+                g1= A / sqrt( ONE - flatfn*sin_lat*sin_lat );
+                g2= g1*funsq + hgt[i];
+                g1= (g1 + hgt[i]) * cos( lat_rad );
+
+                x[i]= g1 * cos( lon_rad );
+                y[i]= g1 * sin( lon_rad );
+                z[i]= g2 * sin_lat;
+        }
+}
+
+
+void plh2xyzov( int n, int mask, double *lat, double *lon, double *hgt,
+                double *x, double *y, double *z, double *r,
+                struct ellipsoid *ell )
+/********1*********2*********3*********4*********5*********6*********7*********
+ * name:            plh2xyzov
+ * version:         2610.18
+ * written by:      geoData
+ * purpose:         plh2xyzv computing only the outputs asked for, and
+ *                  the distance from the Z axis
+ *
+ * input parameters
+ * ----------------
+ * ell              ellipsoid, with its derived constants (ellset)
+ * mask             outputs wanted, OUT_x | OUT_y | OUT_z | OUT_r
+ *                  (xyzbat.h)
+ * n                number of points
+ * lat[], lon[]     geodetic latitude and longitude east of Greenwich
+ *                  [degrees]
+ * hgt[]            height above the ellipsoid [m]
+ *
+ * output parameters
+ * -----------------
+ * x[], y[], z[]    geocentric Cartesian coordinates [m], if in mask
+ * r[]              distance from the Z axis, sqrt(X^2 + Y^2) [m], if
+ *                  in mask
+ *
+ * calls:
+ * ------------------------------
+ * plh2xyzov_avx2   AVX2 kernel (plh2xyza.c)
+ * plh2xyzv         all of X, Y, Z
+ * simd_level       vector instruction level of this processor
+ *
+ * comments:
+ * ------------------------------
+ * Arrays not in mask are not touched and may be NULL; lon[] is not
+ * read without X or Y.  X, Y, Z alone go to plh2xyzv.  Otherwise,
+ * with AVX2 and FMA, plh2xyzov_avx2 gives the results of plh2xyzv
+ * for the outputs wanted; without, xyzokern does the same for the
+ * loop of plh2xyzv.  Either way r, Z (as rZ.txt) needs no sin or cos
+ * of the longitude, and Z alone no cos of the latitude.  r is
+ * (N + h)cos(Phi) as X and Y are made from, so X = r cos(Lambda) to
+ * the last bit.
+ *
+ ********1*********2*********3*********4*********5*********6*********7*********
+ *:modification history
+ *:2610.18, GD, Creation
+ ********1*********2*********3*********4*********5*********6*********7*********/
+
+{
+        mask&= OUT_xyz | OUT_r;
+        if( mask == OUT_xyz ) {
+                plh2xyzv( n, lat, lon, hgt, x, y, z, ell );
+                return;
+        }
+        if( simd_level() >= 1 ) {
+                plh2xyzov_avx2( n, mask, lat, lon, hgt, x, y, z, r, ell );
+                return;
+        }
+
+#define XYZ_case( m )   case m: \
+        xyzokern( n, lat, lon, hgt, x, y, z, r, ell, m ); break
+
+        switch( mask ) {
+        XYZ_case( 1 );
+        XYZ_case( 2 );
+        XYZ_case( 3 );
+        XYZ_case( 4 );
+        XYZ_case( 5 );
+        XYZ_case( 6 );
+        XYZ_case( 8 );
+        XYZ_case( 9 );
+        XYZ_case( 10 );
+        XYZ_case( 11 );
+        XYZ_case( 12 );
+        XYZ_case( 13 );
+        XYZ_case( 14 );
+        XYZ_case( 15 );
+        }
+
+#undef XYZ_case
+}
+
+
+static inline void xyzokern( int n, double *lat, double *lon, double *hgt,
+                             double *x, double *y, double *z, double *r,
+                             struct ellipsoid *ell, const int mask )
+/********1*********2*********3*********4*********5*********6*********7*********
+ * purpose:         the loop of plh2xyzv for the outputs in mask, in the
+ *                  same order of operations.  Called with a constant
+ *                  mask, one copy of the loop per mask.
+ ********1*********2*********3*********4*********5*********6*********7*********/
+
+{
+        double A= ell->A;
+        double flatfn= ell->e2;
+        double funsq= ell->funsq;
+        double g1;
+        double g2;
+        double lat_rad;
+        double lon_rad;
+        double sin_lat;
+        int i;
+
+        for( i= 0; i < n; i++ ) {
+                lat_rad= deg_to_rad * lat[i];
+                sin_lat= sin( lat_rad );
+
+                g1= A / sqrt( ONE - flatfn*sin_lat*sin_lat );
+                if( mask & OUT_z ) {
+                        g2= g1*funsq + hgt[i];
+                        z[i]= g2 * sin_lat;
+                }
+                if( !( mask & (OUT_x | OUT_y | OUT_r) ) )
+                        continue;
+                g1= (g1 + hgt[i]) * cos( lat_rad );
+
+                if( mask & OUT_r )
+                        r[i]= g1;
+                if( mask & (OUT_x | OUT_y) ) {
+                        lon_rad= deg_to_rad * lon[i];
+                        if( mask & OUT_x )
+                                x[i]= g1 * cos( lon_rad );
+                        if( mask & OUT_y )
+                                y[i]= g1 * sin( lon_rad );
+                }
+        }
+}
@@ -0,0 +1,118 @@
+/*  @(#)plhmemo.h       1.0  26/10/18  */
+/********1*********2*********3*********4*********5*********6*********7*********
+ * name:            plhmemo.h
+ * version:         2610.18
+ * written by:      geoData
+ * purpose:         memo of X, Y, Z -> lat, lon, hgt conversions of
+ *                  repeat stations, shared by threads
+ *
+ * global variables and constants
+ * ------------------------------
+ * MEMO_nshard      number of shards of a memo, each with its own lock
+ * MEMO_axis        a point nearer the Z axis than MEMO_axis*q is not
+ *                  corrected, but converted
+ *
+ * plh_entry, one memoized conversion:
+ *    key[]         X, Y, Z in units of q, rounded
+ *    A, FL         ellipsoid of the conversion
+ *    xyz[]         X, Y, Z converted [m]
+ *    plh[]         their lat, lon [deg], hgt [m]
+ *    J[]           d(lat, lon, hgt)/d(X, Y, Z), by rows [deg/m, 1]; J[0]
+ *                  is NaN when the entry is too near the Z axis to be
+ *                  corrected
+ *
+ * plh_shard, one part of a memo:
+ *    lock          held while the shard is searched or added to
+ *    size          number of slots, a power of 2
+ *    n             number of entries held
+ *    max           most entries held, size/2
+ *    slot[]        1 + the entry of a slot, 0 = empty; open addressed
+ *                  by a hash of the key
+ *    e[]           the entries, in the order added
+ *    hit           lookups of a point memoized exactly
+ *    near          lookups of another point of a memoized cell
+ *    miss          lookups converted; shard 0 also counts the points
+ *                  not to be memoized, so hit + near + miss over the
+ *                  shards is every lookup
+ *
+ * plh_memo, the memo:
+ *    q             size of a cell [m]
+ *    lin           = 1 = correct a point of a memoized cell by J
+ *    sh[]          the shards, chosen by the hash of the key
+ *
+ * functions
+ * ------------------------------
+ * plhmfree:        frees a memo made by plhminit
+ * plhminit:        makes an empty memo
+ * plhmstat:        counts of a memo's lookups
+ * xyz2plhm:        X, Y, Z to lat, lon, hgt through a memo
+ * xyz2plhmv:       xyz2plhm on arrays (batch)
+ *
+ * comments:
+ * ------------------------------
+ * A job over many epochs of a few thousand stations converts the same
+ * X, Y, Z, or nearly, again and again.  The memo keeps the conversion
+ * (xyz2plhe, or xyz2plhv in a batch) of the first point met in each
+ * cell of q m, so a repeat is one hash lookup rather than the
+ * trigonometry.  Another point of the cell gets the memoized lat, lon,
+ * hgt, which are within q*sqrt(3) of its own, or with lin those plus
+ * J times its offset from the memoized point, which are within about
+ * d^2/p, d the offset and p the distance from the Z axis, at most
+ * 3e-3 q.
+ *
+ * The shards are locked one at a time, and not while converting, so
+ * threads converting different stations seldom wait for each other.
+ * Entries stay until plhmfree; a full shard converts but keeps no
+ * more.  Which point of a cell is memoized first, and so what the
+ * others get, depends on the order threads reach it.
+ *
+ ********1*********2*********3*********4*********5*********6*********7*********
+ *:modification history
+ *:2610.18, GD, Creation
+ *:2610.18, GD, Count the points not memoized as misses
+ ********1*********2*********3*********4*********5*********6*********7*********/
+
+#ifndef plhmemo_h
+#define plhmemo_h
+
+#include <pthread.h>
+#include "ellips.h"
+
+#define MEMO_nshard     ((int)16)
+#define MEMO_axis       ((double)1000.0)
+
+struct plh_entry {
+        long long key[3];
+        double A;
+        double FL;
+        double xyz[3];
+        double plh[3];
+        double J[9];
+};
+
+struct plh_shard {
+        pthread_mutex_t lock;
+        int    size;
+        int    n;
+        int    max;
+        int   *slot;
+        struct plh_entry *e;
+        long   hit;
+        long   near;
+        long   miss;
+};
+
+struct plh_memo {
+        double q;
+        int    lin;
+        struct plh_shard sh[MEMO_nshard];
+};
+
+void plhmfree( struct plh_memo * );
+int plhminit( struct plh_memo *, int, double, int );
+void plhmstat( struct plh_memo *, long *, long *, long *, int * );
+int xyz2plhm( struct plh_memo *, double *, double *, struct ellipsoid * );
+void xyz2plhmv( struct plh_memo *, int, double *, double *, double *,
+                double *, double *, double *, struct ellipsoid * );
+
+#endif /* plhmemo_h */
@@ -59,6 +59,28 @@
  *
  *                  Currently (9506.18) all values are in meters.
  *
+ *                  The file is written with 4 byte longs, so the structures
+ *                  below match it only where long is 4 bytes.  The mapped
+ *                  reader (siindex.c) takes each field at its byte offset in
+ *                  the record instead; in the record, after the SIZE, the
+ *                  common piece is modmjd, modday, type, valmjd, valday,
+ *                  key, id, seq, as in common_data_info.
+ *
+ *                  si_entry, one record in the index of a mapped file:
+ *                    stid   key, id and seq of the record, as in the file
+ *                    valmjd first valid epoch [MJD]
+ *                    valday first valid epoch [day]
+ *                    off    offset of the leading SIZE in the file
+ *                    size   SIZE of the record
+ *
+ *                  si_file, a mapped station information file:
+ *                    base   the mapping
+ *                    len    length of the file [char]
+ *                    swap   = 1 = the file is in the other byte order
+ *                    n      number of records
+ *                    rec[]  index of the records, by key, id, seq and
+ *                           first valid epoch, then by place in the file
+ *
  * see also:
  *
  ********1*********2*********3*********4*********5*********6*********7*********
@@ -76,6 +98,7 @@
  *:9904.23, MSS, Change antenna record length to account for padding.
  *:0003.23, MSS, Corrected met structure by adding a 4-byte dummy variable
  *:              making the structure fit to an even 8-byte boundary.
+ *:2610.18, GD,  Add si_entry, si_file, the mapped and indexed reader.
  ********1*********2*********3*********4*********5*********6*********7*********/
 
 #ifndef sidata_h
@@ -307,6 +330,25 @@ struct receiver_m1 {
         long   size;
 };
 
+/*
+ * index of a mapped station information file
+ */
+struct si_entry {
+        char   stid[1+MAX_id+MAX_seq];
+        long   valmjd;
+        double valday;
+        long   off;
+        int    size;
+};
+
+struct si_file {
+        char   *base;
+        long   len;
+        int    swap;
+        int    n;
+        struct si_entry *rec;
+};
+
 /*
  * library function prototypes
  */
@@ -315,5 +357,12 @@ void flip_double( double * );
 void flip_long( long * );
 int recgetmi( FILE * );
 int recgetnext( FILE * );
+void siclose( struct si_file * );
+struct si_entry *sifind( struct si_file *, int, char *, long, double );
+int sigetA( struct si_file *, struct si_entry *, struct common_data_info *,
+            struct antenna * );
+int sigetC( struct si_file *, struct si_entry *, struct common_data_info *,
+            struct coordinates * );
+int siopen( struct si_file *, char * );
 
 #endif /* sidata_h */
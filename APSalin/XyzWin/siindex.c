@@ -0,0 +1,461 @@
+/*  @(#)siindex.c       1.0  26/10/18  */
+static char *sccsid= "@(#)siindex.c     1.0  26/10/18";
+/*
+ *  include files
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include "sidata.h"
+
+/*
+ *  function prototypes
+ */
+
+void siclose( struct si_file * );
+struct si_entry *sifind( struct si_file *, int, char *, long, double );
+int sigetA( struct si_file *, struct si_entry *, struct common_data_info *,
+            struct antenna * );
+int sigetC( struct si_file *, struct si_entry *, struct common_data_info *,
+            struct coordinates * );
+int siopen( struct si_file *, char * );
+static int sicmp( const void *, const void * );
+static void sicommon( struct si_file *, char *, struct common_data_info * );
+static double sird8( struct si_file *, char * );
+static long sird4( struct si_file *, char * );
+static long siframe( char *, long, long, int );
+
+/*
+ *  definitions and global variables
+ *
+ *  SI_common        length of the common piece, with the leading SIZE
+ *  SI_sizeA         SIZE of a current (type -2) antenna record
+ *  SI_sizeA_m1      SIZE of an original (type -1) antenna record
+ *  SI_sizeC         SIZE of a coordinates record
+ */
+
+#define SI_common       40
+#define SI_sizeA        192
+#define SI_sizeA_m1     232
+#define SI_sizeC        288
+
+
+
+int siopen( struct si_file *sf, char *path )
+/********1*********2*********3*********4*********5*********6*********7*********
+ * name:            siopen
+ * version:         2610.18
+ * written by:      geoData
+ * purpose:         maps a station information file and indexes its
+ *                  records
+ *
+ * input parameters
+ * ----------------
+ * path             name of the file
+ *
+ * output parameters
+ * -----------------
+ * sf               the mapping and its index
+ *
+ * returns the number of records, or -1 if the file cannot be mapped or
+ * a record's leading and trailing SIZE do not agree
+ *
+ * calls:
+ * ------------------------------
+ * siframe          checks the framing of one record
+ *
+ * comments:
+ * ------------------------------
+ * The byte order is found from the first record: its SIZE must frame
+ * it in one order or the other.  The framing of every record is then
+ * checked once, here, and only the key, id, seq and valid epoch are
+ * read (and swapped) for the index; the rest of a record is decoded
+ * when it is asked for, by sigetA or sigetC.
+ *
+ ********1*********2*********3*********4*********5*********6*********7*********
+ *:modification history
+ *:2610.18, GD, Creation
+ ********1*********2*********3*********4*********5*********6*********7*********/
+
+{
+        struct stat st;
+        struct si_entry *e;
+        FILE *fp;
+        void *base;
+        long off;
+        long sz;
+        int i;
+        int n;
+
+        memset( sf, 0, sizeof(*sf) );
+        if( (fp= fopen( path, "rb" )) == NULL )
+                return( -1 );
+        if( fstat( fileno( fp ), &st ) != 0 || st.st_size < SI_common + 4 ) {
+                fclose( fp );
+                return( -1 );
+        }
+        base= mmap( NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE,
+                    fileno( fp ), 0 );
+        fclose( fp );
+        if( base == MAP_FAILED )
+                return( -1 );
+        sf->base= (char *)base;
+        sf->len= (long)st.st_size;
+
+        if( siframe( sf->base, sf->len, 0L, 0 ) < 0 ) {
+                sf->swap= 1;
+                if( siframe( sf->base, sf->len, 0L, 1 ) < 0 ) {
+                        siclose( sf );
+                        return( -1 );
+                }
+        }
+
+        for( n= 0, off= 0; off < sf->len; n++, off+= sz + 8 )
+                if( (sz= siframe( sf->base, sf->len, off, sf->swap )) < 0 ) {
+                        siclose( sf );
+                        return( -1 );
+                }
+
+        sf->rec= (struct si_entry *)malloc( (n > 0 ? n : 1)
+                                            * sizeof(struct si_entry) );
+        if( sf->rec == NULL ) {
+                siclose( sf );
+                return( -1 );
+        }
+        for( i= 0, off= 0; i < n; i++, off+= e->size + 8 ) {
+                e= &sf->rec[i];
+                memcpy( e->stid, sf->base + off + 32, sizeof(e->stid) );
+                e->valmjd= sird4( sf, sf->base + off + 20 );
+                e->valday= sird8( sf, sf->base + off + 24 );
+                e->off= off;
+                e->size= (int)sird4( sf, sf->base + off );
+        }
+        sf->n= n;
+        qsort( sf->rec, (size_t)n, sizeof(struct si_entry), sicmp );
+
+        return( n );
+}
+
+
+void siclose( struct si_file *sf )
+/********1*********2*********3*********4*********5*********6*********7*********
+ * name:            siclose
+ * version:         2610.18
+ * written by:      geoData
+ * purpose:         unmaps a file mapped by siopen and frees its index
+ *
+ ********1*********2*********3*********4*********5*********6*********7*********
+ *:modification history
+ *:2610.18, GD, Creation
+ ********1*********2*********3*********4*********5*********6*********7*********/
+
+{
+        if( sf->base != NULL )
+                munmap( sf->base, (size_t)sf->len );
+        free( sf->rec );
+        memset( sf, 0, sizeof(*sf) );
+}
+
+
+struct si_entry *sifind( struct si_file *sf, int key, char *stid, long mjd,
+                         double day )
+/********1*********2*********3*********4*********5*********6*********7*********
+ * name:            sifind
+ * version:         2610.18
+ * written by:      geoData
+ * purpose:         finds the record of a station in force at an epoch
+ *
+ * input parameters
+ * ----------------
+ * day              epoch [day]
+ * key              record type, e.g. 'A', 'C'
+ * mjd              epoch [MJD]
+ * sf               indexed file
+ * stid             full station ID, id and seq (7 char, as stidcmp);
+ *                  a shorter string is blank padded
+ *
+ * returns the entry of the record with the latest first valid epoch at
+ * or before mjd + day (of those, the last in the file), or NULL if the
+ * station has none
+ *
+ * comments:
+ * ------------------------------
+ * One binary search of the index, for the first entry after (key,
+ * stid, epoch); the entry before it is the answer if it is of the same
+ * key and station.
+ *
+ ********1*********2*********3*********4*********5*********6*********7*********
+ *:modification history
+ *:2610.18, GD, Creation
+ ********1*********2*********3*********4*********5*********6*********7*********/
+
+{
+        char want[1+MAX_id+MAX_seq];
+        struct si_entry *e;
+        int c;
+        int i;
+        int hi= sf->n;
+        int lo= 0;
+        int mid;
+
+        want[0]= (char)key;
+        for( i= 0; i < MAX_id + MAX_seq; i++ )
+                want[1+i]= ' ';
+        for( i= 0; i < MAX_id + MAX_seq && stid[i] != '\0'; i++ )
+                want[1+i]= stid[i];
+
+        while( lo < hi ) {
+                mid= lo + ( hi - lo ) / 2;
+                e= &sf->rec[mid];
+                c= memcmp( e->stid, want, sizeof(want) );
+                if( c == 0 )
+                        c= e->valmjd < mjd ? -1 : e->valmjd > mjd ? 1
+                           : e->valday > day ? 1 : -1;
+                if( c < 0 )
+                        lo= mid + 1;
+                else
+                        hi= mid;
+        }
+        if( lo == 0 )
+                return( NULL );
+        e= &sf->rec[lo-1];
+        if( memcmp( e->stid, want, sizeof(want) ) != 0 )
+                return( NULL );
+
+        return( e );
+}
+
+
+int sigetA( struct si_file *sf, struct si_entry *e,
+            struct common_data_info *cdi, struct antenna *ant )
+/********1*********2*********3*********4*********5*********6*********7*********
+ * name:            sigetA
+ * version:         2610.18
+ * written by:      geoData
+ * purpose:         decodes an antenna record of a mapped file
+ *
+ * input parameters
+ * ----------------
+ * e                entry of the record, from sifind
+ * sf               indexed file
+ *
+ * output parameters
+ * -----------------
+ * ant              antenna offsets and names, in this machine's order;
+ *                  from an original (type -1) record the shorter name
+ *                  is blank padded
+ * cdi              common piece of the record
+ *
+ * returns 0, or -1 if e is not an antenna record
+ *
+ ********1*********2*********3*********4*********5*********6*********7*********
+ *:modification history
+ *:2610.18, GD, Creation
+ ********1*********2*********3*********4*********5*********6*********7*********/
+
+{
+        char *r= sf->base + e->off;
+
+        if( e->stid[0] != 'A'
+            || ( e->size != SI_sizeA && e->size != SI_sizeA_m1 ) )
+                return( -1 );
+
+        sicommon( sf, r, cdi );
+        ant->n= sird8( sf, r + 40 );
+        ant->e= sird8( sf, r + 48 );
+        ant->u= sird8( sf, r + 56 );
+        memcpy( ant->from, r + 64, MAX_from );
+        memcpy( ant->to, r + 80, MAX_to );
+        memset( ant->dummy, 0, sizeof(ant->dummy) );
+        if( e->size == SI_sizeA ) {
+                memcpy( ant->name, r + 96, MAX_name );
+                memcpy( ant->sn, r + 116, MAX_sn );
+                memcpy( ant->comment, r + 132, MAX_comment );
+        } else {
+                memset( ant->name, ' ', MAX_name );
+                memcpy( ant->name, r + 144, MAX_name_m1 );
+                memcpy( ant->sn, r + 160, MAX_sn );
+                memcpy( ant->comment, r + 176, MAX_comment );
+        }
+        ant->size= e->size;
+
+        return( 0 );
+}
+
+
+int sigetC( struct si_file *sf, struct si_entry *e,
+            struct common_data_info *cdi, struct coordinates *crd )
+/********1*********2*********3*********4*********5*********6*********7*********
+ * name:            sigetC
+ * version:         2610.18
+ * written by:      geoData
+ * purpose:         decodes a coordinates record of a mapped file
+ *
+ * input parameters
+ * ----------------
+ * e                entry of the record, from sifind
+ * sf               indexed file
+ *
+ * output parameters
+ * -----------------
+ * cdi              common piece of the record
+ * crd              coordinates, velocities and names, in this machine's
+ *                  order
+ *
+ * returns 0, or -1 if e is not a coordinates record
+ *
+ ********1*********2*********3*********4*********5*********6*********7*********
+ *:modification history
+ *:2610.18, GD, Creation
+ ********1*********2*********3*********4*********5*********6*********7*********/
+
+{
+        char *r= sf->base + e->off;
+        double v[12];
+        int i;
+
+        if( e->stid[0] != 'C' || e->size != SI_sizeC )
+                return( -1 );
+
+        sicommon( sf, r, cdi );
+        for( i= 0; i < 12; i++ )
+                v[i]= sird8( sf, r + 40 + 8*i );
+        crd->x= v[0];
+        crd->y= v[1];
+        crd->z= v[2];
+        crd->xsig= v[3];
+        crd->ysig= v[4];
+        crd->zsig= v[5];
+        crd->vx= v[6];
+        crd->vy= v[7];
+        crd->vz= v[8];
+        crd->vxsig= v[9];
+        crd->vysig= v[10];
+        crd->vzsig= v[11];
+        crd->refday= sird8( sf, r + 136 );
+        crd->refmjd= sird4( sf, r + 144 );
+        memcpy( crd->frame, r + 148, MAX_frame );
+        memcpy( crd->domes, r + 155, MAX_domes );
+        memcpy( crd->plate, r + 164, MAX_plate );
+        memcpy( crd->sitename, r + 168, MAX_sitename );
+        memcpy( crd->altname, r + 192, MAX_altname );
+        memcpy( crd->comment, r + 232, MAX_comment );
+        crd->size= e->size;
+
+        return( 0 );
+}
+
+
+static long siframe( char *base, long len, long off, int swap )
+/********1*********2*********3*********4*********5*********6*********7*********
+ * purpose:         SIZE of the record at off, or -1 if it is too short,
+ *                  runs past len or its trailing SIZE differs
+ ********1*********2*********3*********4*********5*********6*********7*********/
+
+{
+        struct si_file sf;
+        long sz;
+
+        sf.swap= swap;
+        if( off + SI_common > len )
+                return( -1 );
+        sz= sird4( &sf, base + off );
+        if( sz < SI_common - 4 || sz > len - off - 8
+            || sird4( &sf, base + off + 4 + sz ) != sz )
+                return( -1 );
+
+        return( sz );
+}
+
+
+static void sicommon( struct si_file *sf, char *r,
+                      struct common_data_info *cdi )
+/********1*********2*********3*********4*********5*********6*********7*********
+ * purpose:         decodes the common piece of the record at r
+ ********1*********2*********3*********4*********5*********6*********7*********/
+
+{
+        cdi->size= sird4( sf, r );
+        cdi->modmjd= sird4( sf, r + 4 );
+        cdi->modday= sird8( sf, r + 8 );
+        cdi->type= sird4( sf, r + 16 );
+        cdi->valmjd= sird4( sf, r + 20 );
+        cdi->valday= sird8( sf, r + 24 );
+        cdi->key= r[32];
+        memcpy( cdi->id, r + 33, MAX_id );
+        cdi->seq= r[39];
+}
+
+
+static int sicmp( const void *a, const void *b )
+/********1*********2*********3*********4*********5*********6*********7*********
+ * purpose:         qsort order of the index: key, id, seq, first valid
+ *                  epoch, place in the file
+ ********1*********2*********3*********4*********5*********6*********7*********/
+
+{
+        const struct si_entry *p= (const struct si_entry *)a;
+        const struct si_entry *q= (const struct si_entry *)b;
+        int c= memcmp( p->stid, q->stid, sizeof(p->stid) );
+
+        if( c != 0 )
+                return( c );
+        if( p->valmjd != q->valmjd )
+                return( p->valmjd < q->valmjd ? -1 : 1 );
+        if( p->valday != q->valday )
+                return( p->valday < q->valday ? -1 : 1 );
+
+        return( p->off < q->off ? -1 : p->off > q->off );
+}
+
+
+static long sird4( struct si_file *sf, char *p )
+/********1*********2*********3*********4*********5*********6*********7*********
+ * purpose:         the 4 byte integer at p, swapped if the file is in
+ *                  the other byte order
+ ********1*********2*********3*********4*********5*********6*********7*********/
+
+{
+        unsigned char c[4];
+        unsigned char t;
+        int32_t v;
+
+        memcpy( c, p, 4 );
+        if( sf->swap ) {
+                t= c[0]; c[0]= c[3]; c[3]= t;
+                t= c[1]; c[1]= c[2]; c[2]= t;
+        }
+        memcpy( &v, c, 4 );
+
+        return( (long)v );
+}
+
+
+static double sird8( struct si_file *sf, char *p )
+/********1*********2*********3*********4*********5*********6*********7*********
+ * purpose:         the double at p, swapped if the file is in the other
+ *                  byte order
+ ********1*********2*********3*********4*********5*********6*********7*********/
+
+{
+        unsigned char c[8];
+        unsigned char t;
+        double v;
+        int i;
+
+        memcpy( c, p, 8 );
+        if( sf->swap )
+                for( i= 0; i < 4; i++ ) {
+                        t= c[i];
+                        c[i]= c[7-i];
+                        c[7-i]= t;
+                }
+        memcpy( &v, c, 8 );
+
+        return( v );
+}
@@ -0,0 +1,80 @@
+/*  @(#)topo.h          1.0  26/10/18  */
+/********1*********2*********3*********4*********5*********6*********7*********
+ * name:            topo.h
+ * version:         2610.18
+ * written by:      geoData
+ * purpose:         topocentric (north, east, up) frames of reference
+ *                  stations, for the batch rotations
+ *
+ * global variables and constants
+ * ------------------------------
+ * neu_station, the local frame of one station:
+ *    xyz[]         geocentric X, Y, Z of the station [m]
+ *    lat           geodetic latitude of the station [deg]
+ *    lon           longitude east of Greenwich of the station [deg]
+ *    R[]           rotation X, Y, Z -> N, E, U, by rows: R[0..2] is the
+ *                  north, R[3..5] the east, R[6..8] the up unit vector
+ *
+ * neu_cache, the frames of a set of stations, by X, Y, Z:
+ *    size          number of slots, a power of 2
+ *    n             number of stations held
+ *    max           most stations held, size/2
+ *    used[]        = 1 = slot holds a station
+ *    st[]          the stations, open addressed by a hash of X, Y, Z
+ *
+ * functions
+ * ------------------------------
+ * neu2xyzv:        rotates arrays of N, E, U vectors to X, Y, Z
+ * neufree:         frees a cache made by neuinit
+ * neuget:          the frame of a station, from a cache
+ * neuinit:         makes an empty cache
+ * neuset:          fills in the frame of a station
+ * xyz2neup:        arrays of X, Y, Z positions to N, E, U of a station
+ * xyz2neuv:        rotates arrays of X, Y, Z vectors to N, E, U
+ *
+ * comments:
+ * ------------------------------
+ * The rotation of a station is made once, by neuset, with the only
+ * trigonometry of the frame; the batch routines are then 9 multiply
+ * adds a vector.  neuget keeps the frames of repeat stations so a job
+ * over many epochs of a few hundred stations finds each frame by one
+ * hash lookup, without going through lat, lon again.
+ *
+ ********1*********2*********3*********4*********5*********6*********7*********
+ *:modification history
+ *:2610.18, GD, Creation
+ ********1*********2*********3*********4*********5*********6*********7*********/
+
+#ifndef topo_h
+#define topo_h
+
+#include "ellips.h"
+
+struct neu_station {
+        double xyz[3];
+        double lat;
+        double lon;
+        double R[9];
+};
+
+struct neu_cache {
+        int    size;
+        int    n;
+        int    max;
+        char  *used;
+        struct neu_station *st;
+};
+
+void neu2xyzv( struct neu_station *, int, double *, double *, double *,
+               double *, double *, double * );
+void neufree( struct neu_cache * );
+struct neu_station *neuget( struct neu_cache *, double *,
+                            struct ellipsoid * );
+int neuinit( struct neu_cache *, int );
+void neuset( struct neu_station *, double, double, double * );
+void xyz2neup( struct neu_station *, int, double *, double *, double *,
+               double *, double *, double * );
+void xyz2neuv( struct neu_station *, int, double *, double *, double *,
+               double *, double *, double * );
+
+#endif /* topo_h */
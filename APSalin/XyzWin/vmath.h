@@ -0,0 +1,218 @@
+/*  @(#)vmath.h         1.0  26/10/18  */
+/********1*********2*********3*********4*********5*********6*********7*********
+ * name:            vmath.h
+ * version:         2610.18
+ * written by:      geoData
+ * purpose:         AVX2 (4 x double) elementary functions for the batch
+ *                  conversion kernels
+ *
+ * functions
+ * ------------------------------
+ * vabs:            |x|
+ * vatan:           arc tangent [rad]
+ * vatan2:          arc tangent of y/x in (-pi, pi] [rad]
+ * vblend:          m ? a : b, lane by lane
+ * vcbrt:           real cube root, any sign
+ * vconst:          broadcast a double
+ * vsincos:         sine and cosine of an angle [rad]
+ *
+ * comments:
+ * ------------------------------
+ * Only for translation units compiled with -mavx2 -mfma; everything is
+ * static inline so each kernel file gets its own copy.
+ *
+ * vatan is the Cephes rational approximation with the same range
+ * reduction, good to about 1 ulp.  vcbrt starts from the fdlibm
+ * high-word estimate (hx/3 + B1), applies two Halley steps and a
+ * Newton step on an FMA-compensated residual, good to about 1 ulp.
+ * vsincos reduces by pi/2 in three parts (Cody-Waite) and uses the
+ * Cephes sin/cos polynomials on [-pi/4, pi/4], good to 2 ulp for
+ * |x| < 1e5 rad, far beyond any angle in degrees met here.
+ * None of these handles NaN specially; NaN in gives NaN out.
+ *
+ * references:
+ * ------------------------------
+ * Moshier, S. L. (1989). "Methods and Programs for Mathematical
+ * Functions", Ellis Horwood (Cephes library, atan.c, sin.c).
+ *
+ * Sun Microsystems (1993). fdlibm, s_cbrt.c.
+ *
+ ********1*********2*********3*********4*********5*********6*********7*********
+ *:modification history
+ *:2610.18, GD, Creation
+ ********1*********2*********3*********4*********5*********6*********7*********/
+
+#ifndef vmath_h
+#define vmath_h
+
+#ifdef __AVX2__
+
+#include <immintrin.h>
+
+#define vconst( c )     _mm256_set1_pd( (double)(c) )
+
+static inline __m256d vblend( __m256d m, __m256d a, __m256d b )
+{
+        return( _mm256_blendv_pd( b, a, m ) );
+}
+
+static inline __m256d vabs( __m256d x )
+{
+        return( _mm256_andnot_pd( vconst( -0.0 ), x ) );
+}
+
+static inline __m256d vatan( __m256d x )
+{
+        __m256d big;
+        __m256d mid;
+        __m256d p;
+        __m256d q;
+        __m256d sgn= _mm256_and_pd( x, vconst( -0.0 ) );
+        __m256d y;
+        __m256d z;
+
+        x= vabs( x );
+/*
+ *   reduce to |x| <= 0.66
+ */
+        big= _mm256_cmp_pd( x, vconst( 2.41421356237309504880 ), _CMP_GT_OQ );
+        mid= _mm256_andnot_pd( big,
+             _mm256_cmp_pd( x, vconst( 0.66 ), _CMP_GT_OQ ) );
+
+        y= vblend( big, vconst( 1.57079632679489661923 ),
+           vblend( mid, vconst( 0.78539816339744830962 ), vconst( 0.0 ) ) );
+        x= vblend( big, _mm256_div_pd( vconst( -1.0 ), x ),
+           vblend( mid, _mm256_div_pd( _mm256_sub_pd( x, vconst( 1.0 ) ),
+                                       _mm256_add_pd( x, vconst( 1.0 ) ) ),
+                   x ) );
+
+        z= _mm256_mul_pd( x, x );
+        p= _mm256_fmadd_pd( vconst( -8.750608600031904122785e-1 ), z,
+                            vconst( -1.615753718733365076637e1 ) );
+        p= _mm256_fmadd_pd( p, z, vconst( -7.500855792314704667340e1 ) );
+        p= _mm256_fmadd_pd( p, z, vconst( -1.228866684490136173410e2 ) );
+        p= _mm256_fmadd_pd( p, z, vconst( -6.485021904942025371773e1 ) );
+        q= _mm256_add_pd( z, vconst( 2.485846490142306297962e1 ) );
+        q= _mm256_fmadd_pd( q, z, vconst( 1.650270098316988542046e2 ) );
+        q= _mm256_fmadd_pd( q, z, vconst( 4.328810604912902668951e2 ) );
+        q= _mm256_fmadd_pd( q, z, vconst( 4.853903996359136964868e2 ) );
+        q= _mm256_fmadd_pd( q, z, vconst( 1.945506571482613964425e2 ) );
+        z= _mm256_div_pd( _mm256_mul_pd( z, p ), q );
+        z= _mm256_fmadd_pd( x, z, x );
+
+        z= _mm256_add_pd( z, vblend( big, vconst( 6.123233995736765886130e-17 ),
+                             vblend( mid, vconst( 3.061616997868382943065e-17 ),
+                                     vconst( 0.0 ) ) ) );
+        y= _mm256_add_pd( y, z );
+
+        return( _mm256_xor_pd( y, sgn ) );
+}
+
+static inline __m256d vatan2( __m256d y, __m256d x )
+{
+        __m256d ax= vabs( x );
+        __m256d ay= vabs( y );
+        __m256d hi= _mm256_max_pd( ax, ay );
+        __m256d lo= _mm256_min_pd( ax, ay );
+        __m256d a;
+        __m256d zero= _mm256_cmp_pd( hi, vconst( 0.0 ), _CMP_EQ_OQ );
+
+        a= vatan( _mm256_div_pd( lo, vblend( zero, vconst( 1.0 ), hi ) ) );
+        a= vblend( _mm256_cmp_pd( ay, ax, _CMP_GT_OQ ),
+                   _mm256_sub_pd( vconst( 1.57079632679489661923 ), a ), a );
+        a= vblend( _mm256_cmp_pd( x, vconst( 0.0 ), _CMP_LT_OQ ),
+                   _mm256_sub_pd( vconst( 3.14159265358979323846 ), a ), a );
+
+        return( _mm256_or_pd( a, _mm256_and_pd( y, vconst( -0.0 ) ) ) );
+}
+
+static inline __m256d vcbrt( __m256d w )
+{
+        __m256d aw= vabs( w );
+        __m256d t;
+        __m256d t2;
+        __m256d t3;
+        __m256i hx;
+        int i;
+/*
+ *   t ~ |w|^(1/3) to about 5 bits: high word hx/3 + B1, low word 0
+ */
+        hx= _mm256_srli_epi64( _mm256_castpd_si256( aw ), 32 );
+        hx= _mm256_srli_epi64( _mm256_mul_epu32( hx,
+                               _mm256_set1_epi64x( 0xAAAAAAABLL ) ), 33 );
+        hx= _mm256_add_epi64( hx, _mm256_set1_epi64x( 715094163LL ) );
+        t= _mm256_castsi256_pd( _mm256_slli_epi64( hx, 32 ) );
+/*
+ *   Halley: t= t*(t^3 + 2w)/(2t^3 + w), then one Newton step on the
+ *   residual t^3 - w evaluated with FMA error terms
+ */
+        for( i= 0; i < 2; i++ ) {
+                t3= _mm256_mul_pd( _mm256_mul_pd( t, t ), t );
+                t= _mm256_mul_pd( t, _mm256_div_pd(
+                        _mm256_fmadd_pd( vconst( 2.0 ), aw, t3 ),
+                        _mm256_fmadd_pd( vconst( 2.0 ), t3, aw ) ) );
+        }
+        t2= _mm256_mul_pd( t, t );
+        t3= _mm256_fmadd_pd( _mm256_fmsub_pd( t, t, t2 ), t,
+                             _mm256_fmsub_pd( t2, t, aw ) );
+        t= _mm256_sub_pd( t, _mm256_div_pd( t3,
+                          _mm256_mul_pd( vconst( 3.0 ), t2 ) ) );
+        t= vblend( _mm256_cmp_pd( aw, vconst( 0.0 ), _CMP_EQ_OQ ),
+                   vconst( 0.0 ), t );
+
+        return( _mm256_or_pd( t, _mm256_and_pd( w, vconst( -0.0 ) ) ) );
+}
+
+static inline void vsincos( __m256d x, __m256d *s, __m256d *c )
+{
+        __m256d cp;
+        __m256d m;
+        __m256d q;
+        __m256d r;
+        __m256d sp;
+        __m256d z;
+/*
+ *   x = q*pi/2 + r, |r| <= pi/4; q taken modulo 4 below
+ */
+        q= _mm256_round_pd(
+                _mm256_mul_pd( x, vconst( 0.63661977236758134308 ) ),
+                _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC );
+        r= _mm256_fnmadd_pd( q, vconst( 1.57079625129699707031e0 ), x );
+        r= _mm256_fnmadd_pd( q, vconst( 7.54978941586159635336e-8 ), r );
+        r= _mm256_fnmadd_pd( q, vconst( 5.39030285815811905290e-15 ), r );
+        q= _mm256_sub_pd( q, _mm256_mul_pd( vconst( 4.0 ), _mm256_floor_pd(
+                          _mm256_mul_pd( q, vconst( 0.25 ) ) ) ) );
+
+        z= _mm256_mul_pd( r, r );
+        sp= _mm256_fmadd_pd( vconst( 1.58962301576546568060e-10 ), z,
+                             vconst( -2.50507477628578072866e-8 ) );
+        sp= _mm256_fmadd_pd( sp, z, vconst( 2.75573136213857245213e-6 ) );
+        sp= _mm256_fmadd_pd( sp, z, vconst( -1.98412698295895385996e-4 ) );
+        sp= _mm256_fmadd_pd( sp, z, vconst( 8.33333333332211858878e-3 ) );
+        sp= _mm256_fmadd_pd( sp, z, vconst( -1.66666666666666307295e-1 ) );
+        sp= _mm256_fmadd_pd( _mm256_mul_pd( r, z ), sp, r );
+        cp= _mm256_fmadd_pd( vconst( -1.13585365213876817300e-11 ), z,
+                             vconst( 2.08757008419747316778e-9 ) );
+        cp= _mm256_fmadd_pd( cp, z, vconst( -2.75573141792967388112e-7 ) );
+        cp= _mm256_fmadd_pd( cp, z, vconst( 2.48015872888517045348e-5 ) );
+        cp= _mm256_fmadd_pd( cp, z, vconst( -1.38888888888730564116e-3 ) );
+        cp= _mm256_fmadd_pd( cp, z, vconst( 4.16666666666665929218e-2 ) );
+        cp= _mm256_fmadd_pd( _mm256_mul_pd( z, z ), cp,
+                _mm256_fnmadd_pd( vconst( 0.5 ), z, vconst( 1.0 ) ) );
+/*
+ *   quadrants 1 and 3 swap sin and cos; 1, 2 negate cos, 2, 3 negate sin
+ */
+        m= _mm256_or_pd( _mm256_cmp_pd( q, vconst( 1.0 ), _CMP_EQ_OQ ),
+                         _mm256_cmp_pd( q, vconst( 3.0 ), _CMP_EQ_OQ ) );
+        *s= vblend( m, cp, sp );
+        *c= vblend( m, sp, cp );
+        *s= _mm256_xor_pd( *s, _mm256_and_pd( vconst( -0.0 ),
+                           _mm256_cmp_pd( q, vconst( 1.5 ), _CMP_GT_OQ ) ) );
+        m= _mm256_and_pd( _mm256_cmp_pd( q, vconst( 0.5 ), _CMP_GT_OQ ),
+                          _mm256_cmp_pd( q, vconst( 2.5 ), _CMP_LT_OQ ) );
+        *c= _mm256_xor_pd( *c, _mm256_and_pd( vconst( -0.0 ), m ) );
+}
+
+#endif /* __AVX2__ */
+
+#endif /* vmath_h */
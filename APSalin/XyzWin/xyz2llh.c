@@ -16,26 +16,55 @@ static char *sccsid= "@(#)xyz2llh.c     1.5  02/02/07";
  *
  * local variables and constants
  * -----------------------------
+ * bname            column file output name in file mode; "-" = stdout
+ * bp               column file output stream
  * c                command-line option
+ * colin            header of a column file input
+ * colout           header of the column file output
+ * custom           ellipsoid given as A,FL with -e, or that of a column
+ *                  file input not in the registry
  * display          = 1 = display latitude and longitude in deg min sec
  *                        rather than decimal degrees
+ * ell              ellipsoid of lat, lon, hgt
+ * ename            ellipsoid given with -e; NULL = GRS80
  * errflg           command-line error/usage print flag
+ * fp               input stream in file mode
+ * fname            input file name in file mode; "-" = stdin
+ * ftol             latitude tolerance of -s auto [arcsec]
+ * hit, near, miss  lookups of the memo: exact, near, converted
+ * k                length of a name of -o
+ * htol             height tolerance of -s auto [m]
  * i                loop counter
  * in[]             input coordinates
  * j                loop counter
+ * lin              = 1 = -m corrects nearby points by the Jacobian
+ * memo             memo of repeat stations of -m
+ * mname            memo cell size given with -m; NULL = no memo
+ * ncol             number of outputs of -o
+ * ocol[]           output column of each bit of mask
+ * oname            outputs given with -o; NULL = all three
+ * chk              one chunk of records in file mode
+ * cname[][]        names of the outputs of -o, by mode and bit of mask
+ * job              conversion options in file mode
+ * nthr             number of conversion threads in file mode
+ * mask             outputs of -o, OUT_...; 0 = all three
  * mode             display mode
  *                  = 0 = X, Y, Z -> lat, lon, hgt
  *                  = 1 = lat, lon, hgt -> X, Y, Z
  * out[]            output coordinates
  * pgm              program name
+ * q                memo cell size [m]
  * ptr              scratch string pointer
+ * sname            solver given with -s; NULL = borkowski
+ * solver           X, Y, Z -> lat, lon, hgt method, SOLV_...
+ * sta[]            X, Y, Z of the station given with -t
+ * station          north, east, up frame of the station
+ * tname            station given with -t; NULL = lat, lon, hgt output
  * vrsn             program version ID
  * west             = 1 = longitudes are west rather than east longitude
  *
  * global variables and constants
  * ------------------------------
- * eflat            Earth flattening factor
- * emajor           Earth's semi-major axis [m]
  * optarg           argument of an option flag
  * optind           parameter count of first argument after all flags
  * optopt           argument triggering an error in getopt
@@ -43,8 +72,24 @@ static char *sccsid= "@(#)xyz2llh.c     1.5  02/02/07";
  *
  * calls:
  * -----------------------------
- * plh2xyz          lat, lon, hgt to X, Y, Z
- * xyz2plh          X, Y, Z to lat, lon, hgt
+ * colell           ellipsoid of a column file input
+ * cvtfile          converts every record of a file, multi-threaded
+ * ellfind          looks up a registry ellipsoid
+ * ellparse         ellipsoid given with -e
+ * neuset           north, east, up frame of the -t station
+ * plhminit         makes the memo of -m
+ * plhmstat         counts of the lookups of the memo
+ * plh2xyze         lat, lon, hgt to X, Y, Z
+ * plh2xyzov        lat, lon, hgt to the X, Y, Z, r of -o
+ * xyz2neup         X, Y, Z to north, east, up from the -t station
+ * xyz2plhd         X, Y, Z to lat, lon, hgt by the cheapest solver
+ *                  meeting ftol, htol
+ * xyz2plhe         X, Y, Z to lat, lon, hgt
+ * xyz2plhh         X, Y, Z to lat, lon, hgt by one Halley correction
+ * xyz2plhhc        X, Y, Z to lat, lon, hgt by Halley to convergence
+ * xyz2plhmv        X, Y, Z to lat, lon, hgt through the memo of -m
+ * xyz2plhov        X, Y, Z to the lat, lon, hgt of -o
+ * xyz2plht         X, Y, Z to lat, lon, hgt by trilateration
  *
  * include files:
  * -----------------------------
@@ -58,6 +103,49 @@ static char *sccsid= "@(#)xyz2llh.c     1.5  02/02/07";
  *
  * comments:
  * -----------------------------
+ * With -f the program converts every record of a file (or stdin) in
+ * chunks of MAX_chunk points and writes buffered output in the same
+ * formats as the single point mode.  Header and comment lines are
+ * skipped.  The chunks are converted on all processors (or -j n
+ * threads); the output stays in input order.  A regular file (or
+ * stdin redirected from one) is mapped into memory, not copied.
+ * With -b the output is a column file of X, Y, Z or lat, lon, hgt
+ * (decimal degrees) instead; the input may also be a column file.
+ *
+ * The ellipsoid is GRS80 unless chosen with -e, by name from the
+ * registry (ellips.c) or as A,FL.  lat, lon, hgt column files carry
+ * their ellipsoid in the header and are converted on it, so files on
+ * different datums go through the same binary, each on its own.
+ *
+ * X, Y, Z are converted by Borkowski's closed form (xyz2plh) unless
+ * -s chooses the trilateration algorithm (trilat, xyz2plht), one
+ * Halley correction (halley, xyz2plhh) or Halley corrections to
+ * convergence (halleyc, xyz2plhhc).  -s auto,ftol,htol converts each
+ * point by the cheapest of these that is within ftol arcsec in
+ * latitude and htol m in height at its height (xyz2plhd); by default
+ * 1e-6 arcsec and 0.1 mm, which is one Halley correction from -1000
+ * to 1000 km and the closed form elsewhere.  A tolerance that no
+ * solver meets gets Halley to convergence, with a warning for a
+ * single point.
+ *
+ * With -t X,Y,Z the output is instead north, east, up [m] of each
+ * point from the station at X, Y, Z, in the local frame of the station
+ * on the ellipsoid, as "%13.4f" like X, Y, Z.  The frame is made once;
+ * every chunk is then rotated in one pass (xyz2neup).
+ *
+ * With -m q, for files of many epochs of the same stations, X, Y, Z
+ * go through a memo (plhmemo.h) of MAX_memo cells of q m: the first
+ * point of a cell is converted by Borkowski, the others get its lat,
+ * lon, hgt, within q*sqrt(3); with -m q,lin, those corrected to first
+ * order by its Jacobian, within about 3e-3 q.  The counts of the memo
+ * go to stderr at the end.
+ *
+ * With -o the -f output is only the columns listed, in that order:
+ * any of lat, lon, hgt, or with -r of X, Y, Z and r, the distance
+ * from the Z axis (-r -o r,Z as geo_4277_Points/rZ.txt).  The points
+ * go through xyz2plhov, plh2xyzov, which leave out the work of the
+ * outputs not wanted: a height alone, or r and Z, cost less than half
+ * the conversion.  The columns keep their formats.
  *
  * see also:
  * -----------------------------
@@ -67,6 +155,21 @@ static char *sccsid= "@(#)xyz2llh.c     1.5  02/02/07";
  *:9406.16, MSS, Convert from FORTRAN program wgs84.
  *:9901.21, MSS, Rewrite of xyz program.
  *:9901.28, MSS, Improve trap for negative coordinates.
+ *:2610.18, GD,  File mode fails on lines or records cut to fit.
+ *:2610.18, GD,  Add -o; only the outputs listed, in file mode.
+ *:2610.18, GD,  Add -m; a memo of repeat stations in file mode.
+ *:2610.18, GD,  -s auto; the cheapest solver meeting a tolerance.
+ *:2610.18, GD,  -d by dmsfmt; -0 degrees keep the sign, no 60 seconds.
+ *:2610.18, GD,  Add -t; north, east, up from a station.
+ *:2610.18, GD,  -s halley, halleyc.
+ *:2610.18, GD,  Add -s; trilateration solver.
+ *:2610.18, GD,  Add -e; ellipsoid from the registry.
+ *:2610.18, GD,  Add -b; column file input and output in file mode.
+ *:2610.18, GD,  Read values with numscan, as in file mode.
+ *:2610.18, GD,  Add -j; file mode converts on several threads.
+ *:2610.18, GD,  Add file/stream mode (-f); negative coordinates used
+ *:               optopt, which is only set on errors by some getopt's,
+ *:               and GNU getopt reordered them ahead of the positive ones.
  ********1*********2*********3*********4*********5*********6*********7********/
 
 /*
@@ -77,6 +180,7 @@ static char *sccsid= "@(#)xyz2llh.c     1.5  02/02/07";
 #include <stdlib.h>
 #include <string.h>
 #include <math.h>
+#include <unistd.h>
 #include "physcon.h"
 #include "libgpsC.h"
 
@@ -87,28 +191,64 @@ static char *sccsid= "@(#)xyz2llh.c     1.5  02/02/07";
 
 /*
  *  global definitions and variables
+ *
+ *  MAX_memo        most cells of the memo of -m
+ *  cname           names of the outputs of -o
  */
 
+#define MAX_memo        ((int)16384)
+
+static char *cname[2][4]= { { "lat", "lon", "hgt", NULL },
+                            { "X", "Y", "Z", "r" } };
+
 
 
 int main( int argc, char *argv[] )
 {
   char buf[81];
+  char *bname= NULL;
+  char dms[32];
+  char *ename= NULL;
+  char *fname= NULL;
+  char *mname= NULL;
+  char *oname= NULL;
   char *pgm;
   char *ptr;
+  char *sname= NULL;
+  char *tname= NULL;
   char *vrsn= "1.5 02/02/07";
+  double ftol= 1.0e-6;
+  double htol= 1.0e-4;
   double in[3]= { 0.0, 0.0, 0.0 };
   double out[3];
-  double sec;
+  double q;
+  double sta[3];
   int c;
-  int deg;
   int display= 0;
   int errflg= 0;
   int i;
   int j;
-  int min;
+  int k;
+  int lin= 0;
+  int mask= 0;
   int mode= 0;
+  int ncol= 0;
+  int nthr= 0;
+  int ocol[4]= { 0, 0, 0, 0 };
+  int solver= SOLV_borkowski;
   int west= 0;
+  long hit;
+  long miss;
+  long near;
+  FILE *bp= stdout;
+  FILE *fp;
+  struct col_head colin;
+  struct col_head colout;
+  struct ellipsoid custom;
+  struct ellipsoid *ell;
+  struct neu_station station;
+  struct plh_memo memo;
+  struct xyz_job job;
 
   extern char *optarg;
   extern int optind;
@@ -123,17 +263,42 @@ int main( int argc, char *argv[] )
     pgm= ptr+1;
 
   i= 0;
-  while( (c= getopt(argc, argv, ":dhrw0:1:2:3:4:5:6:7:8:9:")) != -1 )
+  while( (c= getopt(argc, argv,
+                    "+:b:de:f:hj:m:o:rs:t:w0:1:2:3:4:5:6:7:8:9:")) != -1 )
     switch( c ) {
+    case 'b':
+      bname= optarg;
+      break;
     case 'd':
       display= 1;
       break;
+    case 'e':
+      ename= optarg;
+      break;
+    case 'f':
+      fname= optarg;
+      break;
     case 'h':
       errflg= 1;
       break;
+    case 'j':
+      nthr= atoi( optarg );
+      break;
+    case 'm':
+      mname= optarg;
+      break;
+    case 'o':
+      oname= optarg;
+      break;
     case 'r':
       mode= 1;
       break;
+    case 's':
+      sname= optarg;
+      break;
+    case 't':
+      tname= optarg;
+      break;
     case 'w':
       west= 1;
       break;
@@ -147,8 +312,8 @@ int main( int argc, char *argv[] )
     case '7':
     case '8':
     case '9':
-      sprintf( buf, "-%c%s", optopt, optarg );
-      in[i]= atof( buf );
+      sprintf( buf, "-%c%s", c, optarg );
+      in[i]= numscan( buf, NULL );
       i++;
       break;
     case '?':
@@ -162,27 +327,249 @@ int main( int argc, char *argv[] )
     }
 
   if( errflg
-      || ( mode == 0 && (argc-optind+i) != 3 )
-      || ( mode == 1 && (argc-optind+i) != 2 && (argc-optind+i) != 3 ) ) {
+      || ( tname != NULL && mode == 1 )
+      || ( mname != NULL && ( fname == NULL || mode == 1 || tname != NULL ) )
+      || ( oname != NULL && ( fname == NULL || tname != NULL || mname != NULL
+                              || display == 1 ) )
+      || ( fname != NULL && (argc-optind+i) != 0 )
+      || ( fname == NULL && mode == 0 && (argc-optind+i) != 3 )
+      || ( fname == NULL && mode == 1 && (argc-optind+i) != 2
+           && (argc-optind+i) != 3 ) ) {
     printf("%s(%s): Converts X Y Z to lat, lon and ellipsoid hgt\n",
            pgm, vrsn);
     printf("Usage: %s X Y Z\n", pgm );
+    printf("       %s -f file\n", pgm );
     printf("  options:\n");
+    printf("           -b file writes the -f output as a column file\n");
+    printf("              (\"-\" = stdout) rather than as text.\n");
     printf("           -d print deg min sec rather than decimal degrees.\n");
+    printf("           -e ellipsoid, by name or as A,FL (FL > 1 = 1/f);\n");
+    printf("              default GRS80, or that of a column file.\n");
+    printf("           -f converts every record, one point per line,\n");
+    printf("              of file (\"-\" = stdin); values separated by\n");
+    printf("              commas and/or blanks; header lines skipped.\n");
+    printf("              A column file (see xyzcol) is read as such.\n");
     printf("           -h prints this message.\n");
+    printf("           -j n threads for -f (default: all processors).\n");
+    printf("           -m q[,lin] memoizes the -f conversions of repeat\n");
+    printf("              stations in cells of q m; lin corrects the\n");
+    printf("              other points of a cell to first order.\n");
+    printf("           -o names prints only these -f outputs, in\n");
+    printf("              this order: lat,lon,hgt, or with -r X,Y,Z,r\n");
+    printf("              (r = distance from the Z axis); not with\n");
+    printf("              -d, -m or -t.\n");
     printf("           -r = input coordinates are lat, lon, hgt,\n");
     printf("                output coordinates will be X, Y, Z.\n");
+    printf("           -s solver for X, Y, Z -> lat, lon, hgt:\n");
+    printf("              borkowski (default), trilat, halley\n");
+    printf("              or halleyc (Halley to convergence);\n");
+    printf("              auto[,ftol[,htol]] the cheapest within ftol\n");
+    printf("              arcsec and htol m (default 1e-6,1e-4).\n");
+    printf("           -t X,Y,Z prints north, east, up from the station\n");
+    printf("              at X,Y,Z rather than lat, lon, hgt.\n");
     printf("           -w longitudes are west rather than east longitude.\n");
+    printf("  ellipsoids:\n");
+    elllist( stdout );
+    exit(1);
+  }
+
+  if( ename == NULL )
+    ell= ellfind( "GRS80" );
+  else if( (ell= ellparse( ename, &custom )) == NULL ) {
+    fprintf(stderr, "%s ERROR: Unknown ellipsoid \"%s\"\n", pgm, ename);
+    exit(1);
+  }
+
+  if( sname == NULL || strcmp( sname, "borkowski" ) == 0 )
+    solver= SOLV_borkowski;
+  else if( strcmp( sname, "trilat" ) == 0 )
+    solver= SOLV_trilat;
+  else if( strcmp( sname, "halley" ) == 0 )
+    solver= SOLV_halley;
+  else if( strcmp( sname, "halleyc" ) == 0 )
+    solver= SOLV_halleyc;
+  else if( strncmp( sname, "auto", 4 ) == 0
+           && (sname[4] == '\0' || sname[4] == ',') ) {
+    solver= SOLV_auto;
+    ptr= sname + 4;
+    if( *ptr == ',' )
+      ftol= numscan( ptr + 1, &ptr );
+    if( *ptr == ',' )
+      htol= numscan( ptr + 1, &ptr );
+    if( *ptr != '\0' || !(ftol > 0.0) || !(htol > 0.0) ) {
+      fprintf(stderr, "%s ERROR: Bad tolerances \"%s\"\n", pgm, sname);
+      exit(1);
+    }
+  } else {
+    fprintf(stderr, "%s ERROR: Unknown solver \"%s\"\n", pgm, sname);
     exit(1);
   }
 
+  if( mname != NULL ) {
+    q= numscan( mname, &ptr );
+    if( strcmp( ptr, ",lin" ) == 0 )
+      lin= 1;
+    else if( *ptr != '\0' )
+      q= ZERO;
+    if( solver != SOLV_borkowski ) {
+      fprintf(stderr, "%s ERROR: -m converts by borkowski only\n", pgm);
+      exit(1);
+    }
+    if( plhminit( &memo, MAX_memo, q, lin ) != 0 ) {
+      fprintf(stderr, "%s ERROR: Bad memo \"%s\"\n", pgm, mname);
+      exit(1);
+    }
+  }
+
+  if( oname != NULL ) {
+    if( solver != SOLV_borkowski ) {
+      fprintf(stderr, "%s ERROR: -o converts by borkowski only\n", pgm);
+      exit(1);
+    }
+    ptr= oname;
+    do {
+      k= strcspn( ptr, "," );
+      for( j= 0; j < 4; j++ )
+        if( cname[mode][j] != NULL && k > 0
+            && strncmp( ptr, cname[mode][j], k ) == 0
+            && cname[mode][j][k] == '\0' )
+          break;
+      if( j == 4 || mask & 1 << j ) {
+        fprintf(stderr, "%s ERROR: Bad outputs \"%s\"\n", pgm, oname);
+        exit(1);
+      }
+      mask|= 1 << j;
+      ocol[j]= ncol++;
+      ptr+= k;
+    } while( *ptr++ == ',' );
+  }
+
+  if( tname != NULL ) {
+    for( j= 0, ptr= tname; j < 3; j++ ) {
+      sta[j]= numscan( ptr, &ptr );
+      if( j < 2 && *ptr++ != ',' )
+        break;
+    }
+    if( j < 3 || *ptr != '\0' ) {
+      fprintf(stderr, "%s ERROR: Bad station \"%s\"\n", pgm, tname);
+      exit(1);
+    }
+    xyz2plhe( sta, out, ell );
+    neuset( &station, out[0], out[1], sta );
+  }
+
+/*
+ *   1.1  File mode: convert chunks until end of file
+ */
+
+  if( fname != NULL ) {
+    if( strcmp( fname, "-" ) == 0 )
+      fp= stdin;
+    else if( (fp= fopen( fname, "r" )) == NULL ) {
+      fprintf(stderr, "%s ERROR: Cannot open \"%s\"\n", pgm, fname);
+      exit(1);
+    }
+    setvbuf( stdout, NULL, _IOFBF, (size_t)1 << 16 );
+
+    job.mode= mode;
+    job.display= display;
+    job.west= west;
+    job.ell= ell;
+    job.solver= solver;
+    job.ftol= ftol;
+    job.htol= htol;
+    job.neu= tname != NULL ? &station : NULL;
+    job.memo= mname != NULL ? &memo : NULL;
+    job.mask= mask;
+    job.ncol= ncol;
+    for( j= 0; j < 4; j++ )
+      job.ocol[j]= ocol[j];
+    job.colin= NULL;
+    job.colout= NULL;
+    job.nread= 0;
+    job.nskip= 0;
+    job.nlong= 0;
+    if( nthr <= 0 )
+      nthr= (int)sysconf( _SC_NPROCESSORS_ONLN );
+
+/*
+ *        A column file input is known by its first byte; lat, lon, hgt
+ *        columns refer to the ellipsoid in its header, unless -e
+ */
+
+    if( (c= getc( fp )) != EOF )
+      ungetc( c, fp );
+    if( c == (unsigned char)COL_magic[0] ) {
+      if( colgethead( fp, &colin ) != 0 || colin.ncol < 3 - mode ) {
+        fprintf(stderr, "%s ERROR: \"%s\" is not a column file of %s\n",
+                pgm, fname, mode == 1 ? "lat, lon[, hgt]" : "X, Y, Z");
+        exit(1);
+      }
+      job.colin= &colin;
+      if( mode == 1 && ename == NULL
+          && (job.ell= colell( &colin, &custom )) == NULL ) {
+        fprintf(stderr, "%s ERROR: \"%s\" has no valid ellipsoid\n",
+                pgm, fname);
+        exit(1);
+      }
+    }
+
+    if( bname != NULL ) {
+      if( strcmp( bname, "-" ) != 0
+          && (bp= fopen( bname, "wb" )) == NULL ) {
+        fprintf(stderr, "%s ERROR: Cannot create \"%s\"\n", pgm, bname);
+        exit(1);
+      }
+      colinit( &colout, mask != 0 ? ncol : 3,
+               mask != 0 ? oname : tname != NULL ? "north,east,up"
+               : mode == 1 ? "X,Y,Z" : "lat,lon,hgt", COL_raw, job.ell );
+      colout.nrow= -1;
+      if( colputhead( bp, &colout ) != 0 ) {
+        fprintf(stderr, "%s ERROR: Write failed\n", pgm);
+        exit(1);
+      }
+      job.colout= &colout;
+    }
+
+    if( cvtfile( fp, bp, &job, nthr ) != 0 ) {
+      fprintf(stderr, "%s ERROR: Read or write failed\n", pgm);
+      exit(1);
+    }
+    if( fp != stdin )
+      fclose( fp );
+    if( job.colout != NULL ) {
+      colout.nrow= job.nread;
+      if( fflush( bp ) == 0 && fseek( bp, 0L, SEEK_SET ) == 0 )
+        colputhead( bp, &colout );
+      if( bp != stdout && fclose( bp ) != 0 ) {
+        fprintf(stderr, "%s ERROR: Write failed\n", pgm);
+        exit(1);
+      }
+    }
+    if( job.nskip > 0 )
+      fprintf(stderr, "%s: %ld records converted, %ld lines skipped\n",
+              pgm, job.nread, job.nskip);
+    if( job.nlong > 0 ) {
+      fprintf(stderr, "%s ERROR: %ld input lines longer than %d or output "
+              "records longer than %d characters were cut\n",
+              pgm, job.nlong, MAX_line - 1, MAX_outrec - 1);
+      exit(1);
+    }
+    if( job.memo != NULL ) {
+      plhmstat( &memo, &hit, &near, &miss, &j );
+      fprintf(stderr, "%s: memo %ld exact, %ld near, %ld converted, %d cells\n",
+              pgm, hit, near, miss, j);
+    }
+    exit(0);
+  }
+
 /*
- *   1.1  Convert and store input coordinates
+ *   1.2  Convert and store input coordinates
  *        NOTE: i initialized above getopt loop.
  */
 
   for( ; optind < argc; optind++, i++ )
-    in[i]= atof(argv[optind]);
+    in[i]= numscan( argv[optind], NULL );
 
 /*
  *   2.0  Convert and print coordinates
@@ -192,21 +579,36 @@ int main( int argc, char *argv[] )
     if( west == 1 )
       in[1]= fmod( 360.0-in[1], 360.0 );
 
-    plh2xyz( in, out, emajor, eflat );
+    plh2xyze( in, out, ell );
+
+    printf( "%13.4lf %13.4lf %13.4lf\n", out[0], out[1], out[2] );
+  } else if( tname != NULL ) {
+    xyz2neup( &station, 1, &in[0], &in[1], &in[2], &out[0], &out[1], &out[2] );
 
     printf( "%13.4lf %13.4lf %13.4lf\n", out[0], out[1], out[2] );
   } else {
-    xyz2plh( in, out, emajor, eflat );
+    if( solver == SOLV_trilat )
+      xyz2plht( in, out, ell );
+    else if( solver == SOLV_halley )
+      xyz2plhh( in, out, ell );
+    else if( solver == SOLV_halleyc )
+      xyz2plhhc( in, out, ell );
+    else if( solver == SOLV_auto ) {
+      if( xyz2plhd( 1, &in[0], &in[1], &in[2], &out[0], &out[1], &out[2],
+                    ell, ftol, htol ) > 0 )
+        fprintf(stderr, "%s WARNING: Tolerance not met\n", pgm);
+    } else
+      xyz2plhe( in, out, ell );
 
     if( west == 1 )
       out[1]= fmod( 360.0-out[1], 360.0 );
 
     if( display == 1 ) {
-      degdms( out[0], &deg, &min, &sec );
-      printf( "%3d %2d %8.5lf", deg, min, sec );
+      dmsfmt( dms, sizeof(dms), out[0], 3, 5 );
+      printf( "%s", dms );
 
-      degdms( out[1], &deg, &min, &sec );
-      printf( " %3d %2d %8.5lf", deg, min, sec );
+      dmsfmt( dms, sizeof(dms), out[1], 3, 5 );
+      printf( " %s", dms );
 
       printf( " %13.8lf\n", out[2] );
     } else
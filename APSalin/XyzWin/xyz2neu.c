@@ -0,0 +1,427 @@
+/*  @(#)xyz2neu.c       1.0  26/10/18  */
+static char *sccsid= "@(#)xyz2neu.c     1.0  26/10/18";
+/*
+ *      include files
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "physcon.h"
+#include "libgpsC.h"
+
+/*
+ *      function prototypes
+ */
+
+void neu2xyz( double, double, double, double, double,
+              double *, double *, double * );
+void neu2xyzv( struct neu_station *, int, double *, double *, double *,
+               double *, double *, double * );
+void neufree( struct neu_cache * );
+struct neu_station *neuget( struct neu_cache *, double *,
+                            struct ellipsoid * );
+int neuinit( struct neu_cache *, int );
+void neurotv_avx2( int, double *, double *, double *, double *, double *,
+                   double *, double *, double * );
+void neuset( struct neu_station *, double, double, double * );
+void xyz2neu( double, double, double, double, double,
+              double *, double *, double * );
+void xyz2neup( struct neu_station *, int, double *, double *, double *,
+               double *, double *, double * );
+void xyz2neuv( struct neu_station *, int, double *, double *, double *,
+               double *, double *, double * );
+static void neurotv( int, double *, double *, double *, double *, double *,
+                     double *, double *, double * );
+static inline unsigned long neuhash( double * );
+
+/*
+ *      definitions and global variables
+ */
+
+
+
+void neuset( struct neu_station *st, double lat, double lon, double *xyz )
+/********1*********2*********3*********4*********5*********6*********7**
+ * Name:        neuset
+ * Version:     2610.18
+ * Author:      geoData
+ * Purpose:     Fills in the topocentric frame of a station.
+ *
+ * Input:
+ * -----------
+ * lat              geodetic latitude of the station [deg]
+ * lon              longitude of the station, east of Greenwich [deg]
+ * xyz[]            geocentric X, Y, Z of the station [m]; NULL when only
+ *                  vectors are rotated (xyz2neuv, neu2xyzv)
+ *
+ * Output:
+ * -----------
+ * st               the frame, with its rotation X, Y, Z -> N, E, U
+ *
+ ********1*********2*********3*********4*********5*********6*********7**
+ * Modification History:
+ * 2610.18, GD,  Creation
+ ********1*********2*********3*********4*********5*********6*********7*/
+{
+        double cf= cos( lat * deg_to_rad );
+        double cl= cos( lon * deg_to_rad );
+        double sf= sin( lat * deg_to_rad );
+        double sl= sin( lon * deg_to_rad );
+        int k;
+
+        for( k= 0; k < 3; k++ )
+                st->xyz[k]= xyz != NULL ? xyz[k] : ZERO;
+        st->lat= lat;
+        st->lon= lon;
+
+        st->R[0]= -sf*cl;
+        st->R[1]= -sf*sl;
+        st->R[2]= cf;
+        st->R[3]= -sl;
+        st->R[4]= cl;
+        st->R[5]= ZERO;
+        st->R[6]= cf*cl;
+        st->R[7]= cf*sl;
+        st->R[8]= sf;
+}
+
+
+void xyz2neu( double lat, double lon, double dx, double dy, double dz,
+              double *n, double *e, double *u )
+/********1*********2*********3*********4*********5*********6*********7**
+ * Name:        xyz2neu
+ * Version:     2610.18
+ * Author:      geoData
+ * Purpose:     Converts a geocentric X, Y, Z vector to local north,
+ *              east, up at a point.
+ *
+ * Input:
+ * -----------
+ * dx, dy, dz       vector in X, Y, Z [m]
+ * lat              geodetic latitude of the point [deg]
+ * lon              longitude of the point, east of Greenwich [deg]
+ *
+ * Output:
+ * -----------
+ * n, e, u          the vector in north, east, up [m]
+ *
+ * Notes:
+ * -----------
+ * One vector per call, with the trigonometry of the frame each time;
+ * for many vectors at the same point see xyz2neuv.
+ *
+ ********1*********2*********3*********4*********5*********6*********7**
+ * Modification History:
+ * 2610.18, GD,  Creation
+ ********1*********2*********3*********4*********5*********6*********7*/
+{
+        struct neu_station st;
+
+        neuset( &st, lat, lon, NULL );
+        *n= st.R[0]*dx + st.R[1]*dy + st.R[2]*dz;
+        *e= st.R[3]*dx + st.R[4]*dy;
+        *u= st.R[6]*dx + st.R[7]*dy + st.R[8]*dz;
+}
+
+
+void neu2xyz( double lat, double lon, double n, double e, double u,
+              double *dx, double *dy, double *dz )
+/********1*********2*********3*********4*********5*********6*********7**
+ * Name:        neu2xyz
+ * Version:     2610.18
+ * Author:      geoData
+ * Purpose:     Converts a local north, east, up vector at a point to
+ *              geocentric X, Y, Z.
+ *
+ * Input:
+ * -----------
+ * lat              geodetic latitude of the point [deg]
+ * lon              longitude of the point, east of Greenwich [deg]
+ * n, e, u          vector in north, east, up [m]
+ *
+ * Output:
+ * -----------
+ * dx, dy, dz       the vector in X, Y, Z [m]
+ *
+ ********1*********2*********3*********4*********5*********6*********7**
+ * Modification History:
+ * 2610.18, GD,  Creation
+ ********1*********2*********3*********4*********5*********6*********7*/
+{
+        struct neu_station st;
+
+        neuset( &st, lat, lon, NULL );
+        *dx= st.R[0]*n + st.R[3]*e + st.R[6]*u;
+        *dy= st.R[1]*n + st.R[4]*e + st.R[7]*u;
+        *dz= st.R[2]*n + st.R[8]*u;
+}
+
+
+static void neurotv( int n, double *M, double *o, double *x, double *y,
+                     double *z, double *a, double *b, double *c )
+/********1*********2*********3*********4*********5*********6*********7**
+ * Purpose:     (a, b, c) = M * ((x, y, z) - o) over n points, M by rows;
+ *              by neurotv_avx2 when the processor has it
+ ********1*********2*********3*********4*********5*********6*********7*/
+{
+        double dx;
+        double dy;
+        double dz;
+        int i;
+
+        if( simd_level() >= 1 ) {
+                neurotv_avx2( n, M, o, x, y, z, a, b, c );
+                return;
+        }
+
+        for( i= 0; i < n; i++ ) {
+                dx= x[i] - o[0];
+                dy= y[i] - o[1];
+                dz= z[i] - o[2];
+                a[i]= M[0]*dx + M[1]*dy + M[2]*dz;
+                b[i]= M[3]*dx + M[4]*dy + M[5]*dz;
+                c[i]= M[6]*dx + M[7]*dy + M[8]*dz;
+        }
+}
+
+
+void xyz2neuv( struct neu_station *st, int n, double *dx, double *dy,
+               double *dz, double *north, double *east, double *up )
+/********1*********2*********3*********4*********5*********6*********7**
+ * Name:        xyz2neuv
+ * Version:     2610.18
+ * Author:      geoData
+ * Purpose:     Rotates arrays of geocentric X, Y, Z vectors to north,
+ *              east, up at a station.  Batch form of xyz2neu.
+ *
+ * Input:
+ * -----------
+ * dx[], dy[], dz[] n vectors in X, Y, Z [m], e.g. baselines
+ * n                number of vectors
+ * st               frame of the station (neuset, neuget)
+ *
+ * Output:
+ * -----------
+ * north[], east[], up[]  the vectors in north, east, up [m]
+ *
+ * Notes:
+ * -----------
+ * Four vectors at a time with AVX2/FMA when simd_level() allows,
+ * which rounds each component once rather than three times (within
+ * 1 ulp of the length of the vector).  The output may not overlap the
+ * input.
+ *
+ ********1*********2*********3*********4*********5*********6*********7**
+ * Modification History:
+ * 2610.18, GD,  Creation
+ ********1*********2*********3*********4*********5*********6*********7*/
+{
+        double o[3]= { ZERO, ZERO, ZERO };
+
+        neurotv( n, st->R, o, dx, dy, dz, north, east, up );
+}
+
+
+void xyz2neup( struct neu_station *st, int n, double *x, double *y,
+               double *z, double *north, double *east, double *up )
+/********1*********2*********3*********4*********5*********6*********7**
+ * Name:        xyz2neup
+ * Version:     2610.18
+ * Author:      geoData
+ * Purpose:     Converts arrays of geocentric X, Y, Z positions to north,
+ *              east, up from a station.
+ *
+ * Input:
+ * -----------
+ * n                number of positions
+ * st               frame of the station, with its X, Y, Z
+ * x[], y[], z[]    n positions in X, Y, Z [m]
+ *
+ * Output:
+ * -----------
+ * north[], east[], up[]  position - station in north, east, up [m]
+ *
+ * Notes:
+ * -----------
+ * The difference from the station and the rotation are made in one
+ * pass, with no array of differences in between.
+ *
+ ********1*********2*********3*********4*********5*********6*********7**
+ * Modification History:
+ * 2610.18, GD,  Creation
+ ********1*********2*********3*********4*********5*********6*********7*/
+{
+        neurotv( n, st->R, st->xyz, x, y, z, north, east, up );
+}
+
+
+void neu2xyzv( struct neu_station *st, int n, double *north, double *east,
+               double *up, double *dx, double *dy, double *dz )
+/********1*********2*********3*********4*********5*********6*********7**
+ * Name:        neu2xyzv
+ * Version:     2610.18
+ * Author:      geoData
+ * Purpose:     Rotates arrays of north, east, up vectors at a station to
+ *              geocentric X, Y, Z.  Batch form of neu2xyz.
+ *
+ * Input:
+ * -----------
+ * n                number of vectors
+ * north[], east[], up[]  n vectors in north, east, up [m]
+ * st               frame of the station
+ *
+ * Output:
+ * -----------
+ * dx[], dy[], dz[] the vectors in X, Y, Z [m]
+ *
+ * Notes:
+ * -----------
+ * By the transpose of the rotation of xyz2neuv.
+ *
+ ********1*********2*********3*********4*********5*********6*********7**
+ * Modification History:
+ * 2610.18, GD,  Creation
+ ********1*********2*********3*********4*********5*********6*********7*/
+{
+        double Rt[9];
+        double o[3]= { ZERO, ZERO, ZERO };
+        int j;
+        int k;
+
+        for( j= 0; j < 3; j++ )
+                for( k= 0; k < 3; k++ )
+                        Rt[3*j+k]= st->R[3*k+j];
+        neurotv( n, Rt, o, north, east, up, dx, dy, dz );
+}
+
+
+int neuinit( struct neu_cache *cache, int max )
+/********1*********2*********3*********4*********5*********6*********7**
+ * Name:        neuinit
+ * Version:     2610.18
+ * Author:      geoData
+ * Purpose:     Makes an empty cache of station frames.
+ *
+ * Input:
+ * -----------
+ * max              most stations the cache is to hold
+ *
+ * Output:
+ * -----------
+ * cache            empty, with at least 2*max slots
+ * returns          0, or -1 if out of memory
+ *
+ ********1*********2*********3*********4*********5*********6*********7**
+ * Modification History:
+ * 2610.18, GD,  Creation
+ ********1*********2*********3*********4*********5*********6*********7*/
+{
+        int size;
+
+        for( size= 8; size < 2*max; size*= 2 )
+                ;
+        cache->used= calloc( size, sizeof(char) );
+        cache->st= malloc( size*sizeof(struct neu_station) );
+        if( cache->used == NULL || cache->st == NULL ) {
+                free( cache->used );
+                free( cache->st );
+                cache->used= NULL;
+                cache->st= NULL;
+                return( -1 );
+        }
+        cache->size= size;
+        cache->n= 0;
+        cache->max= size/2;
+
+        return( 0 );
+}
+
+
+void neufree( struct neu_cache *cache )
+/********1*********2*********3*********4*********5*********6*********7**
+ * Name:        neufree
+ * Version:     2610.18
+ * Author:      geoData
+ * Purpose:     Frees a cache of station frames made by neuinit.
+ *
+ ********1*********2*********3*********4*********5*********6*********7**
+ * Modification History:
+ * 2610.18, GD,  Creation
+ ********1*********2*********3*********4*********5*********6*********7*/
+{
+        free( cache->used );
+        free( cache->st );
+        cache->used= NULL;
+        cache->st= NULL;
+        cache->size= 0;
+        cache->n= 0;
+        cache->max= 0;
+}
+
+
+static inline unsigned long neuhash( double *xyz )
+/********1*********2*********3*********4*********5*********6*********7**
+ * Purpose:     hash of the bits of X, Y, Z
+ ********1*********2*********3*********4*********5*********6*********7*/
+{
+        unsigned long long b[3];
+
+        memcpy( b, xyz, sizeof(b) );
+
+        return( (unsigned long)( ( b[0] * 0x9E3779B97F4A7C15ULL
+                                   ^ b[1] * 0xC2B2AE3D27D4EB4FULL
+                                   ^ b[2] * 0x165667B19E3779F9ULL ) >> 32 ) );
+}
+
+
+struct neu_station *neuget( struct neu_cache *cache, double *xyz,
+                            struct ellipsoid *ell )
+/********1*********2*********3*********4*********5*********6*********7**
+ * Name:        neuget
+ * Version:     2610.18
+ * Author:      geoData
+ * Purpose:     Returns the frame of the station at X, Y, Z from a cache,
+ *              making it on the first call for that station.
+ *
+ * Input:
+ * -----------
+ * cache            cache made by neuinit
+ * ell              ellipsoid of the frame
+ * xyz[]            geocentric X, Y, Z of the station [m]
+ *
+ * Output:
+ * -----------
+ * cache            holds the station
+ * returns          its frame; NULL if it is new and the cache is full
+ *
+ * Notes:
+ * -----------
+ * A station is known by the exact bits of its X, Y, Z.  A new one
+ * goes through xyz2plhe once for the lat, lon of neuset; a cache holds
+ * the frames of one ellipsoid only.  The frames stay where they are
+ * until neufree, so a pointer returned stays valid.  Not thread safe
+ * while stations are being added.
+ *
+ ********1*********2*********3*********4*********5*********6*********7**
+ * Modification History:
+ * 2610.18, GD,  Creation
+ ********1*********2*********3*********4*********5*********6*********7*/
+{
+        double plh[3];
+        unsigned long k;
+        unsigned long mask= (unsigned long)cache->size - 1;
+
+        for( k= neuhash( xyz ) & mask; cache->used[k]; k= (k + 1) & mask )
+                if( memcmp( cache->st[k].xyz, xyz, 3*sizeof(double) ) == 0 )
+                        return( &cache->st[k] );
+
+        if( cache->n >= cache->max )
+                return( NULL );
+        xyz2plhe( xyz, plh, ell );
+        neuset( &cache->st[k], plh[0], plh[1], xyz );
+        cache->used[k]= 1;
+        cache->n++;
+
+        return( &cache->st[k] );
+}
@@ -0,0 +1,119 @@
+/*  @(#)xyz2neua.c      1.0  26/10/18  */
+static char *sccsid= "@(#)xyz2neua.c    1.0  26/10/18";
+/*
+ *      include files
+ */
+
+#include <math.h>
+#include "physcon.h"
+#include "libgpsC.h"
+#include "vmath.h"
+
+/*
+ *      function prototypes
+ */
+
+void neurotv_avx2( int, double *, double *, double *, double *, double *,
+                   double *, double *, double * );
+
+/*
+ *      definitions and global variables
+ */
+
+
+#ifdef __AVX2__
+
+void neurotv_avx2( int n, double *M, double *o, double *x, double *y,
+                   double *z, double *a, double *b, double *c )
+/********1*********2*********3*********4*********5*********6*********7**
+ * Name:        neurotv_avx2
+ * Version:     2610.18
+ * Author:      geoData
+ * Purpose:     AVX2 kernel of the topocentric rotations (xyz2neu.c):
+ *              (a, b, c) = M * ((x, y, z) - o), four points at a time.
+ *
+ * Input:
+ * -----------
+ * M[]              3 x 3 matrix, by rows
+ * n                number of points
+ * o[]              origin subtracted first
+ * x[], y[], z[]    n points
+ *
+ * Output:
+ * -----------
+ * a[], b[], c[]    n rotated points
+ *
+ * Notes:
+ * -----------
+ * This file must be compiled with -mavx2 -mfma.  It is only called
+ * after simd_level() has checked the processor.  Each row is one
+ * multiply and two FMA.  The last n % 4 points are done as scalars,
+ * with fma() so they round as the vector lanes do.
+ *
+ ********1*********2*********3*********4*********5*********6*********7**
+ * Modification History:
+ * 2610.18, GD,  Creation
+ ********1*********2*********3*********4*********5*********6*********7*/
+{
+        __m256d m[9];
+        __m256d ox= vconst( o[0] );
+        __m256d oy= vconst( o[1] );
+        __m256d oz= vconst( o[2] );
+        __m256d dx;
+        __m256d dy;
+        __m256d dz;
+        double sx;
+        double sy;
+        double sz;
+        int i;
+        int k;
+
+        for( k= 0; k < 9; k++ )
+                m[k]= vconst( M[k] );
+
+        for( i= 0; i + 4 <= n; i+= 4 ) {
+                dx= _mm256_sub_pd( _mm256_loadu_pd( x + i ), ox );
+                dy= _mm256_sub_pd( _mm256_loadu_pd( y + i ), oy );
+                dz= _mm256_sub_pd( _mm256_loadu_pd( z + i ), oz );
+                _mm256_storeu_pd( a + i, _mm256_fmadd_pd( m[2], dz,
+                        _mm256_fmadd_pd( m[1], dy,
+                                         _mm256_mul_pd( m[0], dx ) ) ) );
+                _mm256_storeu_pd( b + i, _mm256_fmadd_pd( m[5], dz,
+                        _mm256_fmadd_pd( m[4], dy,
+                                         _mm256_mul_pd( m[3], dx ) ) ) );
+                _mm256_storeu_pd( c + i, _mm256_fmadd_pd( m[8], dz,
+                        _mm256_fmadd_pd( m[7], dy,
+                                         _mm256_mul_pd( m[6], dx ) ) ) );
+        }
+
+        for( ; i < n; i++ ) {
+                sx= x[i] - o[0];
+                sy= y[i] - o[1];
+                sz= z[i] - o[2];
+                a[i]= fma( M[2], sz, fma( M[1], sy, M[0]*sx ) );
+                b[i]= fma( M[5], sz, fma( M[4], sy, M[3]*sx ) );
+                c[i]= fma( M[8], sz, fma( M[7], sy, M[6]*sx ) );
+        }
+}
+
+#else
+
+void neurotv_avx2( int n, double *M, double *o, double *x, double *y,
+                   double *z, double *a, double *b, double *c )
+{
+        double dx;
+        double dy;
+        double dz;
+        int i;
+
+        for( i= 0; i < n; i++ ) {
+                dx= x[i] - o[0];
+                dy= y[i] - o[1];
+                dz= z[i] - o[2];
+                a[i]= M[0]*dx + M[1]*dy + M[2]*dz;
+                b[i]= M[3]*dx + M[4]*dy + M[5]*dz;
+                c[i]= M[6]*dx + M[7]*dy + M[8]*dz;
+        }
+}
+
+#endif /* __AVX2__ */
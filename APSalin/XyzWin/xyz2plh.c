@@ -1,17 +1,20 @@
-/*  @(#)xyz2plh.c       1.1  98/12/08  */
-static char *sccsid= "@(#)xyz2plh.c     1.1  98/12/08";
+/*  @(#)xyz2plh.c       1.2  26/10/18  */
+static char *sccsid= "@(#)xyz2plh.c     1.2  26/10/18";
 /*
  *      include files
  */
 
 #include <math.h>
 #include "physcon.h"
+#include "ellips.h"
 
 /*
  *      function prototypes
  */
 
 void xyz2plh( double *, double *, double, double );
+void xyz2plhe( double *, double *, struct ellipsoid * );
+void xyz2plhn( double *, double *, double, double );
 
 /*
  *      definitions and global variables
@@ -51,7 +54,7 @@ void xyz2plh( double *xyz, double *plh, double A, double FL )
  * Notes:
  * -----------
  * This routine will fail for points on the Z axis, i.e. if X= Y= 0
- * (Phi = +/- 90 degrees).
+ * (Phi = +/- 90 degrees).  xyz2plhe and the batch routines do not.
  *
  * Units of input parameters `A' and `xyz' must be the same.
  *
@@ -147,3 +150,260 @@ void xyz2plh( double *xyz, double *plh, double A, double FL )
 
         return;
 }
+
+
+void xyz2plhe( double *xyz, double *plh, struct ellipsoid *ell )
+/********1*********2*********3*********4*********5*********6*********7**
+ * Name:        xyz2plhe
+ * Version:     2610.18
+ * Author:      geoData
+ * Purpose:     Converts XYZ geocentric coordinates to Phi (latitude),
+ *              Lambda (longitude), H (height) referred to a registry
+ *              ellipsoid.
+ *
+ * Input:
+ * -----------
+ * ell              ellipsoid, with its derived constants (ellset)
+ * xyz[]            geocentric Cartesian coordinates [m]
+ *
+ * Output:
+ * -----------
+ * plh[]            as xyz2plh [deg, deg, m]
+ *
+ * Notes:
+ * -----------
+ * xyz2plh with B and A*A - B*B taken from the ellipsoid instead of
+ * being computed for every point, and with the Z axis and the poles
+ * handled:
+ *   2.0  E and F are formed with r no less than BRK_rmin*A, so they
+ *        stay finite on the Z axis
+ *   2.1  within BRK_rpol*A of the axis and with B*|z| <= 2*c, a
+ *        core about the centre that holds the evolute, the point goes
+ *        to xyz2plhn
+ *   4.1  within BRK_rpol*A of the axis t is corrected by one Newton
+ *        step on the quartic multiplied through by r,
+ *          r*t^4 + 2*E'*t^3 + 2*F'*t - r = 0,  E'= E*r,  F'= F*r
+ *        which stays well conditioned as r -> 0 (t -> r/(2*F'))
+ * Borkowski's cubic loses digits as 1/r^2 near the pole: 1e-6 deg
+ * from it the latitude was 1.5e-7 deg off and on the axis NaN; with
+ * the step both are at the rounding of the rest of the routine.
+ * The step needs B*|z| clear of c: inside the evolute, |z| < c/B on
+ * the axis, the quartic has other roots, and Borkowski's t can be one
+ * of them (0, 0, 40 km gave the other pole and a positive height).
+ * Elsewhere the order of operations is that of xyz2plh, so the results
+ * are identical.
+ *
+ ********1*********2*********3*********4*********5*********6*********7**
+ * Modification History:
+ * 2610.18, GD,  Creation
+ * 2610.18, GD,  Z axis and polar cap (steps 2.0, 4.1)
+ * 2610.18, GD,  The core about the centre by xyz2plhn (step 2.1)
+ ********1*********2*********3*********4*********5*********6*********7*/
+{
+        double A= ell->A;
+        double B= ell->B;
+        double c= ell->c;
+        double d;
+        double e;
+        double f;
+        double g;
+        double p;
+        double q;
+        double r;
+        double rs;
+        double t;
+        double v;
+        double x= xyz[0];
+        double y= xyz[1];
+        double z= xyz[2];
+        double zlong;
+/*
+ *   1.0 semi-minor axis with the sign of z
+ */
+        if( z < ZERO )
+                B= -B;
+/*
+ *   2.0 compute intermediate values for latitude
+ */
+        r= sqrt( x*x + y*y );
+/*
+ *   2.1 the core about the centre: the nearest point of the ellipsoid
+ */
+        if( r < BRK_rpol*A && B*z <= TWO*c ) {
+                xyz2plhn( xyz, plh, A, ell->FL );
+                return;
+        }
+        rs= r < BRK_rmin*A ? BRK_rmin*A : r;
+        e= ( B*z - c ) / ( A*rs );
+        f= ( B*z + c ) / ( A*rs );
+/*
+ *   3.0 find solution to:
+ *       t^4 + 2*E*t^3 + 2*F*t - 1 = 0
+ */
+        p= (FOUR / THREE) * (e*f + ONE);
+        q= TWO * (e*e - f*f);
+        d= p*p*p + q*q;
+
+        if( d >= ZERO ) {
+                v= pow( (sqrt( d ) - q), (ONE / THREE) )
+                 - pow( (sqrt( d ) + q), (ONE / THREE) );
+        } else {
+                v= TWO * sqrt( -p )
+                 * cos( acos( q/(p * sqrt( -p )) ) / THREE );
+        }
+/*
+ *   4.0 improve v
+ */
+        if( v*v < fabs(p) ) {
+                v= -(v*v*v + TWO*q) / (THREE*p);
+        }
+        g= (sqrt( e*e + v ) + e) / TWO;
+        t = sqrt( g*g  + (f - v*g)/(TWO*g - e) ) - g;
+/*
+ *   4.1 near the Z axis, one Newton step on r*t^4 + 2*E'*t^3 +
+ *       2*F'*t - r = 0
+ */
+        if( r < BRK_rpol*A && B*z > TWO*c ) {
+                e= ( B*z - c ) / A;
+                f= ( B*z + c ) / A;
+                t-= ( ((r*t + TWO*e)*t)*t*t + TWO*f*t - r )
+                  / ( (FOUR*r*t + TWO*THREE*e)*t*t + TWO*f );
+        }
+
+        plh[0] = atan( (A*(ONE - t*t)) / (TWO*B*t) );
+/*
+ *   5.0 compute height above ellipsoid
+ */
+        plh[2]= (r - A*t)*cos( plh[0] ) + (z - B)*sin( plh[0] );
+/*
+ *   6.0 compute longitude east of Greenwich
+ */
+        zlong = atan2( y, x );
+        if( zlong < ZERO )
+                zlong= zlong + twopi;
+
+        plh[1]= zlong;
+/*
+ *   7.0 convert latitude and longitude to degrees
+ */
+        plh[0] = plh[0] * rad_to_deg;
+        plh[1] = plh[1] * rad_to_deg;
+
+        return;
+}
+
+
+void xyz2plhn( double *xyz, double *plh, double A, double FL )
+/********1*********2*********3*********4*********5*********6*********7**
+ * Name:        xyz2plhn
+ * Version:     2610.18
+ * Author:      geoData
+ * Purpose:     Converts XYZ geocentric coordinates to Phi (latitude),
+ *              Lambda (longitude), H (height) by the nearest point of
+ *              the ellipsoid, found by bisection.
+ *
+ * Input:
+ * -----------
+ * A                semi-major axis of ellipsoid [m]
+ * FL               flattening of ellipsoid [unitless]
+ * xyz[]            geocentric Cartesian coordinates [m]
+ *
+ * Output:
+ * -----------
+ * plh[]            as xyz2plh [deg, deg, m]
+ *
+ * Local:
+ * -----------
+ * s                s = u + B^2, u the parameter of Eberly's F(u)
+ *
+ * Notes:
+ * -----------
+ * With r = sqrt(x^2 + y^2), the nearest point of the ellipse in the
+ * quadrant of (r, |z|) is
+ *   (A^2*r/(s + c), B^2*|z|/s),  c = A^2 - B^2,
+ * s the one root s > 0 of
+ *   G(s) = (A*r/(s + c))^2 + (B*|z|/s)^2 - 1
+ * which decreases from +inf to -1 (Eberly).  This holds inside the
+ * evolute too, where the quartic of Borkowski has up to four roots,
+ * and on the axis.  Taking s rather than u keeps s + c and s free of
+ * cancellation near the centre.  Then
+ *   tan(Phi) = (|z|/s) / (r/(s + c))
+ *   H = (s - B^2) * sqrt((r/(s + c))^2 + (|z|/s)^2)
+ * The bisection halves [max(B|z|, A*r - c), sqrt(2)*max(B|z|, A*r)]
+ * geometrically while it spans more than a factor 4, then until no
+ * double lies between its ends; at most about 1100 steps, 60 to 70
+ * about the core.  On z = 0 inside the evolute (A*r < c) the root is
+ * s = 0 and the point is taken from its limit.
+ *
+ * For the core about the centre, where xyz2plhe and the batch
+ * routines send it; elsewhere Borkowski is faster and as accurate.
+ *
+ * References:
+ * -----------
+ * Eberly, D. (2011).  "Distance from a Point to an Ellipse, an
+ * Ellipsoid, or a Hyperellipsoid", Geometric Tools.
+ *
+ ********1*********2*********3*********4*********5*********6*********7**
+ * Modification History:
+ * 2610.18, GD,  Creation
+ ********1*********2*********3*********4*********5*********6*********7*/
+{
+        double B= A * (ONE - FL);
+        double c= A*A - B*B;
+        double ar;
+        double bz;
+        double g;
+        double hi;
+        double lo;
+        double r;
+        double s;
+        double u;
+        double v;
+        double x= xyz[0];
+        double y= xyz[1];
+        double z= xyz[2];
+        double zlong;
+
+        r= sqrt( x*x + y*y );
+        ar= A*r;
+        bz= B*fabs( z );
+        if( bz == ZERO && ar < c ) {
+/*
+ *   on the equator plane inside the evolute: the limit s -> 0
+ */
+                u= A*r/c;
+                v= B*sqrt( ONE - u*u );
+                plh[0]= atan2( v*A, u*B*B );
+                plh[2]= -sqrt( (r - A*u)*(r - A*u) + v*v );
+        } else {
+                lo= bz > ar - c ? bz : ar - c;
+                hi= sqrt( TWO ) * ( bz > ar ? bz : ar );
+                for( ;; ) {
+                        s= hi > FOUR*lo ? sqrt( lo*hi ) : (lo + hi) / TWO;
+                        if( !( s > lo && s < hi ) )
+                                break;
+                        g= (ar/(s + c))*(ar/(s + c)) + (bz/s)*(bz/s) - ONE;
+                        if( g > ZERO )
+                                lo= s;
+                        else
+                                hi= s;
+                }
+                u= r / (lo + c);
+                v= bz == ZERO ? ZERO : fabs( z ) / lo;
+                plh[0]= atan2( v, u );
+                plh[2]= (lo - B*B) * sqrt( u*u + v*v );
+        }
+        if( z < ZERO )
+                plh[0]= -plh[0];
+
+        zlong = atan2( y, x );
+        if( zlong < ZERO )
+                zlong= zlong + twopi;
+
+        plh[1]= zlong;
+
+        plh[0] = plh[0] * rad_to_deg;
+        plh[1] = plh[1] * rad_to_deg;
+
+        return;
+}
@@ -0,0 +1,405 @@
+/*  @(#)xyz2plha.c      1.0  26/10/18  */
+static char *sccsid= "@(#)xyz2plha.c    1.0  26/10/18";
+/*
+ *      include files
+ */
+
+#include <math.h>
+#include "physcon.h"
+#include "libgpsC.h"
+#include "vmath.h"
+
+/*
+ *      function prototypes
+ */
+
+void xyz2plhov_avx2( int, int, double *, double *, double *,
+                     double *, double *, double *, struct ellipsoid * );
+void xyz2plhv_avx2( int, double *, double *, double *,
+                    double *, double *, double *, struct ellipsoid * );
+
+/*
+ *      definitions and global variables
+ */
+
+
+#ifdef __AVX2__
+
+static inline void plhkern( int, double *, double *, double *,
+                            double *, double *, double *,
+                            struct ellipsoid *, const int );
+
+
+void xyz2plhv_avx2( int n, double *x, double *y, double *z,
+                    double *lat, double *lon, double *hgt,
+                    struct ellipsoid *ell )
+/********1*********2*********3*********4*********5*********6*********7**
+ * Name:        xyz2plhv_avx2
+ * Version:     2610.18
+ * Author:      geoData
+ * Purpose:     AVX2 kernel of xyz2plhv; Borkowski's method four points
+ *              at a time.
+ *
+ * Input:
+ * -----------
+ * see xyz2plhv
+ *
+ * Output:
+ * -----------
+ * see xyz2plhv
+ *
+ * Notes:
+ * -----------
+ * This file must be compiled with -mavx2 -mfma.  It is only called
+ * after simd_level() has checked the processor.
+ *
+ * The steps are those of xyz2plhe with the branches replaced by blends:
+ *   1.0  B takes the sign of z by blend
+ *   2.0  r is kept at least BRK_rmin*A by a max for E and F
+ *   2.1  lanes in the core about the centre (r < BRK_rpol*A and
+ *        B*|z| <= 2*c, which holds the evolute and so every d < 0)
+ *        are redone by xyz2plhe, which takes them to xyz2plhn
+ *   3.0  the d >= 0 root is taken for every lane with a real cube
+ *        root.  Where xyz2plh's pow() of a negative base returns
+ *        NaN this kernel returns the real root.
+ *   4.0  the v improvement is computed for every lane and blended in
+ *   4.1  the polar Newton step of t is computed for every lane and
+ *        blended in where the lane is in the polar cap
+ *   5.0  cos(Phi) and sin(Phi) follow from tan(Phi) = num/den without
+ *        trigonometric calls
+ *   6.0  the 2 pi wrap of longitude is blended in
+ *
+ * The differences from xyz2plhe are then the rounding of vatan, vatan2
+ * and vcbrt (about 1 ulp each) and of the algebraic cos/sin.  Points
+ * on or near the Z axis stay on the vector path: only core lanes go to
+ * the scalar routine, points within 100 km of the centre.
+ *
+ ********1*********2*********3*********4*********5*********6*********7**
+ * Modification History:
+ * 2610.18, GD,  Creation
+ * 2610.18, GD,  Ellipsoid from the registry rather than A, FL
+ * 2610.18, GD,  Z axis and polar cap (steps 2.0, 4.1), as xyz2plhe
+ * 2610.18, GD,  Core lanes rather than d < 0 ones to xyz2plhe
+ * 2610.18, GD,  Body moved to plhkern, shared with xyz2plhov_avx2
+ ********1*********2*********3*********4*********5*********6*********7*/
+{
+        plhkern( n, x, y, z, lat, lon, hgt, ell, OUT_plh );
+}
+
+
+void xyz2plhov_avx2( int n, int mask, double *x, double *y, double *z,
+                     double *lat, double *lon, double *hgt,
+                     struct ellipsoid *ell )
+/********1*********2*********3*********4*********5*********6*********7**
+ * Name:        xyz2plhov_avx2
+ * Version:     2610.18
+ * Author:      geoData
+ * Purpose:     AVX2 kernel of xyz2plhov; xyz2plhv_avx2 computing only
+ *              the outputs in mask.
+ *
+ * Input:
+ * -----------
+ * see xyz2plhov
+ *
+ * Output:
+ * -----------
+ * see xyz2plhov
+ *
+ * Notes:
+ * -----------
+ * One copy of plhkern per mask, each with the steps of the others
+ * left out: longitude alone is one vatan2 and no Borkowski; latitude
+ * and height alone skip the vatan2 of step 6.0, height alone also the
+ * vatan of the latitude (its cos and sin are algebraic either way),
+ * and latitude alone step 5.0.  What is computed is computed as by
+ * xyz2plhv_avx2, so the results are identical.
+ *
+ ********1*********2*********3*********4*********5*********6*********7**
+ * Modification History:
+ * 2610.18, GD,  Creation
+ ********1*********2*********3*********4*********5*********6*********7*/
+{
+        switch( mask & OUT_plh ) {
+        case OUT_lat:
+                plhkern( n, x, y, z, lat, lon, hgt, ell, OUT_lat );
+                break;
+        case OUT_lon:
+                plhkern( n, x, y, z, lat, lon, hgt, ell, OUT_lon );
+                break;
+        case OUT_hgt:
+                plhkern( n, x, y, z, lat, lon, hgt, ell, OUT_hgt );
+                break;
+        case OUT_lat | OUT_lon:
+                plhkern( n, x, y, z, lat, lon, hgt, ell, OUT_lat | OUT_lon );
+                break;
+        case OUT_lat | OUT_hgt:
+                plhkern( n, x, y, z, lat, lon, hgt, ell, OUT_lat | OUT_hgt );
+                break;
+        case OUT_lon | OUT_hgt:
+                plhkern( n, x, y, z, lat, lon, hgt, ell, OUT_lon | OUT_hgt );
+                break;
+        case OUT_plh:
+                plhkern( n, x, y, z, lat, lon, hgt, ell, OUT_plh );
+                break;
+        }
+}
+
+
+static inline void plhkern( int n, double *x, double *y, double *z,
+                            double *lat, double *lon, double *hgt,
+                            struct ellipsoid *ell, const int mask )
+/********1*********2*********3*********4*********5*********6*********7**
+ * Purpose:     the kernel of xyz2plhv_avx2 for the outputs in mask.
+ *              Called with a constant mask, the steps of the outputs
+ *              not wanted and their stores drop out; those arrays are
+ *              not touched and may be NULL.
+ ********1*********2*********3*********4*********5*********6*********7*/
+{
+        double A= ell->A;
+        double bx[4];
+        double by[4];
+        double bz[4];
+        double plh[3];
+        double tlat[4];
+        double tlon[4];
+        double thgt[4];
+        double xyz[3];
+        int i;
+        int k;
+        int lanes;
+        int m;
+        __m256d vA= vconst( A );
+        __m256d vB= vconst( ell->B );
+        __m256d vc= vconst( ell->c );
+        __m256d Bz;
+        __m256d Bs;
+        __m256d cs;
+        __m256d d;
+        __m256d den;
+        __m256d e;
+        __m256d f;
+        __m256d g;
+        __m256d hyp;
+        __m256d num;
+        __m256d p;
+        __m256d pol;
+        __m256d q;
+        __m256d r;
+        __m256d sd;
+        __m256d sn;
+        __m256d t;
+        __m256d v;
+        __m256d vi;
+        __m256d vx;
+        __m256d vy;
+        __m256d vz;
+        __m256d zl;
+        double *px;
+        double *py;
+        double *pz;
+        double *plat;
+        double *plon;
+        double *phgt;
+
+        for( i= 0; i < n; i+= 4 ) {
+                lanes= n - i < 4 ? n - i : 4;
+                if( lanes == 4 ) {
+                        px= x + i;
+                        py= y + i;
+                        pz= z + i;
+                        plat= mask & OUT_lat ? lat + i : tlat;
+                        plon= mask & OUT_lon ? lon + i : tlon;
+                        phgt= mask & OUT_hgt ? hgt + i : thgt;
+                } else {
+                        for( k= 0; k < 4; k++ ) {
+                                bx[k]= k < lanes ? x[i+k] : A;
+                                by[k]= k < lanes ? y[i+k] : ZERO;
+                                bz[k]= k < lanes ? z[i+k] : ZERO;
+                        }
+                        px= bx;
+                        py= by;
+                        pz= bz;
+                        plat= tlat;
+                        plon= tlon;
+                        phgt= thgt;
+                }
+                vx= _mm256_loadu_pd( px );
+                vy= _mm256_loadu_pd( py );
+                vz= _mm256_loadu_pd( pz );
+/*
+ *   1.0 semi-minor axis with the sign of z
+ */
+                Bs= vblend( _mm256_cmp_pd( vz, vconst( ZERO ), _CMP_LT_OQ ),
+                            _mm256_sub_pd( vconst( ZERO ), vB ), vB );
+/*
+ *   2.0 intermediate values for latitude
+ */
+                r= _mm256_sqrt_pd( _mm256_add_pd( _mm256_mul_pd( vx, vx ),
+                                                  _mm256_mul_pd( vy, vy ) ) );
+                t= _mm256_mul_pd( vA,
+                                  _mm256_max_pd( vconst( BRK_rmin*A ), r ) );
+                Bz= _mm256_mul_pd( Bs, vz );
+                e= _mm256_div_pd( _mm256_sub_pd( Bz, vc ), t );
+                f= _mm256_div_pd( _mm256_add_pd( Bz, vc ), t );
+/*
+ *   3.0 t^4 + 2*E*t^3 + 2*F*t - 1 = 0, real root branch
+ */
+                p= _mm256_mul_pd( vconst( FOUR / THREE ),
+                        _mm256_add_pd( _mm256_mul_pd( e, f ), vconst( ONE ) ) );
+                q= _mm256_mul_pd( vconst( TWO ),
+                        _mm256_sub_pd( _mm256_mul_pd( e, e ),
+                                       _mm256_mul_pd( f, f ) ) );
+                d= _mm256_add_pd( _mm256_mul_pd( _mm256_mul_pd( p, p ), p ),
+                                  _mm256_mul_pd( q, q ) );
+                m= mask & (OUT_lat | OUT_hgt)
+                   ? _mm256_movemask_pd( _mm256_and_pd(
+                        _mm256_cmp_pd( r, vconst( BRK_rpol*A ), _CMP_LT_OQ ),
+                        _mm256_cmp_pd( Bz, _mm256_mul_pd( vconst( TWO ), vc ),
+                                       _CMP_LE_OQ ) ) ) : 0;
+                sd= _mm256_sqrt_pd( _mm256_max_pd( d, vconst( ZERO ) ) );
+                v= _mm256_sub_pd( vcbrt( _mm256_sub_pd( sd, q ) ),
+                                  vcbrt( _mm256_add_pd( sd, q ) ) );
+/*
+ *   4.0 improve v where v*v < |p|
+ */
+                vi= _mm256_div_pd( _mm256_sub_pd( vconst( ZERO ),
+                        _mm256_add_pd(
+                                _mm256_mul_pd( _mm256_mul_pd( v, v ), v ),
+                                _mm256_mul_pd( vconst( TWO ), q ) ) ),
+                        _mm256_mul_pd( vconst( THREE ), p ) );
+                v= vblend( _mm256_cmp_pd( _mm256_mul_pd( v, v ), vabs( p ),
+                                          _CMP_LT_OQ ), vi, v );
+                g= _mm256_mul_pd( vconst( 0.5 ), _mm256_add_pd( _mm256_sqrt_pd(
+                        _mm256_add_pd( _mm256_mul_pd( e, e ), v ) ), e ) );
+                t= _mm256_sub_pd( _mm256_sqrt_pd( _mm256_add_pd(
+                        _mm256_mul_pd( g, g ),
+                        _mm256_div_pd(
+                                _mm256_sub_pd( f, _mm256_mul_pd( v, g ) ),
+                                _mm256_sub_pd(
+                                        _mm256_mul_pd( vconst( TWO ), g ),
+                                        e ) ) ) ), g );
+/*
+ *   4.1 polar cap: t -= (r*t^4 + 2*E'*t^3 + 2*F'*t - r)
+ *                      / (4*r*t^3 + 6*E'*t^2 + 2*F')
+ */
+                pol= _mm256_and_pd(
+                        _mm256_cmp_pd( r, vconst( BRK_rpol*A ), _CMP_LT_OQ ),
+                        _mm256_cmp_pd( Bz, _mm256_mul_pd( vconst( TWO ), vc ),
+                                       _CMP_GT_OQ ) );
+                e= _mm256_mul_pd( _mm256_sub_pd( Bz, vc ), vconst( ONE / A ) );
+                f= _mm256_mul_pd( _mm256_add_pd( Bz, vc ), vconst( ONE / A ) );
+                g= _mm256_mul_pd( t, t );
+                num= _mm256_sub_pd( _mm256_fmadd_pd( _mm256_mul_pd(
+                        _mm256_fmadd_pd( r, t, _mm256_add_pd( e, e ) ), t ), g,
+                        _mm256_mul_pd( _mm256_add_pd( f, f ), t ) ), r );
+                den= _mm256_fmadd_pd( _mm256_fmadd_pd( _mm256_mul_pd(
+                        vconst( FOUR ), r ), t,
+                        _mm256_mul_pd( vconst( TWO*THREE ), e ) ), g,
+                        _mm256_add_pd( f, f ) );
+                t= vblend( pol,
+                           _mm256_sub_pd( t, _mm256_div_pd( num, den ) ), t );
+
+                num= _mm256_mul_pd( vA,
+                        _mm256_sub_pd( vconst( ONE ), _mm256_mul_pd( t, t ) ) );
+                den= _mm256_mul_pd( _mm256_mul_pd( vconst( TWO ), Bs ), t );
+                if( mask & OUT_lat )
+                        _mm256_storeu_pd( plat,
+                                _mm256_mul_pd( vconst( rad_to_deg ),
+                                vatan( _mm256_div_pd( num, den ) ) ) );
+/*
+ *   5.0 height above ellipsoid
+ */
+                hyp= _mm256_sqrt_pd( _mm256_add_pd( _mm256_mul_pd( num, num ),
+                        _mm256_mul_pd( den, den ) ) );
+                cs= _mm256_div_pd( vabs( den ), hyp );
+                sn= _mm256_div_pd( _mm256_xor_pd( num, _mm256_and_pd( den,
+                                   vconst( -0.0 ) ) ), hyp );
+                if( mask & OUT_hgt )
+                        _mm256_storeu_pd( phgt, _mm256_add_pd(
+                                _mm256_mul_pd( _mm256_sub_pd( r,
+                                        _mm256_mul_pd( vA, t ) ), cs ),
+                                _mm256_mul_pd( _mm256_sub_pd( vz, Bs ),
+                                               sn ) ) );
+/*
+ *   6.0 longitude east of Greenwich
+ */
+                zl= vatan2( vy, vx );
+                zl= vblend( _mm256_cmp_pd( zl, vconst( ZERO ), _CMP_LT_OQ ),
+                            _mm256_add_pd( zl, vconst( twopi ) ), zl );
+                if( mask & OUT_lon )
+                        _mm256_storeu_pd( plon,
+                                _mm256_mul_pd( vconst( rad_to_deg ), zl ) );
+/*
+ *   core lanes: scalar routine
+ */
+                for( k= 0; m != 0 && k < lanes; k++ )
+                        if( m & (1 << k) ) {
+                                xyz[0]= px[k];
+                                xyz[1]= py[k];
+                                xyz[2]= pz[k];
+                                xyz2plhe( xyz, plh, ell );
+                                if( mask & OUT_lat )
+                                        plat[k]= plh[0];
+                                if( mask & OUT_lon )
+                                        plon[k]= plh[1];
+                                if( mask & OUT_hgt )
+                                        phgt[k]= plh[2];
+                        }
+
+                if( lanes < 4 )
+                        for( k= 0; k < lanes; k++ ) {
+                                if( mask & OUT_lat )
+                                        lat[i+k]= tlat[k];
+                                if( mask & OUT_lon )
+                                        lon[i+k]= tlon[k];
+                                if( mask & OUT_hgt )
+                                        hgt[i+k]= thgt[k];
+                        }
+        }
+}
+
+#else
+
+void xyz2plhv_avx2( int n, double *x, double *y, double *z,
+                    double *lat, double *lon, double *hgt,
+                    struct ellipsoid *ell )
+{
+        double plh[3];
+        double xyz[3];
+        int i;
+
+        for( i= 0; i < n; i++ ) {
+                xyz[0]= x[i];
+                xyz[1]= y[i];
+                xyz[2]= z[i];
+                xyz2plhe( xyz, plh, ell );
+                lat[i]= plh[0];
+                lon[i]= plh[1];
+                hgt[i]= plh[2];
+        }
+}
+
+
+void xyz2plhov_avx2( int n, int mask, double *x, double *y, double *z,
+                     double *lat, double *lon, double *hgt,
+                     struct ellipsoid *ell )
+{
+        double plh[3];
+        double xyz[3];
+        int i;
+
+        for( i= 0; i < n; i++ ) {
+                xyz[0]= x[i];
+                xyz[1]= y[i];
+                xyz[2]= z[i];
+                xyz2plhe( xyz, plh, ell );
+                if( mask & OUT_lat )
+                        lat[i]= plh[0];
+                if( mask & OUT_lon )
+                        lon[i]= plh[1];
+                if( mask & OUT_hgt )
+                        hgt[i]= plh[2];
+        }
+}
+
+#endif /* __AVX2__ */
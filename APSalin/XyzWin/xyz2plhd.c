@@ -0,0 +1,247 @@
+/*  @(#)xyz2plhd.c      1.0  26/10/18  */
+static char *sccsid= "@(#)xyz2plhd.c    1.0  26/10/18";
+/*
+ *      include files
+ */
+
+#include <math.h>
+#include "physcon.h"
+#include "libgpsC.h"
+
+/*
+ *      function prototypes
+ */
+
+int xyz2plhd( int, double *, double *, double *,
+              double *, double *, double *, struct ellipsoid *,
+              double, double );
+static int dspblock( int, double *, double *, double *,
+                     double *, double *, double *, struct ellipsoid *,
+                     int *, double );
+
+/*
+ *      definitions and global variables
+ *
+ *      DSP_nblk        points classified and regrouped at a time
+ *      DSP_nband       number of height bands
+ *      DSP_nsolv       number of solvers
+ *      DSP_hrel        bound of the height error of every solver, as a
+ *                      fraction of A + |h|
+ *      dsp_edge[]      upper edges of the height bands but the last [m]
+ *      dsp_fmax[][]    bound of the latitude error of each solver in
+ *                      each band [arcsec]; HUGE_VAL = never used there
+ *      dsp_solv[]      the batch solvers, by increasing accuracy
+ */
+
+#define DSP_nblk        ((int)256)
+#define DSP_nband       ((int)10)
+#define DSP_nsolv       ((int)3)
+#define DSP_hrel        ((double)2.0e-15)
+
+static const double dsp_edge[DSP_nband-1]= {
+        -2.0e6, -1.0e6, -3.0e5, -1.0e5, 1.0e5, 3.0e5, 1.0e6, 1.0e7, 1.0e10 };
+
+static const double dsp_fmax[DSP_nband][DSP_nsolv]= {
+/*        xyz2plhhv  xyz2plhv   xyz2plhhcv */
+        { HUGE_VAL,  4.6e-9,    7.3e-10 },      /*   deep, to the centre */
+        { 2.0e-5,    6.8e-9,    7.3e-10 },      /*  -2000 to -1000 km */
+        { 1.0e-6,    7.0e-9,    7.3e-10 },      /*  -1000 to  -300 km */
+        { 2.0e-8,    7.2e-9,    7.3e-10 },      /*   -300 to  -100 km */
+        { 9.4e-10,   7.0e-9,    7.3e-10 },      /*   -100 to   100 km */
+        { 1.0e-8,    9.4e-9,    7.3e-10 },      /*    100 to   300 km */
+        { 3.0e-7,    1.2e-8,    7.3e-10 },      /*    300 to  1000 km */
+        { 1.0e-5,    2.2e-8,    7.3e-10 },      /*   1000 to 10^4 km */
+        { 2.0e-5,    1.4e-5,    7.3e-10 },      /*  10^4 km to 10^7 km */
+        { 3.0e-3,    HUGE_VAL,  7.3e-10 } };    /*  beyond 10^7 km */
+
+static void (*const dsp_solv[DSP_nsolv])( int, double *, double *, double *,
+                                          double *, double *, double *,
+                                          struct ellipsoid * )= {
+        xyz2plhhv, xyz2plhv, xyz2plhhcv };
+
+
+int xyz2plhd( int n, double *x, double *y, double *z,
+              double *lat, double *lon, double *hgt, struct ellipsoid *ell,
+              double ftol, double htol )
+/********1*********2*********3*********4*********5*********6*********7**
+ * Name:        xyz2plhd
+ * Version:     2610.18
+ * Author:      geoData
+ * Purpose:     Converts arrays of XYZ geocentric coordinates to Phi
+ *              (latitude), Lambda (longitude), H (height), each point
+ *              by the cheapest solver that meets the given accuracy at
+ *              its height.
+ *
+ * Input:
+ * -----------
+ * ell              ellipsoid, with its derived constants (ellset)
+ * ftol             largest latitude error wanted [arcsec]
+ * htol             largest height error wanted [m]
+ * n                number of points
+ * x[], y[], z[]    geocentric Cartesian coordinates [m]
+ *
+ * Output:
+ * -----------
+ * lat[], lon[]     as xyz2plhv
+ * hgt[]
+ *
+ * returns      number of points no solver is known to convert within
+ *              ftol and htol; these are converted by xyz2plhhcv
+ *
+ * Notes:
+ * -----------
+ * The height is estimated as hs = sqrt(p^2 + (z*A/B)^2) - A, zero on
+ * the ellipsoid and within FL*|h| of h elsewhere, which is all the
+ * band boundaries need.  For each band, dsp_fmax[][] holds twice the
+ * largest latitude error of each solver against a double-double
+ * reference on 10^6 random points of the band, widened by 2%, with
+ * WGS84, scalar and AVX2; a quarter of the points are within 1e-3 rad
+ * of a pole, and in the deep band a quarter are in the core about the
+ * centre.  No solver does better than 3.6e-10 arcsec, the pi of
+ * physcon.h at 90 deg.  The error of xyz2plhv peaks just outside its
+ * polar cap (BRK_rpol) and grows with the distance, so it has no bound
+ * beyond 10^7 km.  The height error of all three is the rounding of the
+ * input, below 8.1e-16*(A + |h|) (with one Halley correction, 24 m
+ * below -2000 km), so a height tolerance either holds for every solver
+ * or for none.
+ *
+ * The solvers are tried in the order of their cost on this processor:
+ * with AVX2 xyz2plhhv (18 ns a point), xyz2plhv (46), xyz2plhhcv (200);
+ * without it the closed form of Borkowski costs more than Halley to
+ * convergence (220 against 180 ns) and is never used.  Trilateration
+ * (xyz2plht) is no more accurate than xyz2plhhcv and slower, so it is
+ * not a candidate.
+ *
+ * The points are taken DSP_nblk at a time; those of one solver are
+ * gathered together, so each batch call gets full vectors, and the
+ * results are put back in place.  A block that needs one solver only
+ * is converted where it lies.  The bounds hold for ellipsoids of the
+ * size and flattening of the Earth.
+ *
+ ********1*********2*********3*********4*********5*********6*********7**
+ * Modification History:
+ * 2610.18, GD,  Creation
+ ********1*********2*********3*********4*********5*********6*********7*/
+{
+        int pick[DSP_nband];
+        int i;
+        int k;
+        int m;
+        int nbad;
+        int s;
+        int vec= simd_level();
+
+/*
+ *   1.0 cheapest solver of each band that meets ftol
+ */
+        for( k= 0; k < DSP_nband; k++ ) {
+                pick[k]= DSP_nsolv - 1;
+                for( s= 0; s < DSP_nsolv - 1; s++ ) {
+                        if( s == 1 && vec < 1 )
+                                continue;
+                        if( dsp_fmax[k][s] <= ftol ) {
+                                pick[k]= s;
+                                break;
+                        }
+                }
+                if( dsp_fmax[k][pick[k]] > ftol )
+                        pick[k]= -1;
+        }
+
+/*
+ *   2.0 convert by blocks
+ */
+        nbad= 0;
+        for( i= 0; i < n; i+= m ) {
+                m= n - i < DSP_nblk ? n - i : DSP_nblk;
+                nbad+= dspblock( m, x + i, y + i, z + i,
+                                 lat + i, lon + i, hgt + i, ell, pick, htol );
+        }
+
+        return( nbad );
+}
+
+
+static int dspblock( int n, double *x, double *y, double *z,
+                     double *lat, double *lon, double *hgt,
+                     struct ellipsoid *ell, int *pick, double htol )
+/********1*********2*********3*********4*********5*********6*********7**
+ * Purpose:     one block of xyz2plhd: n <= DSP_nblk points by the
+ *              solvers of pick[] (-1 = none meets ftol), and the
+ *              number of points that meet neither tolerance
+ ********1*********2*********3*********4*********5*********6*********7*/
+{
+        double A= ell->A;
+        double aB= ell->A * ell->rB;
+        double hs;
+        double gx[DSP_nblk];
+        double gy[DSP_nblk];
+        double gz[DSP_nblk];
+        double ga[DSP_nblk];
+        double go[DSP_nblk];
+        double gh[DSP_nblk];
+        double zs;
+        int cnt[DSP_nsolv];
+        int first[DSP_nsolv];
+        int idx[DSP_nblk];
+        int i;
+        int j;
+        int k;
+        int nbad= 0;
+        int s;
+        unsigned char sol[DSP_nblk];
+
+/*
+ *   1.0 solver of each point, from its height band
+ */
+        for( s= 0; s < DSP_nsolv; s++ )
+                cnt[s]= 0;
+        for( i= 0; i < n; i++ ) {
+                zs= z[i] * aB;
+                hs= sqrt( x[i]*x[i] + y[i]*y[i] + zs*zs ) - A;
+                for( k= 0; k < DSP_nband - 1 && hs >= dsp_edge[k]; k++ )
+                        ;
+                s= pick[k];
+                if( s < 0 || !(htol >= DSP_hrel*(A + fabs( hs ))) ) {
+                        s= DSP_nsolv - 1;
+                        nbad++;
+                }
+                sol[i]= (unsigned char)s;
+                cnt[s]++;
+        }
+
+/*
+ *   2.0 one solver: convert in place
+ */
+        for( s= 0; s < DSP_nsolv; s++ )
+                if( cnt[s] == n ) {
+                        dsp_solv[s]( n, x, y, z, lat, lon, hgt, ell );
+                        return( nbad );
+                }
+
+/*
+ *   3.0 gather the points of each solver, convert, scatter back
+ */
+        for( s= 0, j= 0; s < DSP_nsolv; s++ ) {
+                first[s]= j;
+                j+= cnt[s];
+        }
+        for( i= 0; i < n; i++ ) {
+                j= first[sol[i]]++;
+                idx[j]= i;
+                gx[j]= x[i];
+                gy[j]= y[i];
+                gz[j]= z[i];
+        }
+        for( s= 0, j= 0; s < DSP_nsolv; j+= cnt[s], s++ )
+                if( cnt[s] > 0 )
+                        dsp_solv[s]( cnt[s], gx + j, gy + j, gz + j,
+                                     ga + j, go + j, gh + j, ell );
+        for( j= 0; j < n; j++ ) {
+                lat[idx[j]]= ga[j];
+                lon[idx[j]]= go[j];
+                hgt[idx[j]]= gh[j];
+        }
+
+        return( nbad );
+}
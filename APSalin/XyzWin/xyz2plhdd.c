@@ -0,0 +1,580 @@
+/*  @(#)xyz2plhdd.c     1.0  26/10/18  */
+static char *sccsid= "@(#)xyz2plhdd.c   1.0  26/10/18";
+/*
+ *      include files
+ */
+
+#include <math.h>
+#include <pthread.h>
+#include "physcon.h"
+#include "libgpsC.h"
+#include "ddmath.h"
+
+/*
+ *      function prototypes
+ */
+
+int ddfoot( double *, double *, struct ellipsoid * );
+const struct dd_trig *ddtrig( void );
+void plh2xyzdd( double *, double *, struct ellipsoid * );
+void plh2xyzddv( int, double *, double *, double *,
+                 double *, double *, double *,
+                 double *, double *, double *, struct ellipsoid * );
+void plh2xyzddv_avx2( int, double *, double *, double *,
+                      double *, double *, double *,
+                      double *, double *, double *, struct ellipsoid * );
+void xyz2plhdd( double *, double *, struct ellipsoid * );
+void xyz2plhddv( int, double *, double *, double *,
+                 double *, double *, double *,
+                 double *, double *, double *, struct ellipsoid * );
+void xyz2plhddv_avx2( int, double *, double *, double *,
+                      double *, double *, double *,
+                      double *, double *, double *, struct ellipsoid * );
+static inline void ddfwd( struct dd *, struct dd *, double *, double,
+                          struct dd, struct dd, const struct dd_trig * );
+static inline void ddnewton( double *, struct dd *, double, struct dd,
+                             struct dd, const struct dd_trig * );
+static inline void ddsincos( struct dd, struct dd *, struct dd *,
+                             const struct dd_trig * );
+static void trigmake( void );
+
+/*
+ *      definitions and global variables
+ *
+ *      DD_niter        Newton corrections of xyz2plhdd
+ *      dd_once         makes trig once, whatever the number of threads
+ *      trig            the tables and constants (ddmath.h)
+ */
+
+#define DD_niter        ((int)2)
+
+static pthread_once_t dd_once= PTHREAD_ONCE_INIT;
+static struct dd_trig trig;
+
+
+int ddfoot( double *xyz, double *plh, struct ellipsoid *ell )
+/********1*********2*********3*********4*********5*********6*********7**
+ * Name:        ddfoot
+ * Version:     2610.18
+ * Author:      geoData
+ * Purpose:     Tells whether lat, hgt are of the nearest foot of the
+ *              point xyz[] rather than of another normal through it.
+ *
+ * Input:
+ * -----------
+ * ell              ellipsoid
+ * plh[]            lat, lon [deg], hgt [m], a result of xyz2plhdd
+ * xyz[]            geocentric Cartesian coordinates [m]
+ *
+ * Output:
+ * -----------
+ * returns      1 if the foot is on the side of the equator of the point
+ *              and the point within both radii of curvature of it,
+ *              M + h >= 0 and N + h >= 0; 0 if not or not finite
+ *
+ * Notes:
+ * -----------
+ * Inside the evolute, |Z| < c/B and distance from the axis < c/A,
+ * up to four normals pass through a point; Newton converges to the
+ * foot of whichever is nearest its start.  Only the nearest foot is
+ * a minimum of the distance, for which the point must lie within the
+ * centres of curvature, and on the axis the other pole meets the
+ * first test.
+ *
+ ********1*********2*********3*********4*********5*********6*********7**
+ * Modification History:
+ * 2610.18, GD,  Creation
+ ********1*********2*********3*********4*********5*********6*********7*/
+{
+        double N;
+        double s;
+        double w;
+
+        s= sin( plh[0] * (DD_pihi/180.0) );
+        w= ONE - ell->e2*s*s;
+        N= ell->A / sqrt( w );
+
+        return( plh[0]*xyz[2] >= ZERO && N + plh[2] >= ZERO
+                && N*ell->funsq/w + plh[2] >= ZERO );
+}
+
+
+const struct dd_trig *ddtrig( void )
+/********1*********2*********3*********4*********5*********6*********7**
+ * Name:        ddtrig
+ * Version:     2610.18
+ * Author:      geoData
+ * Purpose:     Returns the sine and cosine tables and the constants of
+ *              the double-double conversions, making them on the first
+ *              call.
+ *
+ * Output:
+ * -----------
+ * returns      the dd_trig (ddmath.h); read only
+ *
+ ********1*********2*********3*********4*********5*********6*********7**
+ * Modification History:
+ * 2610.18, GD,  Creation
+ ********1*********2*********3*********4*********5*********6*********7*/
+{
+        pthread_once( &dd_once, trigmake );
+
+        return( &trig );
+}
+
+
+static void trigmake( void )
+/********1*********2*********3*********4*********5*********6*********7**
+ * Purpose:     fills in trig: the series of sine and cosine summed in
+ *              double-double to 1e-40 at each of j*pi/1440, j <
+ *              DD_ntab, and pi/180, -1/6, 1/24.
+ ********1*********2*********3*********4*********5*********6*********7*/
+{
+        struct dd c;
+        struct dd ddpi= { DD_pihi, DD_pilo };
+        struct dd r;
+        struct dd r2;
+        struct dd s;
+        struct dd step;
+        struct dd tc;
+        struct dd ts;
+        struct dd one= { ONE, ZERO };
+        int j;
+        int k;
+
+        trig.d2r= dddiv( ddpi, ddsum( 180.0, ZERO ) );
+        trig.s3= ddneg( dddiv( one, ddsum( 6.0, ZERO ) ) );
+        trig.c4= dddiv( one, ddsum( 24.0, ZERO ) );
+        step= dddiv( ddpi, ddsum( 1440.0, ZERO ) );
+
+        for( j= 0; j < DD_ntab; j++ ) {
+                r= ddmuld( step, (double)j );
+                r2= ddmul( r, r );
+                s= ts= r;
+                c= tc= one;
+                for( k= 1; fabs( ts.hi ) + fabs( tc.hi ) > 1.0e-40; k++ ) {
+                        tc= ddneg( dddiv( ddmul( tc, r2 ),
+                                ddsum( (double)((2*k - 1)*(2*k)), ZERO ) ) );
+                        ts= ddneg( dddiv( ddmul( ts, r2 ),
+                                ddsum( (double)((2*k)*(2*k + 1)), ZERO ) ) );
+                        c= ddadd( c, tc );
+                        s= ddadd( s, ts );
+                }
+                trig.sh[j]= s.hi;
+                trig.sl[j]= s.lo;
+                trig.ch[j]= c.hi;
+                trig.cl[j]= c.lo;
+        }
+}
+
+
+static inline void ddsincos( struct dd x, struct dd *s, struct dd *c,
+                             const struct dd_trig *t )
+/********1*********2*********3*********4*********5*********6*********7**
+ * Purpose:     sine and cosine of x [deg] in double-double.  x.hi =
+ *              k/8 + f exactly, |f| <= 1/16; the table gives k/8 and
+ *              r = (f + x.lo)*pi/180, |r| < 1.1e-3, the series
+ *                sin r = r + r^3*(-1/6 + r^2/120 - r^4/5040 + r^6/9!)
+ *                cos r = 1 - r^2/2 + r^4*(1/24 - r^2/720 + r^4/8!)
+ *              whose higher terms are below 1e-33.  A non-finite or
+ *              huge x takes entry 0 and gives NaN.
+ ********1*********2*********3*********4*********5*********6*********7*/
+{
+        struct dd a;
+        struct dd b;
+        struct dd cr;
+        struct dd r;
+        struct dd sr;
+        struct dd z;
+        double k;
+        double m;
+        double zh;
+        int j;
+        int q;
+
+        k= nearbyint( x.hi * 8.0 );
+        r= ddmul( ddsum( x.hi - k*0.125, x.lo ), t->d2r );
+        m= k - 2880.0*floor( k * (1.0/2880.0) );
+        if( !(m >= ZERO && m < 2880.0) )
+                m= ZERO;
+        q= (int)m / DD_ntab;
+        j= (int)m - q*DD_ntab;
+
+        z= ddmul( r, r );
+        zh= z.hi;
+        sr= ddaddd( t->s3,
+                    zh*(1.0/120.0 + zh*(-1.0/5040.0 + zh*(1.0/362880.0))) );
+        sr= ddadd( r, ddmul( ddmul( r, z ), sr ) );
+        cr= ddaddd( t->c4, zh*(-1.0/720.0 + zh*(1.0/40320.0)) );
+        cr= ddadd( ddmul( ddmul( z, z ), cr ),
+                   ddaddd( ddmuld( z, -0.5 ), ONE ) );
+
+        a.hi= t->sh[j];
+        a.lo= t->sl[j];
+        b.hi= t->ch[j];
+        b.lo= t->cl[j];
+        *s= ddadd( ddmul( a, cr ), ddmul( b, sr ) );
+        *c= ddadd( ddmul( b, cr ), ddneg( ddmul( a, sr ) ) );
+/*
+ *   quadrant q: sin(q*90 + y) is sin y, cos y, -sin y, -cos y
+ */
+        if( q & 1 ) {
+                a= *s;
+                *s= *c;
+                *c= ddneg( a );
+        }
+        if( q & 2 ) {
+                *s= ddneg( *s );
+                *c= ddneg( *c );
+        }
+}
+
+
+static inline void ddfwd( struct dd *plh, struct dd *xyz, double *aux,
+                          double A, struct dd e2, struct dd ome2,
+                          const struct dd_trig *t )
+/********1*********2*********3*********4*********5*********6*********7**
+ * Purpose:     X, Y, Z of lat, lon [deg], hgt [m] in double-double,
+ *                N = A/sqrt(1 - e2*sin^2(lat)),  X = (N + h)cos(lat)cos(lon)
+ *                Y = (N + h)cos(lat)sin(lon),    Z = (N(1 - e2) + h)sin(lat)
+ *              and in aux[] the doubles ddnewton corrects with: sin,
+ *              cos of lat, of lon, N + h, M + h (M the meridian radius).
+ ********1*********2*********3*********4*********5*********6*********7*/
+{
+        struct dd cl;
+        struct dd cp;
+        struct dd nh;
+        struct dd rn;
+        struct dd sl;
+        struct dd sp;
+        struct dd w;
+        struct dd y2;
+        double e;
+        double y;
+
+        ddsincos( plh[0], &sp, &cp, t );
+        ddsincos( plh[1], &sl, &cl, t );
+/*
+ *   1/sqrt(w): y from the double square root, then one correction
+ *   y*(1 + e/2 + 3e^2/8), e = 1 - w*y^2
+ */
+        w= ddaddd( ddneg( ddmul( e2, ddmul( sp, sp ) ) ), ONE );
+        y= ONE / sqrt( w.hi );
+        y2= ddprod( y, y );
+        e= ddaddd( ddneg( ddmul( w, y2 ) ), ONE ).hi;
+        rn= ddmuld( ddaddd( ddsum( y, ZERO ), y*e*(0.5 + 0.375*e) ), A );
+
+        nh= ddadd( rn, plh[2] );
+        xyz[0]= ddmul( ddmul( nh, cp ), cl );
+        xyz[1]= ddmul( ddmul( nh, cp ), sl );
+        xyz[2]= ddmul( ddadd( ddmul( rn, ome2 ), plh[2] ), sp );
+
+        aux[0]= sp.hi;
+        aux[1]= cp.hi;
+        aux[2]= sl.hi;
+        aux[3]= cl.hi;
+        aux[4]= nh.hi;
+        aux[5]= rn.hi * ome2.hi / w.hi + plh[2].hi;
+}
+
+
+static inline void ddnewton( double *xyz, struct dd *plh, double A,
+                             struct dd e2, struct dd ome2,
+                             const struct dd_trig *t )
+/********1*********2*********3*********4*********5*********6*********7**
+ * Purpose:     DD_niter Newton corrections of lat, lon [deg], hgt [m]
+ *              towards the point xyz[]; see xyz2plhdd
+ ********1*********2*********3*********4*********5*********6*********7*/
+{
+        struct dd r[3];
+        double aux[6];
+        double d;
+        int k;
+
+        for( k= 0; k < DD_niter; k++ ) {
+                ddfwd( plh, r, aux, A, e2, ome2, t );
+                r[0]= ddaddd( ddneg( r[0] ), xyz[0] );
+                r[1]= ddaddd( ddneg( r[1] ), xyz[1] );
+                r[2]= ddaddd( ddneg( r[2] ), xyz[2] );
+                d= aux[3]*r[0].hi + aux[2]*r[1].hi;
+                plh[0]= ddaddd( plh[0], (aux[1]*r[2].hi - aux[0]*d)
+                                        / aux[5] * (180.0/DD_pihi) );
+                if( aux[1]*aux[4] != ZERO )
+                        plh[1]= ddaddd( plh[1],
+                                        (aux[3]*r[1].hi - aux[2]*r[0].hi)
+                                        / (aux[1]*aux[4]) * (180.0/DD_pihi) );
+                plh[2]= ddaddd( plh[2], aux[1]*d + aux[0]*r[2].hi );
+        }
+}
+
+
+void plh2xyzdd( double *plh, double *xyz, struct ellipsoid *ell )
+/********1*********2*********3*********4*********5*********6*********7**
+ * Name:        plh2xyzdd
+ * Version:     2610.18
+ * Author:      geoData
+ * Purpose:     Converts Phi (latitude), Lambda (longitude), H (height)
+ *              to XYZ geocentric coordinates in double-double, as a
+ *              reference for the double routines.
+ *
+ * Input:
+ * -----------
+ * ell              ellipsoid; A and FL are taken as exact
+ * plh[]            as plh2xyz [deg, deg, m], exact
+ *
+ * Output:
+ * -----------
+ * xyz[]            X, Y, Z [m]: leading parts in xyz[0..2], trailing
+ *                  parts in xyz[3..5]; xyz[0] + xyz[3] is X to about
+ *                  1e-31 relative
+ *
+ * Notes:
+ * -----------
+ * e2 is FL*(2 - FL) in double-double and degrees are pi/180 of the
+ * true pi.  (physcon.h has pi cut to 15 digits, so plh2xyz and xyz2plh
+ * turn degrees to radians 1e-15 too small, up to 4e-8 m at the
+ * surface; that is part of their error measured against these.)
+ *
+ * The sine and cosine are of 1/8 deg from a table (ddtrig) and of the
+ * rest, below 1.1e-3 rad, by series; 1/sqrt(1 - e2*sin^2) is the
+ * double one with one correction.  No library function but sqrt is
+ * used, so the result is the same on any machine with FMA.
+ *
+ ********1*********2*********3*********4*********5*********6*********7**
+ * Modification History:
+ * 2610.18, GD,  Creation
+ ********1*********2*********3*********4*********5*********6*********7*/
+{
+        const struct dd_trig *t= ddtrig();
+        struct dd e2= ddmuld( ddsum( TWO, -ell->FL ), ell->FL );
+        struct dd p[3];
+        struct dd r[3];
+        double aux[6];
+        int k;
+
+        for( k= 0; k < 3; k++ ) {
+                p[k].hi= plh[k];
+                p[k].lo= ZERO;
+        }
+        ddfwd( p, r, aux, ell->A, e2, ddaddd( ddneg( e2 ), ONE ), t );
+        for( k= 0; k < 3; k++ ) {
+                xyz[k]= r[k].hi;
+                xyz[3+k]= r[k].lo;
+        }
+}
+
+
+void xyz2plhdd( double *xyz, double *plh, struct ellipsoid *ell )
+/********1*********2*********3*********4*********5*********6*********7**
+ * Name:        xyz2plhdd
+ * Version:     2610.18
+ * Author:      geoData
+ * Purpose:     Converts XYZ geocentric coordinates to Phi (latitude),
+ *              Lambda (longitude), H (height) in double-double, as a
+ *              reference for the double routines.
+ *
+ * Input:
+ * -----------
+ * ell              ellipsoid; A and FL are taken as exact
+ * xyz[]            geocentric Cartesian coordinates [m], exact
+ *
+ * Output:
+ * -----------
+ * plh[]            lat, lon [deg], hgt [m]: leading parts in plh[0..2],
+ *                  trailing parts in plh[3..5]; plh[0] + plh[3] is the
+ *                  latitude to about 1e-30 deg, plh[2] + plh[5] the
+ *                  height to about 1e-24 m
+ *
+ * Notes:
+ * -----------
+ * Starting from xyz2plhe, DD_niter Newton corrections of lat, lon, h.
+ * The residual R = X, Y, Z - plh2xyzdd(lat, lon, h) is made in
+ * double-double; it is then split along the north, east and normal
+ * directions and divided by M + h, (N + h)cos(lat) and 1 in double,
+ * since it is 1e-8 m or less: the first correction leaves about
+ * 1e-24 m, the second the rounding of the double-double result.
+ * Points on the Z axis keep the longitude of the start.  Near the
+ * centre of the ellipsoid a point has more than one foot and Newton
+ * goes to the one nearest the start; a result that is not the
+ * nearest foot (ddfoot) is made again from xyz2plhn.
+ *
+ ********1*********2*********3*********4*********5*********6*********7**
+ * Modification History:
+ * 2610.18, GD,  Creation
+ * 2610.18, GD,  Made again from xyz2plhn if not the nearest foot
+ ********1*********2*********3*********4*********5*********6*********7*/
+{
+        const struct dd_trig *t= ddtrig();
+        struct dd e2= ddmuld( ddsum( TWO, -ell->FL ), ell->FL );
+        struct dd p[3];
+        double start[3];
+        int j;
+        int k;
+
+        xyz2plhe( xyz, start, ell );
+        for( j= 0; j < 2; j++ ) {
+                for( k= 0; k < 3; k++ ) {
+                        p[k].hi= start[k];
+                        p[k].lo= ZERO;
+                }
+                ddnewton( xyz, p, ell->A, e2, ddaddd( ddneg( e2 ), ONE ), t );
+                for( k= 0; k < 3; k++ ) {
+                        plh[k]= p[k].hi;
+                        plh[3+k]= p[k].lo;
+                }
+                if( ddfoot( xyz, plh, ell ) )
+                        break;
+                xyz2plhn( xyz, start, ell->A, ell->FL );
+        }
+}
+
+
+void plh2xyzddv( int n, double *lat, double *lon, double *hgt,
+                 double *x, double *y, double *z,
+                 double *xl, double *yl, double *zl, struct ellipsoid *ell )
+/********1*********2*********3*********4*********5*********6*********7**
+ * Name:        plh2xyzddv
+ * Version:     2610.18
+ * Author:      geoData
+ * Purpose:     Converts arrays of Phi (latitude), Lambda (longitude),
+ *              H (height) to XYZ geocentric coordinates in
+ *              double-double.  Batch form of plh2xyzdd.
+ *
+ * Input:
+ * -----------
+ * ell              ellipsoid; A and FL are taken as exact
+ * lat[], lon[]     geodetic latitude and longitude east of Greenwich
+ *                  [degrees]
+ * hgt[]            height above the ellipsoid [m]
+ * n                number of points
+ *
+ * Output:
+ * -----------
+ * x[], y[], z[]    geocentric Cartesian coordinates [m], leading parts
+ * xl[], yl[], zl[] trailing parts; NULL if not wanted
+ *
+ * Notes:
+ * -----------
+ * When the processor has AVX2 and FMA the points are converted four at
+ * a time by plh2xyzddv_avx2 (see xyz2plhdda.c), otherwise as by
+ * plh2xyzdd.  Both make the same operations and give the same results.
+ *
+ ********1*********2*********3*********4*********5*********6*********7**
+ * Modification History:
+ * 2610.18, GD,  Creation
+ ********1*********2*********3*********4*********5*********6*********7*/
+{
+        const struct dd_trig *t= ddtrig();
+        struct dd e2;
+        struct dd ome2;
+        struct dd plh[3];
+        struct dd xyz[3];
+        double aux[6];
+        int i;
+
+        if( simd_level() >= 1 ) {
+                plh2xyzddv_avx2( n, lat, lon, hgt, x, y, z, xl, yl, zl, ell );
+                return;
+        }
+
+        e2= ddmuld( ddsum( TWO, -ell->FL ), ell->FL );
+        ome2= ddaddd( ddneg( e2 ), ONE );
+        for( i= 0; i < n; i++ ) {
+                plh[0]= ddsum( lat[i], ZERO );
+                plh[1]= ddsum( lon[i], ZERO );
+                plh[2]= ddsum( hgt[i], ZERO );
+                ddfwd( plh, xyz, aux, ell->A, e2, ome2, t );
+                x[i]= xyz[0].hi;
+                y[i]= xyz[1].hi;
+                z[i]= xyz[2].hi;
+                if( xl != NULL ) {
+                        xl[i]= xyz[0].lo;
+                        yl[i]= xyz[1].lo;
+                        zl[i]= xyz[2].lo;
+                }
+        }
+}
+
+
+void xyz2plhddv( int n, double *x, double *y, double *z,
+                 double *lat, double *lon, double *hgt,
+                 double *latl, double *lonl, double *hgtl,
+                 struct ellipsoid *ell )
+/********1*********2*********3*********4*********5*********6*********7**
+ * Name:        xyz2plhddv
+ * Version:     2610.18
+ * Author:      geoData
+ * Purpose:     Converts arrays of XYZ geocentric coordinates to Phi
+ *              (latitude), Lambda (longitude), H (height) in
+ *              double-double.  Batch form of xyz2plhdd.
+ *
+ * Input:
+ * -----------
+ * ell              ellipsoid; A and FL are taken as exact
+ * n                number of points
+ * x[], y[], z[]    geocentric Cartesian coordinates [m], exact
+ *
+ * Output:
+ * -----------
+ * lat[], lon[]     as xyz2plhv, leading parts [deg]
+ * hgt[]            leading part of the height [m]
+ * latl[], lonl[],  trailing parts; NULL if not wanted
+ * hgtl[]
+ *
+ * Notes:
+ * -----------
+ * The start is xyz2plhv rather than xyz2plhe.  When the processor has
+ * AVX2 and FMA the corrections are made four points at a time by
+ * xyz2plhddv_avx2 (see xyz2plhdda.c), at about 10 times the cost of
+ * xyz2plhv alone, so every point of a run can be checked against it.
+ * A point whose result is not the nearest foot (ddfoot) is made again
+ * by xyz2plhdd.
+ *
+ ********1*********2*********3*********4*********5*********6*********7**
+ * Modification History:
+ * 2610.18, GD,  Creation
+ * 2610.18, GD,  Points not at the nearest foot again by xyz2plhdd
+ ********1*********2*********3*********4*********5*********6*********7*/
+{
+        const struct dd_trig *t= ddtrig();
+        struct dd e2;
+        struct dd ome2;
+        struct dd plh[3];
+        double p[6];
+        double xyz[3];
+        int i;
+        int k;
+
+        if( simd_level() >= 1 ) {
+                xyz2plhddv_avx2( n, x, y, z, lat, lon, hgt,
+                                 latl, lonl, hgtl, ell );
+                return;
+        }
+
+        xyz2plhv( n, x, y, z, lat, lon, hgt, ell );
+        e2= ddmuld( ddsum( TWO, -ell->FL ), ell->FL );
+        ome2= ddaddd( ddneg( e2 ), ONE );
+        for( i= 0; i < n; i++ ) {
+                xyz[0]= x[i];
+                xyz[1]= y[i];
+                xyz[2]= z[i];
+                plh[0]= ddsum( lat[i], ZERO );
+                plh[1]= ddsum( lon[i], ZERO );
+                plh[2]= ddsum( hgt[i], ZERO );
+                ddnewton( xyz, plh, ell->A, e2, ome2, t );
+                for( k= 0; k < 3; k++ ) {
+                        p[k]= plh[k].hi;
+                        p[3+k]= plh[k].lo;
+                }
+                if( !ddfoot( xyz, p, ell ) )
+                        xyz2plhdd( xyz, p, ell );
+                lat[i]= p[0];
+                lon[i]= p[1];
+                hgt[i]= p[2];
+                if( latl != NULL ) {
+                        latl[i]= p[3];
+                        lonl[i]= p[4];
+                        hgtl[i]= p[5];
+                }
+        }
+}
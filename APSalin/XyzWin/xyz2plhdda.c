@@ -0,0 +1,462 @@
+/*  @(#)xyz2plhdda.c    1.0  26/10/18  */
+static char *sccsid= "@(#)xyz2plhdda.c  1.0  26/10/18";
+/*
+ *      include files
+ */
+
+#include <math.h>
+#include "physcon.h"
+#include "libgpsC.h"
+#include "ddmath.h"
+#include "vmath.h"
+
+/*
+ *      function prototypes
+ */
+
+void plh2xyzddv_avx2( int, double *, double *, double *,
+                      double *, double *, double *,
+                      double *, double *, double *, struct ellipsoid * );
+void xyz2plhddv_avx2( int, double *, double *, double *,
+                      double *, double *, double *,
+                      double *, double *, double *, struct ellipsoid * );
+
+/*
+ *      definitions and global variables
+ *
+ *      DD_niter        Newton corrections, as xyz2plhdd
+ */
+
+#define DD_niter        ((int)2)
+
+
+#ifdef __AVX2__
+
+static inline void vddsincos( struct vdd x, struct vdd *s, struct vdd *c,
+                              const struct dd_trig *t )
+/********1*********2*********3*********4*********5*********6*********7**
+ * Purpose:     ddsincos of xyz2plhdd.c, four lanes; the table entries
+ *              are gathered, the quadrant is applied by blends
+ ********1*********2*********3*********4*********5*********6*********7*/
+{
+        struct vdd a;
+        struct vdd b;
+        struct vdd cr;
+        struct vdd r;
+        struct vdd sr;
+        struct vdd z;
+        __m256d k;
+        __m256d m;
+        __m256d mo;
+        __m256d q;
+        __m256d sg;
+        __m256d zh;
+        __m128i j;
+
+        k= _mm256_round_pd( _mm256_mul_pd( x.hi, vconst( 8.0 ) ),
+                            _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC );
+        r= vddsum( _mm256_fnmadd_pd( k, vconst( 0.125 ), x.hi ), x.lo );
+        r= vddmul( r, (struct vdd){ vconst( t->d2r.hi ),
+                                    vconst( t->d2r.lo ) } );
+        m= _mm256_fnmadd_pd( vconst( 2880.0 ), _mm256_floor_pd(
+                             _mm256_mul_pd( k, vconst( 1.0/2880.0 ) ) ), k );
+        m= vblend( _mm256_and_pd(
+                        _mm256_cmp_pd( m, vconst( 0.0 ), _CMP_GE_OQ ),
+                        _mm256_cmp_pd( m, vconst( 2880.0 ), _CMP_LT_OQ ) ),
+                   m, vconst( 0.0 ) );
+        q= _mm256_floor_pd( _mm256_mul_pd( _mm256_add_pd( m, vconst( 0.5 ) ),
+                                           vconst( 1.0/DD_ntab ) ) );
+        j= _mm256_cvtpd_epi32( _mm256_fnmadd_pd( q, vconst( DD_ntab ), m ) );
+
+        z= vddmul( r, r );
+        zh= z.hi;
+        sr= vddaddd( (struct vdd){ vconst( t->s3.hi ), vconst( t->s3.lo ) },
+                     _mm256_mul_pd( zh, _mm256_fmadd_pd( zh,
+                             _mm256_fmadd_pd( zh, vconst( 1.0/362880.0 ),
+                                              vconst( -1.0/5040.0 ) ),
+                             vconst( 1.0/120.0 ) ) ) );
+        sr= vddadd( r, vddmul( vddmul( r, z ), sr ) );
+        cr= vddaddd( (struct vdd){ vconst( t->c4.hi ), vconst( t->c4.lo ) },
+                     _mm256_mul_pd( zh, _mm256_fmadd_pd( zh,
+                             vconst( 1.0/40320.0 ), vconst( -1.0/720.0 ) ) ) );
+        cr= vddadd( vddmul( vddmul( z, z ), cr ),
+                    vddaddd( vddmuld( z, vconst( -0.5 ) ), vconst( 1.0 ) ) );
+
+        a.hi= _mm256_i32gather_pd( t->sh, j, 8 );
+        a.lo= _mm256_i32gather_pd( t->sl, j, 8 );
+        b.hi= _mm256_i32gather_pd( t->ch, j, 8 );
+        b.lo= _mm256_i32gather_pd( t->cl, j, 8 );
+        *s= vddadd( vddmul( a, cr ), vddmul( b, sr ) );
+        *c= vddadd( vddmul( b, cr ), vddneg( vddmul( a, sr ) ) );
+/*
+ *   quadrant q, as ddsincos: odd q takes cos y, -sin y; q >= 2 negates
+ */
+        mo= _mm256_cmp_pd( _mm256_sub_pd( q, _mm256_mul_pd( vconst( 2.0 ),
+                _mm256_floor_pd( _mm256_mul_pd( q, vconst( 0.5 ) ) ) ) ),
+                vconst( 1.0 ), _CMP_EQ_OQ );
+        a= vddneg( *s );
+        s->hi= vblend( mo, c->hi, s->hi );
+        s->lo= vblend( mo, c->lo, s->lo );
+        c->hi= vblend( mo, a.hi, c->hi );
+        c->lo= vblend( mo, a.lo, c->lo );
+        sg= _mm256_and_pd( _mm256_cmp_pd( q, vconst( 1.5 ), _CMP_GT_OQ ),
+                           vconst( -0.0 ) );
+        s->hi= _mm256_xor_pd( s->hi, sg );
+        s->lo= _mm256_xor_pd( s->lo, sg );
+        c->hi= _mm256_xor_pd( c->hi, sg );
+        c->lo= _mm256_xor_pd( c->lo, sg );
+}
+
+
+static inline void vddfwd( struct vdd *plh, struct vdd *xyz, __m256d *aux,
+                           __m256d A, struct vdd e2, struct vdd ome2,
+                           const struct dd_trig *t )
+/********1*********2*********3*********4*********5*********6*********7**
+ * Purpose:     ddfwd of xyz2plhdd.c, four lanes
+ ********1*********2*********3*********4*********5*********6*********7*/
+{
+        struct vdd cl;
+        struct vdd cp;
+        struct vdd nh;
+        struct vdd rn;
+        struct vdd sl;
+        struct vdd sp;
+        struct vdd w;
+        __m256d e;
+        __m256d one= vconst( 1.0 );
+        __m256d y;
+
+        vddsincos( plh[0], &sp, &cp, t );
+        vddsincos( plh[1], &sl, &cl, t );
+
+        w= vddaddd( vddneg( vddmul( e2, vddmul( sp, sp ) ) ), one );
+        y= _mm256_div_pd( one, _mm256_sqrt_pd( w.hi ) );
+        e= vddaddd( vddneg( vddmul( w, vddprod( y, y ) ) ), one ).hi;
+        rn= vddfast( y, _mm256_mul_pd( _mm256_mul_pd( y, e ),
+                _mm256_fmadd_pd( vconst( 0.375 ), e, vconst( 0.5 ) ) ) );
+        rn= vddmuld( rn, A );
+
+        nh= vddadd( rn, plh[2] );
+        xyz[0]= vddmul( vddmul( nh, cp ), cl );
+        xyz[1]= vddmul( vddmul( nh, cp ), sl );
+        xyz[2]= vddmul( vddadd( vddmul( rn, ome2 ), plh[2] ), sp );
+
+        aux[0]= sp.hi;
+        aux[1]= cp.hi;
+        aux[2]= sl.hi;
+        aux[3]= cl.hi;
+        aux[4]= nh.hi;
+        aux[5]= _mm256_add_pd( _mm256_div_pd( _mm256_mul_pd( rn.hi, ome2.hi ),
+                                              w.hi ), plh[2].hi );
+}
+
+
+void plh2xyzddv_avx2( int n, double *lat, double *lon, double *hgt,
+                      double *x, double *y, double *z,
+                      double *xl, double *yl, double *zl,
+                      struct ellipsoid *ell )
+/********1*********2*********3*********4*********5*********6*********7**
+ * Name:        plh2xyzddv_avx2
+ * Version:     2610.18
+ * Author:      geoData
+ * Purpose:     AVX2 kernel of plh2xyzddv, four points at a time.
+ *
+ * Input:
+ * -----------
+ * see plh2xyzddv
+ *
+ * Output:
+ * -----------
+ * see plh2xyzddv
+ *
+ * Notes:
+ * -----------
+ * This file must be compiled with -mavx2 -mfma.  It is only called
+ * after simd_level() has checked the processor.  The steps are those
+ * of xyz2plhdd.c lane by lane; the last n % 4 points are padded with
+ * copies of the last one.
+ *
+ ********1*********2*********3*********4*********5*********6*********7**
+ * Modification History:
+ * 2610.18, GD,  Creation
+ ********1*********2*********3*********4*********5*********6*********7*/
+{
+        const struct dd_trig *t= ddtrig();
+        struct dd e2d= ddmuld( ddsum( TWO, -ell->FL ), ell->FL );
+        struct vdd e2= { vconst( e2d.hi ), vconst( e2d.lo ) };
+        struct vdd ome2;
+        struct vdd plh[3];
+        struct vdd xyz[3];
+        __m256d aux[6];
+        __m256d A= vconst( ell->A );
+        __m256d zero= vconst( 0.0 );
+        double buf[6][4];
+        double *in[3];
+        int i;
+        int k;
+        int m;
+
+        e2d= ddaddd( ddneg( e2d ), ONE );
+        ome2.hi= vconst( e2d.hi );
+        ome2.lo= vconst( e2d.lo );
+
+        for( i= 0; i < n; i+= 4 ) {
+                if( i + 4 <= n ) {
+                        in[0]= lat + i;
+                        in[1]= lon + i;
+                        in[2]= hgt + i;
+                } else {
+                        for( m= 0; m < 4; m++ ) {
+                                buf[0][m]= lat[i + (i + m < n ? m : n - 1 - i)];
+                                buf[1][m]= lon[i + (i + m < n ? m : n - 1 - i)];
+                                buf[2][m]= hgt[i + (i + m < n ? m : n - 1 - i)];
+                        }
+                        in[0]= buf[0];
+                        in[1]= buf[1];
+                        in[2]= buf[2];
+                }
+                for( k= 0; k < 3; k++ ) {
+                        plh[k].hi= _mm256_loadu_pd( in[k] );
+                        plh[k].lo= zero;
+                }
+                vddfwd( plh, xyz, aux, A, e2, ome2, t );
+                if( i + 4 <= n ) {
+                        _mm256_storeu_pd( x + i, xyz[0].hi );
+                        _mm256_storeu_pd( y + i, xyz[1].hi );
+                        _mm256_storeu_pd( z + i, xyz[2].hi );
+                        if( xl != NULL ) {
+                                _mm256_storeu_pd( xl + i, xyz[0].lo );
+                                _mm256_storeu_pd( yl + i, xyz[1].lo );
+                                _mm256_storeu_pd( zl + i, xyz[2].lo );
+                        }
+                        continue;
+                }
+                for( k= 0; k < 3; k++ ) {
+                        _mm256_storeu_pd( buf[k], xyz[k].hi );
+                        _mm256_storeu_pd( buf[3+k], xyz[k].lo );
+                }
+                for( m= 0; i + m < n; m++ ) {
+                        x[i+m]= buf[0][m];
+                        y[i+m]= buf[1][m];
+                        z[i+m]= buf[2][m];
+                        if( xl != NULL ) {
+                                xl[i+m]= buf[3][m];
+                                yl[i+m]= buf[4][m];
+                                zl[i+m]= buf[5][m];
+                        }
+                }
+        }
+}
+
+
+void xyz2plhddv_avx2( int n, double *x, double *y, double *z,
+                      double *lat, double *lon, double *hgt,
+                      double *latl, double *lonl, double *hgtl,
+                      struct ellipsoid *ell )
+/********1*********2*********3*********4*********5*********6*********7**
+ * Name:        xyz2plhddv_avx2
+ * Version:     2610.18
+ * Author:      geoData
+ * Purpose:     AVX2 kernel of xyz2plhddv, four points at a time.
+ *
+ * Input:
+ * -----------
+ * see xyz2plhddv
+ *
+ * Output:
+ * -----------
+ * see xyz2plhddv
+ *
+ * Notes:
+ * -----------
+ * This file must be compiled with -mavx2 -mfma.  It is only called
+ * after simd_level() has checked the processor.  The start is
+ * xyz2plhv, i.e. xyz2plhv_avx2; the Newton corrections are those of
+ * ddnewton with the test of the Z axis made by a blend.  The last
+ * n % 4 points are padded with copies of the last one.  Results that
+ * are not the nearest foot (ddfoot) are made again by xyz2plhdd, one
+ * at a time.
+ *
+ ********1*********2*********3*********4*********5*********6*********7**
+ * Modification History:
+ * 2610.18, GD,  Creation
+ * 2610.18, GD,  Points not at the nearest foot again by xyz2plhdd
+ ********1*********2*********3*********4*********5*********6*********7*/
+{
+        const struct dd_trig *t= ddtrig();
+        struct dd e2d= ddmuld( ddsum( TWO, -ell->FL ), ell->FL );
+        struct vdd e2= { vconst( e2d.hi ), vconst( e2d.lo ) };
+        struct vdd ome2;
+        struct vdd plh[3];
+        struct vdd xyz[3];
+        __m256d aux[6];
+        __m256d A= vconst( ell->A );
+        __m256d d;
+        __m256d den;
+        __m256d r2d= vconst( 180.0/DD_pihi );
+        __m256d rx;
+        __m256d ry;
+        __m256d rz;
+        __m256d v[3];
+        __m256d zero= vconst( 0.0 );
+        double buf[6][4];
+        double *in[6];
+        double p[6];
+        double q[3];
+        int i;
+        int k;
+        int m;
+
+        e2d= ddaddd( ddneg( e2d ), ONE );
+        ome2.hi= vconst( e2d.hi );
+        ome2.lo= vconst( e2d.lo );
+
+        xyz2plhv( n, x, y, z, lat, lon, hgt, ell );
+
+        for( i= 0; i < n; i+= 4 ) {
+                if( i + 4 <= n ) {
+                        in[0]= lat + i;
+                        in[1]= lon + i;
+                        in[2]= hgt + i;
+                        in[3]= x + i;
+                        in[4]= y + i;
+                        in[5]= z + i;
+                } else {
+                        for( m= 0; m < 4; m++ ) {
+                                k= i + m < n ? i + m : n - 1;
+                                buf[0][m]= lat[k];
+                                buf[1][m]= lon[k];
+                                buf[2][m]= hgt[k];
+                                buf[3][m]= x[k];
+                                buf[4][m]= y[k];
+                                buf[5][m]= z[k];
+                        }
+                        for( k= 0; k < 6; k++ )
+                                in[k]= buf[k];
+                }
+                for( k= 0; k < 3; k++ ) {
+                        plh[k].hi= _mm256_loadu_pd( in[k] );
+                        plh[k].lo= zero;
+                        v[k]= _mm256_loadu_pd( in[3+k] );
+                }
+                for( k= 0; k < DD_niter; k++ ) {
+                        vddfwd( plh, xyz, aux, A, e2, ome2, t );
+                        rx= vddaddd( vddneg( xyz[0] ), v[0] ).hi;
+                        ry= vddaddd( vddneg( xyz[1] ), v[1] ).hi;
+                        rz= vddaddd( vddneg( xyz[2] ), v[2] ).hi;
+                        d= _mm256_fmadd_pd( aux[2], ry,
+                                            _mm256_mul_pd( aux[3], rx ) );
+                        plh[0]= vddaddd( plh[0], _mm256_mul_pd( _mm256_div_pd(
+                                _mm256_fmsub_pd( aux[1], rz,
+                                        _mm256_mul_pd( aux[0], d ) ),
+                                aux[5] ), r2d ) );
+                        den= _mm256_mul_pd( aux[1], aux[4] );
+                        plh[1]= vddaddd( plh[1], vblend(
+                                _mm256_cmp_pd( den, zero, _CMP_NEQ_UQ ),
+                                _mm256_mul_pd( _mm256_div_pd( _mm256_fmsub_pd(
+                                        aux[3], ry,
+                                        _mm256_mul_pd( aux[2], rx ) ),
+                                        den ), r2d ), zero ) );
+                        plh[2]= vddaddd( plh[2], _mm256_fmadd_pd( aux[1], d,
+                                         _mm256_mul_pd( aux[0], rz ) ) );
+                }
+                if( i + 4 <= n ) {
+                        _mm256_storeu_pd( lat + i, plh[0].hi );
+                        _mm256_storeu_pd( lon + i, plh[1].hi );
+                        _mm256_storeu_pd( hgt + i, plh[2].hi );
+                        if( latl != NULL ) {
+                                _mm256_storeu_pd( latl + i, plh[0].lo );
+                                _mm256_storeu_pd( lonl + i, plh[1].lo );
+                                _mm256_storeu_pd( hgtl + i, plh[2].lo );
+                        }
+                        continue;
+                }
+                for( k= 0; k < 3; k++ ) {
+                        _mm256_storeu_pd( buf[k], plh[k].hi );
+                        _mm256_storeu_pd( buf[3+k], plh[k].lo );
+                }
+                for( m= 0; i + m < n; m++ ) {
+                        lat[i+m]= buf[0][m];
+                        lon[i+m]= buf[1][m];
+                        hgt[i+m]= buf[2][m];
+                        if( latl != NULL ) {
+                                latl[i+m]= buf[3][m];
+                                lonl[i+m]= buf[4][m];
+                                hgtl[i+m]= buf[5][m];
+                        }
+                }
+        }
+
+        for( i= 0; i < n; i++ ) {
+                q[0]= x[i];
+                q[1]= y[i];
+                q[2]= z[i];
+                p[0]= lat[i];
+                p[2]= hgt[i];
+                if( ddfoot( q, p, ell ) )
+                        continue;
+                xyz2plhdd( q, p, ell );
+                lat[i]= p[0];
+                lon[i]= p[1];
+                hgt[i]= p[2];
+                if( latl != NULL ) {
+                        latl[i]= p[3];
+                        lonl[i]= p[4];
+                        hgtl[i]= p[5];
+                }
+        }
+}
+
+#else
+
+void plh2xyzddv_avx2( int n, double *lat, double *lon, double *hgt,
+                      double *x, double *y, double *z,
+                      double *xl, double *yl, double *zl,
+                      struct ellipsoid *ell )
+{
+        double plh[3];
+        double xyz[6];
+        int i;
+
+        for( i= 0; i < n; i++ ) {
+                plh[0]= lat[i];
+                plh[1]= lon[i];
+                plh[2]= hgt[i];
+                plh2xyzdd( plh, xyz, ell );
+                x[i]= xyz[0];
+                y[i]= xyz[1];
+                z[i]= xyz[2];
+                if( xl != NULL ) {
+                        xl[i]= xyz[3];
+                        yl[i]= xyz[4];
+                        zl[i]= xyz[5];
+                }
+        }
+}
+
+void xyz2plhddv_avx2( int n, double *x, double *y, double *z,
+                      double *lat, double *lon, double *hgt,
+                      double *latl, double *lonl, double *hgtl,
+                      struct ellipsoid *ell )
+{
+        double plh[6];
+        double xyz[3];
+        int i;
+
+        for( i= 0; i < n; i++ ) {
+                xyz[0]= x[i];
+                xyz[1]= y[i];
+                xyz[2]= z[i];
+                xyz2plhdd( xyz, plh, ell );
+                lat[i]= plh[0];
+                lon[i]= plh[1];
+                hgt[i]= plh[2];
+                if( latl != NULL ) {
+                        latl[i]= plh[3];
+                        lonl[i]= plh[4];
+                        hgtl[i]= plh[5];
+                }
+        }
+}
+
+#endif /* __AVX2__ */
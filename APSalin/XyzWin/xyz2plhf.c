@@ -0,0 +1,407 @@
+/*  @(#)xyz2plhf.c      1.0  26/10/18  */
+static char *sccsid= "@(#)xyz2plhf.c    1.0  26/10/18";
+/*
+ *      include files
+ */
+
+#include <math.h>
+#include "physcon.h"
+#include "libgpsC.h"
+#include "fltmath.h"
+
+/*
+ *      function prototypes
+ */
+
+void fltorg( double *, struct flt_org *, struct ellipsoid * );
+void plh2xyzf( double *, float *, float *, struct ellipsoid * );
+void plh2xyzfv( int, double *, float *, float *, float *,
+                float *, float *, float *, struct ellipsoid * );
+void plh2xyzfv_avx2( int, double *, float *, float *, float *,
+                     float *, float *, float *, struct ellipsoid * );
+void xyz2plhf( double *, float *, float *, struct ellipsoid * );
+void xyz2plhfv( int, double *, float *, float *, float *,
+                float *, float *, float *, struct ellipsoid * );
+void xyz2plhfv_avx2( int, double *, float *, float *, float *,
+                     float *, float *, float *, struct ellipsoid * );
+static inline void fltdiff( const struct flt_org *, float, float,
+                            float *, float * );
+static inline void fltfwd( const struct flt_org *, float *, float * );
+static inline void fltinv( const struct flt_org *, float *, float * );
+
+/*
+ *      definitions and global variables
+ *
+ *      FLT_niter       Newton corrections of xyz2plhf after the start
+ */
+
+#define FLT_niter       ((int)2)
+
+
+void fltorg( double *org, struct flt_org *o, struct ellipsoid *ell )
+/********1*********2*********3*********4*********5*********6*********7**
+ * Name:        fltorg
+ * Version:     2610.18
+ * Author:      geoData
+ * Purpose:     Makes the constants of the float conversions about an
+ *              origin.
+ *
+ * Input:
+ * -----------
+ * ell              ellipsoid
+ * org[]            lat, lon [deg], hgt [m] of the origin
+ *
+ * Output:
+ * -----------
+ * o                the flt_org (fltmath.h) of the origin
+ *
+ * Notes:
+ * -----------
+ * Everything is made in double as plh2xyze makes the origin's X, Y, Z,
+ * and only then rounded to float.
+ *
+ ********1*********2*********3*********4*********5*********6*********7**
+ * Modification History:
+ * 2610.18, GD,  Creation
+ ********1*********2*********3*********4*********5*********6*********7*/
+{
+        double lat_rad= deg_to_rad * org[0];
+        double lon_rad= deg_to_rad * org[1];
+        double cp= cos( lat_rad );
+        double sp= sin( lat_rad );
+        double n;
+        double w;
+
+        w= sqrt( ONE - ell->e2*sp*sp );
+        n= ell->A / w;
+
+        o->sl0= (float)sin( lon_rad );
+        o->cl0= (float)cos( lon_rad );
+        o->sp0= (float)sp;
+        o->cp0= (float)cp;
+        o->w0= (float)w;
+        o->n0= (float)n;
+        o->nh0= (float)( n + org[2] );
+        o->ne0= (float)( n*ell->funsq + org[2] );
+        o->mh0= (float)( n*ell->funsq/(w*w) + org[2] );
+        o->p0= (float)( ( n + org[2] )*cp );
+        o->h0= (float)org[2];
+        o->ae2= (float)( ell->A*ell->e2 );
+        o->e2= (float)ell->e2;
+        o->ome2= (float)ell->funsq;
+}
+
+
+static inline void fltdiff( const struct flt_org *o, float dp, float dh,
+                            float *d, float *aux )
+/********1*********2*********3*********4*********5*********6*********7**
+ * Purpose:     offset d[0] = dP (from the Z axis), d[1] = dZ of the
+ *              point dp [rad], dh [m] from the origin, in its meridian
+ *              plane; aux[] = sin, cos of its latitude and M + h.
+ *              Every term is a difference formula, so d has the
+ *              relative accuracy of float whatever the size of P, Z:
+ *                sin(p) - sp0 =  2 sin(dp/2) cos(p0 + dp/2)
+ *                cos(p) - cp0 = -2 sin(dp/2) sin(p0 + dp/2)
+ *                N - N0 = A e2 (sin^2(p) - sp0^2) / (W W0 (W + W0))
+ ********1*********2*********3*********4*********5*********6*********7*/
+{
+        float c;
+        float dc;
+        float dn;
+        float ds;
+        float s;
+        float w;
+
+        fsincos( 0.5f*dp, &s, &c );
+        ds= 2.0f*s*( o->cp0*c - o->sp0*s );
+        dc= -2.0f*s*( o->sp0*c + o->cp0*s );
+        aux[0]= o->sp0 + ds;
+        aux[1]= o->cp0 + dc;
+        w= sqrtf( 1.0f - o->e2*aux[0]*aux[0] );
+        dn= o->ae2*ds*( aux[0] + o->sp0 ) / ( w*o->w0*( w + o->w0 ) );
+
+        d[0]= ( dn + dh )*aux[1] + o->nh0*dc;
+        d[1]= ( dn*o->ome2 + dh )*aux[0] + o->ne0*ds;
+        aux[2]= ( o->n0 + dn )*o->ome2/( w*w ) + o->h0 + dh;
+}
+
+
+static inline void fltfwd( const struct flt_org *o, float *plh, float *xyz )
+/********1*********2*********3*********4*********5*********6*********7**
+ * Purpose:     plh2xyzf of one point about a made origin: dP, dZ by
+ *              fltdiff, then the turn by the longitude offset dl in
+ *              the same way, cos(dl) - 1 = -2 sin^2(dl/2)
+ ********1*********2*********3*********4*********5*********6*********7*/
+{
+        float aux[3];
+        float c;
+        float d[2];
+        float dl;
+        float dx;
+        float e;
+        float s;
+
+        dl= plh[1] - 360.0f*nearbyintf( plh[1]*(1.0f/360.0f) );
+        fltdiff( o, (float)deg_to_rad*plh[0], plh[2], d, aux );
+        fsincos( (float)(0.5*deg_to_rad)*dl, &s, &c );
+
+        dx= d[0]*( 1.0f - 2.0f*s*s ) - 2.0f*o->p0*s*s;
+        e= ( o->p0 + d[0] )*2.0f*s*c;
+        xyz[0]= o->cl0*dx - o->sl0*e;
+        xyz[1]= o->sl0*dx + o->cl0*e;
+        xyz[2]= d[1];
+}
+
+
+static inline void fltinv( const struct flt_org *o, float *xyz, float *plh )
+/********1*********2*********3*********4*********5*********6*********7**
+ * Purpose:     xyz2plhf of one point about a made origin: the longitude
+ *              offset from the turn of the point's meridian, then dp,
+ *              dh in it from the linear start and FLT_niter Newton
+ *              corrections on fltdiff.  The target dP is
+ *                P - P0 = (dx (2 P0 + dx) + e^2) / (P + P0)
+ *              with dx, e the offset along and across the origin's
+ *              meridian.
+ ********1*********2*********3*********4*********5*********6*********7*/
+{
+        float aux[3];
+        float d[2];
+        float dh;
+        float dp;
+        float dx;
+        float e;
+        float p;
+        float px;
+        float r[2];
+        float t[2];
+        int k;
+
+        dx= o->cl0*xyz[0] + o->sl0*xyz[1];
+        e= o->cl0*xyz[1] - o->sl0*xyz[0];
+        px= o->p0 + dx;
+        p= sqrtf( px*px + e*e );
+        t[0]= p + o->p0 > 0.0f ? ( dx*( 2.0f*o->p0 + dx ) + e*e )/( p + o->p0 )
+                               : 0.0f;
+        t[1]= xyz[2];
+
+        dp= ( o->cp0*t[1] - o->sp0*t[0] )/o->mh0;
+        dh= o->cp0*t[0] + o->sp0*t[1];
+        for( k= 0; k < FLT_niter; k++ ) {
+                fltdiff( o, dp, dh, d, aux );
+                r[0]= t[0] - d[0];
+                r[1]= t[1] - d[1];
+                dp+= ( aux[1]*r[1] - aux[0]*r[0] )/aux[2];
+                dh+= aux[1]*r[0] + aux[0]*r[1];
+        }
+
+        plh[0]= (float)rad_to_deg*dp;
+        plh[1]= (float)rad_to_deg*fatan2( e, px );
+        plh[2]= dh;
+}
+
+
+void plh2xyzf( double *org, float *plh, float *xyz, struct ellipsoid *ell )
+/********1*********2*********3*********4*********5*********6*********7**
+ * Name:        plh2xyzf
+ * Version:     2610.18
+ * Author:      geoData
+ * Purpose:     Converts Phi (latitude), Lambda (longitude), H (height)
+ *              to XYZ geocentric coordinates in single precision, as
+ *              offsets from an origin.
+ *
+ * Input:
+ * -----------
+ * ell              ellipsoid
+ * org[]            lat, lon [deg], hgt [m] of the origin (tile centre)
+ * plh[]            lat, lon [deg], hgt [m] of the point less those of
+ *                  the origin
+ *
+ * Output:
+ * -----------
+ * xyz[]            X, Y, Z [m] of the point less those of the origin
+ *                  by plh2xyze
+ *
+ * Notes:
+ * -----------
+ * See xyz2plhf.  This makes the origin's constants on every call; for
+ * many points about one origin use plh2xyzfv.
+ *
+ ********1*********2*********3*********4*********5*********6*********7**
+ * Modification History:
+ * 2610.18, GD,  Creation
+ ********1*********2*********3*********4*********5*********6*********7*/
+{
+        struct flt_org o;
+
+        fltorg( org, &o, ell );
+        fltfwd( &o, plh, xyz );
+}
+
+
+void xyz2plhf( double *org, float *xyz, float *plh, struct ellipsoid *ell )
+/********1*********2*********3*********4*********5*********6*********7**
+ * Name:        xyz2plhf
+ * Version:     2610.18
+ * Author:      geoData
+ * Purpose:     Converts XYZ geocentric coordinates to Phi (latitude),
+ *              Lambda (longitude), H (height) in single precision, as
+ *              offsets from an origin.
+ *
+ * Input:
+ * -----------
+ * ell              ellipsoid
+ * org[]            lat, lon [deg], hgt [m] of the origin (tile centre)
+ * xyz[]            X, Y, Z [m] of the point less those of the origin
+ *                  by plh2xyze
+ *
+ * Output:
+ * -----------
+ * plh[]            lat, lon [deg], hgt [m] of the point less those of
+ *                  the origin; the longitude in (-180, 180]
+ *
+ * Notes:
+ * -----------
+ * A float holds a geocentric coordinate only to 0.5 m and a latitude
+ * in degrees to 0.8 m, so the float routines work on offsets from an
+ * origin given in double, each of which a float holds to 6e-8 of
+ * itself.  The sums with the origin are the caller's, in double.
+ *
+ * All the arithmetic is in float on differences (see fltdiff), so the
+ * error is a fixed fraction of the distance from the origin: with any
+ * point of the 4277 point grid as origin (h from -1000 to 1e6 km) and
+ * offsets up to FLT_dmax = 1000 km it is below FLT_erel = 6e-7 of the
+ * offset, about 10 float roundings, in either direction; xyzcheck
+ * checks it against xyz2plhhc and plh2xyze.  That is 1 cm to
+ * 16 km from the origin.  The start and FLT_niter corrections converge
+ * to rounding up to FLT_dmax; beyond, the error grows with the
+ * square of the offset.  The longitude is found directly and has no
+ * trouble at the poles, but a point on the Z axis gets longitude 0
+ * (180 if the origin is on the axis).
+ *
+ * Against the double routines this halves the memory per point and
+ * doubles the number of lanes of the AVX2 kernels.
+ *
+ ********1*********2*********3*********4*********5*********6*********7**
+ * Modification History:
+ * 2610.18, GD,  Creation
+ ********1*********2*********3*********4*********5*********6*********7*/
+{
+        struct flt_org o;
+
+        fltorg( org, &o, ell );
+        fltinv( &o, xyz, plh );
+}
+
+
+void plh2xyzfv( int n, double *org, float *lat, float *lon, float *hgt,
+                float *x, float *y, float *z, struct ellipsoid *ell )
+/********1*********2*********3*********4*********5*********6*********7**
+ * Name:        plh2xyzfv
+ * Version:     2610.18
+ * Author:      geoData
+ * Purpose:     Converts arrays of Phi (latitude), Lambda (longitude),
+ *              H (height) offsets from an origin to X, Y, Z offsets in
+ *              single precision.  Batch form of plh2xyzf.
+ *
+ * Input:
+ * -----------
+ * ell              ellipsoid
+ * lat[], lon[]     latitude and longitude less those of the origin
+ *                  [degrees]
+ * hgt[]            height less that of the origin [m]
+ * n                number of points
+ * org[]            lat, lon [deg], hgt [m] of the origin
+ *
+ * Output:
+ * -----------
+ * x[], y[], z[]    X, Y, Z less those of the origin by plh2xyze [m]
+ *
+ * Notes:
+ * -----------
+ * When the processor has AVX2 and FMA the points are converted eight
+ * at a time by plh2xyzfv_avx2 (see xyz2plhfa.c), otherwise as by
+ * plh2xyzf.  The two differ by rounding only.
+ *
+ ********1*********2*********3*********4*********5*********6*********7**
+ * Modification History:
+ * 2610.18, GD,  Creation
+ ********1*********2*********3*********4*********5*********6*********7*/
+{
+        struct flt_org o;
+        float plh[3];
+        float xyz[3];
+        int i;
+
+        if( simd_level() >= 1 ) {
+                plh2xyzfv_avx2( n, org, lat, lon, hgt, x, y, z, ell );
+                return;
+        }
+
+        fltorg( org, &o, ell );
+        for( i= 0; i < n; i++ ) {
+                plh[0]= lat[i];
+                plh[1]= lon[i];
+                plh[2]= hgt[i];
+                fltfwd( &o, plh, xyz );
+                x[i]= xyz[0];
+                y[i]= xyz[1];
+                z[i]= xyz[2];
+        }
+}
+
+
+void xyz2plhfv( int n, double *org, float *x, float *y, float *z,
+                float *lat, float *lon, float *hgt, struct ellipsoid *ell )
+/********1*********2*********3*********4*********5*********6*********7**
+ * Name:        xyz2plhfv
+ * Version:     2610.18
+ * Author:      geoData
+ * Purpose:     Converts arrays of X, Y, Z offsets from an origin to
+ *              Phi (latitude), Lambda (longitude), H (height) offsets
+ *              in single precision.  Batch form of xyz2plhf.
+ *
+ * Input:
+ * -----------
+ * ell              ellipsoid
+ * n                number of points
+ * org[]            lat, lon [deg], hgt [m] of the origin
+ * x[], y[], z[]    X, Y, Z less those of the origin by plh2xyze [m]
+ *
+ * Output:
+ * -----------
+ * lat[], lon[]     latitude and longitude less those of the origin
+ *                  [degrees], the longitude in (-180, 180]
+ * hgt[]            height less that of the origin [m]
+ *
+ * Notes:
+ * -----------
+ * When the processor has AVX2 and FMA the points are converted eight
+ * at a time by xyz2plhfv_avx2 (see xyz2plhfa.c), otherwise as by
+ * xyz2plhf.  The two differ by rounding only.
+ *
+ ********1*********2*********3*********4*********5*********6*********7**
+ * Modification History:
+ * 2610.18, GD,  Creation
+ ********1*********2*********3*********4*********5*********6*********7*/
+{
+        struct flt_org o;
+        float plh[3];
+        float xyz[3];
+        int i;
+
+        if( simd_level() >= 1 ) {
+                xyz2plhfv_avx2( n, org, x, y, z, lat, lon, hgt, ell );
+                return;
+        }
+
+        fltorg( org, &o, ell );
+        for( i= 0; i < n; i++ ) {
+                xyz[0]= x[i];
+                xyz[1]= y[i];
+                xyz[2]= z[i];
+                fltinv( &o, xyz, plh );
+                lat[i]= plh[0];
+                lon[i]= plh[1];
+                hgt[i]= plh[2];
+        }
+}
@@ -0,0 +1,369 @@
+/*  @(#)xyz2plhfa.c     1.0  26/10/18  */
+static char *sccsid= "@(#)xyz2plhfa.c   1.0  26/10/18";
+/*
+ *      include files
+ */
+
+#include <math.h>
+#include "physcon.h"
+#include "libgpsC.h"
+#include "fltmath.h"
+
+/*
+ *      function prototypes
+ */
+
+void plh2xyzfv_avx2( int, double *, float *, float *, float *,
+                     float *, float *, float *, struct ellipsoid * );
+void xyz2plhfv_avx2( int, double *, float *, float *, float *,
+                     float *, float *, float *, struct ellipsoid * );
+
+/*
+ *      definitions and global variables
+ *
+ *      FLT_niter       Newton corrections, as xyz2plhf
+ *      vflt_org        the flt_org of an origin broadcast to 8 lanes
+ */
+
+#define FLT_niter       ((int)2)
+
+
+#ifdef __AVX2__
+
+struct vflt_org {
+        __m256 sl0;
+        __m256 cl0;
+        __m256 sp0;
+        __m256 cp0;
+        __m256 w0;
+        __m256 n0;
+        __m256 nh0;
+        __m256 ne0;
+        __m256 mh0;
+        __m256 p0;
+        __m256 h0;
+        __m256 ae2;
+        __m256 e2;
+        __m256 ome2;
+};
+
+static inline void vfltorg( double *org, struct vflt_org *v,
+                            struct ellipsoid *ell )
+/********1*********2*********3*********4*********5*********6*********7**
+ * Purpose:     fltorg, broadcast
+ ********1*********2*********3*********4*********5*********6*********7*/
+{
+        struct flt_org o;
+
+        fltorg( org, &o, ell );
+        v->sl0= vfconst( o.sl0 );
+        v->cl0= vfconst( o.cl0 );
+        v->sp0= vfconst( o.sp0 );
+        v->cp0= vfconst( o.cp0 );
+        v->w0= vfconst( o.w0 );
+        v->n0= vfconst( o.n0 );
+        v->nh0= vfconst( o.nh0 );
+        v->ne0= vfconst( o.ne0 );
+        v->mh0= vfconst( o.mh0 );
+        v->p0= vfconst( o.p0 );
+        v->h0= vfconst( o.h0 );
+        v->ae2= vfconst( o.ae2 );
+        v->e2= vfconst( o.e2 );
+        v->ome2= vfconst( o.ome2 );
+}
+
+
+static inline void vfltdiff( const struct vflt_org *o, __m256 dp, __m256 dh,
+                             __m256 *d, __m256 *aux )
+/********1*********2*********3*********4*********5*********6*********7**
+ * Purpose:     fltdiff of xyz2plhf.c, eight lanes
+ ********1*********2*********3*********4*********5*********6*********7*/
+{
+        __m256 c;
+        __m256 dc;
+        __m256 dn;
+        __m256 ds;
+        __m256 s;
+        __m256 s2;
+        __m256 w;
+
+        vfsincos( _mm256_mul_ps( vfconst( 0.5 ), dp ), &s, &c );
+        s2= _mm256_add_ps( s, s );
+        ds= _mm256_mul_ps( s2, _mm256_fmsub_ps( o->cp0, c,
+                                                _mm256_mul_ps( o->sp0, s ) ) );
+        dc= _mm256_mul_ps( s2, _mm256_fmadd_ps( o->sp0, c,
+                                                _mm256_mul_ps( o->cp0, s ) ) );
+        dc= _mm256_xor_ps( dc, vfconst( -0.0 ) );
+        aux[0]= _mm256_add_ps( o->sp0, ds );
+        aux[1]= _mm256_add_ps( o->cp0, dc );
+        w= _mm256_sqrt_ps( _mm256_fnmadd_ps( _mm256_mul_ps( o->e2, aux[0] ),
+                                             aux[0], vfconst( 1.0 ) ) );
+        dn= _mm256_div_ps( _mm256_mul_ps( _mm256_mul_ps( o->ae2, ds ),
+                                          _mm256_add_ps( aux[0], o->sp0 ) ),
+                           _mm256_mul_ps( _mm256_mul_ps( w, o->w0 ),
+                                          _mm256_add_ps( w, o->w0 ) ) );
+
+        d[0]= _mm256_fmadd_ps( _mm256_add_ps( dn, dh ), aux[1],
+                               _mm256_mul_ps( o->nh0, dc ) );
+        d[1]= _mm256_fmadd_ps( _mm256_fmadd_ps( dn, o->ome2, dh ), aux[0],
+                               _mm256_mul_ps( o->ne0, ds ) );
+        aux[2]= _mm256_add_ps( _mm256_div_ps(
+                    _mm256_mul_ps( _mm256_add_ps( o->n0, dn ), o->ome2 ),
+                    _mm256_mul_ps( w, w ) ),
+                _mm256_add_ps( o->h0, dh ) );
+}
+
+
+void plh2xyzfv_avx2( int n, double *org, float *lat, float *lon, float *hgt,
+                     float *x, float *y, float *z, struct ellipsoid *ell )
+/********1*********2*********3*********4*********5*********6*********7**
+ * Name:        plh2xyzfv_avx2
+ * Version:     2610.18
+ * Author:      geoData
+ * Purpose:     AVX2 kernel of plh2xyzfv, eight points at a time.
+ *
+ * Input:
+ * -----------
+ * see plh2xyzfv
+ *
+ * Output:
+ * -----------
+ * see plh2xyzfv
+ *
+ * Notes:
+ * -----------
+ * This file must be compiled with -mavx2 -mfma.  It is only called
+ * after simd_level() has checked the processor.  The steps are those
+ * of fltfwd in xyz2plhf.c lane by lane; the last n % 8 points are
+ * padded with copies of the last one.
+ *
+ ********1*********2*********3*********4*********5*********6*********7**
+ * Modification History:
+ * 2610.18, GD,  Creation
+ ********1*********2*********3*********4*********5*********6*********7*/
+{
+        struct vflt_org o;
+        __m256 aux[3];
+        __m256 c;
+        __m256 d[2];
+        __m256 dl;
+        __m256 dx;
+        __m256 e;
+        __m256 s;
+        __m256 ss;
+        __m256 v[3];
+        float buf[3][8];
+        float *in[3];
+        int i;
+        int k;
+        int m;
+
+        vfltorg( org, &o, ell );
+
+        for( i= 0; i < n; i+= 8 ) {
+                if( i + 8 <= n ) {
+                        in[0]= lat + i;
+                        in[1]= lon + i;
+                        in[2]= hgt + i;
+                } else {
+                        for( m= 0; m < 8; m++ ) {
+                                buf[0][m]= lat[i + (i + m < n ? m : n - 1 - i)];
+                                buf[1][m]= lon[i + (i + m < n ? m : n - 1 - i)];
+                                buf[2][m]= hgt[i + (i + m < n ? m : n - 1 - i)];
+                        }
+                        in[0]= buf[0];
+                        in[1]= buf[1];
+                        in[2]= buf[2];
+                }
+                for( k= 0; k < 3; k++ )
+                        v[k]= _mm256_loadu_ps( in[k] );
+
+                dl= _mm256_round_ps(
+                        _mm256_mul_ps( v[1], vfconst( 1.0/360.0 ) ),
+                        _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC );
+                dl= _mm256_fnmadd_ps( dl, vfconst( 360.0 ), v[1] );
+                vfltdiff( &o, _mm256_mul_ps( vfconst( deg_to_rad ), v[0] ),
+                          v[2], d, aux );
+                vfsincos( _mm256_mul_ps( vfconst( 0.5*deg_to_rad ), dl ),
+                          &s, &c );
+
+                ss= _mm256_mul_ps( _mm256_add_ps( s, s ), s );
+                dx= _mm256_fnmadd_ps( o.p0, ss,
+                        _mm256_fnmadd_ps( d[0], ss, d[0] ) );
+                e= _mm256_mul_ps( _mm256_add_ps( o.p0, d[0] ),
+                                  _mm256_mul_ps( _mm256_add_ps( s, s ), c ) );
+                v[0]= _mm256_fmsub_ps( o.cl0, dx, _mm256_mul_ps( o.sl0, e ) );
+                v[1]= _mm256_fmadd_ps( o.sl0, dx, _mm256_mul_ps( o.cl0, e ) );
+                v[2]= d[1];
+
+                if( i + 8 <= n ) {
+                        _mm256_storeu_ps( x + i, v[0] );
+                        _mm256_storeu_ps( y + i, v[1] );
+                        _mm256_storeu_ps( z + i, v[2] );
+                        continue;
+                }
+                for( k= 0; k < 3; k++ )
+                        _mm256_storeu_ps( buf[k], v[k] );
+                for( m= 0; i + m < n; m++ ) {
+                        x[i+m]= buf[0][m];
+                        y[i+m]= buf[1][m];
+                        z[i+m]= buf[2][m];
+                }
+        }
+}
+
+
+void xyz2plhfv_avx2( int n, double *org, float *x, float *y, float *z,
+                     float *lat, float *lon, float *hgt, struct ellipsoid *ell )
+/********1*********2*********3*********4*********5*********6*********7**
+ * Name:        xyz2plhfv_avx2
+ * Version:     2610.18
+ * Author:      geoData
+ * Purpose:     AVX2 kernel of xyz2plhfv, eight points at a time.
+ *
+ * Input:
+ * -----------
+ * see xyz2plhfv
+ *
+ * Output:
+ * -----------
+ * see xyz2plhfv
+ *
+ * Notes:
+ * -----------
+ * This file must be compiled with -mavx2 -mfma.  It is only called
+ * after simd_level() has checked the processor.  The steps are those
+ * of fltinv in xyz2plhf.c, with the test of P + P0 made by a blend;
+ * the last n % 8 points are padded with copies of the last one.
+ *
+ ********1*********2*********3*********4*********5*********6*********7**
+ * Modification History:
+ * 2610.18, GD,  Creation
+ ********1*********2*********3*********4*********5*********6*********7*/
+{
+        struct vflt_org o;
+        __m256 aux[3];
+        __m256 d[2];
+        __m256 den;
+        __m256 dh;
+        __m256 dp;
+        __m256 dx;
+        __m256 e;
+        __m256 px;
+        __m256 r[2];
+        __m256 t[2];
+        __m256 v[3];
+        float buf[3][8];
+        float *in[3];
+        int i;
+        int k;
+        int m;
+
+        vfltorg( org, &o, ell );
+
+        for( i= 0; i < n; i+= 8 ) {
+                if( i + 8 <= n ) {
+                        in[0]= x + i;
+                        in[1]= y + i;
+                        in[2]= z + i;
+                } else {
+                        for( m= 0; m < 8; m++ ) {
+                                buf[0][m]= x[i + (i + m < n ? m : n - 1 - i)];
+                                buf[1][m]= y[i + (i + m < n ? m : n - 1 - i)];
+                                buf[2][m]= z[i + (i + m < n ? m : n - 1 - i)];
+                        }
+                        in[0]= buf[0];
+                        in[1]= buf[1];
+                        in[2]= buf[2];
+                }
+                for( k= 0; k < 3; k++ )
+                        v[k]= _mm256_loadu_ps( in[k] );
+
+                dx= _mm256_fmadd_ps( o.cl0, v[0],
+                                     _mm256_mul_ps( o.sl0, v[1] ) );
+                e= _mm256_fmsub_ps( o.cl0, v[1], _mm256_mul_ps( o.sl0, v[0] ) );
+                px= _mm256_add_ps( o.p0, dx );
+                den= _mm256_add_ps( _mm256_sqrt_ps( _mm256_fmadd_ps( px, px,
+                                        _mm256_mul_ps( e, e ) ) ), o.p0 );
+                t[0]= _mm256_div_ps( _mm256_fmadd_ps( dx,
+                        _mm256_fmadd_ps( vfconst( 2.0 ), o.p0, dx ),
+                        _mm256_mul_ps( e, e ) ),
+                        vfblend( _mm256_cmp_ps( den, vfconst( 0.0 ),
+                                                _CMP_GT_OQ ),
+                                 den, vfconst( 1.0 ) ) );
+                t[1]= v[2];
+
+                dp= _mm256_div_ps( _mm256_fmsub_ps( o.cp0, t[1],
+                                        _mm256_mul_ps( o.sp0, t[0] ) ), o.mh0 );
+                dh= _mm256_fmadd_ps( o.cp0, t[0],
+                                     _mm256_mul_ps( o.sp0, t[1] ) );
+                for( k= 0; k < FLT_niter; k++ ) {
+                        vfltdiff( &o, dp, dh, d, aux );
+                        r[0]= _mm256_sub_ps( t[0], d[0] );
+                        r[1]= _mm256_sub_ps( t[1], d[1] );
+                        dp= _mm256_add_ps( dp, _mm256_div_ps( _mm256_fmsub_ps(
+                                aux[1], r[1], _mm256_mul_ps( aux[0], r[0] ) ),
+                                aux[2] ) );
+                        dh= _mm256_add_ps( dh, _mm256_fmadd_ps( aux[1], r[0],
+                                _mm256_mul_ps( aux[0], r[1] ) ) );
+                }
+
+                v[0]= _mm256_mul_ps( vfconst( rad_to_deg ), dp );
+                v[1]= _mm256_mul_ps( vfconst( rad_to_deg ), vfatan2( e, px ) );
+                v[2]= dh;
+
+                if( i + 8 <= n ) {
+                        _mm256_storeu_ps( lat + i, v[0] );
+                        _mm256_storeu_ps( lon + i, v[1] );
+                        _mm256_storeu_ps( hgt + i, v[2] );
+                        continue;
+                }
+                for( k= 0; k < 3; k++ )
+                        _mm256_storeu_ps( buf[k], v[k] );
+                for( m= 0; i + m < n; m++ ) {
+                        lat[i+m]= buf[0][m];
+                        lon[i+m]= buf[1][m];
+                        hgt[i+m]= buf[2][m];
+                }
+        }
+}
+
+#else
+
+void plh2xyzfv_avx2( int n, double *org, float *lat, float *lon, float *hgt,
+                     float *x, float *y, float *z, struct ellipsoid *ell )
+{
+        float plh[3];
+        float xyz[3];
+        int i;
+
+        for( i= 0; i < n; i++ ) {
+                plh[0]= lat[i];
+                plh[1]= lon[i];
+                plh[2]= hgt[i];
+                plh2xyzf( org, plh, xyz, ell );
+                x[i]= xyz[0];
+                y[i]= xyz[1];
+                z[i]= xyz[2];
+        }
+}
+
+void xyz2plhfv_avx2( int n, double *org, float *x, float *y, float *z,
+                     float *lat, float *lon, float *hgt, struct ellipsoid *ell )
+{
+        float plh[3];
+        float xyz[3];
+        int i;
+
+        for( i= 0; i < n; i++ ) {
+                xyz[0]= x[i];
+                xyz[1]= y[i];
+                xyz[2]= z[i];
+                xyz2plhf( org, xyz, plh, ell );
+                lat[i]= plh[0];
+                lon[i]= plh[1];
+                hgt[i]= plh[2];
+        }
+}
+
+#endif /* __AVX2__ */
@@ -0,0 +1,382 @@
+/*  @(#)xyz2plhh.c      1.0  26/10/18  */
+static char *sccsid= "@(#)xyz2plhh.c    1.0  26/10/18";
+/*
+ *      include files
+ */
+
+#include <math.h>
+#include "physcon.h"
+#include "libgpsC.h"
+
+/*
+ *      function prototypes
+ */
+
+void xyz2plhh( double *, double *, struct ellipsoid * );
+int xyz2plhhc( double *, double *, struct ellipsoid * );
+void xyz2plhhcv( int, double *, double *, double *,
+                 double *, double *, double *, struct ellipsoid * );
+void xyz2plhhv( int, double *, double *, double *,
+                double *, double *, double *, struct ellipsoid * );
+void xyz2plhhv_avx2( int, double *, double *, double *,
+                     double *, double *, double *, struct ellipsoid * );
+static inline void halley( double *, double *, struct ellipsoid * );
+
+/*
+ *      definitions and global variables
+ *
+ *      HAL_eps         xyz2plhhc stops when a correction changes the
+ *                      reduced latitude by less than this [rad]
+ *      HAL_nmax        maximum number of corrections of xyz2plhhc
+ *      HAL_pmin        least distance from the Z axis [m]; on the axis
+ *                      S1 and CC of the correction would both be zero
+ */
+
+#define HAL_eps         ((double)1.0e-15)
+#define HAL_nmax        ((int)4)
+#define HAL_pmin        ((double)1.0e-90)
+
+
+static inline void halley( double *xyz, double *plh, struct ellipsoid *ell )
+/********1*********2*********3*********4*********5*********6*********7**
+ * Purpose:     one Halley correction from the starting value; see
+ *              xyz2plhh.  No data dependent branches.
+ ********1*********2*********3*********4*********5*********6*********7*/
+{
+        double A= ell->A;
+        double e2= ell->e2;
+        double ec= ONE - ell->FL;
+        double rA= ell->rA;
+        double a0;
+        double a02;
+        double a03;
+        double az;
+        double b0;
+        double c0;
+        double c02;
+        double c03;
+        double cc;
+        double cc2;
+        double d0;
+        double f0;
+        double p;
+        double pn;
+        double s0;
+        double s02;
+        double s03;
+        double s1;
+        double s12;
+        double x= xyz[0];
+        double y= xyz[1];
+        double z= xyz[2];
+        double zc;
+        double zlong;
+/*
+ *   1.0 normalized coordinates and the starting value
+ */
+        p= fmax( sqrt( x*x + y*y ), HAL_pmin );
+        az= fabs( z );
+        pn= p * rA;
+        zc= ec * az * rA;
+        s0= az * rA;
+        c0= ec * pn;
+        s02= s0 * s0;
+        s03= s02 * s0;
+        c02= c0 * c0;
+        c03= c02 * c0;
+        a02= c02 + s02;
+        a0= sqrt( a02 );
+        a03= a02 * a0;
+/*
+ *   2.0 Halley correction
+ */
+        d0= zc*a03 + e2*s03;
+        f0= pn*a03 - e2*c03;
+        b0= 1.5*e2*e2*s02*c02*pn*(a0 - ec);
+        s1= d0*f0 - b0*s0;
+        cc= ec*(f0*f0 - b0*c0);
+/*
+ *   3.0 latitude, height
+ */
+        s12= s1 * s1;
+        cc2= cc * cc;
+        plh[0]= copysign( atan( s1 / cc ), z ) * rad_to_deg;
+        plh[2]= (p*cc + az*s1 - A*sqrt( ec*ec*s12 + cc2 )) / sqrt( s12 + cc2 );
+/*
+ *   4.0 longitude east of Greenwich
+ */
+        zlong= atan2( y, x );
+        plh[1]= (zlong + ( zlong < ZERO ? twopi : ZERO )) * rad_to_deg;
+}
+
+
+void xyz2plhh( double *xyz, double *plh, struct ellipsoid *ell )
+/********1*********2*********3*********4*********5*********6*********7**
+ * Name:        xyz2plhh
+ * Version:     2610.18
+ * Author:      geoData
+ * Purpose:     Converts XYZ geocentric coordinates to Phi (latitude),
+ *              Lambda (longitude), H (height) by one Halley correction
+ *              of Fukushima's starting value.
+ *
+ * Input:
+ * -----------
+ * ell              ellipsoid, with its derived constants (ellset)
+ * xyz[]            geocentric Cartesian coordinates [m]
+ *
+ * Output:
+ * -----------
+ * plh[]            as xyz2plh [deg, deg, m]
+ *
+ * Notes:
+ * -----------
+ * With pn = p/A, ec = 1 - FL, the foot point at reduced latitude beta
+ * satisfies g(T) = pn*T - zc - e2*T/sqrt(1 + T*T) = 0, T = tan(beta),
+ * zc = ec*|z|/A.  T is carried as S/C.  Starting from S0 = |z|/A,
+ * C0 = ec*pn (the ray from the centre), one Halley step gives
+ *   S1 = D0*F0 - B0*S0,  CC = ec*(F0*F0 - B0*C0)
+ *   D0 = zc*A0^3 + e2*S0^3,  F0 = pn*A0^3 - e2*C0^3
+ *   B0 = 1.5*e2^2*S0^2*C0^2*pn*(A0 - ec),  A0 = sqrt(S0^2 + C0^2)
+ * and tan(Phi) = S1/CC.  The names are those of
+ * Halley_Output/_Halley_Trace.txt.  There is no iteration and no
+ * branch on the data, so the batch form (xyz2plhhv) runs the same
+ * instructions for every point.
+ *
+ * From Halley_XYZ.txt on WGS84 the results are within 1.0e-13 deg
+ * and 2.4e-7 m of Halley_Output/_Halley.txt.  One correction is
+ * enough near the Earth but not far from it; the largest position
+ * errors on the xyzbench sets are
+ *   surface  (-500 m to 9 km)         5.1e-8 m
+ *   leo      (200 to 2000 km)         2.2e-5 m
+ *   geo      (35286 to 36286 km)      9.7e-4 m
+ *   deep     (-100 to -6000 km)       7.1 m
+ * and 1.6e-3 m on the 4277 point grid.  xyz2plhhc iterates to
+ * convergence instead.  Points on the Z axis are moved HAL_pmin off
+ * it, which leaves S1 nonzero and CC underflowing to zero, i.e.
+ * exactly 90 deg; the centre of the Earth gives NaN.
+ *
+ * References:
+ * -----------
+ * Fukushima, T. (2006).  "Transformation from Cartesian to geodetic
+ * coordinates accelerated by Halley's method", *Journal of Geodesy*,
+ * v. 79, pp. 689-693.
+ *
+ ********1*********2*********3*********4*********5*********6*********7**
+ * Modification History:
+ * 2610.18, GD,  Creation
+ ********1*********2*********3*********4*********5*********6*********7*/
+{
+        halley( xyz, plh, ell );
+}
+
+
+int xyz2plhhc( double *xyz, double *plh, struct ellipsoid *ell )
+/********1*********2*********3*********4*********5*********6*********7**
+ * Name:        xyz2plhhc
+ * Version:     2610.18
+ * Author:      geoData
+ * Purpose:     Converts XYZ geocentric coordinates to Phi (latitude),
+ *              Lambda (longitude), H (height) by Halley corrections
+ *              repeated to convergence.
+ *
+ * Input:
+ * -----------
+ * ell              ellipsoid, with its derived constants (ellset)
+ * xyz[]            geocentric Cartesian coordinates [m]
+ *
+ * Output:
+ * -----------
+ * plh[]            as xyz2plh [deg, deg, m]
+ *
+ * returns      number of corrections made, 1 to HAL_nmax; 0 for a
+ *              point of the core, by xyz2plhn
+ *
+ * Notes:
+ * -----------
+ * The first correction is that of xyz2plhh.  The later ones use the
+ * general B = 1.5*e2*S*C^2*(A*(pn*S - zc*C) - e2*S*C), which is B0 of
+ * xyz2plhh at the starting value; S, C are scaled to a unit vector
+ * between corrections.  They stop when one changes beta by less than
+ * HAL_eps, so a point needs one more correction than it would with
+ * the result known: two on and near the surface, three for distant
+ * or deep points (1416 and 2861 of the 4277 point grid).
+ *
+ * Inside the evolute more than one normal passes through a point and
+ * the corrections need not go to the nearest foot, nor converge; the
+ * core about the centre, less than BRK_rpol*A from the axis and
+ * B*|z| <= 2*c, is taken by xyz2plhn as in xyz2plhe.
+ *
+ ********1*********2*********3*********4*********5*********6*********7**
+ * Modification History:
+ * 2610.18, GD,  Creation
+ * 2610.18, GD,  The core about the centre by xyz2plhn
+ ********1*********2*********3*********4*********5*********6*********7*/
+{
+        double A= ell->A;
+        double e2= ell->e2;
+        double ec= ONE - ell->FL;
+        double rA= ell->rA;
+        double a0;
+        double a02;
+        double az;
+        double b0;
+        double C;
+        double cc;
+        double d0;
+        double dt;
+        double f0;
+        double p;
+        double pn;
+        double r;
+        double S;
+        double s1;
+        double t1;
+        double w;
+        double x= xyz[0];
+        double y= xyz[1];
+        double z= xyz[2];
+        double zc;
+        double zlong;
+        int n;
+/*
+ *   1.0 normalized coordinates and the starting value
+ */
+        p= fmax( sqrt( x*x + y*y ), HAL_pmin );
+        az= fabs( z );
+        if( p < BRK_rpol*A && ell->B*az <= TWO*ell->c ) {
+                xyz2plhn( xyz, plh, A, ell->FL );
+                return( 0 );
+        }
+        pn= p * rA;
+        zc= ec * az * rA;
+        S= az * rA;
+        C= ec * pn;
+/*
+ *   2.0 Halley corrections until beta stops changing
+ */
+        for( n= 1; ; n++ ) {
+                a02= S*S + C*C;
+                a0= sqrt( a02 );
+                d0= zc*a02*a0 + e2*S*S*S;
+                f0= pn*a02*a0 - e2*C*C*C;
+                if( n == 1 )
+                        w= e2*S*pn*(a0 - ec);
+                else
+                        w= a0*(pn*S - zc*C) - e2*S*C;
+                b0= 1.5*e2*S*C*C*w;
+                s1= d0*f0 - b0*S;
+                t1= f0*f0 - b0*C;
+                r= sqrt( s1*s1 + t1*t1 );
+                s1= s1 / r;
+                t1= t1 / r;
+                dt= fabs( s1*C - t1*S ) / a0;
+                S= s1;
+                C= t1;
+                if( dt < HAL_eps || n >= HAL_nmax )
+                        break;
+        }
+/*
+ *   3.0 latitude, height
+ */
+        cc= ec * C;
+        plh[0]= copysign( atan( S / cc ), z ) * rad_to_deg;
+        plh[2]= (p*cc + az*S - A*sqrt( ec*ec*S*S + cc*cc ))
+                / sqrt( S*S + cc*cc );
+/*
+ *   4.0 longitude east of Greenwich
+ */
+        zlong= atan2( y, x );
+        if( zlong < ZERO )
+                zlong= zlong + twopi;
+        plh[1]= zlong * rad_to_deg;
+
+        return( n );
+}
+
+
+void xyz2plhhv( int n, double *x, double *y, double *z,
+                double *lat, double *lon, double *hgt, struct ellipsoid *ell )
+/********1*********2*********3*********4*********5*********6*********7**
+ * Name:        xyz2plhhv
+ * Version:     2610.18
+ * Author:      geoData
+ * Purpose:     Converts arrays of XYZ geocentric coordinates to Phi
+ *              (latitude), Lambda (longitude), H (height) by one Halley
+ *              correction.  Batch form of xyz2plhh.
+ *
+ * Input:
+ * -----------
+ * as xyz2plhv
+ *
+ * Output:
+ * -----------
+ * as xyz2plhv
+ *
+ * Notes:
+ * -----------
+ * When the processor has AVX2 and FMA the points are converted four at
+ * a time by xyz2plhhv_avx2 (see xyz2plhha.c), otherwise by xyz2plhh.
+ *
+ ********1*********2*********3*********4*********5*********6*********7**
+ * Modification History:
+ * 2610.18, GD,  Creation
+ ********1*********2*********3*********4*********5*********6*********7*/
+{
+        double plh[3];
+        double xyz[3];
+        int i;
+
+        if( simd_level() >= 1 ) {
+                xyz2plhhv_avx2( n, x, y, z, lat, lon, hgt, ell );
+                return;
+        }
+
+        for( i= 0; i < n; i++ ) {
+                xyz[0]= x[i];
+                xyz[1]= y[i];
+                xyz[2]= z[i];
+                halley( xyz, plh, ell );
+                lat[i]= plh[0];
+                lon[i]= plh[1];
+                hgt[i]= plh[2];
+        }
+}
+
+
+void xyz2plhhcv( int n, double *x, double *y, double *z,
+                 double *lat, double *lon, double *hgt, struct ellipsoid *ell )
+/********1*********2*********3*********4*********5*********6*********7**
+ * Name:        xyz2plhhcv
+ * Version:     2610.18
+ * Author:      geoData
+ * Purpose:     Converts arrays of XYZ geocentric coordinates to Phi
+ *              (latitude), Lambda (longitude), H (height) by Halley
+ *              corrections to convergence.  Batch form of xyz2plhhc.
+ *
+ * Input:
+ * -----------
+ * as xyz2plhv
+ *
+ * Output:
+ * -----------
+ * as xyz2plhv
+ *
+ ********1*********2*********3*********4*********5*********6*********7**
+ * Modification History:
+ * 2610.18, GD,  Creation
+ ********1*********2*********3*********4*********5*********6*********7*/
+{
+        double plh[3];
+        double xyz[3];
+        int i;
+
+        for( i= 0; i < n; i++ ) {
+                xyz[0]= x[i];
+                xyz[1]= y[i];
+                xyz[2]= z[i];
+                xyz2plhhc( xyz, plh, ell );
+                lat[i]= plh[0];
+                lon[i]= plh[1];
+                hgt[i]= plh[2];
+        }
+}
@@ -0,0 +1,218 @@
+/*  @(#)xyz2plhha.c     1.0  26/10/18  */
+static char *sccsid= "@(#)xyz2plhha.c   1.0  26/10/18";
+/*
+ *      include files
+ */
+
+#include <math.h>
+#include "physcon.h"
+#include "libgpsC.h"
+#include "vmath.h"
+
+/*
+ *      function prototypes
+ */
+
+void xyz2plhhv_avx2( int, double *, double *, double *,
+                     double *, double *, double *, struct ellipsoid * );
+
+/*
+ *      definitions and global variables
+ */
+
+
+#ifdef __AVX2__
+
+void xyz2plhhv_avx2( int n, double *x, double *y, double *z,
+                     double *lat, double *lon, double *hgt,
+                     struct ellipsoid *ell )
+/********1*********2*********3*********4*********5*********6*********7**
+ * Name:        xyz2plhhv_avx2
+ * Version:     2610.18
+ * Author:      geoData
+ * Purpose:     AVX2 kernel of xyz2plhhv; one Halley correction four
+ *              points at a time.
+ *
+ * Input:
+ * -----------
+ * see xyz2plhhv
+ *
+ * Output:
+ * -----------
+ * see xyz2plhhv
+ *
+ * Notes:
+ * -----------
+ * This file must be compiled with -mavx2 -mfma.  It is only called
+ * after simd_level() has checked the processor.
+ *
+ * The steps are those of xyz2plhh, which has no branch on the data,
+ * so unlike xyz2plhv_avx2 no lane is ever redone by the scalar code.
+ * p is kept at least 1e-90 m as HAL_pmin of xyz2plhh.c, by max.  The
+ * sign of latitude is that of z, copied bitwise, and the 2 pi wrap
+ * of longitude is blended in.  The differences from xyz2plhh are the
+ * rounding of vatan and vatan2 (about 1 ulp each).
+ *
+ ********1*********2*********3*********4*********5*********6*********7**
+ * Modification History:
+ * 2610.18, GD,  Creation
+ ********1*********2*********3*********4*********5*********6*********7*/
+{
+        double A= ell->A;
+        double ec= ONE - ell->FL;
+        double bx[4];
+        double by[4];
+        double bz[4];
+        double tlat[4];
+        double tlon[4];
+        double thgt[4];
+        int i;
+        int k;
+        int lanes;
+        __m256d vA= vconst( A );
+        __m256d ve2= vconst( ell->e2 );
+        __m256d vec= vconst( ec );
+        __m256d vrA= vconst( ell->rA );
+        __m256d a0;
+        __m256d a02;
+        __m256d a03;
+        __m256d az;
+        __m256d b0;
+        __m256d c0;
+        __m256d c02;
+        __m256d cc;
+        __m256d cc2;
+        __m256d d0;
+        __m256d f0;
+        __m256d p;
+        __m256d pn;
+        __m256d s0;
+        __m256d s02;
+        __m256d s1;
+        __m256d s12;
+        __m256d sgn;
+        __m256d vx;
+        __m256d vy;
+        __m256d vz;
+        __m256d zc;
+        __m256d zl;
+        double *px;
+        double *py;
+        double *pz;
+        double *plat;
+        double *plon;
+        double *phgt;
+
+        for( i= 0; i < n; i+= 4 ) {
+                lanes= n - i < 4 ? n - i : 4;
+                if( lanes == 4 ) {
+                        px= x + i;
+                        py= y + i;
+                        pz= z + i;
+                        plat= lat + i;
+                        plon= lon + i;
+                        phgt= hgt + i;
+                } else {
+                        for( k= 0; k < 4; k++ ) {
+                                bx[k]= k < lanes ? x[i+k] : A;
+                                by[k]= k < lanes ? y[i+k] : ZERO;
+                                bz[k]= k < lanes ? z[i+k] : ZERO;
+                        }
+                        px= bx;
+                        py= by;
+                        pz= bz;
+                        plat= tlat;
+                        plon= tlon;
+                        phgt= thgt;
+                }
+                vx= _mm256_loadu_pd( px );
+                vy= _mm256_loadu_pd( py );
+                vz= _mm256_loadu_pd( pz );
+/*
+ *   1.0 normalized coordinates and the starting value
+ */
+                p= _mm256_max_pd( _mm256_sqrt_pd( _mm256_add_pd(
+                        _mm256_mul_pd( vx, vx ), _mm256_mul_pd( vy, vy ) ) ),
+                        vconst( 1.0e-90 ) );
+                sgn= _mm256_and_pd( vz, vconst( -0.0 ) );
+                az= vabs( vz );
+                pn= _mm256_mul_pd( p, vrA );
+                zc= _mm256_mul_pd( _mm256_mul_pd( vec, az ), vrA );
+                s0= _mm256_mul_pd( az, vrA );
+                c0= _mm256_mul_pd( vec, pn );
+                s02= _mm256_mul_pd( s0, s0 );
+                c02= _mm256_mul_pd( c0, c0 );
+                a02= _mm256_add_pd( c02, s02 );
+                a0= _mm256_sqrt_pd( a02 );
+                a03= _mm256_mul_pd( a02, a0 );
+/*
+ *   2.0 Halley correction
+ */
+                d0= _mm256_add_pd( _mm256_mul_pd( zc, a03 ),
+                        _mm256_mul_pd( ve2, _mm256_mul_pd( s02, s0 ) ) );
+                f0= _mm256_sub_pd( _mm256_mul_pd( pn, a03 ),
+                        _mm256_mul_pd( ve2, _mm256_mul_pd( c02, c0 ) ) );
+                b0= _mm256_mul_pd( _mm256_mul_pd(
+                        _mm256_mul_pd( vconst( 1.5 ),
+                                       _mm256_mul_pd( ve2, ve2 ) ),
+                        _mm256_mul_pd( s02, c02 ) ),
+                        _mm256_mul_pd( pn, _mm256_sub_pd( a0, vec ) ) );
+                s1= _mm256_sub_pd( _mm256_mul_pd( d0, f0 ),
+                                   _mm256_mul_pd( b0, s0 ) );
+                cc= _mm256_mul_pd( vec, _mm256_sub_pd( _mm256_mul_pd( f0, f0 ),
+                        _mm256_mul_pd( b0, c0 ) ) );
+/*
+ *   3.0 latitude, height
+ */
+                s12= _mm256_mul_pd( s1, s1 );
+                cc2= _mm256_mul_pd( cc, cc );
+                _mm256_storeu_pd( plat, _mm256_or_pd( sgn,
+                        _mm256_mul_pd( vconst( rad_to_deg ),
+                                       vatan( _mm256_div_pd( s1, cc ) ) ) ) );
+                _mm256_storeu_pd( phgt, _mm256_div_pd( _mm256_sub_pd(
+                        _mm256_add_pd( _mm256_mul_pd( p, cc ),
+                                       _mm256_mul_pd( az, s1 ) ),
+                        _mm256_mul_pd( vA, _mm256_sqrt_pd( _mm256_add_pd(
+                                _mm256_mul_pd( _mm256_mul_pd( vec, vec ), s12 ),
+                                cc2 ) ) ) ),
+                        _mm256_sqrt_pd( _mm256_add_pd( s12, cc2 ) ) ) );
+/*
+ *   4.0 longitude east of Greenwich
+ */
+                zl= vatan2( vy, vx );
+                zl= vblend( _mm256_cmp_pd( zl, vconst( ZERO ), _CMP_LT_OQ ),
+                            _mm256_add_pd( zl, vconst( twopi ) ), zl );
+                _mm256_storeu_pd( plon, _mm256_mul_pd( vconst( rad_to_deg ),
+                                  zl ) );
+
+                if( lanes < 4 )
+                        for( k= 0; k < lanes; k++ ) {
+                                lat[i+k]= tlat[k];
+                                lon[i+k]= tlon[k];
+                                hgt[i+k]= thgt[k];
+                        }
+        }
+}
+
+#else
+
+void xyz2plhhv_avx2( int n, double *x, double *y, double *z,
+                     double *lat, double *lon, double *hgt,
+                     struct ellipsoid *ell )
+{
+        double plh[3];
+        double xyz[3];
+        int i;
+
+        for( i= 0; i < n; i++ ) {
+                xyz[0]= x[i];
+                xyz[1]= y[i];
+                xyz[2]= z[i];
+                xyz2plhh( xyz, plh, ell );
+                lat[i]= plh[0];
+                lon[i]= plh[1];
+                hgt[i]= plh[2];
+        }
+}
+
+#endif /* __AVX2__ */
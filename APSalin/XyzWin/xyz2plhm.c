@@ -0,0 +1,552 @@
+/*  @(#)xyz2plhm.c      1.0  26/10/18  */
+static char *sccsid= "@(#)xyz2plhm.c    1.0  26/10/18";
+/*
+ *      include files
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <pthread.h>
+#include "physcon.h"
+#include "libgpsC.h"
+
+/*
+ *      function prototypes
+ */
+
+void plhmfree( struct plh_memo * );
+int plhminit( struct plh_memo *, int, double, int );
+void plhmstat( struct plh_memo *, long *, long *, long *, int * );
+int xyz2plhm( struct plh_memo *, double *, double *, struct ellipsoid * );
+void xyz2plhmv( struct plh_memo *, int, double *, double *, double *,
+                double *, double *, double *, struct ellipsoid * );
+static void memoadd( struct plh_memo *, struct plh_shard *, long long *,
+                     unsigned long, double *, double *, struct ellipsoid * );
+static int memofind( struct plh_memo *, struct plh_shard *, long long *,
+                     unsigned long, double *, double *, struct ellipsoid * );
+static void memojac( struct plh_entry *, double, struct ellipsoid * );
+static inline int memokey( struct plh_memo *, double *, struct ellipsoid *,
+                           long long *, unsigned long * );
+
+/*
+ *      definitions and global variables
+ *
+ *      MEMO_blk        points of a block of xyz2plhmv
+ *      MEMO_kmax       largest |X, Y, Z|/q that is memoized, so that the
+ *                      key fits a long long
+ */
+
+#define MEMO_blk        ((int)256)
+#define MEMO_kmax       ((double)1.0e18)
+
+
+
+int plhminit( struct plh_memo *memo, int max, double q, int lin )
+/********1*********2*********3*********4*********5*********6*********7**
+ * Name:        plhminit
+ * Version:     2610.18
+ * Author:      geoData
+ * Purpose:     Makes an empty memo of X, Y, Z -> lat, lon, hgt
+ *              conversions.
+ *
+ * Input:
+ * -----------
+ * max              most points the memo is to hold
+ * q                size of a cell [m]: points in one cell share an
+ *                  entry
+ * lin              = 1 = correct the other points of a cell by the
+ *                  Jacobian of the memoized one
+ *
+ * Output:
+ * -----------
+ * memo             empty, with its counts zero
+ * returns          0, or -1 if out of memory or q is not > 0
+ *
+ * Notes:
+ * -----------
+ * Each of the MEMO_nshard shards is made for at least half as many
+ * again as its share of max, so that an uneven hash does not fill one
+ * first.
+ *
+ ********1*********2*********3*********4*********5*********6*********7**
+ * Modification History:
+ * 2610.18, GD,  Creation
+ ********1*********2*********3*********4*********5*********6*********7*/
+{
+        int i;
+        int size;
+        struct plh_shard *sh;
+
+        memset( memo, 0, sizeof(struct plh_memo) );
+        if( !( q > ZERO ) )
+                return( -1 );
+        memo->q= q;
+        memo->lin= lin;
+
+        for( size= 8; size < 3*(max/MEMO_nshard + 1); size*= 2 )
+                ;
+        for( i= 0; i < MEMO_nshard; i++ ) {
+                sh= &memo->sh[i];
+                sh->slot= calloc( size, sizeof(int) );
+                sh->e= malloc( size/2*sizeof(struct plh_entry) );
+                if( sh->slot == NULL || sh->e == NULL ) {
+                        free( sh->slot );
+                        free( sh->e );
+                        sh->slot= NULL;
+                        sh->e= NULL;
+                        plhmfree( memo );
+                        return( -1 );
+                }
+                pthread_mutex_init( &sh->lock, NULL );
+                sh->size= size;
+                sh->max= size/2;
+        }
+
+        return( 0 );
+}
+
+
+void plhmfree( struct plh_memo *memo )
+/********1*********2*********3*********4*********5*********6*********7**
+ * Name:        plhmfree
+ * Version:     2610.18
+ * Author:      geoData
+ * Purpose:     Frees a memo made by plhminit.
+ *
+ ********1*********2*********3*********4*********5*********6*********7**
+ * Modification History:
+ * 2610.18, GD,  Creation
+ ********1*********2*********3*********4*********5*********6*********7*/
+{
+        int i;
+        struct plh_shard *sh;
+
+        for( i= 0; i < MEMO_nshard; i++ ) {
+                sh= &memo->sh[i];
+                if( sh->slot == NULL )
+                        continue;
+                pthread_mutex_destroy( &sh->lock );
+                free( sh->slot );
+                free( sh->e );
+                sh->slot= NULL;
+                sh->e= NULL;
+                sh->size= 0;
+                sh->n= 0;
+                sh->max= 0;
+        }
+}
+
+
+void plhmstat( struct plh_memo *memo, long *hit, long *near, long *miss,
+               int *n )
+/********1*********2*********3*********4*********5*********6*********7**
+ * Name:        plhmstat
+ * Version:     2610.18
+ * Author:      geoData
+ * Purpose:     Counts of the lookups of a memo, over all its shards.
+ *
+ * Input:
+ * -----------
+ * memo             memo made by plhminit
+ *
+ * Output:
+ * -----------
+ * hit              lookups of a point memoized exactly
+ * near             lookups of another point of a memoized cell
+ * miss             lookups converted, memoized or not
+ * n                number of points held
+ *
+ ********1*********2*********3*********4*********5*********6*********7**
+ * Modification History:
+ * 2610.18, GD,  Creation
+ ********1*********2*********3*********4*********5*********6*********7*/
+{
+        int i;
+        struct plh_shard *sh;
+
+        *hit= *near= *miss= 0;
+        *n= 0;
+        for( i= 0; i < MEMO_nshard; i++ ) {
+                sh= &memo->sh[i];
+                pthread_mutex_lock( &sh->lock );
+                *hit+= sh->hit;
+                *near+= sh->near;
+                *miss+= sh->miss;
+                *n+= sh->n;
+                pthread_mutex_unlock( &sh->lock );
+        }
+}
+
+
+static inline int memokey( struct plh_memo *memo, double *xyz,
+                           struct ellipsoid *ell, long long *key,
+                           unsigned long *h )
+/********1*********2*********3*********4*********5*********6*********7**
+ * Purpose:     the key of X, Y, Z and its hash; returns the shard, or
+ *              -1 if X, Y, Z are not to be memoized
+ ********1*********2*********3*********4*********5*********6*********7*/
+{
+        unsigned long long b[2];
+        double d;
+        int k;
+
+        for( k= 0; k < 3; k++ ) {
+                d= xyz[k] / memo->q;
+                if( !( fabs( d ) < MEMO_kmax ) )
+                        return( -1 );
+                key[k]= (long long)nearbyint( d );
+        }
+        memcpy( &b[0], &ell->A, sizeof(double) );
+        memcpy( &b[1], &ell->FL, sizeof(double) );
+
+        *h= (unsigned long)( ( (unsigned long long)key[0]
+                               * 0x9E3779B97F4A7C15ULL
+                               ^ (unsigned long long)key[1]
+                               * 0xC2B2AE3D27D4EB4FULL
+                               ^ (unsigned long long)key[2]
+                               * 0x165667B19E3779F9ULL
+                               ^ ( b[0] ^ b[1] << 1 )
+                               * 0x27D4EB2F165667C5ULL ) >> 32 );
+
+        return( (int)( *h % MEMO_nshard ) );
+}
+
+
+static int memofind( struct plh_memo *memo, struct plh_shard *sh,
+                     long long *key, unsigned long h, double *xyz,
+                     double *plh, struct ellipsoid *ell )
+/********1*********2*********3*********4*********5*********6*********7**
+ * Purpose:     looks a key up in its shard, which the caller has
+ *              locked, and counts the lookup; returns 0 and plh[] for
+ *              the point memoized, 1 and plh[] for another point of
+ *              its cell, or 2 if the point is to be converted
+ ********1*********2*********3*********4*********5*********6*********7*/
+{
+        double d[3];
+        int k;
+        struct plh_entry *e;
+        unsigned long i;
+        unsigned long mask= (unsigned long)sh->size - 1;
+
+        for( i= h/MEMO_nshard & mask; sh->slot[i]; i= (i + 1) & mask ) {
+                e= &sh->e[sh->slot[i]-1];
+                if( e->key[0] != key[0] || e->key[1] != key[1]
+                    || e->key[2] != key[2]
+                    || e->A != ell->A || e->FL != ell->FL )
+                        continue;
+                if( memcmp( e->xyz, xyz, sizeof(e->xyz) ) == 0 ) {
+                        sh->hit++;
+                        memcpy( plh, e->plh, sizeof(e->plh) );
+                        return( 0 );
+                }
+                if( memo->lin && isnan( e->J[0] ) )
+                        break;
+                sh->near++;
+                memcpy( plh, e->plh, sizeof(e->plh) );
+                if( memo->lin ) {
+                        for( k= 0; k < 3; k++ )
+                                d[k]= xyz[k] - e->xyz[k];
+                        for( k= 0; k < 3; k++ )
+                                plh[k]+= e->J[3*k]*d[0] + e->J[3*k+1]*d[1]
+                                         + e->J[3*k+2]*d[2];
+                        if( plh[1] < ZERO )
+                                plh[1]+= 360.0;
+                        else if( plh[1] >= 360.0 )
+                                plh[1]-= 360.0;
+                }
+                return( 1 );
+        }
+        sh->miss++;
+
+        return( 2 );
+}
+
+
+static void memoadd( struct plh_memo *memo, struct plh_shard *sh,
+                     long long *key, unsigned long h, double *xyz,
+                     double *plh, struct ellipsoid *ell )
+/********1*********2*********3*********4*********5*********6*********7**
+ * Purpose:     adds the conversion of a point to its shard, which the
+ *              caller has locked, unless its cell is there already or
+ *              the shard is full
+ ********1*********2*********3*********4*********5*********6*********7*/
+{
+        struct plh_entry *e;
+        unsigned long i;
+        unsigned long mask= (unsigned long)sh->size - 1;
+
+        for( i= h/MEMO_nshard & mask; sh->slot[i]; i= (i + 1) & mask ) {
+                e= &sh->e[sh->slot[i]-1];
+                if( e->key[0] == key[0] && e->key[1] == key[1]
+                    && e->key[2] == key[2]
+                    && e->A == ell->A && e->FL == ell->FL )
+                        return;
+        }
+        if( sh->n >= sh->max )
+                return;
+
+        e= &sh->e[sh->n];
+        memcpy( e->key, key, sizeof(e->key) );
+        e->A= ell->A;
+        e->FL= ell->FL;
+        memcpy( e->xyz, xyz, sizeof(e->xyz) );
+        memcpy( e->plh, plh, sizeof(e->plh) );
+        if( memo->lin )
+                memojac( e, memo->q, ell );
+        sh->n++;
+        sh->slot[i]= sh->n;
+}
+
+
+static void memojac( struct plh_entry *e, double q, struct ellipsoid *ell )
+/********1*********2*********3*********4*********5*********6*********7**
+ * Purpose:     fills in e->J from e->plh; J[0] is NaN when the point
+ *              is nearer the Z axis than MEMO_axis*q
+ ********1*********2*********3*********4*********5*********6*********7*/
+{
+        double cf= cos( e->plh[0] * deg_to_rad );
+        double cl= cos( e->plh[1] * deg_to_rad );
+        double sf= sin( e->plh[0] * deg_to_rad );
+        double sl= sin( e->plh[1] * deg_to_rad );
+        double w2= ONE - ell->e2*sf*sf;
+        double rn= ell->A / sqrt( w2 );
+        double rm= rn * ( ONE - ell->e2 ) / w2;
+        double p= ( rn + e->plh[2] ) * cf;
+
+        if( !( p >= MEMO_axis*q ) || !( rm + e->plh[2] > ZERO ) ) {
+                e->J[0]= NAN;
+                return;
+        }
+/*
+ *   rows: north / (M + h), east / ((N + h) cos lat) in degrees, up
+ */
+        e->J[0]= -sf*cl * rad_to_deg / ( rm + e->plh[2] );
+        e->J[1]= -sf*sl * rad_to_deg / ( rm + e->plh[2] );
+        e->J[2]= cf * rad_to_deg / ( rm + e->plh[2] );
+        e->J[3]= -sl * rad_to_deg / p;
+        e->J[4]= cl * rad_to_deg / p;
+        e->J[5]= ZERO;
+        e->J[6]= cf*cl;
+        e->J[7]= cf*sl;
+        e->J[8]= sf;
+}
+
+
+int xyz2plhm( struct plh_memo *memo, double *xyz, double *plh,
+              struct ellipsoid *ell )
+/********1*********2*********3*********4*********5*********6*********7**
+ * Name:        xyz2plhm
+ * Version:     2610.18
+ * Author:      geoData
+ * Purpose:     Converts geocentric X, Y, Z to geodetic lat, lon, hgt
+ *              through a memo of earlier conversions.
+ *
+ * Input:
+ * -----------
+ * memo             memo made by plhminit
+ * xyz[]            geocentric X, Y, Z [m]
+ * ell              ellipsoid of lat, lon, hgt
+ *
+ * Output:
+ * -----------
+ * plh[]            geodetic latitude, longitude east of Greenwich
+ *                  [deg] and ellipsoidal height [m]
+ * memo             holds the point, if its cell was new and its shard
+ *                  not full; counts the lookup
+ * returns          0 = memoized exactly, 1 = from the memoized point of
+ *                  its cell, 2 = converted by xyz2plhe
+ *
+ * Notes:
+ * -----------
+ * The key is X, Y, Z rounded to multiples of memo->q, with the
+ * ellipsoid's A, FL, so one memo serves several ellipsoids.  The exact
+ * point memoized gets its own conversion back; another point of its
+ * cell the one memoized, or with memo->lin that plus J times the
+ * offset, except near the Z axis, where it is converted.  X, Y, Z that
+ * are not finite, or beyond MEMO_kmax*q, are converted and not
+ * memoized, and count as misses of shard 0.  The shard is not locked
+ * while converting.  Thread safe.
+ *
+ ********1*********2*********3*********4*********5*********6*********7**
+ * Modification History:
+ * 2610.18, GD,  Creation
+ * 2610.18, GD,  Count the points not memoized as misses
+ ********1*********2*********3*********4*********5*********6*********7*/
+{
+        long long key[3];
+        int r;
+        int s;
+        struct plh_shard *sh;
+        unsigned long h;
+
+        if( (s= memokey( memo, xyz, ell, key, &h )) < 0 ) {
+                sh= &memo->sh[0];
+                pthread_mutex_lock( &sh->lock );
+                sh->miss++;
+                pthread_mutex_unlock( &sh->lock );
+                xyz2plhe( xyz, plh, ell );
+                return( 2 );
+        }
+        sh= &memo->sh[s];
+
+        pthread_mutex_lock( &sh->lock );
+        r= memofind( memo, sh, key, h, xyz, plh, ell );
+        pthread_mutex_unlock( &sh->lock );
+        if( r < 2 )
+                return( r );
+
+        xyz2plhe( xyz, plh, ell );
+        pthread_mutex_lock( &sh->lock );
+        memoadd( memo, sh, key, h, xyz, plh, ell );
+        pthread_mutex_unlock( &sh->lock );
+
+        return( 2 );
+}
+
+
+void xyz2plhmv( struct plh_memo *memo, int n, double *x, double *y,
+                double *z, double *lat, double *lon, double *hgt,
+                struct ellipsoid *ell )
+/********1*********2*********3*********4*********5*********6*********7**
+ * Name:        xyz2plhmv
+ * Version:     2610.18
+ * Author:      geoData
+ * Purpose:     Converts arrays of geocentric X, Y, Z to geodetic lat,
+ *              lon, hgt through a memo (batch).
+ *
+ * Input:
+ * -----------
+ * memo             memo made by plhminit
+ * n                number of points
+ * x[], y[], z[]    geocentric X, Y, Z [m]
+ * ell              ellipsoid of lat, lon, hgt
+ *
+ * Output:
+ * -----------
+ * lat[], lon[]     geodetic latitude, longitude east of Greenwich [deg]
+ * hgt[]            ellipsoidal height [m]
+ * memo             as xyz2plhm
+ *
+ * Notes:
+ * -----------
+ * As xyz2plhm, a block of MEMO_blk points at a time: each shard is
+ * locked once to look up the points of the block that fall in it and
+ * once to add those converted, and the misses of the block are
+ * converted together by xyz2plhv, so a job of new points costs little
+ * more than xyz2plhv itself.  The arrays may be the same as x, y, z.
+ *
+ ********1*********2*********3*********4*********5*********6*********7**
+ * Modification History:
+ * 2610.18, GD,  Creation
+ * 2610.18, GD,  Count the points not memoized as misses
+ ********1*********2*********3*********4*********5*********6*********7*/
+{
+        double mx[3][MEMO_blk];
+        double mp[3][MEMO_blk];
+        double plh[3];
+        double xyz[3];
+        long long key[MEMO_blk][3];
+        int first[MEMO_nshard+1];
+        int i;
+        int j;
+        int k;
+        int m;
+        int nb;
+        int miss[MEMO_blk];
+        int ord[MEMO_blk];
+        int s;
+        int shard[MEMO_blk];
+        struct plh_shard *sh;
+        unsigned long h[MEMO_blk];
+
+        for( ; n > 0; n-= nb, x+= nb, y+= nb, z+= nb,
+                      lat+= nb, lon+= nb, hgt+= nb ) {
+                nb= n < MEMO_blk ? n : MEMO_blk;
+                memset( first, 0, sizeof(first) );
+                for( m= 0, i= 0; i < nb; i++ ) {
+                        xyz[0]= x[i];
+                        xyz[1]= y[i];
+                        xyz[2]= z[i];
+                        shard[i]= memokey( memo, xyz, ell, key[i], &h[i] );
+                        if( shard[i] < 0 )
+                                miss[m++]= i;
+                        else
+                                first[shard[i]+1]++;
+                }
+                if( m > 0 ) {
+                        sh= &memo->sh[0];
+                        pthread_mutex_lock( &sh->lock );
+                        sh->miss+= m;
+                        pthread_mutex_unlock( &sh->lock );
+                }
+/*
+ *   1.0  order the block by shard, then look each shard's points up
+ *        under one lock
+ */
+                for( s= 0; s < MEMO_nshard; s++ )
+                        first[s+1]+= first[s];
+                for( i= 0; i < nb; i++ )
+                        if( shard[i] >= 0 )
+                                ord[first[shard[i]]++]= i;
+                for( s= MEMO_nshard; s > 0; s-- )
+                        first[s]= first[s-1];
+                first[0]= 0;
+
+                for( s= 0; s < MEMO_nshard; s++ ) {
+                        if( first[s] == first[s+1] )
+                                continue;
+                        sh= &memo->sh[s];
+                        pthread_mutex_lock( &sh->lock );
+                        for( k= first[s]; k < first[s+1]; k++ ) {
+                                i= ord[k];
+                                xyz[0]= x[i];
+                                xyz[1]= y[i];
+                                xyz[2]= z[i];
+                                if( memofind( memo, sh, key[i], h[i], xyz, plh,
+                                              ell ) == 2 ) {
+                                        miss[m++]= i;
+                                        continue;
+                                }
+                                lat[i]= plh[0];
+                                lon[i]= plh[1];
+                                hgt[i]= plh[2];
+                        }
+                        pthread_mutex_unlock( &sh->lock );
+                }
+                if( m == 0 )
+                        continue;
+/*
+ *   2.0  convert the misses together, then add them, which are in
+ *        shard order after those not to be memoized
+ */
+                for( j= 0; j < m; j++ ) {
+                        mx[0][j]= x[miss[j]];
+                        mx[1][j]= y[miss[j]];
+                        mx[2][j]= z[miss[j]];
+                }
+                xyz2plhv( m, mx[0], mx[1], mx[2], mp[0], mp[1], mp[2], ell );
+                for( j= 0; j < m; j++ ) {
+                        lat[miss[j]]= mp[0][j];
+                        lon[miss[j]]= mp[1][j];
+                        hgt[miss[j]]= mp[2][j];
+                }
+                for( j= 0; j < m; ) {
+                        if( (s= shard[miss[j]]) < 0 ) {
+                                j++;
+                                continue;
+                        }
+                        sh= &memo->sh[s];
+                        pthread_mutex_lock( &sh->lock );
+                        for( ; j < m && shard[miss[j]] == s; j++ ) {
+                                for( k= 0; k < 3; k++ ) {
+                                        xyz[k]= mx[k][j];
+                                        plh[k]= mp[k][j];
+                                }
+                                memoadd( memo, sh, key[miss[j]], h[miss[j]],
+                                         xyz, plh, ell );
+                        }
+                        pthread_mutex_unlock( &sh->lock );
+                }
+        }
+}
@@ -0,0 +1,370 @@
+/*  @(#)xyz2plhs.c      1.0  26/10/18  */
+static char *sccsid= "@(#)xyz2plhs.c    1.0  26/10/18";
+/*
+ *      include files
+ */
+
+#include <math.h>
+#include "physcon.h"
+#include "libgpsC.h"
+
+/*
+ *      function prototypes
+ */
+
+void plh2xyz_grs80( double *, double * );
+void plh2xyz_wgs84( double *, double * );
+int plh2xyzs( int, double *, double *, double *,
+              double *, double *, double *, struct ellipsoid * );
+void xyz2plh_grs80( double *, double * );
+void xyz2plh_wgs84( double *, double * );
+int xyz2plhs( int, double *, double *, double *,
+              double *, double *, double *, struct ellipsoid * );
+static inline void borkowski( double *, double *, const double,
+                              const double );
+static inline void borkowskiv( int, double *, double *, double *,
+                               double *, double *, double *,
+                               const double, const double );
+static inline void goad( double *, double *, const double, const double );
+static inline void goadv( int, double *, double *, double *,
+                          double *, double *, double *,
+                          const double, const double );
+
+/*
+ *      definitions and global variables
+ *
+ *      isell(e, N)     ellipsoid e has the defining values N_A, N_FL
+ */
+
+#define isell( e, N )   ( (e)->A == N##_A && (e)->FL == N##_FL )
+
+
+static inline void borkowski( double *xyz, double *plh, const double A,
+                              const double FL )
+/********1*********2*********3*********4*********5*********6*********7**
+ * Purpose:     xyz2plh for an ellipsoid known at compile time.  Called
+ *              with constant A, FL, every ellipsoid term below is
+ *              folded into an immediate.
+ ********1*********2*********3*********4*********5*********6*********7*/
+{
+        const double B0= A * (ONE - FL);
+        const double c= A*A - B0*B0;
+        const double rA= ONE / A;
+        const double rB= ONE / B0;
+        double B= B0;
+        double ar;
+        double d;
+        double e;
+        double f;
+        double g;
+        double p;
+        double q;
+        double r;
+        double t;
+        double v;
+        double x= xyz[0];
+        double y= xyz[1];
+        double z= xyz[2];
+        double zlong;
+/*
+ *   1.0 semi-minor axis with the sign of z
+ */
+        if( z < ZERO )
+                B= -B;
+/*
+ *   2.0 intermediate values for latitude; one division by r for the
+ *       two by A*r, r kept off the Z axis as in xyz2plhe, and the core
+ *       about the centre by xyz2plhn, as xyz2plhe
+ */
+        r= sqrt( x*x + y*y );
+        if( r < BRK_rpol*A && B*z <= TWO*c ) {
+                xyz2plhn( xyz, plh, A, FL );
+                return;
+        }
+        ar= rA / ( r < BRK_rmin*A ? BRK_rmin*A : r );
+        e= ( B*z - c ) * ar;
+        f= ( B*z + c ) * ar;
+/*
+ *   3.0 t^4 + 2*E*t^3 + 2*F*t - 1 = 0
+ */
+        p= (FOUR / THREE) * (e*f + ONE);
+        q= TWO * (e*e - f*f);
+        d= p*p*p + q*q;
+
+        if( d >= ZERO ) {
+                v= pow( (sqrt( d ) - q), (ONE / THREE) )
+                 - pow( (sqrt( d ) + q), (ONE / THREE) );
+        } else {
+                v= TWO * sqrt( -p )
+                 * cos( acos( q/(p * sqrt( -p )) ) / THREE );
+        }
+/*
+ *   4.0 improve v
+ */
+        if( v*v < fabs(p) ) {
+                v= -(v*v*v + TWO*q) / (THREE*p);
+        }
+        g= (sqrt( e*e + v ) + e) * (ONE / TWO);
+        t = sqrt( g*g  + (f - v*g)/(TWO*g - e) ) - g;
+/*
+ *   4.1 near the Z axis, the Newton step of xyz2plhe
+ */
+        if( r < BRK_rpol*A && B*z > TWO*c ) {
+                e= ( B*z - c ) * rA;
+                f= ( B*z + c ) * rA;
+                t-= ( ((r*t + TWO*e)*t)*t*t + TWO*f*t - r )
+                  / ( (FOUR*r*t + TWO*THREE*e)*t*t + TWO*f );
+        }
+/*
+ *   A*(1 - t*t) / (2*B*t) with A/(2*B) folded; the sign of B
+ *   is carried by z
+ */
+        plh[0] = atan( (A*rB*(ONE / TWO)) * (ONE - t*t)
+                       / ( z < ZERO ? -t : t ) );
+/*
+ *   5.0 height above ellipsoid
+ */
+        plh[2]= (r - A*t)*cos( plh[0] ) + (z - B)*sin( plh[0] );
+/*
+ *   6.0 longitude east of Greenwich
+ */
+        zlong = atan2( y, x );
+        if( zlong < ZERO )
+                zlong= zlong + twopi;
+
+        plh[0] = plh[0] * rad_to_deg;
+        plh[1] = zlong * rad_to_deg;
+}
+
+
+static inline void goad( double *plh, double *xyz, const double A,
+                         const double FL )
+/********1*********2*********3*********4*********5*********6*********7**
+ * Purpose:     plh2xyz for an ellipsoid known at compile time; flatfn
+ *              and funsq fold into immediates.  Same order of
+ *              operations as plh2xyz, so the same results.
+ ********1*********2*********3*********4*********5*********6*********7*/
+{
+        const double flatfn= (TWO - FL)*FL;
+        const double funsq= (ONE - FL)*(ONE - FL);
+        double g1;
+        double g2;
+        double lat_rad= deg_to_rad * plh[0];
+        double lon_rad= deg_to_rad * plh[1];
+        double sin_lat= sin( lat_rad );
+
+        g1= A / sqrt( ONE - flatfn*sin_lat*sin_lat );
+        g2= g1*funsq + plh[2];
+        g1= (g1 + plh[2]) * cos( lat_rad );
+
+        xyz[0]= g1 * cos( lon_rad );
+        xyz[1]= g1 * sin( lon_rad );
+        xyz[2]= g2 * sin_lat;
+}
+
+
+static inline void borkowskiv( int n, double *x, double *y, double *z,
+                               double *lat, double *lon, double *hgt,
+                               const double A, const double FL )
+/********1*********2*********3*********4*********5*********6*********7**
+ * Purpose:     borkowski over arrays, one copy of the loop per
+ *              ellipsoid
+ ********1*********2*********3*********4*********5*********6*********7*/
+{
+        double plh[3];
+        double xyz[3];
+        int i;
+
+        for( i= 0; i < n; i++ ) {
+                xyz[0]= x[i];
+                xyz[1]= y[i];
+                xyz[2]= z[i];
+                borkowski( xyz, plh, A, FL );
+                lat[i]= plh[0];
+                lon[i]= plh[1];
+                hgt[i]= plh[2];
+        }
+}
+
+
+static inline void goadv( int n, double *lat, double *lon, double *hgt,
+                          double *x, double *y, double *z,
+                          const double A, const double FL )
+/********1*********2*********3*********4*********5*********6*********7**
+ * Purpose:     goad over arrays, one copy of the loop per ellipsoid
+ ********1*********2*********3*********4*********5*********6*********7*/
+{
+        double plh[3];
+        double xyz[3];
+        int i;
+
+        for( i= 0; i < n; i++ ) {
+                plh[0]= lat[i];
+                plh[1]= lon[i];
+                plh[2]= hgt[i];
+                goad( plh, xyz, A, FL );
+                x[i]= xyz[0];
+                y[i]= xyz[1];
+                z[i]= xyz[2];
+        }
+}
+
+
+void xyz2plh_grs80( double *xyz, double *plh )
+/********1*********2*********3*********4*********5*********6*********7**
+ * Name:        xyz2plh_grs80, xyz2plh_wgs84
+ * Version:     2610.18
+ * Author:      geoData
+ * Purpose:     Converts XYZ geocentric coordinates to Phi (latitude),
+ *              Lambda (longitude), H (height) on GRS80 or WGS84, with
+ *              the ellipsoid compiled in.
+ *
+ * Input:
+ * -----------
+ * xyz[]            geocentric Cartesian coordinates [m]
+ *
+ * Output:
+ * -----------
+ * plh[]            as xyz2plh [deg, deg, m]
+ *
+ * Notes:
+ * -----------
+ * Borkowski's method as in xyz2plhe, Z axis and polar cap included,
+ * with B, A*A - B*B, 1/A and A/(2B) as immediates and the two
+ * divisions by A*r done as one division and two multiplications.
+ * The reciprocals round differently from the divisions.  Against
+ * xyz2plh on geo_4277_Points/XYZ.txt longitude is identical, latitude
+ * within 1.3e-11 deg (the ill-conditioning of Borkowski's t near the
+ * equator, see xyz2plhv) and height within 2.4e-7 m at h = 1e9 m.
+ *
+ * Measured on the same file, both -O2, one core: xyz2plh 388 ns and
+ * xyz2plh_grs80 393 ns per point, i.e. no gain within the noise; the
+ * time is in pow, atan, atan2, sin and cos.  plh2xyz 74 ns and
+ * plh2xyz_grs80 59 ns.
+ *
+ ********1*********2*********3*********4*********5*********6*********7**
+ * Modification History:
+ * 2610.18, GD,  Creation
+ * 2610.18, GD,  Z axis and polar cap, as xyz2plhe
+ * 2610.18, GD,  The core about the centre by xyz2plhn, as xyz2plhe
+ ********1*********2*********3*********4*********5*********6*********7*/
+{
+        borkowski( xyz, plh, GRS80_A, GRS80_FL );
+}
+
+
+void xyz2plh_wgs84( double *xyz, double *plh )
+{
+        borkowski( xyz, plh, WGS84_A, WGS84_FL );
+}
+
+
+void plh2xyz_grs80( double *plh, double *xyz )
+/********1*********2*********3*********4*********5*********6*********7**
+ * Name:        plh2xyz_grs80, plh2xyz_wgs84
+ * Version:     2610.18
+ * Author:      geoData
+ * Purpose:     Converts elliptic lat, lon, hgt to geocentric X, Y, Z on
+ *              GRS80 or WGS84, with the ellipsoid compiled in.
+ *
+ * Input:
+ * -----------
+ * plh[]            as plh2xyz [deg, deg, m]
+ *
+ * Output:
+ * -----------
+ * xyz[]            geocentric Cartesian coordinates [m]
+ *
+ * Notes:
+ * -----------
+ * Same results as plh2xyz.
+ *
+ ********1*********2*********3*********4*********5*********6*********7**
+ * Modification History:
+ * 2610.18, GD,  Creation
+ ********1*********2*********3*********4*********5*********6*********7*/
+{
+        goad( plh, xyz, GRS80_A, GRS80_FL );
+}
+
+
+void plh2xyz_wgs84( double *plh, double *xyz )
+{
+        goad( plh, xyz, WGS84_A, WGS84_FL );
+}
+
+
+int xyz2plhs( int n, double *x, double *y, double *z,
+              double *lat, double *lon, double *hgt, struct ellipsoid *ell )
+/********1*********2*********3*********4*********5*********6*********7**
+ * Name:        xyz2plhs
+ * Version:     2610.18
+ * Author:      geoData
+ * Purpose:     Scalar batch conversion of X, Y, Z to lat, lon, hgt by
+ *              the specialized kernel of ell, if it has one.
+ *
+ * Input:
+ * -----------
+ * as xyz2plhv
+ *
+ * Output:
+ * -----------
+ * as xyz2plhv
+ *
+ * returns      0 if converted; -1 if ell has no specialized kernel,
+ *              nothing is done and the caller uses the general code
+ *
+ * Notes:
+ * -----------
+ * An ellipsoid is recognised by its A and FL, whatever its name, so a
+ * custom "6378137,298.257223563" gets the WGS84 kernel too.
+ *
+ ********1*********2*********3*********4*********5*********6*********7**
+ * Modification History:
+ * 2610.18, GD,  Creation
+ ********1*********2*********3*********4*********5*********6*********7*/
+{
+        if( isell( ell, GRS80 ) )
+                borkowskiv( n, x, y, z, lat, lon, hgt, GRS80_A, GRS80_FL );
+        else if( isell( ell, WGS84 ) )
+                borkowskiv( n, x, y, z, lat, lon, hgt, WGS84_A, WGS84_FL );
+        else
+                return( -1 );
+
+        return( 0 );
+}
+
+
+int plh2xyzs( int n, double *lat, double *lon, double *hgt,
+              double *x, double *y, double *z, struct ellipsoid *ell )
+/********1*********2*********3*********4*********5*********6*********7**
+ * Name:        plh2xyzs
+ * Version:     2610.18
+ * Author:      geoData
+ * Purpose:     Scalar batch conversion of lat, lon, hgt to X, Y, Z by
+ *              the specialized kernel of ell, if it has one.
+ *
+ * Input:
+ * -----------
+ * as plh2xyzv
+ *
+ * Output:
+ * -----------
+ * as plh2xyzv
+ *
+ * returns      0 if converted; -1 if ell has no specialized kernel
+ *
+ ********1*********2*********3*********4*********5*********6*********7**
+ * Modification History:
+ * 2610.18, GD,  Creation
+ ********1*********2*********3*********4*********5*********6*********7*/
+{
+        if( isell( ell, GRS80 ) )
+                goadv( n, lat, lon, hgt, x, y, z, GRS80_A, GRS80_FL );
+        else if( isell( ell, WGS84 ) )
+                goadv( n, lat, lon, hgt, x, y, z, WGS84_A, WGS84_FL );
+        else
+                return( -1 );
+
+        return( 0 );
+}
@@ -0,0 +1,295 @@
+/*  @(#)xyz2plht.c      1.0  26/10/18  */
+static char *sccsid= "@(#)xyz2plht.c    1.0  26/10/18";
+/*
+ *      include files
+ */
+
+#include <math.h>
+#include "physcon.h"
+#include "libgpsC.h"
+
+/*
+ *      function prototypes
+ */
+
+void xyz2plht( double *, double *, struct ellipsoid * );
+void xyz2plhtk( double *, double *, struct ellipsoid *, int );
+void xyz2plhtv( int, double *, double *, double *,
+                double *, double *, double *, struct ellipsoid * );
+static inline void trilat( double *, double *, struct ellipsoid *, int );
+
+/*
+ *      definitions and global variables
+ *
+ *      TRI_niter       number of corrections made by xyz2plht, xyz2plhtv
+ *      TRI_ndeep       corrections added for points less than
+ *                      sqrt(TRI_rdeep)*ce from the centre, where the first
+ *                      estimate degenerates
+ *      TRI_rconf       Q0 taken from the confocal ellipse through points
+ *                      less than sqrt(TRI_rconf)*ce from the centre,
+ *                      near the evolute
+ */
+
+#define TRI_niter       ((int)2)
+#define TRI_ndeep       ((int)2)
+#define TRI_rconf       ((double)(1.0/64.0))
+#define TRI_rdeep       ((double)25.0)
+
+
+static inline void trilat( double *xyz, double *plh, struct ellipsoid *ell,
+                           int k )
+/********1*********2*********3*********4*********5*********6*********7**
+ * Purpose:     the k-th trilateration estimate P(k) of the point; see
+ *              xyz2plhtk.  k < 0 = as many corrections as needed for
+ *              full precision
+ ********1*********2*********3*********4*********5*********6*********7*/
+{
+        double A= ell->A;
+        double B= ell->B;
+        double c= ell->c;
+        double ce;
+        double cb;
+        double d1;
+        double d2;
+        double dr;
+        double dz;
+        double g;
+        double gp;
+        double h0;
+        double k0;
+        double q;
+        double r;
+        double s;
+        double sb;
+        double u;
+        double beta;
+        double lat;
+        double x= xyz[0];
+        double y= xyz[1];
+        double z= fabs( xyz[2] );
+        double zlong;
+        int i;
+/*
+ *   1.0 distances of P from the foci (+-ce, 0) of the meridian ellipse
+ */
+        ce= sqrt( c );
+        r= sqrt( x*x + y*y );
+        d1= sqrt( (r - ce)*(r - ce) + z*z );
+        d2= sqrt( (r + ce)*(r + ce) + z*z );
+/*
+ *   2.0 Q0: with d1 - r1 = d2 - r2, the focal distances of Q0 are
+ *       r1, r2 = A +- (d1 - d2)/2, and k0 = B/sqrt(r1*r2) is the
+ *       cosine of the angle of each with the normal n.  The triangles
+ *       P Q0 F1 and P Q0 F2 give
+ *         d1^2 + d2^2 = r1^2 + r2^2 + 2*h0^2 + 4*A*k0*h0
+ *       for the height h0 (q = h0^2 + 2*A*k0*h0 below), and Q0 = P -
+ *       h0*n is at reduced latitude beta.  Less than sqrt(TRI_rconf)*ce
+ *       from the centre, or where B*B + A*k0*h0 <= 0, beta is that of
+ *       P on its confocal ellipse, of semi-axes s and sqrt(u), instead
+ */
+        s= (d1 + d2) / TWO;
+        u= (s - ce) * (s + ce);
+        k0= B / sqrt( (A*s + ce*r)*(A*s - ce*r) / (s*s) );
+        q= r*r*u/(s*s) + (z - B)*(z + B);
+        h0= q / ( A*k0 + sqrt( A*A*k0*k0 + q ) );
+        if( B*B + A*k0*h0 > ZERO && r*r + z*z >= TRI_rconf*c )
+                beta= atan2( z*B*(A + k0*h0), r*(B*B + A*k0*h0) );
+        else
+                beta= atan2( z*s, r*sqrt( u ) );
+        sb= sin( beta );
+        cb= cos( beta );
+        if( k < 0 )
+                k= ( r*r + z*z < TRI_rdeep*c ) ? TRI_niter + TRI_ndeep
+                                               : TRI_niter;
+/*
+ *   3.0 P(1), P(2), ...: Newton corrections of beta for the foot point
+ *       condition; with r1, r2 the focal distances of the foot point Q,
+ *       P is on the normal at Q (the bisector of F1 Q F2) when
+ *         r2*(d1^2 - r1^2 - |PQ|^2) = r1*(d2^2 - r2^2 - |PQ|^2)
+ *       which reduces to 4*ce*sin(beta)*g(beta) = 0, with g below
+ */
+        for( i= 0; i < k; i++ ) {
+                g= c*sb*cb - A*r*sb + B*z*cb;
+                gp= c*(cb*cb - sb*sb) - A*r*cb - B*z*sb;
+                beta= beta - g / gp;
+                sb= sin( beta );
+                cb= cos( beta );
+        }
+/*
+ *   4.0 P(0): latitude of the direction from Q0 to P and height |PQ0|,
+ *       negative below the ellipsoid; P(k): latitude of the normal at
+ *       Q = (A cos(beta), B sin(beta)) and height along it
+ */
+        dr= r - A*cb;
+        dz= z - B*sb;
+        if( k == 0 && ( dr != ZERO || dz != ZERO ) ) {
+                if( h0 < ZERO ) {
+                        dr= -dr;
+                        dz= -dz;
+                }
+                lat= atan2( dz, dr );
+                plh[2]= sqrt( dr*dr + dz*dz );
+                if( h0 < ZERO )
+                        plh[2]= -plh[2];
+        } else {
+                lat= atan2( A*sb, B*cb );
+                plh[2]= dr*cos( lat ) + dz*sin( lat );
+        }
+        if( xyz[2] < ZERO )
+                lat= -lat;
+/*
+ *   5.0 longitude east of Greenwich
+ */
+        zlong= atan2( y, x );
+        if( zlong < ZERO )
+                zlong= zlong + twopi;
+
+        plh[0]= lat * rad_to_deg;
+        plh[1]= zlong * rad_to_deg;
+}
+
+
+void xyz2plhtk( double *xyz, double *plh, struct ellipsoid *ell, int k )
+/********1*********2*********3*********4*********5*********6*********7**
+ * Name:        xyz2plhtk
+ * Version:     2610.18
+ * Author:      geoData
+ * Purpose:     Converts XYZ geocentric coordinates to Phi (latitude),
+ *              Lambda (longitude), H (height) by the trilateration
+ *              algorithm, stopped after k corrections.
+ *
+ * Input:
+ * -----------
+ * ell              ellipsoid, with its derived constants (ellset)
+ * k                number of corrections; 0 = the first estimate P0
+ * xyz[]            geocentric Cartesian coordinates [m]
+ *
+ * Output:
+ * -----------
+ * plh[]            as xyz2plh [deg, deg, m]
+ *
+ * Notes:
+ * -----------
+ * In the meridian plane of P the foci of the ellipsoid are F1, F2 =
+ * (+-ce, 0), ce = sqrt(A*A - B*B), and P is at distances d1, d2 from
+ * them.  The foot point Q on the ellipsoid is at distances r1, r2 =
+ * 2*A - r1 from the foci, and the normal at Q, which bisects the angle
+ * F1 Q F2, makes the same angle with both, of cosine B/sqrt(r1*r2).
+ * The triangles P Q F1 and P Q F2 then give d1 and d2 in r1 and the
+ * height.  The first estimate Q0 takes the two focal radii of P longer
+ * than those of Q by the same amount, and solves the triangles for the
+ * height with that angle (see trilat).  As in the original program P0
+ * is then the direction from Q0 to P and the distance |PQ0|.
+ *
+ * Each correction is a Newton step on the reduced latitude beta of Q
+ * for the condition that the normal at Q passes through P, in
+ * distances only (see trilat); divided by the spurious root
+ * sin(beta) = 0 it is the usual foot point equation in beta.  P(k),
+ * k > 0, is the normal at Q and the height along it.  Against
+ * fi_lam_h(4277).txt on WGS84 the latitude is within
+ *   k = 0   6.8e-10 deg for |h| <= 1 km, 1.8e-8 deg for |h| <= 100 km,
+ *           3.9e-7 deg for h up to 1e9 m
+ *   k = 1   2.1e-14 deg
+ * and the height within 2.4e-7 m (2 ulp at h = 1e9 m).  Points on the
+ * Z axis need no special case; points deep inside the Earth need four
+ * corrections (see xyz2plht).
+ *
+ * Output/err_0.txt, err_1.txt and err_2.txt list the errors of P0, P1
+ * and P2 of the original program on the same grid: 6.2e-5 deg and
+ * 1.6e-4 m for P0, 7.1e-10 deg and 4.8e-7 m for P1.  Its Q0, in
+ * Output/_geo_00.txt (rQw, ZQw), is off the foot point by up to 46 m
+ * at h = 1e9 m, where that above is within 0.01 m; xyzcheck checks
+ * that the max and rms errors of P(k) are within those files.  They
+ * are not reproduced digit for digit: from their own Q0 the errors of
+ * P0 recomputed here differ from the files by up to 1.8e-6 arcsec and
+ * 2.4e-7 m, the rounding of the printed Q0 and of that program.
+ *
+ * References:
+ * -----------
+ * Eleiche, M. "Trilateration Algorithm to Transform Cartesian
+ * Coordinates into Geodetic Coordinates" (see README.md).
+ *
+ ********1*********2*********3*********4*********5*********6*********7**
+ * Modification History:
+ * 2610.18, GD,  Creation
+ * 2610.18, GD,  Q0 by the triangles P Q F1, P Q F2; P0 the direction
+ *               and distance from Q0, as in the original program
+ ********1*********2*********3*********4*********5*********6*********7*/
+{
+        trilat( xyz, plh, ell, k );
+}
+
+
+void xyz2plht( double *xyz, double *plh, struct ellipsoid *ell )
+/********1*********2*********3*********4*********5*********6*********7**
+ * Name:        xyz2plht
+ * Version:     2610.18
+ * Author:      geoData
+ * Purpose:     Converts XYZ geocentric coordinates to Phi (latitude),
+ *              Lambda (longitude), H (height) by the trilateration
+ *              algorithm, to full precision.
+ *
+ * Input:
+ * -----------
+ * ell              ellipsoid, with its derived constants (ellset)
+ * xyz[]            geocentric Cartesian coordinates [m]
+ *
+ * Output:
+ * -----------
+ * plh[]            as xyz2plh [deg, deg, m]
+ *
+ * Notes:
+ * -----------
+ * xyz2plhtk with TRI_niter corrections, or TRI_niter + TRI_ndeep for
+ * points less than 5*ce (2600 km on WGS84) from the centre of the
+ * Earth.  Towards the focal circle Q0 degenerates: P0 is 0.4 deg off
+ * at 0.5*ce, and two corrections leave 0.07 arcsec at 0.2*ce, and
+ * below 1e-9 arcsec from 0.7*ce out.  Within ce/8, about the evolute,
+ * Q0 is taken from the confocal ellipse through P (TRI_rconf).
+ *
+ ********1*********2*********3*********4*********5*********6*********7**
+ * Modification History:
+ * 2610.18, GD,  Creation
+ ********1*********2*********3*********4*********5*********6*********7*/
+{
+        trilat( xyz, plh, ell, -1 );
+}
+
+
+void xyz2plhtv( int n, double *x, double *y, double *z,
+                double *lat, double *lon, double *hgt, struct ellipsoid *ell )
+/********1*********2*********3*********4*********5*********6*********7**
+ * Name:        xyz2plhtv
+ * Version:     2610.18
+ * Author:      geoData
+ * Purpose:     Converts arrays of XYZ geocentric coordinates to Phi
+ *              (latitude), Lambda (longitude), H (height) by the
+ *              trilateration algorithm.  Batch form of xyz2plht.
+ *
+ * Input:
+ * -----------
+ * as xyz2plhv
+ *
+ * Output:
+ * -----------
+ * as xyz2plhv
+ *
+ ********1*********2*********3*********4*********5*********6*********7**
+ * Modification History:
+ * 2610.18, GD,  Creation
+ ********1*********2*********3*********4*********5*********6*********7*/
+{
+        double plh[3];
+        double xyz[3];
+        int i;
+
+        for( i= 0; i < n; i++ ) {
+                xyz[0]= x[i];
+                xyz[1]= y[i];
+                xyz[2]= z[i];
+                trilat( xyz, plh, ell, -1 );
+                lat[i]= plh[0];
+                lon[i]= plh[1];
+                hgt[i]= plh[2];
+        }
+}
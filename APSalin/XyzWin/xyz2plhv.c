@@ -0,0 +1,322 @@
+/*  @(#)xyz2plhv.c      1.0  26/10/18  */
+static char *sccsid= "@(#)xyz2plhv.c    1.0  26/10/18";
+/*
+ *      include files
+ */
+
+#include <stdlib.h>
+#include <math.h>
+#include "physcon.h"
+#include "libgpsC.h"
+
+/*
+ *      function prototypes
+ */
+
+void xyz2plhov( int, int, double *, double *, double *,
+                double *, double *, double *, struct ellipsoid * );
+void xyz2plhov_avx2( int, int, double *, double *, double *,
+                     double *, double *, double *, struct ellipsoid * );
+void xyz2plhv( int, double *, double *, double *,
+               double *, double *, double *, struct ellipsoid * );
+void xyz2plhv_avx2( int, double *, double *, double *,
+                    double *, double *, double *, struct ellipsoid * );
+int simd_level( void );
+static inline void plhokern( int, double *, double *, double *,
+                             double *, double *, double *,
+                             struct ellipsoid *, const int );
+
+/*
+ *      definitions and global variables
+ */
+
+
+void xyz2plhv( int n, double *x, double *y, double *z,
+               double *lat, double *lon, double *hgt, struct ellipsoid *ell )
+/********1*********2*********3*********4*********5*********6*********7**
+ * Name:        xyz2plhv
+ * Version:     2610.18
+ * Author:      geoData
+ * Purpose:     Converts arrays of XYZ geocentric coordinates to Phi
+ *              (latitude), Lambda (longitude), H (height) referred to
+ *              an ellipsoid of the registry.  Batch,
+ *              structure-of-arrays form of xyz2plh.
+ *
+ * Input:
+ * -----------
+ * ell              ellipsoid, with its derived constants (ellset)
+ * n                number of points
+ * x[], y[], z[]    geocentric Cartesian coordinates [units are of distance]
+ *
+ * Output:
+ * -----------
+ * lat[], lon[]     geodetic latitude and longitude east of Greenwich
+ *                  [degrees]
+ * hgt[]            height above the ellipsoid [m]
+ *
+ * Notes:
+ * -----------
+ * When the processor has AVX2 and FMA the points are converted four at
+ * a time by xyz2plhv_avx2 (see xyz2plha.c); otherwise GRS80 and WGS84
+ * go through the kernels compiled for them (xyz2plhs.c) and any other
+ * ellipsoid through xyz2plhe, which gives the same results as xyz2plh.
+ * The output arrays may not overlap the input ones.
+ *
+ * Compared to xyz2plh on geo_4277_Points/XYZ.txt the AVX2 kernel gives
+ *   longitude     within 1 ulp
+ *   height        within 3 ulp of max(|h|, A) (2.4e-7 m at h = 1e9 m)
+ *   latitude      within 1.3e-11 deg (about 1000 ulp of 90 deg)
+ * Latitude is ill-conditioned in Borkowski's t near the equator, and
+ * xyz2plh itself is only good to 1.1e-9 deg against fi_lam_h(4277).txt
+ * there, so the bound is about 1% of the method's own error.  See
+ * xyz2plha.c for where the kernels differ.
+ *
+ ********1*********2*********3*********4*********5*********6*********7**
+ * Modification History:
+ * 2610.18, GD,  Creation
+ * 2610.18, GD,  Ellipsoid from the registry rather than A, FL
+ * 2610.18, GD,  Specialized scalar kernels for GRS80 and WGS84
+ ********1*********2*********3*********4*********5*********6*********7*/
+{
+        double plh[3];
+        double xyz[3];
+        int i;
+
+        if( simd_level() >= 1 ) {
+                xyz2plhv_avx2( n, x, y, z, lat, lon, hgt, ell );
+                return;
+        }
+        if( xyz2plhs( n, x, y, z, lat, lon, hgt, ell ) == 0 )
+                return;
+
+        for( i= 0; i < n; i++ ) {
+                xyz[0]= x[i];
+                xyz[1]= y[i];
+                xyz[2]= z[i];
+                xyz2plhe( xyz, plh, ell );
+                lat[i]= plh[0];
+                lon[i]= plh[1];
+                hgt[i]= plh[2];
+        }
+}
+
+
+void xyz2plhov( int n, int mask, double *x, double *y, double *z,
+                double *lat, double *lon, double *hgt, struct ellipsoid *ell )
+/********1*********2*********3*********4*********5*********6*********7**
+ * Name:        xyz2plhov
+ * Version:     2610.18
+ * Author:      geoData
+ * Purpose:     xyz2plhv computing only the outputs asked for.
+ *
+ * Input:
+ * -----------
+ * ell              ellipsoid, with its derived constants (ellset)
+ * mask             outputs wanted, OUT_lat | OUT_lon | OUT_hgt
+ *                  (xyzbat.h)
+ * n                number of points
+ * x[], y[], z[]    geocentric Cartesian coordinates [m]
+ *
+ * Output:
+ * -----------
+ * lat[], lon[]     geodetic latitude and longitude east of Greenwich
+ *                  [degrees], if in mask
+ * hgt[]            height above the ellipsoid [m], if in mask
+ *
+ * Notes:
+ * -----------
+ * Arrays not in mask are not touched and may be NULL.  With AVX2 and
+ * FMA, xyz2plhov_avx2 gives the results of xyz2plhv_avx2 for the
+ * outputs wanted, without the steps of the others; without, plhokern
+ * does the same for xyz2plhe: a longitude alone is one atan2 and no
+ * Borkowski, a latitude alone or with the height skips the atan2, and
+ * a height without the latitude takes cos and sin of it algebraically,
+ * as the AVX2 kernel, rather than by atan, cos and sin.  On
+ * geo_4277_Points/fi_lam_h(4277).txt that height is within 2 ulp of
+ * max(|h|, A) of xyz2plhe's; the rest is identical to it.  All three
+ * go through plhokern too, not xyz2plhv, whose GRS80 and WGS84
+ * kernels (xyz2plhs) differ from xyz2plhe in the last bits, so that
+ * no mask changes the bits of the outputs it keeps.
+ *
+ ********1*********2*********3*********4*********5*********6*********7**
+ * Modification History:
+ * 2610.18, GD,  Creation
+ ********1*********2*********3*********4*********5*********6*********7*/
+{
+        mask&= OUT_plh;
+        if( simd_level() >= 1 ) {
+                xyz2plhov_avx2( n, mask, x, y, z, lat, lon, hgt, ell );
+                return;
+        }
+
+        switch( mask ) {
+        case OUT_lat:
+                plhokern( n, x, y, z, lat, lon, hgt, ell, OUT_lat );
+                break;
+        case OUT_lon:
+                plhokern( n, x, y, z, lat, lon, hgt, ell, OUT_lon );
+                break;
+        case OUT_hgt:
+                plhokern( n, x, y, z, lat, lon, hgt, ell, OUT_hgt );
+                break;
+        case OUT_lat | OUT_lon:
+                plhokern( n, x, y, z, lat, lon, hgt, ell, OUT_lat | OUT_lon );
+                break;
+        case OUT_lat | OUT_hgt:
+                plhokern( n, x, y, z, lat, lon, hgt, ell, OUT_lat | OUT_hgt );
+                break;
+        case OUT_lon | OUT_hgt:
+                plhokern( n, x, y, z, lat, lon, hgt, ell, OUT_lon | OUT_hgt );
+                break;
+        case OUT_plh:
+                plhokern( n, x, y, z, lat, lon, hgt, ell, OUT_plh );
+                break;
+        }
+}
+
+
+static inline void plhokern( int n, double *x, double *y, double *z,
+                             double *lat, double *lon, double *hgt,
+                             struct ellipsoid *ell, const int mask )
+/********1*********2*********3*********4*********5*********6*********7**
+ * Purpose:     xyz2plhe over arrays for the outputs in mask; the steps
+ *              are those of xyz2plhe, in the same order.  Called with
+ *              a constant mask, one copy of the loop per mask.
+ ********1*********2*********3*********4*********5*********6*********7*/
+{
+        double A= ell->A;
+        double B;
+        double c= ell->c;
+        double d;
+        double e;
+        double f;
+        double g;
+        double hyp;
+        double p;
+        double phi;
+        double plh[3];
+        double q;
+        double r;
+        double rs;
+        double t;
+        double v;
+        double xyz[3];
+        double zlong;
+        int i;
+
+        for( i= 0; i < n; i++ ) {
+/*
+ *   6.0 longitude east of Greenwich, on its own
+ */
+                if( mask & OUT_lon ) {
+                        zlong = atan2( y[i], x[i] );
+                        if( zlong < ZERO )
+                                zlong= zlong + twopi;
+                        lon[i]= zlong * rad_to_deg;
+                }
+                if( !( mask & (OUT_lat | OUT_hgt) ) )
+                        continue;
+/*
+ *   1.0 - 4.1 as xyz2plhe, the core by xyz2plhn
+ */
+                B= z[i] < ZERO ? -ell->B : ell->B;
+                r= sqrt( x[i]*x[i] + y[i]*y[i] );
+                if( r < BRK_rpol*A && B*z[i] <= TWO*c ) {
+                        xyz[0]= x[i];
+                        xyz[1]= y[i];
+                        xyz[2]= z[i];
+                        xyz2plhn( xyz, plh, A, ell->FL );
+                        if( mask & OUT_lat )
+                                lat[i]= plh[0];
+                        if( mask & OUT_hgt )
+                                hgt[i]= plh[2];
+                        continue;
+                }
+                rs= r < BRK_rmin*A ? BRK_rmin*A : r;
+                e= ( B*z[i] - c ) / ( A*rs );
+                f= ( B*z[i] + c ) / ( A*rs );
+
+                p= (FOUR / THREE) * (e*f + ONE);
+                q= TWO * (e*e - f*f);
+                d= p*p*p + q*q;
+
+                if( d >= ZERO ) {
+                        v= pow( (sqrt( d ) - q), (ONE / THREE) )
+                         - pow( (sqrt( d ) + q), (ONE / THREE) );
+                } else {
+                        v= TWO * sqrt( -p )
+                         * cos( acos( q/(p * sqrt( -p )) ) / THREE );
+                }
+
+                if( v*v < fabs(p) ) {
+                        v= -(v*v*v + TWO*q) / (THREE*p);
+                }
+                g= (sqrt( e*e + v ) + e) / TWO;
+                t = sqrt( g*g  + (f - v*g)/(TWO*g - e) ) - g;
+
+                if( r < BRK_rpol*A && B*z[i] > TWO*c ) {
+                        e= ( B*z[i] - c ) / A;
+                        f= ( B*z[i] + c ) / A;
+                        t-= ( ((r*t + TWO*e)*t)*t*t + TWO*f*t - r )
+                          / ( (FOUR*r*t + TWO*THREE*e)*t*t + TWO*f );
+                }
+/*
+ *   latitude and 5.0 height: by atan, cos and sin with the latitude,
+ *   algebraically from tan(Phi) = num/den without
+ */
+                if( mask & OUT_lat ) {
+                        phi= atan( (A*(ONE - t*t)) / (TWO*B*t) );
+                        lat[i]= phi * rad_to_deg;
+                        if( mask & OUT_hgt )
+                                hgt[i]= (r - A*t)*cos( phi )
+                                      + (z[i] - B)*sin( phi );
+                } else {
+                        p= A*(ONE - t*t);
+                        q= TWO*B*t;
+                        hyp= sqrt( p*p + q*q );
+                        hgt[i]= (r - A*t)*( fabs( q ) / hyp )
+                              + (z[i] - B)*( copysign( ONE, q ) * p / hyp );
+                }
+        }
+}
+
+
+int simd_level( void )
+/********1*********2*********3*********4*********5*********6*********7**
+ * Name:        simd_level
+ * Version:     2610.18
+ * Author:      geoData
+ * Purpose:     Returns the vector instruction level the batch kernels
+ *              may use on this processor.
+ *
+ * Output:
+ * -----------
+ * returns      = 0 = scalar code only
+ *              = 1 = AVX2 and FMA
+ *
+ * Notes:
+ * -----------
+ * Setting the environment variable XYZ_SCALAR forces 0, which is
+ * useful to compare the vector kernels with the scalar routines.
+ *
+ ********1*********2*********3*********4*********5*********6*********7**
+ * Modification History:
+ * 2610.18, GD,  Creation
+ ********1*********2*********3*********4*********5*********6*********7*/
+{
+        static int level= -1;
+
+        if( level < 0 ) {
+                level= 0;
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+                __builtin_cpu_init();
+                if( __builtin_cpu_supports( "avx2" )
+                    && __builtin_cpu_supports( "fma" ) )
+                        level= 1;
+#endif
+                if( getenv( "XYZ_SCALAR" ) != NULL )
+                        level= 0;
+        }
+
+        return( level );
+}
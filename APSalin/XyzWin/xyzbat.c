@@ -0,0 +1,463 @@
+/*  @(#)xyzbat.c        1.0  26/10/18  */
+static char *sccsid= "@(#)xyzbat.c      1.0  26/10/18";
+/*
+ *  include files
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "physcon.h"
+#include "libgpsC.h"
+
+/*
+ *  function prototypes
+ */
+
+static int getrec( char *, double *, int );
+static int putdms( char *, double *, int * );
+static int putrec( char *, int, double *, const int *, const int *,
+                   int * );
+
+/*
+ *  global definitions and variables
+ *
+ *  Output formats of xyz2llh as field widths and decimals for putrec:
+ *  wxyz/pxyz   "%13.4lf %13.4lf %13.4lf"
+ *  wdeg/pdeg   "%16.10f %16.10lf %13.5lf"
+ */
+
+static const int wxyz[3]= { 13, 13, 13 };
+static const int pxyz[3]= {  4,  4,  4 };
+static const int wdeg[3]= { 16, 16, 13 };
+static const int pdeg[3]= { 10, 10,  5 };
+
+int getchunk( FILE *fp, struct xyz_chunk *chk, long *lineno )
+/********1*********2*********3*********4*********5*********6*********7*********
+ * name:            getchunk
+ * version:         2610.18
+ * written by:      geoData
+ * purpose:         reads the next chunk of lines from a stream
+ *
+ * input parameters
+ * ----------------
+ * fp               input stream
+ * lineno           number of lines read so far
+ *
+ * output parameters
+ * -----------------
+ * chk              text holds up to MAX_chunk lines, each ending in '\n';
+ *                  nlong lines were too long
+ * lineno           number of lines read so far
+ *
+ * returns the number of lines in the chunk; 0 at end of file
+ *
+ * comments:
+ * ------------------------------
+ * Only copies text; the records are split by parsechunk, so that the
+ * work can be done on the conversion threads.  Lines longer than
+ * MAX_line - 1 are cut to fit and counted in nlong, for the caller to
+ * report.
+ *
+ ********1*********2*********3*********4*********5*********6*********7*********
+ *:modification history
+ *:2610.18, GD, Creation
+ *:2610.18, GD, Split record parsing out into parsechunk
+ *:2610.18, GD, Count the lines too long in nlong
+ ********1*********2*********3*********4*********5*********6*********7*********/
+
+{
+        char *ptr= chk->raw;
+        int c;
+        size_t len;
+
+        chk->first= *lineno + 1;
+        chk->nline= 0;
+        chk->nlong= 0;
+        while( chk->nline < MAX_chunk && fgets( ptr, MAX_line, fp ) != NULL ) {
+                len= strlen( ptr );
+                if( len == 0 || ptr[len-1] != '\n' ) {
+                        if( len == MAX_line - 1 && (c= getc( fp )) != EOF
+                            && c != '\n' ) {
+                                chk->nlong++;
+                                while( (c= getc( fp )) != EOF && c != '\n' )
+                                        ;
+                        }
+                        ptr[len++]= '\n';
+                }
+                ptr+= len;
+                chk->nline++;
+        }
+        *ptr= '\0';
+        *lineno+= chk->nline;
+        chk->text= chk->raw;
+        chk->ntext= ptr - chk->raw;
+
+        return( chk->nline );
+}
+
+
+void parsechunk( struct xyz_job *job, struct xyz_chunk *chk )
+/********1*********2*********3*********4*********5*********6*********7*********
+ * name:            parsechunk
+ * version:         2610.18
+ * written by:      geoData
+ * purpose:         splits the lines of a chunk into records
+ *
+ * input parameters
+ * ----------------
+ * job              conversion options; mode selects the number of values
+ *                  required per record
+ * chk              chunk with nline lines in text
+ *
+ * output parameters
+ * -----------------
+ * chk              in[][] holds n records; nskip lines were skipped
+ *
+ * comments:
+ * ------------------------------
+ * X, Y, Z records need three values.  lat, lon, hgt records need two
+ * or three values; a missing height is taken as zero, as on the
+ * command line.
+ *
+ ********1*********2*********3*********4*********5*********6*********7*********
+ *:modification history
+ *:2610.18, GD, Creation
+ ********1*********2*********3*********4*********5*********6*********7*********/
+
+{
+        char *end= chk->text + chk->ntext;
+        char *ptr;
+        double v[3];
+        int need= ( job->mode == 1 ) ? 2 : 3;
+        int nv;
+
+        chk->n= 0;
+        chk->nskip= 0;
+        for( ptr= chk->text; ptr < end; ptr++ ) {
+                nv= getrec( ptr, v, 3 );
+                while( *ptr != '\n' )
+                        ptr++;
+                if( nv < need ) {
+                        chk->nskip++;
+                        continue;
+                }
+                if( nv == 2 )
+                        v[2]= ZERO;
+                chk->in[0][chk->n]= v[0];
+                chk->in[1][chk->n]= v[1];
+                chk->in[2][chk->n]= v[2];
+                chk->n++;
+        }
+}
+
+
+static int getrec( char *line, double *v, int max )
+/********1*********2*********3*********4*********5*********6*********7*********
+ * purpose:         splits one record into at most max values; numscan
+ *                  reads them, so '.' is the decimal point whatever the
+ *                  locale
+ *
+ * returns the number of values found; 0 if the line does not start
+ * with a number (header or comment line)
+ ********1*********2*********3*********4*********5*********6*********7*********/
+{
+        char *end;
+        char *ptr= line;
+        int n= 0;
+
+        while( n < max ) {
+                while( *ptr == ' ' || *ptr == '\t' || *ptr == ',' )
+                        ptr++;
+                if( *ptr == '\0' || *ptr == '\n' || *ptr == '\r' )
+                        break;
+                v[n]= numscan( ptr, &end );
+                if( end == ptr )
+                        break;
+                ptr= end;
+                n++;
+        }
+
+        return( n );
+}
+
+
+void cvtchunk( struct xyz_job *job, struct xyz_chunk *chk )
+/********1*********2*********3*********4*********5*********6*********7*********
+ * name:            cvtchunk
+ * version:         2610.18
+ * written by:      geoData
+ * purpose:         converts and formats one chunk of records
+ *
+ * input parameters
+ * ----------------
+ * job              conversion options
+ * chk              chunk with nline input lines in text, or a column file
+ *                  block read by colgetblk when job->colin is set
+ *
+ * output parameters
+ * -----------------
+ * chk              in[][] holds the n records parsed, out[] holds the
+ *                  converted coordinates and txt[] the formatted output,
+ *                  in the same formats as the single point mode of
+ *                  xyz2llh, or the coded block for a column file;
+ *                  with job->mask only its outputs, in job->ocol[];
+ *                  nlong counts the records too long as well
+ *
+ * calls:
+ * ------------------------------
+ * colpack          codes the output as a column file block
+ * colunpack        decodes a column file block into in[][]
+ * parsechunk       splits the lines into records
+ * plh2xyzov        plh2xyzv for the outputs in job->mask
+ * plh2xyzv         lat, lon, hgt to X, Y, Z, whole chunk at once
+ * putdms           formats one record in degrees, minutes, seconds
+ * putrec           formats one output record
+ * xyz2plhd         xyz2plhv by the cheapest solver meeting job->ftol, htol
+ * xyz2plhhcv       xyz2plhv by Halley corrections to convergence
+ * xyz2plhhv        xyz2plhv by one Halley correction
+ * xyz2plhmv        xyz2plhv through job->memo
+ * xyz2plhtv        xyz2plhv by trilateration (job->solver)
+ * xyz2neup         X, Y, Z to north, east, up from job->neu
+ * xyz2plhov        xyz2plhv for the outputs in job->mask
+ * xyz2plhv         X, Y, Z to lat, lon, hgt, whole chunk at once
+ *
+ ********1*********2*********3*********4*********5*********6*********7*********
+ *:modification history
+ *:2610.18, GD, Creation
+ *:2610.18, GD, X, Y, Z -> lat, lon, hgt by the batch kernel xyz2plhv
+ *:2610.18, GD, lat, lon, hgt -> X, Y, Z by the batch kernel plh2xyzv
+ *:2610.18, GD, Parse the chunk here, on the conversion thread
+ *:2610.18, GD, Format with numfix rather than snprintf
+ *:2610.18, GD, Column file input and output
+ *:2610.18, GD, X, Y, Z -> lat, lon, hgt by the solver of the job
+ *:2610.18, GD, X, Y, Z -> north, east, up from a station
+ *:2610.18, GD, Degrees, minutes, seconds by dmsfmt
+ *:2610.18, GD, SOLV_auto by xyz2plhd
+ *:2610.18, GD, Through a memo of repeat stations
+ *:2610.18, GD, Only the outputs of job->mask, by xyz2plhov, plh2xyzov
+ *:2610.18, GD, Count the records too long in nlong
+ ********1*********2*********3*********4*********5*********6*********7*********/
+
+{
+        char *txt= chk->txt;
+        double *col[4];
+        double out[4];
+        int i;
+        int k;
+        int n;
+        int prec[4];
+        int width[4];
+
+        if( job->colin != NULL ) {
+                col[0]= chk->in[0];
+                col[1]= chk->in[1];
+                col[2]= chk->in[2];
+                chk->nskip= 0;
+                if( (chk->n= colunpack( job->colin, chk->text, 3, col )) < 0 ) {
+                        chk->n= 0;
+                        chk->nskip= 1;
+                }
+                if( job->colin->ncol < 3 )
+                        for( i= 0; i < chk->n; i++ )
+                                chk->in[2][i]= ZERO;
+        } else
+                parsechunk( job, chk );
+
+        if( job->mask != 0 ) {
+                for( k= 0; k < 4; k++ )
+                        col[k]= job->mask & 1 << k ? chk->out[job->ocol[k]]
+                                                   : NULL;
+                if( job->mode == 1 && job->west == 1
+                    && job->mask & (OUT_x | OUT_y) )
+                        for( i= 0; i < chk->n; i++ )
+                                chk->in[1][i]= fmod( 360.0-chk->in[1][i],
+                                                     360.0 );
+                if( job->mode == 1 )
+                        plh2xyzov( chk->n, job->mask, chk->in[0], chk->in[1],
+                                   chk->in[2], col[0], col[1], col[2], col[3],
+                                   job->ell );
+                else
+                        xyz2plhov( chk->n, job->mask, chk->in[0], chk->in[1],
+                                   chk->in[2], col[0], col[1], col[2],
+                                   job->ell );
+        } else if( job->mode == 1 ) {
+                if( job->west == 1 )
+                        for( i= 0; i < chk->n; i++ )
+                                chk->in[1][i]= fmod( 360.0-chk->in[1][i],
+                                                     360.0 );
+                plh2xyzv( chk->n, chk->in[0], chk->in[1], chk->in[2],
+                          chk->out[0], chk->out[1], chk->out[2], job->ell );
+        } else if( job->neu != NULL )
+                xyz2neup( job->neu, chk->n, chk->in[0], chk->in[1], chk->in[2],
+                          chk->out[0], chk->out[1], chk->out[2] );
+        else if( job->memo != NULL )
+                xyz2plhmv( job->memo, chk->n, chk->in[0], chk->in[1],
+                           chk->in[2], chk->out[0], chk->out[1], chk->out[2],
+                           job->ell );
+        else if( job->solver == SOLV_trilat )
+                xyz2plhtv( chk->n, chk->in[0], chk->in[1], chk->in[2],
+                           chk->out[0], chk->out[1], chk->out[2], job->ell );
+        else if( job->solver == SOLV_halley )
+                xyz2plhhv( chk->n, chk->in[0], chk->in[1], chk->in[2],
+                           chk->out[0], chk->out[1], chk->out[2], job->ell );
+        else if( job->solver == SOLV_halleyc )
+                xyz2plhhcv( chk->n, chk->in[0], chk->in[1], chk->in[2],
+                            chk->out[0], chk->out[1], chk->out[2], job->ell );
+        else if( job->solver == SOLV_auto )
+                xyz2plhd( chk->n, chk->in[0], chk->in[1], chk->in[2],
+                          chk->out[0], chk->out[1], chk->out[2], job->ell,
+                          job->ftol, job->htol );
+        else
+                xyz2plhv( chk->n, chk->in[0], chk->in[1], chk->in[2],
+                          chk->out[0], chk->out[1], chk->out[2], job->ell );
+
+        if( job->colout != NULL ) {
+                k= job->mask == 0 ? 1 : job->ocol[1];
+                if( job->mode == 0 && job->neu == NULL && job->west == 1
+                    && ( job->mask == 0 || job->mask & OUT_lon ) )
+                        for( i= 0; i < chk->n; i++ )
+                                chk->out[k][i]= fmod( 360.0-chk->out[k][i],
+                                                      360.0 );
+                col[0]= chk->out[0];
+                col[1]= chk->out[1];
+                col[2]= chk->out[2];
+                col[3]= chk->out[3];
+                chk->ntxt= colpack( job->colout, chk->n, col, chk->txt );
+                return;
+        }
+
+/*
+ *   only the outputs of job->mask, in their columns, each in the format
+ *   it has in the full record
+ */
+
+        if( job->mask != 0 ) {
+                for( k= 0; k < 4; k++ ) {
+                        if( !( job->mask & 1 << k ) )
+                                continue;
+                        width[job->ocol[k]]= job->mode == 1 ? wxyz[0] : wdeg[k];
+                        prec[job->ocol[k]]= job->mode == 1 ? pxyz[0] : pdeg[k];
+                }
+                for( i= 0; i < chk->n; i++ ) {
+                        for( k= 0; k < job->ncol; k++ )
+                                out[k]= chk->out[k][i];
+                        if( job->mode == 0 && job->west == 1
+                            && job->mask & OUT_lon )
+                                out[job->ocol[1]]=
+                                        fmod( 360.0-out[job->ocol[1]], 360.0 );
+                        txt+= putrec( txt, job->ncol, out, width, prec,
+                                      &chk->nlong );
+                }
+                chk->ntxt= txt - chk->txt;
+                return;
+        }
+
+        for( i= 0; i < chk->n; i++ ) {
+                out[0]= chk->out[0][i];
+                out[1]= chk->out[1][i];
+                out[2]= chk->out[2][i];
+
+                if( job->mode == 1 || job->neu != NULL )
+                        n= putrec( txt, 3, out, wxyz, pxyz, &chk->nlong );
+                else {
+                        if( job->west == 1 )
+                                out[1]= fmod( 360.0-out[1], 360.0 );
+
+                        if( job->display == 1 )
+                                n= putdms( txt, out, &chk->nlong );
+                        else
+                                n= putrec( txt, 3, out, wdeg, pdeg,
+                                           &chk->nlong );
+                }
+                txt+= n;
+        }
+        chk->ntxt= txt - chk->txt;
+}
+
+
+static int putdms( char *txt, double *v, int *nlong )
+/********1*********2*********3*********4*********5*********6*********7*********
+ * purpose:         formats lat, lon, hgt as "%3d %2d %8.5lf %3d %2d
+ *                  %8.5lf %13.8lf\n", the degrees and minutes by dmsfmt,
+ *                  with the sign on the degrees and no 60 seconds; as
+ *                  putrec, a record too long is cut to fit, keeps its
+ *                  '\n' and is counted in *nlong
+ *
+ * returns the number of characters written
+ ********1*********2*********3*********4*********5*********6*********7*********/
+{
+        int len;
+
+        len= dmsfmt( txt, MAX_outrec - 1, v[0], 3, 5 );
+        if( len < MAX_outrec - 2 ) {
+                txt[len++]= ' ';
+                len+= dmsfmt( txt + len, MAX_outrec - 1 - len, v[1], 3, 5 );
+        }
+        if( len < MAX_outrec - 2 ) {
+                txt[len++]= ' ';
+                len+= numfix( txt + len, MAX_outrec - 1 - len, v[2], 13, 8 );
+                if( len < MAX_outrec - 1 ) {
+                        txt[len++]= '\n';
+                        return( len );
+                }
+        }
+        (*nlong)++;
+        txt[MAX_outrec-2]= '\n';
+
+        return( MAX_outrec - 1 );
+}
+
+
+static int putrec( char *txt, int nv, double *v, const int *width,
+                   const int *prec, int *nlong )
+/********1*********2*********3*********4*********5*********6*********7*********
+ * purpose:         formats nv values separated by blanks and ended by
+ *                  '\n', value k as "%*.*f" with width[k] and prec[k];
+ *                  a record longer than MAX_outrec - 1 is cut to fit,
+ *                  keeps its '\n' and is counted in *nlong
+ *
+ * returns the number of characters written
+ ********1*********2*********3*********4*********5*********6*********7*********/
+{
+        int k;
+        int len= 0;
+
+        for( k= 0; k < nv; k++ ) {
+                len+= numfix( txt + len, MAX_outrec - 1 - len, v[k],
+                              width[k], prec[k] );
+                if( len >= MAX_outrec - 1 ) {
+                        (*nlong)++;
+                        len= MAX_outrec - 1;
+                        break;
+                }
+                txt[len++]= ' ';
+        }
+        txt[len-1]= '\n';
+
+        return( len );
+}
+
+
+int putchunk( FILE *fp, struct xyz_chunk *chk )
+/********1*********2*********3*********4*********5*********6*********7*********
+ * name:            putchunk
+ * version:         2610.18
+ * written by:      geoData
+ * purpose:         writes the formatted output of one chunk
+ *
+ * returns 0 on success, -1 on a write error
+ *
+ ********1*********2*********3*********4*********5*********6*********7*********
+ *:modification history
+ *:2610.18, GD, Creation
+ ********1*********2*********3*********4*********5*********6*********7*********/
+
+{
+        if( chk->ntxt > 0
+            && fwrite( chk->txt, 1, chk->ntxt, fp ) != (size_t)chk->ntxt )
+                return( -1 );
+
+        return( 0 );
+}
@@ -0,0 +1,189 @@
+/*  @(#)xyzbat.h        1.0  26/10/18  */
+/********1*********2*********3*********4*********5*********6*********7*********
+ * name:            xyzbat.h
+ * version:         2610.18
+ * written by:      geoData
+ * purpose:         definitions for batch (file/stream) coordinate conversion
+ *
+ * global variables and constants
+ * ------------------------------
+ * MAX_chunk        maximum number of records converted as one chunk
+ * MAX_line         maximum length of one input record [char]
+ * MAX_outrec       maximum length of one formatted output record [char]
+ * SOLV_borkowski   solver: Borkowski's closed form (xyz2plhv)
+ * SOLV_trilat      solver: trilateration (xyz2plhtv)
+ * SOLV_halley      solver: one Halley correction (xyz2plhhv)
+ * SOLV_halleyc     solver: Halley corrections to convergence (xyz2plhhcv)
+ * SOLV_auto        solver: the cheapest meeting ftol, htol (xyz2plhd)
+ * OUT_lat, _lon,   output mask of xyz2plhov: latitude, longitude,
+ *   _hgt           height; OUT_plh all three
+ * OUT_x, _y, _z,   output mask of plh2xyzov: X, Y, Z and r, the
+ *   _r             distance from the Z axis; OUT_xyz X, Y, Z
+ *
+ * xyz_chunk, one chunk of records:
+ *    first         input line number of the first line in the chunk
+ *    nline         number of input lines in the chunk
+ *    text          input lines, each ending in '\n'
+ *    ntext         number of characters in text
+ *    raw[]         storage for text when read from a stream, or for a
+ *                  coded block of a column file
+ *    n             number of records in the chunk
+ *    nskip         number of lines skipped in the chunk
+ *    nlong         number of input lines longer than MAX_line - 1 and
+ *                  output records longer than MAX_outrec - 1, cut to fit
+ *    in[][]        input coordinates, in[0..2][record]
+ *    out[][]       output coordinates, out[0..2][record], or out[0..3]
+ *                  in the columns of job->ocol[]
+ *    txt[]         formatted output of the chunk, or its coded block
+ *                  for a column file
+ *    ntxt          number of characters used in txt[]
+ *
+ * xyz_job, conversion options shared by all chunks of one run:
+ *    mode          = 0 = X, Y, Z -> lat, lon, hgt
+ *                  = 1 = lat, lon, hgt -> X, Y, Z
+ *    display       = 1 = display latitude and longitude in deg min sec
+ *    west          = 1 = longitudes are west rather than east longitude
+ *    ell           ellipsoid of lat, lon, hgt (see ellips.h)
+ *    solver        X, Y, Z -> lat, lon, hgt method, SOLV_...
+ *    ftol          latitude tolerance of SOLV_auto [arcsec]
+ *    htol          height tolerance of SOLV_auto [m]
+ *    neu           frame of a station: X, Y, Z -> north, east, up from
+ *                  it rather than lat, lon, hgt; NULL = off
+ *    memo          memo of repeat stations: X, Y, Z -> lat, lon, hgt by
+ *                  xyz2plhmv rather than the solver; NULL = off
+ *    mask          outputs wanted, OUT_..., by xyz2plhov or plh2xyzov;
+ *                  0 = all of lat, lon, hgt or X, Y, Z
+ *    ncol          number of outputs in mask
+ *    ocol[]        output column of each bit of mask, e.g. ocol[2] that
+ *                  of OUT_hgt or OUT_z
+ *    colin         header of a column file input; NULL for text
+ *    colout        header of a column file output; NULL for text
+ *    nread         number of records converted
+ *    nskip         number of lines skipped (headers, comments, bad lines)
+ *    nlong         number of lines and records cut to fit, see xyz_chunk
+ *
+ * xyz_map, an input file mapped into memory:
+ *    base          first byte of the file; NULL if not mapped
+ *    size          length of the file [char]
+ *    pos           offset of the next unread line
+ *
+ * functions
+ * ------------------------------
+ * cvtchunk:        converts and formats one chunk of records
+ * cvtfile:         converts every record of a stream, multi-threaded
+ * getchunk:        reads the next chunk of lines from a stream
+ * mapchunk:        the next chunk of lines of a mapped file, not copied
+ * mapclose:        unmaps a file mapped by mapopen
+ * mapopen:         maps the rest of an input stream into memory
+ * nlscan:          finds the end of the n-th line of a buffer
+ * parsechunk:      splits the lines of a chunk into records
+ * putchunk:        writes the formatted output of one chunk
+ *
+ * comments:
+ * ------------------------------
+ * Records are one point per line; values are separated by commas
+ * and/or white space.  Lines that do not start with a number, e.g.
+ * the "X,Y,Z" header of geo_4277_Points/XYZ.txt, are skipped.
+ * Coordinates are held as structure-of-arrays so the batch kernels
+ * (xyz2plhv) can work on them in place.  When the input is a regular
+ * file, text points into the mapped file rather than to raw.
+ *
+ ********1*********2*********3*********4*********5*********6*********7*********
+ *:modification history
+ *:2610.18, GD, Creation
+ *:2610.18, GD, Structure-of-arrays chunk for xyz2plhv
+ *:2610.18, GD, Add cvtfile; lines are parsed by cvtchunk, off the
+ *:              reading thread
+ *:2610.18, GD, Add xyz_map; regular files are read through mmap
+ *:2610.18, GD, Add colin, colout: column file input and output
+ *:2610.18, GD, ell replaces A, FL
+ *:2610.18, GD, Add solver
+ *:2610.18, GD, Add SOLV_halley, SOLV_halleyc
+ *:2610.18, GD, Add neu
+ *:2610.18, GD, Add SOLV_auto, ftol, htol
+ *:2610.18, GD, Add memo
+ *:2610.18, GD, Add the OUT_ output masks, and mask, ncol, ocol
+ *:2610.18, GD, Add nlong: lines and records too long are counted
+ ********1*********2*********3*********4*********5*********6*********7*********/
+
+#ifndef xyzbat_h
+#define xyzbat_h
+
+#include <stdio.h>
+#include "colio.h"
+#include "ellips.h"
+#include "topo.h"
+#include "plhmemo.h"
+
+#define MAX_chunk       ((int)4096)
+#define MAX_line        ((int)256)
+#define MAX_outrec      ((int)96)
+
+#define SOLV_borkowski  ((int)0)
+#define SOLV_trilat     ((int)1)
+#define SOLV_halley     ((int)2)
+#define SOLV_halleyc    ((int)3)
+#define SOLV_auto       ((int)4)
+
+#define OUT_lat         ((int)1)
+#define OUT_lon         ((int)2)
+#define OUT_hgt         ((int)4)
+#define OUT_plh         ((int)7)
+#define OUT_x           ((int)1)
+#define OUT_y           ((int)2)
+#define OUT_z           ((int)4)
+#define OUT_r           ((int)8)
+#define OUT_xyz         ((int)7)
+
+struct xyz_chunk {
+        long   first;
+        int    nline;
+        char  *text;
+        long   ntext;
+        char   raw[MAX_line*MAX_chunk+1];
+        int    n;
+        int    nskip;
+        int    nlong;
+        double in[3][MAX_chunk];
+        double out[4][MAX_chunk];
+        char   txt[MAX_outrec*MAX_chunk];
+        long   ntxt;
+};
+
+struct xyz_job {
+        int    mode;
+        int    display;
+        int    west;
+        struct ellipsoid *ell;
+        int    solver;
+        double ftol;
+        double htol;
+        struct neu_station *neu;
+        struct plh_memo *memo;
+        int    mask;
+        int    ncol;
+        int    ocol[4];
+        struct col_head *colin;
+        struct col_head *colout;
+        long   nread;
+        long   nskip;
+        long   nlong;
+};
+
+struct xyz_map {
+        char  *base;
+        long   size;
+        long   pos;
+};
+
+void cvtchunk( struct xyz_job *, struct xyz_chunk * );
+int cvtfile( FILE *, FILE *, struct xyz_job *, int );
+int getchunk( FILE *, struct xyz_chunk *, long * );
+int mapchunk( struct xyz_map *, struct xyz_chunk *, long * );
+void mapclose( struct xyz_map * );
+int mapopen( FILE *, struct xyz_map * );
+long nlscan( char *, long, int, int * );
+void parsechunk( struct xyz_job *, struct xyz_chunk * );
+int putchunk( FILE *, struct xyz_chunk * );
+
+#endif /* xyzbat_h */
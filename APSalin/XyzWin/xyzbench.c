@@ -0,0 +1,881 @@
+/* @(#)xyzbench.c       1.0  26/10/18 */
+static char *sccsid= "@(#)xyzbench.c    1.0  26/10/18";
+
+/********1*********2*********3*********4*********5*********6*********7*********
+ * name:            xyzbench
+ * version:         2610.18
+ * written by:      geoData
+ * purpose:         times the geodetic conversion routines and measures
+ *                  their accuracy on the 4277 point grid and on random
+ *                  point sets
+ *
+ * input parameters
+ * -----------------------------
+ *
+ * output parameters
+ * -----------------------------
+ * one line per method and point set:
+ *   ns/pt          wall time per point, best of -r runs [ns]
+ *   Mpt/s          points per second [1e6/s]
+ *   tsc/pt         time stamp counter ticks per point; the TSC runs at
+ *                  a fixed rate, so this is cycles at the nominal clock
+ *   max, rms       position error of the result against the set's
+ *                  reference [m]; lat, lon differences are taken as
+ *                  arcs at A + h
+ *   bad            points with a non-finite result
+ * with -a, followed by the mean, histogram and largest errors of each
+ * (see esreport).
+ *
+ * with -v, one line per method and random set for a validation sweep:
+ *   n              points converted
+ *   ns/pt          wall time per point of the sweep, drawing the points
+ *                  and making their X, Y, Z included [ns]
+ *   max, rms, bad  as above; with -d against the double-double
+ *                  conversion of the drawn points
+ *
+ * local variables and constants
+ * -----------------------------
+ * aflg             = 1 = print the full error statistics
+ * c                command-line option
+ * custom           ellipsoid given as A,FL with -e
+ * dflg             = 1 = validation sweeps against xyz2plhddv, plh2xyzddv
+ * ell              ellipsoid of every set
+ * errflg           command-line error/usage print flag
+ * grid             directory holding XYZ.txt and fi_lam_h(4277).txt
+ * i                loop counter
+ * j                loop counter
+ * mname            run only methods whose name contains mname
+ * nsweep           number of points of each validation sweep; 0 = none
+ * nthr             number of threads of a validation sweep
+ * npts             number of points of each random set
+ * nrep             number of timing runs; the best is reported
+ * out[]            output coordinates of the run
+ * pgm              program name
+ * ptr              scratch string pointer
+ * seed             seed of the random sets
+ * set[]            point sets
+ * sname            run only sets whose name contains sname
+ * tmin             minimum duration of one timing run [s]
+ * vrsn             program version ID
+ *
+ * comments:
+ * -----------------------------
+ * Sets:
+ *   grid4277       geo_4277_Points; the reference is fi_lam_h(4277).txt
+ *                  for lat, lon, hgt and XYZ.txt for X, Y, Z
+ *   surface        h uniform in [-500, 9000] m
+ *   leo            h uniform in [200, 2000] km
+ *   geo            h uniform in [35286, 36286] km
+ *   deep           h uniform in [-6000, -100] km
+ * The random sets have latitude uniform in sin(lat) (uniform over the
+ * surface) and longitude uniform in [0, 360) deg.  Their X, Y, Z are
+ * made by plh2xyze, which is then also the reference of the X, Y, Z
+ * methods; lat, lon, hgt methods are measured against the lat, lon,
+ * hgt the set was drawn from.
+ *
+ * XYZ.txt of the grid was made on WGS84 (plh2xyz on WGS84 reproduces
+ * it to 1.6e-6 m, on GRS80 only to 1.2e-4 m), so WGS84 is the default
+ * ellipsoid.
+ *
+ * Every method converts a whole set per call, through a batch entry
+ * point or a loop over the single point routine, so the times include
+ * the loop but not any I/O.
+ *
+ * A validation sweep (-v) draws its points MAX_sweep at a time, as the
+ * random sets but from a generator seeded by the seed and the chunk
+ * number, and with X, Y, Z by plh2xyzv rather than plh2xyze (so
+ * plh2xyzv is its own reference there); converts them and adds their
+ * errors to an ESDS (errstat.h) of the thread.  The ESDS of the
+ * threads are merged at the end, so the statistics of any number of
+ * points take no memory beyond the chunks, and are the same for any
+ * number of threads.  The point numbers of the largest errors count
+ * from 1 in drawing order.
+ *
+ * With -d the reference of a sweep is instead the double-double
+ * conversion of its input (xyz2plhddv for lat, lon, hgt methods,
+ * plh2xyzddv for X, Y, Z ones), leading and trailing parts, so the
+ * errors are those of the method alone and not of plh2xyzv or of the
+ * 15 digit pi of physcon.h; the time then includes the reference.
+ *
+ * Example:
+ *   make bench
+ *   xyzbench -m xyz2plh -s grid -r 5
+ *   xyzbench -m xyz2plhhv -v 100000000 -a
+ *   xyzbench -m xyz2plhv -v 10000000 -d
+ *
+ ********1*********2*********3*********4*********5*********6*********7*********
+ *:modification history
+ *:2610.18, GD,  Creation
+ *:2610.18, GD,  Add xyz2plhtv, the trilateration algorithm
+ *:2610.18, GD,  Add xyz2plhh, xyz2plhhv, xyz2plhhcv (Halley)
+ *:2610.18, GD,  Errors kept in an ESDS; add -a, and -v validation sweeps
+ *:2610.18, GD,  Add xyz2plhddv, plh2xyzddv and -d, sweeps against them
+ ********1*********2*********3*********4*********5*********6*********7********/
+
+/*
+ *  include files
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include "physcon.h"
+#include "libgpsC.h"
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <x86intrin.h>
+#define ticks()         ((double)__rdtsc())
+#else
+#define ticks()         ((double)0.0)
+#endif
+
+/*
+ *  function prototypes
+ */
+
+struct bench_set;
+struct bench_sweep;
+typedef void (*bench_fn)( int, double *, double *, double *,
+                          double *, double *, double *, struct ellipsoid * );
+
+static void m_plh2xyz( int, double *, double *, double *,
+                       double *, double *, double *, struct ellipsoid * );
+static void m_plh2xyzddv( int, double *, double *, double *,
+                          double *, double *, double *, struct ellipsoid * );
+static void m_plh2xyzs( int, double *, double *, double *,
+                        double *, double *, double *, struct ellipsoid * );
+static void m_xyz2plh( int, double *, double *, double *,
+                       double *, double *, double *, struct ellipsoid * );
+static void m_xyz2plhddv( int, double *, double *, double *,
+                          double *, double *, double *, struct ellipsoid * );
+static void m_xyz2plhe( int, double *, double *, double *,
+                        double *, double *, double *, struct ellipsoid * );
+static void m_xyz2plhh( int, double *, double *, double *,
+                        double *, double *, double *, struct ellipsoid * );
+static void m_xyz2plhs( int, double *, double *, double *,
+                        double *, double *, double *, struct ellipsoid * );
+static int getgrid( char *, char *, int, double ** );
+static void mkset( struct bench_set *, int, double, double,
+                   struct ellipsoid * );
+static double now( void );
+static inline double pterr( int, double **, double **, double **, int,
+                            struct ellipsoid * );
+static void *sweeper( void * );
+static double urand( unsigned long long * );
+
+/*
+ *  global definitions and variables
+ *
+ *  bench_method    a routine under test: name, direction (0 = X, Y, Z
+ *                  -> lat, lon, hgt; 1 = the reverse) and batch form
+ *  bench_set       a point set: name, size, lat, lon, hgt and X, Y, Z
+ *  bench_band      height range of a random set [m]
+ *  bench_sweep     a validation sweep: method, height range, size,
+ *                  reference (0 = the drawn points, 1 = double-double),
+ *                  next chunk to draw, and the merged error statistics
+ *
+ *  MAX_sweep       number of points a sweep draws and converts at once
+ */
+
+#define MAX_grid        ((int)5000)
+#define MAX_sweep       ((int)65536)
+
+struct bench_method {
+        char    *name;
+        int      dir;
+        bench_fn fn;
+};
+
+struct bench_set {
+        char    *name;
+        int      n;
+        double  *plh[3];
+        double  *xyz[3];
+};
+
+struct bench_band {
+        char    *name;
+        double   hlo;
+        double   hhi;
+};
+
+struct bench_sweep {
+        struct bench_method *m;
+        struct bench_band *b;
+        struct ellipsoid *ell;
+        unsigned long seed;
+        long     n;
+        int      dd;
+        long     next;
+        pthread_mutex_t lock;
+        ESDS     es;
+};
+
+static struct bench_method methods[]= {
+        { "xyz2plh",       0, m_xyz2plh  },
+        { "xyz2plhe",      0, m_xyz2plhe },
+        { "xyz2plhs",      0, m_xyz2plhs },
+        { "xyz2plhv",      0, xyz2plhv   },
+        { "xyz2plhtv",     0, xyz2plhtv  },
+        { "xyz2plhh",      0, m_xyz2plhh },
+        { "xyz2plhhv",     0, xyz2plhhv  },
+        { "xyz2plhhcv",    0, xyz2plhhcv },
+        { "xyz2plhddv",    0, m_xyz2plhddv },
+        { "plh2xyz",       1, m_plh2xyz  },
+        { "plh2xyzs",      1, m_plh2xyzs },
+        { "plh2xyzv",      1, plh2xyzv   },
+        { "plh2xyzddv",    1, m_plh2xyzddv }
+};
+
+static struct bench_band bands[]= {
+        { "surface",      -500.0,     9000.0 },
+        { "leo",         200.0e3,   2000.0e3 },
+        { "geo",       35286.0e3,  36286.0e3 },
+        { "deep",      -6000.0e3,   -100.0e3 }
+};
+
+#define MAX_method      ((int)(sizeof(methods)/sizeof(methods[0])))
+#define MAX_band        ((int)(sizeof(bands)/sizeof(bands[0])))
+#define MAX_set         ((int)(MAX_band + 1))
+
+static unsigned long long rstate;
+
+
+
+int main( int argc, char *argv[] )
+{
+  char *grid= "../../geo_4277_Points";
+  char *mname= "";
+  char *pgm;
+  char *ptr;
+  char *sname= "";
+  char *vrsn= "1.0 26/10/18";
+  double best;
+  double t0;
+  double t1;
+  double tk;
+  double tmin= 0.2;
+  double tsc;
+  double *in[3];
+  double *out[3];
+  double *ref[3];
+  int aflg= 0;
+  int c;
+  int dflg= 0;
+  int errflg= 0;
+  int i;
+  int j;
+  int k;
+  int npts= 100000;
+  int nrep= 3;
+  int nset= 0;
+  int nthr= 0;
+  int rep;
+  long ncall;
+  long nsweep= 0;
+  unsigned long seed= 1;
+  pthread_t *tid;
+  struct bench_set set[MAX_set];
+  struct bench_sweep sw;
+  struct ellipsoid custom;
+  struct ellipsoid *ell= NULL;
+  ESDS es;
+
+  extern char *optarg;
+  extern int optind;
+  extern int optopt;
+
+/*
+ *   1.0  Parse command line
+ */
+
+  pgm= argv[0];
+  while( (ptr= strpbrk( pgm, "/\\:" )) != NULL )
+    pgm= ptr+1;
+
+  while( (c= getopt(argc, argv, ":ade:g:hj:m:n:r:s:t:v:x:")) != -1 )
+    switch( c ) {
+    case 'a':
+      aflg= 1;
+      break;
+    case 'd':
+      dflg= 1;
+      break;
+    case 'e':
+      if( (ell= ellparse( optarg, &custom )) == NULL ) {
+        fprintf(stderr, "%s ERROR: Unknown ellipsoid \"%s\"\n", pgm, optarg);
+        errflg++;
+      }
+      break;
+    case 'g':
+      grid= optarg;
+      break;
+    case 'h':
+      errflg= 1;
+      break;
+    case 'j':
+      nthr= atoi( optarg );
+      break;
+    case 'm':
+      mname= optarg;
+      break;
+    case 'n':
+      npts= atoi( optarg );
+      break;
+    case 'r':
+      nrep= atoi( optarg );
+      break;
+    case 's':
+      sname= optarg;
+      break;
+    case 't':
+      tmin= numscan( optarg, NULL );
+      break;
+    case 'v':
+      nsweep= strtol( optarg, NULL, 10 );
+      break;
+    case 'x':
+      seed= strtoul( optarg, NULL, 10 );
+      break;
+    case '?':
+      fprintf(stderr, "%s ERROR: Unrecognized option \"%c\"\n",
+         pgm, optopt);
+      errflg++;
+      break;
+    case ':':
+      errflg++;
+      break;
+    }
+
+  if( errflg || optind != argc || npts < 1 || nrep < 1 || nsweep < 0 ) {
+    printf("%s(%s): Times the coordinate conversion routines\n",
+           pgm, vrsn);
+    printf("Usage: %s [options]\n", pgm );
+    printf("  options:\n");
+    printf("           -a prints the histogram and largest errors too.\n");
+    printf("           -d measures validation sweeps against the\n");
+    printf("              double-double conversion of their points.\n");
+    printf("           -e ellipsoid, by name or as A,FL (default WGS84).\n");
+    printf("           -g dir holding XYZ.txt and fi_lam_h(4277).txt\n");
+    printf("              (default %s).\n", grid);
+    printf("           -h prints this message.\n");
+    printf("           -j threads of a validation sweep (default: one\n");
+    printf("              per processor).\n");
+    printf("           -m runs only methods whose name contains this.\n");
+    printf("           -n points per random set (default %d).\n", npts);
+    printf("           -r timing runs, best reported (default %d).\n", nrep);
+    printf("           -s runs only sets whose name contains this.\n");
+    printf("           -t minimum seconds per timing run (default %.1f).\n",
+           tmin);
+    printf("           -v points of a validation sweep of each random\n");
+    printf("              set, instead of timing the sets.\n");
+    printf("           -x seed of the random sets (default %lu).\n", seed);
+    exit(1);
+  }
+
+  if( ell == NULL )
+    ell= ellfind( "WGS84" );
+
+/*
+ *   2.0  Validation sweeps, instead of the timing: nthr threads each
+ *        with its own ESDS, merged by sweeper
+ */
+
+  if( nsweep > 0 ) {
+    if( nthr <= 0 )
+      nthr= (int)sysconf( _SC_NPROCESSORS_ONLN );
+    if( nthr < 1 )
+      nthr= 1;
+    if( (tid= malloc( nthr*sizeof(pthread_t) )) == NULL ) {
+      fprintf(stderr, "%s ERROR: Out of memory\n", pgm);
+      exit(1);
+    }
+    pthread_mutex_init( &sw.lock, NULL );
+    sw.ell= ell;
+    sw.seed= seed;
+    sw.n= nsweep;
+    sw.dd= dflg;
+
+    printf("simd level %d, ellipsoid %s, %d threads%s\n", simd_level(),
+           ell->name, nthr, dflg ? ", double-double reference" : "");
+    printf("%-12s %-9s %11s %8s %10s %10s %8s\n", "method", "set",
+           "n", "ns/pt", "max[m]", "rms[m]", "bad");
+    for( i= 0; i < MAX_method; i++ ) {
+      if( strstr( methods[i].name, mname ) == NULL )
+        continue;
+      for( j= 0; j < MAX_band; j++ ) {
+        if( strstr( bands[j].name, sname ) == NULL )
+          continue;
+        sw.m= &methods[i];
+        sw.b= &bands[j];
+        sw.next= 0;
+        esinit( &sw.es );
+        t0= now();
+        for( k= 0; k < nthr; k++ )
+          if( pthread_create( &tid[k], NULL, sweeper, &sw ) != 0 ) {
+            fprintf(stderr, "%s ERROR: Cannot start thread\n", pgm);
+            exit(1);
+          }
+        for( k= 0; k < nthr; k++ )
+          pthread_join( tid[k], NULL );
+        t1= ( now() - t0 ) / nsweep;
+        printf("%-12s %-9s %11ld %8.1f %10.3e %10.3e %8ld\n",
+               methods[i].name, bands[j].name, nsweep, t1*1.0e9,
+               sw.es.MaxAbs, sw.es.Count > 0
+                 ? sqrt( sw.es.SumErr2/sw.es.Count ) : 0.0,
+               sw.es.NonFinite);
+        if( aflg )
+          esreport( stdout, &sw.es, "m" );
+        fflush( stdout );
+      }
+    }
+    exit(0);
+  }
+
+/*
+ *   3.0  Build the point sets
+ */
+
+  rstate= seed * 0x9E3779B97F4A7C15ULL + 1;
+
+  set[nset].name= "grid4277";
+  for( i= 0; i < 3; i++ ) {
+    set[nset].plh[i]= malloc( MAX_grid*sizeof(double) );
+    set[nset].xyz[i]= malloc( MAX_grid*sizeof(double) );
+  }
+  set[nset].n= getgrid( grid, "fi_lam_h(4277).txt", MAX_grid, set[nset].plh );
+  if( set[nset].n <= 0
+      || getgrid( grid, "XYZ.txt", MAX_grid, set[nset].xyz ) != set[nset].n )
+    fprintf(stderr, "%s: no 4277 point grid in \"%s\"; skipped\n",
+            pgm, grid);
+  else
+    nset++;
+
+  for( j= 0; j < MAX_band; j++ ) {
+    set[nset].name= bands[j].name;
+    mkset( &set[nset++], npts, bands[j].hlo, bands[j].hhi, ell );
+  }
+
+  for( i= 0; i < 3; i++ )
+    if( (out[i]= malloc( (npts > MAX_grid ? npts : MAX_grid)
+                         * sizeof(double) )) == NULL ) {
+      fprintf(stderr, "%s ERROR: Out of memory\n", pgm);
+      exit(1);
+    }
+
+/*
+ *   4.0  Time every method on every set; best of nrep runs, each
+ *        at least tmin seconds
+ */
+
+  printf("simd level %d, ellipsoid %s\n", simd_level(), ell->name);
+  printf("%-12s %-9s %7s %8s %8s %9s %10s %10s %5s\n", "method", "set",
+         "n", "ns/pt", "Mpt/s", "tsc/pt", "max[m]", "rms[m]", "bad");
+
+  for( i= 0; i < MAX_method; i++ ) {
+    if( strstr( methods[i].name, mname ) == NULL )
+      continue;
+    for( j= 0; j < nset; j++ ) {
+      if( strstr( set[j].name, sname ) == NULL )
+        continue;
+      for( k= 0; k < 3; k++ ) {
+        in[k]= methods[i].dir == 0 ? set[j].xyz[k] : set[j].plh[k];
+        ref[k]= methods[i].dir == 0 ? set[j].plh[k] : set[j].xyz[k];
+      }
+
+      best= 0.0;
+      tsc= 0.0;
+      for( rep= 0; rep < nrep; rep++ ) {
+        ncall= 0;
+        t0= now();
+        tk= ticks();
+        do {
+          methods[i].fn( set[j].n, in[0], in[1], in[2],
+                         out[0], out[1], out[2], ell );
+          ncall++;
+        } while( (t1= now()) - t0 < tmin );
+        tk= ( ticks() - tk ) / ( (double)ncall*set[j].n );
+        t1= ( t1 - t0 ) / ( (double)ncall*set[j].n );
+        if( rep == 0 || t1 < best ) {
+          best= t1;
+          tsc= tk;
+        }
+      }
+
+/*
+ *        Position error against the reference
+ */
+
+      esinit( &es );
+      for( k= 0; k < set[j].n; k++ )
+        esadd( &es, pterr( methods[i].dir, out, ref, NULL, k, ell ), k+1 );
+      printf("%-12s %-9s %7d %8.1f %8.3f %9.0f %10.3e %10.3e %5ld\n",
+             methods[i].name, set[j].name, set[j].n, best*1.0e9,
+             1.0e-6/best, tsc, es.MaxAbs,
+             es.Count > 0 ? sqrt( es.SumErr2/es.Count ) : 0.0,
+             es.NonFinite);
+      if( aflg )
+        esreport( stdout, &es, "m" );
+      fflush( stdout );
+    }
+  }
+
+  exit(0);
+}
+
+
+static int getgrid( char *dir, char *file, int max, double **v )
+/********1*********2*********3*********4*********5*********6*********7*********
+ * purpose:         reads the first three values of each line of
+ *                  dir/file into v[0..2]; lines that do not start with
+ *                  a number are skipped.  Returns the number of lines
+ *                  read, -1 if the file cannot be opened.
+ ********1*********2*********3*********4*********5*********6*********7*********/
+{
+        char line[512];
+        char *end;
+        char *ptr;
+        int k;
+        int n= 0;
+        FILE *fp;
+
+        snprintf( line, sizeof(line), "%s/%s", dir, file );
+        if( (fp= fopen( line, "r" )) == NULL )
+                return( -1 );
+
+        while( n < max && fgets( line, sizeof(line), fp ) != NULL ) {
+                for( k= 0, ptr= line; k < 3; k++ ) {
+                        while( *ptr == ' ' || *ptr == '\t' || *ptr == ',' )
+                                ptr++;
+                        v[k][n]= numscan( ptr, &end );
+                        if( end == ptr )
+                                break;
+                        ptr= end;
+                }
+                if( k == 3 )
+                        n++;
+        }
+        fclose( fp );
+
+        return( n );
+}
+
+
+static void mkset( struct bench_set *set, int n, double hlo, double hhi,
+                   struct ellipsoid *ell )
+/********1*********2*********3*********4*********5*********6*********7*********
+ * purpose:         draws n random points with heights in [hlo, hhi] [m]
+ *                  and makes their X, Y, Z with plh2xyze
+ ********1*********2*********3*********4*********5*********6*********7*********/
+{
+        double plh[3];
+        double xyz[3];
+        int i;
+        int k;
+
+        set->n= n;
+        for( k= 0; k < 3; k++ ) {
+                set->plh[k]= malloc( n*sizeof(double) );
+                set->xyz[k]= malloc( n*sizeof(double) );
+                if( set->plh[k] == NULL || set->xyz[k] == NULL ) {
+                        fprintf(stderr, "xyzbench ERROR: Out of memory\n");
+                        exit(1);
+                }
+        }
+
+        for( i= 0; i < n; i++ ) {
+                plh[0]= rad_to_deg * asin( TWO*urand( &rstate ) - ONE );
+                plh[1]= 360.0 * urand( &rstate );
+                plh[2]= hlo + (hhi - hlo) * urand( &rstate );
+                plh2xyze( plh, xyz, ell );
+                for( k= 0; k < 3; k++ ) {
+                        set->plh[k][i]= plh[k];
+                        set->xyz[k][i]= xyz[k];
+                }
+        }
+}
+
+
+static double urand( unsigned long long *st )
+/********1*********2*********3*********4*********5*********6*********7*********
+ * purpose:         uniform random number in [0, 1) from state *st,
+ *                  xorshift64*; the sets are the same for the same seed
+ *                  on any machine
+ ********1*********2*********3*********4*********5*********6*********7*********/
+{
+        *st^= *st >> 12;
+        *st^= *st << 25;
+        *st^= *st >> 27;
+
+        return( (double)((*st * 0x2545F4914F6CDD1DULL) >> 11)
+                * (ONE / 9007199254740992.0) );
+}
+
+
+static inline double pterr( int dir, double **out, double **ref,
+                            double **lo, int k, struct ellipsoid *ell )
+/********1*********2*********3*********4*********5*********6*********7*********
+ * purpose:         position error of point k of out against ref [m];
+ *                  for lat, lon, hgt (dir 0) the angles are taken as
+ *                  arcs at A + h.  NaN if the result is not finite.
+ *                  lo, if not NULL, holds trailing parts of ref.
+ ********1*********2*********3*********4*********5*********6*********7*********/
+{
+        double d[3];
+        double r;
+
+        if( !isfinite( out[0][k] ) || !isfinite( out[1][k] )
+            || !isfinite( out[2][k] ) )
+                return( NAN );
+        d[0]= out[0][k] - ref[0][k];
+        d[1]= out[1][k] - ref[1][k];
+        d[2]= out[2][k] - ref[2][k];
+        if( lo != NULL ) {
+                d[0]-= lo[0][k];
+                d[1]-= lo[1][k];
+                d[2]-= lo[2][k];
+        }
+        if( dir == 0 ) {
+                d[1]= fmod( d[1] + 540.0, 360.0 ) - 180.0;
+                r= ( ell->A + ref[2][k] ) * deg_to_rad;
+                d[0]*= r;
+                d[1]*= r * cos( deg_to_rad * ref[0][k] );
+        }
+
+        return( sqrt( d[0]*d[0] + d[1]*d[1] + d[2]*d[2] ) );
+}
+
+
+static void *sweeper( void *arg )
+/********1*********2*********3*********4*********5*********6*********7*********
+ * purpose:         one thread of a validation sweep: takes the next
+ *                  chunk of the sweep, draws its points from a state
+ *                  seeded by the seed and the chunk number, converts
+ *                  them and adds their errors to its own ESDS, which is
+ *                  merged into the sweep's when no chunk is left.  With
+ *                  sw->dd the reference replaces the drawn points it
+ *                  was made from.
+ ********1*********2*********3*********4*********5*********6*********7*********/
+{
+        struct bench_sweep *sw= arg;
+        double *e;
+        double *in[3];
+        double *lo[3];
+        double *out[3];
+        double *plh[3];
+        double *ref[3];
+        double *xyz[3];
+        double *v;
+        long c;
+        unsigned long long st;
+        int dir= sw->m->dir;
+        int i;
+        int k;
+        int n;
+        ESDS es;
+
+        if( (v= malloc( 13*MAX_sweep*sizeof(double) )) == NULL ) {
+                fprintf(stderr, "xyzbench ERROR: Out of memory\n");
+                exit(1);
+        }
+        for( k= 0; k < 3; k++ ) {
+                plh[k]= v + k*MAX_sweep;
+                xyz[k]= v + (3 + k)*MAX_sweep;
+                out[k]= v + (6 + k)*MAX_sweep;
+                lo[k]= v + (10 + k)*MAX_sweep;
+        }
+        e= v + 9*MAX_sweep;
+        esinit( &es );
+
+        for( ;; ) {
+                pthread_mutex_lock( &sw->lock );
+                c= sw->next++;
+                pthread_mutex_unlock( &sw->lock );
+                if( c*MAX_sweep >= sw->n )
+                        break;
+                n= sw->n - c*MAX_sweep < MAX_sweep ? (int)(sw->n - c*MAX_sweep)
+                                                   : MAX_sweep;
+
+                st= ( sw->seed * 0x9E3779B97F4A7C15ULL + 1 )
+                    ^ ( (unsigned long long)(c + 1) * 0xBF58476D1CE4E5B9ULL );
+                for( i= 0; i < n; i++ ) {
+                        plh[0][i]= rad_to_deg * asin( TWO*urand( &st ) - ONE );
+                        plh[1][i]= 360.0 * urand( &st );
+                        plh[2][i]= sw->b->hlo + (sw->b->hhi - sw->b->hlo)
+                                                * urand( &st );
+                }
+                plh2xyzv( n, plh[0], plh[1], plh[2], xyz[0], xyz[1], xyz[2],
+                          sw->ell );
+                for( k= 0; k < 3; k++ ) {
+                        in[k]= dir == 0 ? xyz[k] : plh[k];
+                        ref[k]= dir == 0 ? plh[k] : xyz[k];
+                }
+                if( sw->dd && dir == 0 )
+                        xyz2plhddv( n, xyz[0], xyz[1], xyz[2], plh[0], plh[1],
+                                    plh[2], lo[0], lo[1], lo[2], sw->ell );
+                else if( sw->dd )
+                        plh2xyzddv( n, plh[0], plh[1], plh[2], xyz[0], xyz[1],
+                                    xyz[2], lo[0], lo[1], lo[2], sw->ell );
+
+                sw->m->fn( n, in[0], in[1], in[2], out[0], out[1], out[2],
+                           sw->ell );
+                for( i= 0; i < n; i++ )
+                        e[i]= pterr( dir, out, ref, sw->dd ? lo : NULL, i,
+                                     sw->ell );
+                esaddv( &es, n, e, c*MAX_sweep + 1 );
+        }
+
+        pthread_mutex_lock( &sw->lock );
+        esmerge( &sw->es, &es );
+        pthread_mutex_unlock( &sw->lock );
+        free( v );
+
+        return( NULL );
+}
+
+
+static double now( void )
+/********1*********2*********3*********4*********5*********6*********7*********
+ * purpose:         monotonic wall clock [s]
+ ********1*********2*********3*********4*********5*********6*********7*********/
+{
+        struct timespec ts;
+
+        clock_gettime( CLOCK_MONOTONIC, &ts );
+
+        return( (double)ts.tv_sec + 1.0e-9*ts.tv_nsec );
+}
+
+
+/*
+ *  Single point routines as batch methods
+ */
+
+static void m_xyz2plh( int n, double *x, double *y, double *z,
+                       double *lat, double *lon, double *hgt,
+                       struct ellipsoid *ell )
+{
+        double plh[3];
+        double xyz[3];
+        int i;
+
+        for( i= 0; i < n; i++ ) {
+                xyz[0]= x[i];
+                xyz[1]= y[i];
+                xyz[2]= z[i];
+                xyz2plh( xyz, plh, ell->A, ell->FL );
+                lat[i]= plh[0];
+                lon[i]= plh[1];
+                hgt[i]= plh[2];
+        }
+}
+
+
+static void m_xyz2plhe( int n, double *x, double *y, double *z,
+                        double *lat, double *lon, double *hgt,
+                        struct ellipsoid *ell )
+{
+        double plh[3];
+        double xyz[3];
+        int i;
+
+        for( i= 0; i < n; i++ ) {
+                xyz[0]= x[i];
+                xyz[1]= y[i];
+                xyz[2]= z[i];
+                xyz2plhe( xyz, plh, ell );
+                lat[i]= plh[0];
+                lon[i]= plh[1];
+                hgt[i]= plh[2];
+        }
+}
+
+
+static void m_xyz2plhh( int n, double *x, double *y, double *z,
+                        double *lat, double *lon, double *hgt,
+                        struct ellipsoid *ell )
+{
+        double plh[3];
+        double xyz[3];
+        int i;
+
+        for( i= 0; i < n; i++ ) {
+                xyz[0]= x[i];
+                xyz[1]= y[i];
+                xyz[2]= z[i];
+                xyz2plhh( xyz, plh, ell );
+                lat[i]= plh[0];
+                lon[i]= plh[1];
+                hgt[i]= plh[2];
+        }
+}
+
+
+static void m_xyz2plhddv( int n, double *x, double *y, double *z,
+                          double *lat, double *lon, double *hgt,
+                          struct ellipsoid *ell )
+{
+        xyz2plhddv( n, x, y, z, lat, lon, hgt, NULL, NULL, NULL, ell );
+}
+
+
+static void m_xyz2plhs( int n, double *x, double *y, double *z,
+                        double *lat, double *lon, double *hgt,
+                        struct ellipsoid *ell )
+{
+        if( xyz2plhs( n, x, y, z, lat, lon, hgt, ell ) != 0 )
+                m_xyz2plhe( n, x, y, z, lat, lon, hgt, ell );
+}
+
+
+static void m_plh2xyz( int n, double *lat, double *lon, double *hgt,
+                       double *x, double *y, double *z,
+                       struct ellipsoid *ell )
+{
+        double plh[3];
+        double xyz[3];
+        int i;
+
+        for( i= 0; i < n; i++ ) {
+                plh[0]= lat[i];
+                plh[1]= lon[i];
+                plh[2]= hgt[i];
+                plh2xyz( plh, xyz, ell->A, ell->FL );
+                x[i]= xyz[0];
+                y[i]= xyz[1];
+                z[i]= xyz[2];
+        }
+}
+
+
+static void m_plh2xyzddv( int n, double *lat, double *lon, double *hgt,
+                          double *x, double *y, double *z,
+                          struct ellipsoid *ell )
+{
+        plh2xyzddv( n, lat, lon, hgt, x, y, z, NULL, NULL, NULL, ell );
+}
+
+
+static void m_plh2xyzs( int n, double *lat, double *lon, double *hgt,
+                        double *x, double *y, double *z,
+                        struct ellipsoid *ell )
+{
+        double plh[3];
+        double xyz[3];
+        int i;
+
+        if( plh2xyzs( n, lat, lon, hgt, x, y, z, ell ) == 0 )
+                return;
+        for( i= 0; i < n; i++ ) {
+                plh[0]= lat[i];
+                plh[1]= lon[i];
+                plh[2]= hgt[i];
+                plh2xyze( plh, xyz, ell );
+                x[i]= xyz[0];
+                y[i]= xyz[1];
+                z[i]= xyz[2];
+        }
+}
@@ -0,0 +1,1849 @@
+/* @(#)xyzcheck.c       1.0  26/10/18 */
+static char *sccsid= "@(#)xyzcheck.c    1.0  26/10/18";
+
+/********1*********2*********3*********4*********5*********6*********7*********
+ * name:            xyzcheck
+ * version:         2610.18
+ * written by:      geoData
+ * purpose:         accuracy regression check of the X, Y, Z -> lat, lon,
+ *                  hgt routines on the 4277 point grid, against stored
+ *                  baselines
+ *
+ * input parameters
+ * -----------------------------
+ * fi_lam_h(4277).txt of the grid directory, and for each method
+ * baseline/<method>.txt, as written by -w.
+ *
+ * output parameters
+ * -----------------------------
+ * one line per method:
+ *   max, rms       latitude error [1e6*arcsec] and height error [nm]
+ *                  of the round trip
+ *   worse          points whose error exceeds the baseline by more than
+ *                  the tolerance, or that are not finite
+ *   status         PASS, FAIL, or SKIP for a kernel this processor or
+ *                  ellipsoid cannot run
+ * followed by the first few points that are worse.  The exit status is
+ * 1 if any method fails, else 0.
+ *
+ * local variables and constants
+ * -----------------------------
+ * base[]           baseline latitude and height errors of the method
+ * c                command-line option
+ * custom           ellipsoid given as A,FL with -e
+ * ell              ellipsoid of the run
+ * err[]            latitude and height errors of the method
+ * errflg           command-line error/usage print flag
+ * ftol             latitude tolerance [1e6*arcsec]
+ * grid             directory holding fi_lam_h(4277).txt
+ * htol             height tolerance [nm], to which hulp ulp of the
+ *                  height are added
+ * hulp             height tolerance in units in the last place of h
+ * mname            check only methods whose name contains mname
+ * nfail            number of methods failed
+ * plh[]            grid lat, lon, hgt
+ * wflg             = 1 = write the baselines rather than check them
+ * xyz[]            grid X, Y, Z, by plh2xyze
+ *
+ * comments:
+ * -----------------------------
+ * Each point of the grid goes through plh2xyze to X, Y, Z, then through
+ * the method back to lat, lon, hgt.  The errors are those of the files
+ * of the original programs: fi error in 1e6*arcsec (micro arc seconds)
+ * and h error in nm, computed - original.
+ *
+ * A point passes when
+ *   |dfi| <= |dfi(baseline)| + ftol
+ *   |dh|  <= |dh(baseline)|  + htol + hulp*ulp(max(|h|, A))
+ * (|baseline| is taken times BASE_rnd, for the 7 digits it is stored
+ * to) so a change that only moves the rounding (FMA, a reordered sum, a
+ * vector kernel) is accepted and one that loses accuracy anywhere on
+ * the grid is not.  The default ftol, 1e-2 1e6*arcsec, is 3e-7 m on
+ * the ground; it has to allow for xyz2plh near the poles, whose latitude
+ * moves by 3e-3 1e6*arcsec when compiled with FMA.
+ *
+ * The vector kernels are checked directly (xyz2plhv_avx2,
+ * xyz2plhhv_avx2) rather than through their dispatchers, so that the
+ * baseline of each does not depend on the processor.  The grid was
+ * made on WGS84 and so were the baselines in baseline/; with -e another
+ * ellipsoid, give -b a directory of baselines written for it.
+ *
+ * The grid does not reach the core about the centre, which xyz2plhe
+ * and the batch routines take to xyz2plhn.  Points on and near the Z
+ * axis there, axis_pt[], inside the evolute (|z| < c/B) and between
+ * c/B and 2*c/B, are checked against the limit r -> 0 instead: the
+ * normal of a point r from the axis meets it near the centre of
+ * curvature of the pole, -c/B, so
+ *   90 - |Phi| = r/(|z| + c/B) [rad],  h = |z| - B
+ * to O(r^2), below rounding at r = 1e-4 m.  The tolerances are those
+ * of the grid without a baseline.
+ *
+ * The sliding window fit of lrwin.c is checked in both modes: LRW_n
+ * pairs of an MJD-like x go through a window of LRW_win, added and
+ * removed one at a time, and after each step lrwfit must agree with
+ * a direct two-pass least-squares fit of the pairs in the window to
+ * LRW_rel in a, b and their standard deviations, and in chi-square
+ * relative to the sum of squares of y about its mean, from which it
+ * is a difference.
+ *
+ * The ocean loading grid store of oltgrid.c is checked on a small
+ * wrapping grid of two tides, one node undefined: oltintrpv at every
+ * node must give that node, NaN at the undefined one, and at the
+ * middle of every cell the mean of the in-phase and quadrature parts
+ * of its defined corners, to OLT_tol, from the store on the heap and
+ * from its file by oltwrite, oltopen.
+ *
+ * The mapped station information reader of siindex.c is checked on a
+ * small file of coordinates and antenna records made here, once in
+ * the byte order of the machine and once swapped: siopen must index
+ * every record, sifind must find the record valid at each of
+ * si_look[] (or none), and sigetC must give back every field written
+ * and refuse an antenna record.
+ *
+ * The batch seconds of degdms.c are checked against its formatter:
+ * for each of dms_ang[], degdmsv printed by "%*d %2d %*.*f" must read
+ * as dmsfmt, "-0" degrees included, at every prec from 0 to
+ * DMS_maxprec, and at precs outside it, where both clamp.
+ * The float routines xyz2plhfv and plh2xyzfv have no baseline but a
+ * bound (fltmath.h): with each grid point as origin, offsets of
+ * FLT_nrad sizes up to FLT_dmax in 26 directions go through xyz2plhfv,
+ * and their lat, lon, hgt offsets back through plh2xyzfv; a point
+ * passes when its error against xyz2plhhc, plh2xyze is within FLT_erel
+ * of the offset, plus FLT_floor for the double sum with the origin
+ * and the double routines themselves at 1e9 m.
+ *
+ * The masked routines xyz2plhov and plh2xyzov are checked against
+ * xyz2plhv (xyz2plhe at simd level 0) and plh2xyzv, with each mask
+ * and the arrays not in it NULL: lat, lon and X, Y, Z must be
+ * identical, and hgt and r within MASK_ulp ulp of max(|h|, A) and of
+ * hypot(X, Y).
+ *
+ * The dispatcher xyz2plhd is checked at each of dsp_ftol[] with a
+ * height tolerance of DSP_htol: every point it does not count as
+ * beyond the tolerances must be within them of xyz2plhdd.  Its grid
+ * is dsp_hgt[] by dsp_lat[], from the centre to 1e11 m and to 1e-9
+ * deg of the poles, and the points near the axis, dsp_r[] by dsp_z[]:
+ * the core about the centre, and the edge of the polar cap of
+ * xyz2plhv (BRK_rpol) out to 5e9 m.
+ *
+ * The memo of xyz2plhm.c is checked without and with lin, with cells
+ * of MEMO_q: each of memo_pt[] is looked up, looked up again, which
+ * must be a hit identical to xyz2plhe, and looked up offset by
+ * memo_d[] in the same cell, which must come back within q*sqrt(3)
+ * of the point, or with lin within 3e-3 q.  The point beyond the
+ * memo and the one near the Z axis (with lin) must be converted, and
+ * plhmstat must count every lookup.
+ *
+ * The column file blocks of colio.c are checked in the delta and XOR
+ * codecs: a block of COL_nrow rows packed by colpack must unpack to
+ * the same bits, and with each of col_bad[] as the header byte of an
+ * XOR value colunpack must refuse it rather than shift past 64 bits.
+ *
+ * The trilateration P0, P1, P2 and the Halley correction are also
+ * checked against the original programs' errors, Output/err_0.txt,
+ * err_1.txt, err_2.txt and Halley_Results.csv: the max and rms of
+ * each error may exceed those of the original by ftol and htol.
+ * P0 and P1 keep no baseline; they are checked against these alone.
+ *
+ * Example:
+ *   make check
+ *   xyzcheck -m xyz2plhh
+ *   xyzcheck -w                  (after an intended change of accuracy)
+ *
+ ********1*********2*********3*********4*********5*********6*********7*********
+ *:modification history
+ *:2610.18, GD,  Creation
+ *:2610.18, GD,  Check lrwfit against a direct fit, lrwcheck
+ *:2610.18, GD,  Check oltintrpv at nodes and midpoints, oltcheck
+ *:2610.18, GD,  Check siopen, sifind, sigetC in both byte orders, sicheck
+ *:2610.18, GD,  Check degdmsv against dmsfmt, dmscheck
+ *:2610.18, GD,  Check the core on and near the Z axis, axis_pt[]
+ *:2610.18, GD,  Check the float routines against their bound
+ *:2610.18, GD,  Check the masked routines against the full ones
+ *:2610.18, GD,  Check the unflagged results of xyz2plhd, dspcheck
+ *:2610.18, GD,  Check hits, near points and counts of xyz2plhm, memocheck
+ *:2610.18, GD,  Check the trilateration and Halley methods against the
+ *:               original errors, origcheck
+ *:2610.18, GD,  Check colunpack on good and corrupted blocks, colcheck
+ ********1*********2*********3*********4*********5*********6*********7********/
+
+/*
+ *  include files
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <stdint.h>
+#include <unistd.h>
+#include "physcon.h"
+#include "libgpsC.h"
+#include "linfit.h"
+#include "olt.h"
+#include "sidata.h"
+#include "fltmath.h"
+
+/*
+ *  function prototypes
+ */
+
+struct check_method;
+
+void xyz2plhhv_avx2( int, double *, double *, double *,
+                     double *, double *, double *, struct ellipsoid * );
+void xyz2plhv_avx2( int, double *, double *, double *,
+                    double *, double *, double *, struct ellipsoid * );
+static int axischeck( int, double, double, double, double *,
+                      struct ellipsoid * );
+static int colcheck( int, int * );
+static int convert( int, int, double **, double **, struct ellipsoid * );
+static int dmscheck( int, int * );
+static int dspcheck( double, double, double *, int *, struct ellipsoid * );
+static int fltcheck( int, int, double **, double *, struct ellipsoid * );
+static int maskcheck( int, int, double **, double **, double *,
+                      struct ellipsoid * );
+static int memocheck( int, double *, struct ellipsoid * );
+static int getcols( char *, int, int, double ** );
+static int lrwcheck( int, double * );
+static int oltcheck( int, double *, int * );
+static int sicheck( int, int * );
+static void siput( char *, void *, int, int );
+static int origcheck( char *, struct check_method *, int, double **,
+                      double, double, double ** );
+static int putbase( char *, int, double **, struct check_method * );
+
+/*
+ *  global definitions and variables
+ *
+ *  AXIS_n          number of points of axis_pt[]
+ *  BASE_rnd        1 + the relative rounding of a baseline error, which
+ *                  is stored to 7 digits
+ *  COL_nbad        number of header bytes of the colunpack check, col_bad[]
+ *  COL_nrow        number of rows of its block
+ *  DMS_maxprec     MAX_dmsprec of degdms.c, the most digits of seconds
+ *  DMS_nang        number of angles of the degdmsv check, dms_ang[]
+ *  DMS_wdeg        width of its degrees
+ *  DSP_htol        height tolerance of the xyz2plhd check [m]
+ *  DSP_nftol       number of latitude tolerances, dsp_ftol[]
+ *  DSP_nhgt, _nlat, _nr, _nz  sizes of dsp_hgt[], dsp_lat[], dsp_r[],
+ *                  dsp_z[]
+ *  LRW_n           number of data pairs of the lrwfit check
+ *  LRW_rel         relative error allowed lrwfit
+ *  LRW_win         size of its window
+ *  MAX_grid        maximum number of grid points
+ *  MAX_show        number of worse points listed per method
+ *  FLT_floor       error allowed the float routines beside their bound [m]
+ *  FLT_nrad        number of offset sizes of the float check, flt_rad[]
+ *  MASK_ulp        error allowed the hgt, r of the masked routines [ulp]
+ *  MEMO_n          number of points of the xyz2plhm check, memo_pt[]
+ *  MEMO_q          size of its cells [m]
+ *  OLT_nx, _ny     grid size of the oltintrpv check
+ *  OLT_tol         error allowed oltintrpv, in amp*cos(phs), amp*sin(phs)
+ *  OLT_undef       the undefined node of the oltintrpv grid
+ *  SI_nlook        number of lookups of the siindex check, si_look[]
+ *  SI_nrec         number of records of its file, si_rec[]
+ *
+ *  si_look[]       key, station, epoch of each lookup of the siindex
+ *                  check, and the record of si_rec[] it must find (-1
+ *                  for none)
+ *  si_rec[]        key, station, valid epoch [MJD, day] and X of the
+ *                  records of its file
+ *  axis_id[]       methods of the axis check, by id
+ *  axis_pt[]       X, Y, Z of the axis check [m]
+ *  col_bad[]       header bytes colpack cannot write, put in a block of
+ *                  the colunpack check
+ *  dms_ang[]       angles of the degdmsv check [deg]
+ *  dms_prec[]      its precs outside 0 to DMS_maxprec
+ *  dsp_ftol[]      latitude tolerances of the xyz2plhd check [arcsec]
+ *  dsp_hgt[], dsp_lat[]  heights [m] and latitudes [deg] of its grid
+ *  dsp_r[], dsp_z[]  distances from the axis and Z of its points near
+ *                  the axis [m]
+ *  memo_d[]        offset of the second point of a cell of the xyz2plhm
+ *                  check [m]
+ *  memo_pt[]       X, Y, Z of its cells [m]: the last is beyond the
+ *                  memo, the one before nearer the Z axis than
+ *                  MEMO_axis*MEMO_q, the one before that just outside
+ *                  it
+ *  check_method    a routine under test: name, id (see convert),
+ *                  the file and columns of the original program's
+ *                  errors, if any, their factors to 1e6*sec and nm,
+ *                  and whether a baseline is kept
+ */
+
+#define AXIS_n          ((int)8)
+#define BASE_rnd        ((double)1.000001)
+#define COL_nbad        ((int)5)
+#define COL_nrow        ((int)12)
+#define DMS_maxprec     ((int)9)
+#define DMS_nang        ((int)14)
+#define DMS_wdeg        ((int)4)
+#define DSP_htol        ((double)1.0e-3)
+#define DSP_nftol       ((int)7)
+#define DSP_nhgt        ((int)16)
+#define DSP_nlat        ((int)13)
+#define DSP_nr          ((int)9)
+#define DSP_nz          ((int)19)
+#define LRW_n           ((int)400)
+#define LRW_rel         ((double)1.0e-9)
+#define LRW_win         ((int)30)
+#define MAX_grid        ((int)5000)
+#define MAX_show        ((int)5)
+#define FLT_floor       ((double)1.0e-5)
+#define FLT_nrad        ((int)4)
+#define MASK_ulp        ((double)4.0)
+#define MEMO_n          ((int)6)
+#define MEMO_q          ((double)10.0)
+#define OLT_nx          ((int)12)
+#define OLT_ny          ((int)5)
+#define OLT_tol         ((double)1.0e-12)
+#define OLT_undef       ((int)7)
+#define SI_nlook        ((int)8)
+#define SI_nrec         ((int)4)
+
+struct check_method {
+        char    *name;
+        int      id;
+        char    *orig;
+        int      col;
+        double   ofi;
+        double   oh;
+        int      base;
+};
+
+static struct check_method methods[]= {
+        { "xyz2plh",        0, NULL, 0, 0.0, 0.0, 1 },
+        { "xyz2plhe",       1, NULL, 0, 0.0, 0.0, 1 },
+        { "xyz2plhs",       2, NULL, 0, 0.0, 0.0, 1 },
+        { "xyz2plhv_avx2",  3, NULL, 0, 0.0, 0.0, 1 },
+        { "xyz2plht",       4, NULL, 0, 0.0, 0.0, 1 },
+        { "xyz2plhtk0",     5, "Output/err_0.txt", 1, 3.6e9, 1.0e9, 0 },
+        { "xyz2plhtk1",     6, "Output/err_1.txt", 1, 3.6e9, 1.0e9, 0 },
+        { "xyz2plhtk2",     7, "Output/err_2.txt", 1, 3.6e9, 1.0e9, 1 },
+        { "xyz2plhh",       8, "Halley_Results.csv", 5, 1.0, 1.0, 1 },
+        { "xyz2plhhv_avx2", 9, NULL, 0, 0.0, 0.0, 1 },
+        { "xyz2plhhc",     10, NULL, 0, 0.0, 0.0, 1 }
+};
+
+#define MAX_method      ((int)(sizeof(methods)/sizeof(methods[0])))
+
+static int axis_id[3]= { 1, 2, 3 };
+static double axis_pt[AXIS_n][3]= {
+        { 0.0,    0.0,  40000.0 }, { 0.0,    0.0, -40000.0 },
+        { 1.0e-4, 0.0,  21000.0 }, { 1.0e-4, 0.0, -21000.0 },
+        { 1.0e-4, 0.0,  60000.0 }, { 1.0e-4, 0.0, -60000.0 },
+        { 1.0e-4, 0.0,      0.5 }, { 1.0e-4, 0.0, 120000.0 }
+};
+static int col_bad[COL_nbad]= { 0x09, 0x0F, 0x18, 0x54, 0x80 };
+static double dms_ang[DMS_nang]= {
+        0.0, 1.0e-12, -1.0e-12, -0.5, -0.99999999999999, 0.25,
+        12.99999999999999, -12.99999999999999, 45.5125, 59.9999999,
+        -89.99999999999, 180.0, 359.99999999999999, -1.0e-7 };
+static int dms_prec[4]= { -3, -1, DMS_maxprec + 1, DMS_maxprec + 5 };
+static double dsp_ftol[DSP_nftol]= {
+        3.0e-3, 2.0e-5, 1.0e-6, 2.0e-8, 1.0e-8, 1.0e-9, 1.0e-10 };
+static double dsp_hgt[DSP_nhgt]= {
+        -6.35e6, -6.3e6, -6.0e6, -3.0e6, -1.5e6, -5.0e5, -2.0e5, -1.0e3,
+        0.0, 9.0e3, 2.0e5, 5.0e5, 3.0e6, 2.0e7, 1.0e9, 1.0e11 };
+static double dsp_lat[DSP_nlat]= {
+        -90.0, -89.999999999, -89.999999, -89.999, -89.0, -45.0, 0.0,
+        30.0, 60.0, 89.0, 89.999, 89.999999, 89.999999999 };
+static double dsp_r[DSP_nr]= {
+        0.0, 1.0e-4, 1.0, 1.0e3, 2.0e4, 4.0e4, 9.0e4, 1.1e5, 1.2e5 };
+static double dsp_z[DSP_nz]= {
+        -5.0e9, -1.0e8, -1.0e6, -9.0e4, -6.0e4, -4.3e4, -2.0e4, -1.0e3,
+        -1.0, 0.0, 1.0, 1.0e3, 2.0e4, 4.3e4, 6.0e4, 9.0e4, 1.0e6, 1.0e8,
+        5.0e9 };
+static struct {
+        int     key;
+        char    *stid;
+        long    mjd;
+        double  day;
+        int     rec;
+} si_look[SI_nlook]= {
+        { 'C', "ALGO00 ", 54000, 0.0,  3 }, { 'C', "ALGO00 ", 55000, 0.4,  3 },
+        { 'C', "ALGO00 ", 55000, 0.5,  0 }, { 'C', "ALGO00 ", 60000, 0.0,  0 },
+        { 'C', "ALGO00 ", 49999, 0.9, -1 }, { 'C', "BRUS00 ", 60000, 0.0,  2 },
+        { 'C', "WTZR00 ", 60000, 0.0, -1 }, { 'A', "ALGO00 ", 60000, 0.0,  1 }
+};
+static struct {
+        int     key;
+        char    *stid;
+        long    mjd;
+        double  day;
+        double  x;
+} si_rec[SI_nrec]= {
+        { 'C', "ALGO00 ", 55000, 0.5,  918129.4 },
+        { 'A', "ALGO00 ", 50000, 0.0,       0.0 },
+        { 'C', "BRUS00 ", 51000, 0.25, 4027893.7 },
+        { 'C', "ALGO00 ", 50000, 0.0,  918129.1 }
+};
+static char *flt_name[2]= { "xyz2plhfv", "plh2xyzfv" };
+static double flt_rad[FLT_nrad]= { 10.0, 1.0e3, 1.0e5, FLT_dmax };
+static char *mask_name[2]= { "xyz2plhov", "plh2xyzov" };
+static double memo_d[3]= { 3.0, -4.0, 4.5 };
+static double memo_pt[MEMO_n][3]= {
+        { 4027890.0, 307050.0, 4919470.0 },
+        { -2430600.0, -4702440.0, 3546590.0 },
+        { 6378140.0, 0.0, 0.0 },
+        { 10010.0, 0.0, -6356740.0 },
+        { 7000.0, 7000.0, 6356750.0 },
+        { 2.0e19, 0.0, 0.0 } };
+
+
+
+int main( int argc, char *argv[] )
+{
+  char *bdir= "baseline";
+  char *grid= "../../geo_4277_Points";
+  char *mname= "";
+  char *pgm;
+  char *ptr;
+  char *vrsn= "1.0 26/10/18";
+  char path[512];
+  double a;
+  double ftol= 1.0e-2;
+  double htol= 1.0;
+  double hulp= 4.0;
+  double t;
+  double emax[2];
+  double esum[2];
+  double *base[3];
+  double *err[2];
+  double *orig[7];
+  double *out[3];
+  double *plh[3];
+  double *xyz[3];
+  double p[3];
+  double q[3];
+  int c;
+  int errflg= 0;
+  int i;
+  int j;
+  int k;
+  int n;
+  int nb;
+  int nfail= 0;
+  int nshow;
+  int nworse;
+  int wflg= 0;
+  struct ellipsoid custom;
+  struct ellipsoid *ell= NULL;
+
+  extern char *optarg;
+  extern int optind;
+  extern int optopt;
+
+/*
+ *   1.0  Parse command line
+ */
+
+  pgm= argv[0];
+  while( (ptr= strpbrk( pgm, "/\\:" )) != NULL )
+    pgm= ptr+1;
+
+  while( (c= getopt(argc, argv, ":b:e:f:g:hm:t:u:w")) != -1 )
+    switch( c ) {
+    case 'b':
+      bdir= optarg;
+      break;
+    case 'e':
+      if( (ell= ellparse( optarg, &custom )) == NULL ) {
+        fprintf(stderr, "%s ERROR: Unknown ellipsoid \"%s\"\n", pgm, optarg);
+        errflg++;
+      }
+      break;
+    case 'f':
+      ftol= numscan( optarg, NULL );
+      break;
+    case 'g':
+      grid= optarg;
+      break;
+    case 'h':
+      errflg= 1;
+      break;
+    case 'm':
+      mname= optarg;
+      break;
+    case 't':
+      htol= numscan( optarg, NULL );
+      break;
+    case 'u':
+      hulp= numscan( optarg, NULL );
+      break;
+    case 'w':
+      wflg= 1;
+      break;
+    case '?':
+      fprintf(stderr, "%s ERROR: Unrecognized option \"%c\"\n",
+         pgm, optopt);
+      errflg++;
+      break;
+    case ':':
+      errflg++;
+      break;
+    }
+
+  if( errflg || optind != argc || !(ftol >= 0.0) || !(htol >= 0.0)
+      || !(hulp >= 0.0) ) {
+    printf("%s(%s): Checks the accuracy of the X, Y, Z -> lat, lon, hgt\n",
+           pgm, vrsn);
+    printf("        routines on the 4277 point grid against baselines\n");
+    printf("Usage: %s [options]\n", pgm );
+    printf("  options:\n");
+    printf("           -b dir of the baselines (default %s).\n", bdir);
+    printf("           -e ellipsoid, by name or as A,FL (default WGS84).\n");
+    printf("           -f latitude tolerance [1e6*arcsec] (default %g).\n",
+           ftol);
+    printf("           -g dir holding fi_lam_h(4277).txt\n");
+    printf("              (default %s).\n", grid);
+    printf("           -h prints this message.\n");
+    printf("           -m checks only methods whose name contains this.\n");
+    printf("           -t height tolerance [nm] (default %g).\n", htol);
+    printf("           -u height tolerance added in ulp of h"
+           " (default %g).\n", hulp);
+    printf("           -w writes the baselines instead of checking them.\n");
+    exit(1);
+  }
+
+/*
+ *   2.0  Read the grid; X, Y, Z by plh2xyze
+ */
+
+  if( ell == NULL )
+    ell= ellfind( "WGS84" );
+
+  for( i= 0; i < 3; i++ )
+    if( (plh[i]= malloc( MAX_grid*sizeof(double) )) == NULL
+        || (xyz[i]= malloc( MAX_grid*sizeof(double) )) == NULL
+        || (out[i]= malloc( MAX_grid*sizeof(double) )) == NULL
+        || (base[i]= malloc( MAX_grid*sizeof(double) )) == NULL ) {
+      fprintf(stderr, "%s ERROR: Out of memory\n", pgm);
+      exit(1);
+    }
+  for( i= 0; i < 7; i++ )
+    if( (orig[i]= malloc( MAX_grid*sizeof(double) )) == NULL
+        || (i < 2 && (err[i]= malloc( MAX_grid*sizeof(double) )) == NULL) ) {
+      fprintf(stderr, "%s ERROR: Out of memory\n", pgm);
+      exit(1);
+    }
+
+  snprintf( path, sizeof(path), "%s/fi_lam_h(4277).txt", grid );
+  if( (n= getcols( path, 3, MAX_grid, plh )) <= 0 ) {
+    fprintf(stderr, "%s ERROR: no 4277 point grid in \"%s\"\n", pgm, grid);
+    exit(1);
+  }
+  for( i= 0; i < n; i++ ) {
+    p[0]= plh[0][i];
+    p[1]= plh[1][i];
+    p[2]= plh[2][i];
+    plh2xyze( p, q, ell );
+    xyz[0][i]= q[0];
+    xyz[1][i]= q[1];
+    xyz[2][i]= q[2];
+  }
+
+/*
+ *   3.0  Each method: round trip errors, then baseline check or write
+ */
+
+  printf("%d points, ellipsoid %s, simd level %d\n", n, ell->name,
+         simd_level());
+  printf("%-15s %11s %11s %11s %11s %6s  %s\n", "method", "max|dfi|",
+         "rms dfi", "max|dh|", "rms dh", "worse", "status");
+  printf("%-15s %11s %11s %11s %11s\n", "", "[1e6*sec]", "[1e6*sec]",
+         "[nm]", "[nm]");
+
+  for( j= 0; j < MAX_method; j++ ) {
+    if( strstr( methods[j].name, mname ) == NULL )
+      continue;
+    if( convert( methods[j].id, n, xyz, out, ell ) != 0 ) {
+      printf("%-15s %11s %11s %11s %11s %6s  SKIP\n", methods[j].name,
+             "", "", "", "", "");
+      continue;
+    }
+
+    emax[0]= emax[1]= 0.0;
+    esum[0]= esum[1]= 0.0;
+    for( i= 0; i < n; i++ ) {
+      err[0][i]= ( out[0][i] - plh[0][i] ) * 3.6e9;
+      err[1][i]= ( out[2][i] - plh[2][i] ) * 1.0e9;
+      for( k= 0; k < 2; k++ ) {
+        if( !( fabs( err[k][i] ) <= emax[k] ) )
+          emax[k]= fabs( err[k][i] );
+        esum[k]+= err[k][i]*err[k][i];
+      }
+    }
+    printf("%-15s %11.4e %11.4e %11.4e %11.4e", methods[j].name,
+           emax[0], sqrt( esum[0]/n ), emax[1], sqrt( esum[1]/n ));
+
+    if( !methods[j].base ) {
+      printf("\n");
+      if( !wflg )
+        nfail+= origcheck( grid, &methods[j], n, err, ftol, htol, orig );
+      continue;
+    }
+
+    snprintf( path, sizeof(path), "%s/%s.txt", bdir, methods[j].name );
+    if( wflg ) {
+      if( putbase( path, n, err, &methods[j] ) != 0 ) {
+        printf(" %6s  ERROR\n", "");
+        fprintf(stderr, "%s ERROR: Cannot write \"%s\"\n", pgm, path);
+        nfail++;
+      } else
+        printf(" %6s  written\n", "");
+      continue;
+    }
+
+/*
+ *        Against the baseline: base[0] is the ID, base[1..2] the errors
+ */
+
+    if( (nb= getcols( path, 3, MAX_grid, base )) != n ) {
+      printf(" %6s  FAIL\n", "");
+      fprintf(stderr, "%s ERROR: no baseline of %d points in \"%s\"\n",
+              pgm, n, path);
+      nfail++;
+      continue;
+    }
+    nworse= 0;
+    nshow= 0;
+    for( i= 0; i < n; i++ ) {
+      a= fabs( plh[2][i] ) > ell->A ? fabs( plh[2][i] ) : ell->A;
+      t= htol + hulp * ( nextafter( a, 2.0*a ) - a ) * 1.0e9;
+      if( fabs( err[0][i] ) <= fabs( base[1][i] )*BASE_rnd + ftol
+          && fabs( err[1][i] ) <= fabs( base[2][i] )*BASE_rnd + t )
+        continue;
+      if( nshow++ == 0 )
+        printf(" %6s  FAIL\n", "");
+      if( nshow <= MAX_show )
+        printf("    ID %4d  fi %9.4f  h %13.3f:  dfi %11.4e (%11.4e)"
+               "  dh %11.4e (%11.4e)\n", i+1, plh[0][i], plh[2][i],
+               err[0][i], base[1][i], err[1][i], base[2][i]);
+      nworse++;
+    }
+    if( nworse == 0 )
+      printf(" %6d  PASS\n", 0);
+    else {
+      printf("%-15s %47s %6d  FAIL\n", "", "", nworse);
+      nfail++;
+    }
+
+/*
+ *        Against the original program's errors
+ */
+
+    if( methods[j].orig != NULL )
+      nfail+= origcheck( grid, &methods[j], n, err, ftol, htol, orig );
+    fflush( stdout );
+  }
+
+/*
+ *   3.1  The core on and near the Z axis, against the limit r -> 0
+ */
+
+  nshow= 0;
+  for( k= 0; k < 3 && !wflg; k++ ) {
+    for( j= 0; j < MAX_method && methods[j].id != axis_id[k]; j++ )
+      ;
+    if( strstr( methods[j].name, mname ) == NULL )
+      continue;
+    if( nshow++ == 0 )
+      printf("%-15s %11s %11s %11s %11s\n", "axis", "max|dfi|", "",
+             "max|dh|", "");
+    nworse= axischeck( axis_id[k], ftol, htol, hulp, emax, ell );
+    if( nworse < 0 ) {
+      printf("%-15s %11s %11s %11s %11s %6s  SKIP\n", methods[j].name,
+             "", "", "", "", "");
+      continue;
+    }
+    printf("%-15s %11.4e %11s %11.4e %11s %6d  %s\n", methods[j].name,
+           emax[0], "", emax[1], "", nworse, nworse == 0 ? "PASS" : "FAIL");
+    if( nworse != 0 )
+      nfail++;
+  }
+
+/*
+ *   4.0  The sliding window fit, against a direct fit
+ */
+
+  for( j= 0; j < 2 && !wflg && strstr( "lrwfit", mname ) != NULL; j++ ) {
+    if( j == 0 ) {
+      printf("%-15s %11s %11s %11s %11s %6s  %s\n", "window fit", "mode",
+             "max err", "", "bound", "worse", "status");
+      printf("%-15s %11s %11s %11s %11s\n", "", "", "[rel]", "", "[rel]");
+    }
+    nworse= lrwcheck( j, emax );
+    printf("%-15s %11d %11.4e %11s %11.4e %6d  %s\n", "lrwfit", j,
+           emax[0], "", LRW_rel, nworse, nworse == 0 ? "PASS" : "FAIL");
+    if( nworse != 0 )
+      nfail++;
+  }
+
+/*
+ *   5.0  The ocean loading grid store, at nodes and midpoints
+ */
+
+  for( j= 0; j < 2 && !wflg && strstr( "oltintrpv", mname ) != NULL; j++ ) {
+    if( j == 0 ) {
+      printf("%-15s %11s %11s %11s %11s %6s  %s\n", "ocean loading",
+             "stations", "max err", "", "bound", "worse", "status");
+      printf("%-15s %11s %11s %11s %11s\n", "", "", "[amp]", "", "[amp]");
+    }
+    nworse= oltcheck( j, emax, &nb );
+    printf("%-15s %11d %11.4e %11s %11.4e %6d  %s\n",
+           j == 0 ? "oltintrpv" : "oltintrpv file", nb, emax[0], "", OLT_tol,
+           nworse, nworse == 0 ? "PASS" : "FAIL");
+    if( nworse != 0 )
+      nfail++;
+  }
+
+/*
+ *   6.0  The mapped station information reader, in both byte orders
+ */
+
+  for( j= 0; j < 2 && !wflg && strstr( "siindex", mname ) != NULL; j++ ) {
+    if( j == 0 )
+      printf("%-15s %11s %11s %11s %11s %6s  %s\n", "station info",
+             "swapped", "records", "", "lookups", "worse", "status");
+    nworse= sicheck( j, &nb );
+    printf("%-15s %11d %11d %11s %11d %6d  %s\n", "siindex", j, nb, "",
+           SI_nlook, nworse, nworse == 0 ? "PASS" : "FAIL");
+    if( nworse != 0 )
+      nfail++;
+  }
+
+/*
+ *   7.0  The batch degrees, minutes, seconds, against the formatter
+ */
+
+  for( j= 0; j < 2 && !wflg && strstr( "degdmsv", mname ) != NULL; j++ ) {
+    if( j == 0 )
+      printf("%-15s %11s %11s %11s %11s %6s  %s\n", "dms format",
+             "clamped", "precs", "", "angles", "worse", "status");
+    nworse= dmscheck( j, &nb );
+    printf("%-15s %11d %11d %11s %11d %6d  %s\n", "degdmsv", j, nb, "",
+           DMS_nang, nworse, nworse == 0 ? "PASS" : "FAIL");
+    if( nworse != 0 )
+      nfail++;
+  }
+
+/*
+ *   8.0  The float routines, against their bound rather than a baseline
+ */
+
+  nshow= 0;
+  for( j= 0; j < 2 && !wflg; j++ ) {
+    if( strstr( flt_name[j], mname ) == NULL )
+      continue;
+    if( nshow++ == 0 ) {
+      printf("%-15s %11s %11s %11s %11s %6s  %s\n", "float", "max err",
+             "max err/d", "d max", "bound/d", "worse", "status");
+      printf("%-15s %11s %11s %11s %11s\n", "", "[m]", "", "[m]", "");
+    }
+    nworse= fltcheck( j, n, plh, emax, ell );
+    printf("%-15s %11.4e %11.4e %11.4e %11.4e %6d  %s\n", flt_name[j],
+           emax[0], emax[1], FLT_dmax, FLT_erel, nworse,
+           nworse == 0 ? "PASS" : "FAIL");
+    if( nworse != 0 )
+      nfail++;
+  }
+
+/*
+ *   9.0  The masked routines, against the full ones
+ */
+
+  nshow= 0;
+  for( j= 0; j < 2 && !wflg; j++ ) {
+    if( strstr( mask_name[j], mname ) == NULL )
+      continue;
+    if( nshow++ == 0 ) {
+      printf("%-15s %11s %11s %11s %11s %6s  %s\n", "masked", "masks",
+             "max err", "", "bound", "worse", "status");
+      printf("%-15s %11s %11s %11s %11s\n", "", "", "[ulp]", "", "[ulp]");
+    }
+    nworse= maskcheck( j, n, xyz, plh, emax, ell );
+    printf("%-15s %11d %11.4e %11s %11.4e %6d  %s\n", mask_name[j],
+           j == 0 ? OUT_plh : OUT_xyz | OUT_r, emax[0], "", MASK_ulp,
+           nworse, nworse == 0 ? "PASS" : "FAIL");
+    if( nworse != 0 )
+      nfail++;
+  }
+
+/*
+ *  10.0  The dispatcher, its unflagged results against xyz2plhdd
+ */
+
+  for( j= 0; j < DSP_nftol && !wflg && strstr( "xyz2plhd", mname ) != NULL;
+       j++ ) {
+    if( j == 0 ) {
+      printf("%-15s %11s %11s %11s %11s %6s  %s\n", "dispatch", "ftol",
+             "max|dfi|", "max|dh|", "flagged", "worse", "status");
+      printf("%-15s %11s %11s %11s\n", "", "[sec]", "[sec]", "[m]");
+    }
+    nworse= dspcheck( dsp_ftol[j], DSP_htol, emax, &nb, ell );
+    printf("%-15s %11.4e %11.4e %11.4e %11d %6d  %s\n", "xyz2plhd",
+           dsp_ftol[j], emax[0], emax[1], nb, nworse,
+           nworse == 0 ? "PASS" : "FAIL");
+    if( nworse != 0 )
+      nfail++;
+  }
+
+/*
+ *  11.0  The memo of repeat stations, hits against xyz2plhe
+ */
+
+  for( j= 0; j < 2 && !wflg && strstr( "xyz2plhm", mname ) != NULL; j++ ) {
+    if( j == 0 ) {
+      printf("%-15s %11s %11s %11s %11s %6s  %s\n", "memo", "lin",
+             "max err", "", "bound", "worse", "status");
+      printf("%-15s %11s %11s %11s %11s\n", "", "", "[q]", "", "[q]");
+    }
+    nworse= memocheck( j, emax, ell );
+    printf("%-15s %11d %11.4e %11s %11.4e %6d  %s\n", "xyz2plhm", j,
+           emax[0], "", j == 0 ? sqrt( 3.0 ) : 3.0e-3, nworse,
+           nworse == 0 ? "PASS" : "FAIL");
+    if( nworse != 0 )
+      nfail++;
+  }
+
+/*
+ *  12.0  The column file blocks, round trip and corrupted header bytes
+ */
+
+  for( j= 0; j < 2 && !wflg && strstr( "colunpack", mname ) != NULL; j++ ) {
+    if( j == 0 )
+      printf("%-15s %11s %11s %11s %11s %6s  %s\n", "column block",
+             "codec", "rows", "", "corrupted", "worse", "status");
+    nworse= colcheck( j == 0 ? COL_delta : COL_xor, &nb );
+    printf("%-15s %11s %11d %11s %11d %6d  %s\n", "colunpack",
+           j == 0 ? "delta" : "xor", COL_nrow, "", nb, nworse,
+           nworse == 0 ? "PASS" : "FAIL");
+    if( nworse != 0 )
+      nfail++;
+  }
+
+  if( !wflg )
+    printf("%s\n", nfail == 0 ? "all methods PASS" : "FAILED");
+  exit( nfail == 0 ? 0 : 1 );
+}
+
+
+static int axischeck( int id, double ftol, double htol, double hulp,
+                      double *emax, struct ellipsoid *ell )
+/********1*********2*********3*********4*********5*********6*********7*********
+ * purpose:         converts axis_pt[] by method id and compares with the
+ *                  limit r -> 0; emax[] gets the largest latitude
+ *                  [1e6*arcsec] and height [nm] errors.  Returns the
+ *                  number of points beyond ftol, htol + hulp ulp, or -1
+ *                  if the method cannot run.
+ ********1*********2*********3*********4*********5*********6*********7*********/
+{
+        double a;
+        double e[2];
+        double fi;
+        double h;
+        double in[3][AXIS_n];
+        double out[3][AXIS_n];
+        double *vin[3];
+        double *vout[3];
+        double r;
+        double z;
+        int i;
+        int k;
+        int nworse= 0;
+
+        for( k= 0; k < 3; k++ ) {
+                for( i= 0; i < AXIS_n; i++ )
+                        in[k][i]= axis_pt[i][k];
+                vin[k]= in[k];
+                vout[k]= out[k];
+        }
+        if( convert( id, AXIS_n, vin, vout, ell ) != 0 )
+                return( -1 );
+
+        emax[0]= emax[1]= 0.0;
+        for( i= 0; i < AXIS_n; i++ ) {
+                r= hypot( axis_pt[i][0], axis_pt[i][1] );
+                z= fabs( axis_pt[i][2] );
+                fi= 90.0 - r/(z + ell->c/ell->B) * rad_to_deg;
+                h= z - ell->B;
+                e[0]= ( fabs( out[0][i] ) - fi ) * 3.6e9;
+                e[1]= ( out[2][i] - h ) * 1.0e9;
+                if( out[0][i]*axis_pt[i][2] < 0.0 )
+                        e[0]= HUGE_VAL;
+                for( k= 0; k < 2; k++ )
+                        if( !( fabs( e[k] ) <= emax[k] ) )
+                                emax[k]= fabs( e[k] );
+                a= fabs( h ) > ell->A ? fabs( h ) : ell->A;
+                a= htol + hulp*( nextafter( a, 2.0*a ) - a )*1.0e9;
+                if( !( fabs( e[0] ) <= ftol ) || !( fabs( e[1] ) <= a ) )
+                        nworse++;
+        }
+
+        return( nworse );
+}
+
+
+static int dspcheck( double ftol, double htol, double *emax, int *nflag,
+                     struct ellipsoid *ell )
+/********1*********2*********3*********4*********5*********6*********7*********
+ * purpose:         converts the grid of dsp_hgt[] by dsp_lat[] and the
+ *                  points of dsp_r[] by dsp_z[] one point at a time by
+ *                  xyz2plhd at ftol [arcsec], htol [m], and by xyz2plhdd.
+ *                  emax[] gets the largest latitude [arcsec] and height
+ *                  [m] errors of the points it does not flag, *nflag
+ *                  the number it flags.  Returns the number of unflagged
+ *                  points beyond ftol or htol.
+ ********1*********2*********3*********4*********5*********6*********7*********/
+{
+        double e[2];
+        double p[3];
+        double q[3];
+        double ref[6];
+        double u[3];
+        int i;
+        int j;
+        int k;
+        int nworse= 0;
+
+        emax[0]= emax[1]= 0.0;
+        *nflag= 0;
+        for( i= 0; i < DSP_nhgt*DSP_nlat + DSP_nr*DSP_nz; i++ ) {
+                if( i < DSP_nhgt*DSP_nlat ) {
+                        u[0]= dsp_lat[i%DSP_nlat];
+                        u[1]= 37.0*i;
+                        u[2]= dsp_hgt[i/DSP_nlat];
+                        plh2xyze( u, q, ell );
+                } else {
+                        j= i - DSP_nhgt*DSP_nlat;
+                        q[0]= dsp_r[j%DSP_nr] * 0.6;
+                        q[1]= dsp_r[j%DSP_nr] * 0.8;
+                        q[2]= dsp_z[j/DSP_nr];
+                }
+                if( xyz2plhd( 1, &q[0], &q[1], &q[2], &p[0], &p[1], &p[2], ell,
+                              ftol, htol ) != 0 ) {
+                        (*nflag)++;
+                        continue;
+                }
+                xyz2plhdd( q, ref, ell );
+                e[0]= ( p[0] - ref[0] ) * 3600.0;
+                e[1]= p[2] - ref[2];
+                for( k= 0; k < 2; k++ )
+                        if( !( fabs( e[k] ) <= emax[k] ) )
+                                emax[k]= fabs( e[k] );
+                if( !( fabs( e[0] ) <= ftol ) || !( fabs( e[1] ) <= htol ) )
+                        nworse++;
+        }
+
+        return( nworse );
+}
+
+
+static int colcheck( int codec, int *nbad )
+/********1*********2*********3*********4*********5*********6*********7*********
+ * purpose:         packs a block of COL_nrow rows of three columns in
+ *                  codec and unpacks it, which must give back every
+ *                  bit; for COL_xor, then puts each of col_bad[] as the
+ *                  header byte of the first value, which colunpack must
+ *                  refuse.  *nbad gets the number of those.  Returns
+ *                  the number of values not given back plus blocks
+ *                  not refused.
+ ********1*********2*********3*********4*********5*********6*********7*********/
+{
+        char buf[(1 + 3)*sizeof(int) + 10*3*COL_nrow];
+        char hb;
+        double in[3][COL_nrow];
+        double out[3][COL_nrow];
+        double *vin[3];
+        double *vout[3];
+        int i;
+        int k;
+        int n;
+        int nworse= 0;
+        struct col_head hd;
+
+        for( i= 0; i < COL_nrow; i++ ) {
+                in[0][i]= 4510094.566482120 + 0.125*i;
+                in[1][i]= ( i % 3 == 0 ) ? 0.0 : -1.0e-300 * i;
+                in[2][i]= 1105.7602060073095;
+        }
+        for( k= 0; k < 3; k++ ) {
+                vin[k]= in[k];
+                vout[k]= out[k];
+        }
+        colinit( &hd, 3, "X,Y,Z", codec, ellfind( "WGS84" ) );
+        colpack( &hd, COL_nrow, vin, buf );
+
+        memset( out, 0, sizeof(out) );
+        if( (n= colunpack( &hd, buf, 3, vout )) != COL_nrow )
+                return( 3*COL_nrow );
+        for( k= 0; k < 3; k++ )
+                for( i= 0; i < COL_nrow; i++ )
+                        if( memcmp( &in[k][i], &out[k][i], sizeof(double) ) )
+                                nworse++;
+
+        *nbad= codec == COL_xor ? COL_nbad : 0;
+        hb= buf[(1 + 3)*sizeof(int)];
+        for( i= 0; i < *nbad; i++ ) {
+                buf[(1 + 3)*sizeof(int)]= (char)col_bad[i];
+                if( colunpack( &hd, buf, 3, vout ) != -1 )
+                        nworse++;
+        }
+        buf[(1 + 3)*sizeof(int)]= hb;
+
+        return( nworse );
+}
+
+
+static int convert( int id, int n, double **xyz, double **plh,
+                    struct ellipsoid *ell )
+/********1*********2*********3*********4*********5*********6*********7*********
+ * purpose:         converts the n points xyz[0..2] to plh[0..2] by method
+ *                  id of methods[].  Returns 0, or 1 if the method cannot
+ *                  run on this processor or ellipsoid.
+ ********1*********2*********3*********4*********5*********6*********7*********/
+{
+        double p[3];
+        double q[3];
+        int i;
+
+        switch( id ) {
+        case 2:
+                return( xyz2plhs( n, xyz[0], xyz[1], xyz[2],
+                                  plh[0], plh[1], plh[2], ell ) == 0 ? 0 : 1 );
+        case 3:
+                if( simd_level() < 1 )
+                        return( 1 );
+                xyz2plhv_avx2( n, xyz[0], xyz[1], xyz[2],
+                               plh[0], plh[1], plh[2], ell );
+                return( 0 );
+        case 9:
+                if( simd_level() < 1 )
+                        return( 1 );
+                xyz2plhhv_avx2( n, xyz[0], xyz[1], xyz[2],
+                                plh[0], plh[1], plh[2], ell );
+                return( 0 );
+        }
+
+        for( i= 0; i < n; i++ ) {
+                q[0]= xyz[0][i];
+                q[1]= xyz[1][i];
+                q[2]= xyz[2][i];
+                switch( id ) {
+                case 0:
+                        xyz2plh( q, p, ell->A, ell->FL );
+                        break;
+                case 1:
+                        xyz2plhe( q, p, ell );
+                        break;
+                case 4:
+                        xyz2plht( q, p, ell );
+                        break;
+                case 5:
+                case 6:
+                case 7:
+                        xyz2plhtk( q, p, ell, id - 5 );
+                        break;
+                case 8:
+                        xyz2plhh( q, p, ell );
+                        break;
+                case 10:
+                        xyz2plhhc( q, p, ell );
+                        break;
+                }
+                plh[0][i]= p[0];
+                plh[1][i]= p[1];
+                plh[2][i]= p[2];
+        }
+
+        return( 0 );
+}
+
+
+static int fltcheck( int dir, int n, double **plh, double *emax,
+                     struct ellipsoid *ell )
+/********1*********2*********3*********4*********5*********6*********7*********
+ * purpose:         checks xyz2plhfv (dir 0) or plh2xyzfv (dir 1) with
+ *                  each of the n grid points as origin; emax[] gets the
+ *                  largest error [m] and error/offset.  Returns the
+ *                  number of offsets whose error is beyond the bound.
+ ********1*********2*********3*********4*********5*********6*********7*********/
+{
+        double a;
+        double d;
+        double e;
+        double org[3];
+        double r;
+        double p[3];
+        double q[3];
+        double ref[3][26*FLT_nrad];
+        double u[3];
+        double x0[3];
+        float fi[3][26*FLT_nrad];
+        float fo[3][26*FLT_nrad];
+        int i;
+        int j;
+        int k;
+        int l;
+        int m;
+        int nworse= 0;
+
+        emax[0]= emax[1]= 0.0;
+        for( i= 0; i < n; i++ ) {
+                for( k= 0; k < 3; k++ )
+                        org[k]= plh[k][i];
+                plh2xyze( org, x0, ell );
+/*
+ *   offsets: the 26 directions from the centre of a cube to its faces,
+ *   edges and corners, at each of flt_rad[]; their lat, lon, hgt by
+ *   xyz2plhhc, which unlike xyz2plhe converges near the poles at 1e9 m
+ */
+                for( m= 0, j= 0; j < 27; j++ ) {
+                        if( j == 13 )
+                                continue;
+                        u[0]= j/9 - 1;
+                        u[1]= (j/3)%3 - 1;
+                        u[2]= j%3 - 1;
+                        a= sqrt( u[0]*u[0] + u[1]*u[1] + u[2]*u[2] );
+                        for( k= 0; k < FLT_nrad; k++, m++ ) {
+                                for( l= 0; l < 3; l++ ) {
+                                        fi[l][m]= (float)( flt_rad[k]*u[l]/a );
+                                        q[l]= x0[l] + fi[l][m];
+                                }
+                                xyz2plhhc( q, p, ell );
+                                for( l= 0; l < 3; l++ )
+                                        ref[l][m]= p[l];
+                        }
+                }
+                if( dir == 0 )
+                        xyz2plhfv( m, org, fi[0], fi[1], fi[2],
+                                   fo[0], fo[1], fo[2], ell );
+                else {
+                        for( j= 0; j < m; j++ ) {
+                                fi[0][j]= (float)( ref[0][j] - org[0] );
+                                fi[1][j]= (float)remainder( ref[1][j] - org[1],
+                                                            360.0 );
+                                fi[2][j]= (float)( ref[2][j] - org[2] );
+                        }
+                        plh2xyzfv( m, org, fi[0], fi[1], fi[2],
+                                   fo[0], fo[1], fo[2], ell );
+                }
+
+                for( j= 0; j < m; j++ ) {
+                        d= flt_rad[j%FLT_nrad];
+                        if( dir == 0 ) {
+                                r= ( ell->A + ref[2][j] ) * deg_to_rad;
+                                p[0]= ( org[0] - ref[0][j] + fo[0][j] ) * r;
+                                p[1]= remainder( org[1] - ref[1][j] + fo[1][j],
+                                                 360.0 )
+                                      * r * cos( deg_to_rad * ref[0][j] );
+                                p[2]= org[2] - ref[2][j] + fo[2][j];
+                        } else {
+                                for( k= 0; k < 3; k++ )
+                                        q[k]= org[k] + fi[k][j];
+                                plh2xyze( q, p, ell );
+                                for( k= 0; k < 3; k++ )
+                                        p[k]= x0[k] + fo[k][j] - p[k];
+                        }
+                        e= sqrt( p[0]*p[0] + p[1]*p[1] + p[2]*p[2] );
+                        if( !( e <= emax[0] ) )
+                                emax[0]= e;
+                        if( !( e/d <= emax[1] ) )
+                                emax[1]= e/d;
+                        if( !( e <= FLT_erel*d + FLT_floor ) )
+                                nworse++;
+                }
+        }
+
+        return( nworse );
+}
+
+
+static int maskcheck( int dir, int n, double **xyz, double **plh,
+                      double *emax, struct ellipsoid *ell )
+/********1*********2*********3*********4*********5*********6*********7*********
+ * purpose:         checks xyz2plhov (dir 0) or plh2xyzov (dir 1) with
+ *                  each mask on the n grid points against xyz2plhv
+ *                  (xyz2plhe without AVX2) or plh2xyzv; emax[0] gets
+ *                  the largest hgt or r error [ulp].  Returns the
+ *                  number of outputs that differ or are beyond
+ *                  MASK_ulp.
+ ********1*********2*********3*********4*********5*********6*********7*********/
+{
+        static double got[4][MAX_grid];
+        static double ref[4][MAX_grid];
+        double a;
+        double e;
+        double p[3];
+        double q[3];
+        double *o[4];
+        int i;
+        int k;
+        int mask;
+        int nworse= 0;
+
+        if( dir == 0 && simd_level() >= 1 )
+                xyz2plhv( n, xyz[0], xyz[1], xyz[2],
+                          ref[0], ref[1], ref[2], ell );
+        else if( dir == 0 )
+                for( i= 0; i < n; i++ ) {
+                        for( k= 0; k < 3; k++ )
+                                q[k]= xyz[k][i];
+                        xyz2plhe( q, p, ell );
+                        for( k= 0; k < 3; k++ )
+                                ref[k][i]= p[k];
+                }
+        else {
+                plh2xyzv( n, plh[0], plh[1], plh[2],
+                          ref[0], ref[1], ref[2], ell );
+                for( i= 0; i < n; i++ )
+                        ref[3][i]= hypot( ref[0][i], ref[1][i] );
+        }
+
+        emax[0]= 0.0;
+        for( mask= 1; mask <= (dir == 0 ? OUT_plh : OUT_xyz | OUT_r);
+             mask++ ) {
+                for( k= 0; k < 4; k++ )
+                        o[k]= mask & 1 << k ? got[k] : NULL;
+                if( dir == 0 )
+                        xyz2plhov( n, mask, xyz[0], xyz[1], xyz[2],
+                                   o[0], o[1], o[2], ell );
+                else
+                        plh2xyzov( n, mask, plh[0], plh[1], plh[2],
+                                   o[0], o[1], o[2], o[3], ell );
+/*
+ *   lat, lon or X, Y, Z as the full routine; hgt or r to the ulp
+ */
+                for( i= 0; i < n; i++ )
+                        for( k= 0; k < 4; k++ ) {
+                                if( o[k] == NULL )
+                                        continue;
+                                if( dir == 0 ? k < 2 : k < 3 ) {
+                                        if( !( got[k][i] == ref[k][i] ) )
+                                                nworse++;
+                                        continue;
+                                }
+                                a= fabs( ref[k][i] );
+                                if( dir == 0 && a < ell->A )
+                                        a= ell->A;
+                                e= fabs( got[k][i] - ref[k][i] )
+                                 / ( nextafter( a, 2.0*a ) - a );
+                                if( !( e <= emax[0] ) )
+                                        emax[0]= e;
+                                if( !( e <= MASK_ulp ) )
+                                        nworse++;
+                        }
+        }
+
+        return( nworse );
+}
+
+
+static int getcols( char *path, int ncol, int max, double **v )
+/********1*********2*********3*********4*********5*********6*********7*********
+ * purpose:         reads the first ncol values of each line of path
+ *                  into v[0..ncol-1]; lines that do not start with a
+ *                  number are skipped.  Returns the number of lines
+ *                  read, -1 if the file cannot be opened.
+ ********1*********2*********3*********4*********5*********6*********7*********/
+{
+        char line[512];
+        char *end;
+        char *ptr;
+        int k;
+        int n= 0;
+        FILE *fp;
+
+        if( (fp= fopen( path, "r" )) == NULL )
+                return( -1 );
+
+        while( n < max && fgets( line, sizeof(line), fp ) != NULL ) {
+                for( k= 0, ptr= line; k < ncol; k++ ) {
+                        while( *ptr == ' ' || *ptr == '\t' || *ptr == ',' )
+                                ptr++;
+                        v[k][n]= numscan( ptr, &end );
+                        if( end == ptr )
+                                break;
+                        ptr= end;
+                }
+                if( k == ncol )
+                        n++;
+        }
+        fclose( fp );
+
+        return( n );
+}
+
+
+static int lrwcheck( int mode, double *emax )
+/********1*********2*********3*********4*********5*********6*********7*********
+ * purpose:         slides a window of LRW_win over LRW_n data pairs by
+ *                  lrwadd, lrwdel in mode (linfit.h) and compares lrwfit
+ *                  after each step with a direct fit; emax[0] gets the
+ *                  largest relative error.  Returns the number of steps
+ *                  beyond LRW_rel or that lrwfit cannot fit.
+ ********1*********2*********3*********4*********5*********6*********7*********/
+{
+        double e;
+        double fit[5];
+        double ref[5];
+        double s;
+        double sig[LRW_n];
+        double sw;
+        double sxx;
+        double sxy;
+        double syy;
+        double w;
+        double x[LRW_n];
+        double xm;
+        double y[LRW_n];
+        double ym;
+        int i;
+        int j;
+        int k;
+        int m;
+        int nworse= 0;
+        LRWS lrw;
+
+        for( i= 0; i < LRW_n; i++ ) {
+                x[i]= 60000.0 + 0.25*i;
+                y[i]= 0.5 + 3.0e-3*( x[i] - 60000.0 ) + 1.0e-3*sin( 1.7*i );
+                sig[i]= 1.0e-3*( 1.0 + 0.5*( i%5 ) );
+        }
+
+        emax[0]= 0.0;
+        lrwinit( &lrw, mode );
+        for( i= 0; i < LRW_n; i++ ) {
+                lrwadd( &lrw, x[i], y[i], sig[i] );
+                if( i >= LRW_win )
+                        lrwdel( &lrw, x[i-LRW_win], y[i-LRW_win],
+                                sig[i-LRW_win] );
+                j= i >= LRW_win ? i - LRW_win + 1 : 0;
+                m= i - j + 1;
+                if( m < 3 )
+                        continue;
+/*
+ *   direct fit: means, then the sums about them
+ */
+                sw= xm= ym= 0.0;
+                for( k= j; k <= i; k++ ) {
+                        w= mode == 0 ? 1.0 : 1.0/( sig[k]*sig[k] );
+                        sw+= w;
+                        xm+= w*x[k];
+                        ym+= w*y[k];
+                }
+                xm/= sw;
+                ym/= sw;
+                sxx= sxy= syy= 0.0;
+                for( k= j; k <= i; k++ ) {
+                        w= mode == 0 ? 1.0 : 1.0/( sig[k]*sig[k] );
+                        sxx+= w*( x[k] - xm )*( x[k] - xm );
+                        sxy+= w*( x[k] - xm )*( y[k] - ym );
+                        syy+= w*( y[k] - ym )*( y[k] - ym );
+                }
+                ref[1]= sxy / sxx;
+                ref[0]= ym - ref[1]*xm;
+                ref[4]= 0.0;
+                for( k= j; k <= i; k++ ) {
+                        w= mode == 0 ? 1.0 : 1.0/( sig[k]*sig[k] );
+                        e= y[k] - ref[0] - ref[1]*x[k];
+                        ref[4]+= w*e*e;
+                }
+                ref[2]= sqrt( 1.0/sw + xm*xm/sxx );
+                ref[3]= sqrt( 1.0/sxx );
+                if( mode == 0 ) {
+                        s= sqrt( ref[4]/( m - 2 ) );
+                        ref[2]*= s;
+                        ref[3]*= s;
+                }
+
+                if( lrwfit( &lrw, &fit[0], &fit[1], &fit[2], &fit[3],
+                            &fit[4] ) != 0 ) {
+                        nworse++;
+                        continue;
+                }
+                e= 0.0;
+                for( k= 0; k < 5; k++ ) {
+                        s= k < 4 ? fabs( ref[k] ) : syy;
+                        if( !( fabs( fit[k] - ref[k] ) <= e*s ) )
+                                e= fabs( fit[k] - ref[k] ) / s;
+                }
+                if( !( e <= emax[0] ) )
+                        emax[0]= e;
+                if( !( e <= LRW_rel ) )
+                        nworse++;
+        }
+
+        return( nworse );
+}
+
+
+static int oltcheck( int file, double *emax, int *nsta )
+/********1*********2*********3*********4*********5*********6*********7*********
+ * purpose:         fills a grid store of OLT_nx by OLT_ny nodes, two
+ *                  tides, node OLT_undef undefined, and interpolates
+ *                  it by oltintrpv at every node and the middle of
+ *                  every cell, from the heap (file 0) or through a
+ *                  file (file 1).  emax[0] gets the largest error in
+ *                  amp*cos(phs), amp*sin(phs), *nsta the number of
+ *                  stations.  Returns the number of stations beyond
+ *                  OLT_tol or wrong in being NaN, or -1 if the store
+ *                  cannot be made.
+ ********1*********2*********3*********4*********5*********6*********7*********/
+{
+        char id[2][16]= { "M2", "K1" };
+        char path[32];
+        double amp[2][OLT_nx*OLT_ny];
+        double c[2][OLT_nx*OLT_ny][2];
+        double e;
+        double lat[2*OLT_nx*OLT_ny];
+        double lon[2*OLT_nx*OLT_ny];
+        double oa[2*2*OLT_nx*OLT_ny];
+        double op[2*2*OLT_nx*OLT_ny];
+        double phs[2][OLT_nx*OLT_ny];
+        double ref[2];
+        int i;
+        int ix;
+        int iy;
+        int j;
+        int k;
+        int m;
+        int n;
+        int nworse= 0;
+        int fd;
+        int q;
+        struct olt_store store;
+        struct olt_store st;
+
+        emax[0]= 0.0;
+        *nsta= 0;
+        if( oltinit( &store, 2, id, OLT_nx, OLT_ny, 0.0, -60.0,
+                     360.0/OLT_nx, 30.0, 1 ) != 0 )
+                return( -1 );
+        for( k= 0; k < 2; k++ ) {
+                for( i= 0; i < OLT_nx*OLT_ny; i++ ) {
+                        amp[k][i]= 1.0 + 0.1*i + k;
+                        phs[k][i]= fmod( 37.0*i + 100.0*k, 360.0 );
+                        c[k][i][0]= amp[k][i] * cos( phs[k][i] * deg_to_rad );
+                        c[k][i][1]= amp[k][i] * sin( phs[k][i] * deg_to_rad );
+                }
+                amp[k][OLT_undef]= -1.0;
+                oltset( &store, k, amp[k], phs[k], -1.0 );
+        }
+        if( file ) {
+                strcpy( path, "/tmp/xyzcheckXXXXXX" );
+                if( (fd= mkstemp( path )) < 0 ) {
+                        oltclose( &store );
+                        return( -1 );
+                }
+                close( fd );
+                i= oltwrite( &store, path ) != 0 || oltopen( &st, path ) != 0;
+                unlink( path );
+                oltclose( &store );
+                if( i )
+                        return( -1 );
+                store= st;
+        }
+
+/*
+ *   stations: the nodes, then the middle of each cell
+ */
+        n= 0;
+        for( iy= 0; iy < OLT_ny; iy++ )
+                for( ix= 0; ix < OLT_nx; ix++, n++ ) {
+                        lat[n]= -60.0 + 30.0*iy;
+                        lon[n]= ix * 360.0/OLT_nx;
+                }
+        for( iy= 0; iy < OLT_ny - 1; iy++ )
+                for( ix= 0; ix < OLT_nx; ix++, n++ ) {
+                        lat[n]= -60.0 + 30.0*( iy + 0.5 );
+                        lon[n]= ( ix + 0.5 ) * 360.0/OLT_nx;
+                }
+        *nsta= n;
+        oltintrpv( &store, n, lat, lon, oa, op );
+        oltclose( &store );
+
+        for( i= 0; i < n; i++ )
+                for( k= 0; k < 2; k++ ) {
+                        ref[0]= ref[1]= 0.0;
+                        if( i < OLT_nx*OLT_ny ) {
+                                m= i != OLT_undef;
+                                if( m ) {
+                                        ref[0]= c[k][i][0];
+                                        ref[1]= c[k][i][1];
+                                }
+                        } else {
+                                iy= ( i - OLT_nx*OLT_ny ) / OLT_nx;
+                                ix= ( i - OLT_nx*OLT_ny ) % OLT_nx;
+                                for( m= 0, j= 0; j < 4; j++ ) {
+                                        q= ( iy + j/2 )*OLT_nx
+                                           + ( ix + j%2 ) % OLT_nx;
+                                        if( q == OLT_undef )
+                                                continue;
+                                        ref[0]+= c[k][q][0];
+                                        ref[1]+= c[k][q][1];
+                                        m++;
+                                }
+                                ref[0]/= m;
+                                ref[1]/= m;
+                        }
+                        j= i*2 + k;
+                        if( m == 0 ) {
+                                if( !isnan( oa[j] ) || !isnan( op[j] ) )
+                                        nworse++;
+                                continue;
+                        }
+                        e= hypot( oa[j]*cos( op[j]*deg_to_rad ) - ref[0],
+                                  oa[j]*sin( op[j]*deg_to_rad ) - ref[1] );
+                        if( !( e <= emax[0] ) )
+                                emax[0]= e;
+                        if( !( e <= OLT_tol )
+                            || !( op[j] >= 0.0 && op[j] < 360.0 ) )
+                                nworse++;
+                }
+
+        return( nworse );
+}
+
+
+static int sicheck( int swap, int *nrec )
+/********1*********2*********3*********4*********5*********6*********7*********
+ * purpose:         writes the records of si_rec[] as a station
+ *                  information file, in the other byte order if swap,
+ *                  maps it by siopen and makes the lookups of si_look[]
+ *                  by sifind, sigetC.  *nrec gets the number of records
+ *                  siopen indexed.  Returns the number of lookups that
+ *                  go wrong, plus one if the file is not indexed as
+ *                  written.
+ ********1*********2*********3*********4*********5*********6*********7*********/
+{
+        char path[32];
+        char r[4+288+4];
+        double d;
+        double v;
+        long off[SI_nrec];
+        long t;
+        int fd;
+        int i;
+        int k;
+        int nworse= 0;
+        int sz;
+        FILE *fp;
+        struct common_data_info cdi;
+        struct coordinates crd;
+        struct si_entry *e;
+        struct si_file sf;
+
+        *nrec= 0;
+        strcpy( path, "/tmp/xyzcheckXXXXXX" );
+        if( (fd= mkstemp( path )) < 0 || (fp= fdopen( fd, "wb" )) == NULL )
+                return( 1 );
+
+/*
+ *   the records: SIZE, common piece, X, ... of a C record, SIZE
+ */
+        for( i= 0; i < SI_nrec; i++ ) {
+                off[i]= ftell( fp );
+                sz= si_rec[i].key == 'C' ? 288 : 192;
+                memset( r, ' ', sizeof(r) );
+                t= sz;
+                siput( r, &t, 4, swap );
+                siput( r + 4 + sz, &t, 4, swap );
+                t= 61000;
+                siput( r + 4, &t, 4, swap );
+                d= 0.75;
+                siput( r + 8, &d, 8, swap );
+                t= si_rec[i].key == 'A' ? 7 : 0;
+                siput( r + 16, &t, 4, swap );
+                t= si_rec[i].mjd;
+                siput( r + 20, &t, 4, swap );
+                siput( r + 24, &si_rec[i].day, 8, swap );
+                r[32]= (char)si_rec[i].key;
+                memcpy( r + 33, si_rec[i].stid, 7 );
+                if( si_rec[i].key == 'C' ) {
+                        for( k= 0; k < 12; k++ ) {
+                                v= si_rec[i].x + 0.001*k;
+                                siput( r + 40 + 8*k, &v, 8, swap );
+                        }
+                        d= 0.5;
+                        siput( r + 136, &d, 8, swap );
+                        t= 51544;
+                        siput( r + 144, &t, 4, swap );
+                        memcpy( r + 148, "ITRF14 40104M002NOAM", 20 );
+                        memcpy( r + 168, "Algonquin Park", 14 );
+                        memcpy( r + 232, "xyzcheck", 8 );
+                }
+                if( fwrite( r, 1, (size_t)sz + 8, fp ) != (size_t)sz + 8 )
+                        nworse= 1;
+        }
+        if( fclose( fp ) != 0 || nworse ) {
+                unlink( path );
+                return( 1 );
+        }
+
+        *nrec= siopen( &sf, path );
+        unlink( path );
+        if( *nrec < 0 )
+                return( 1 );
+        if( *nrec != SI_nrec || sf.swap != swap )
+                nworse++;
+
+/*
+ *   the lookups
+ */
+        for( i= 0; i < SI_nlook; i++ ) {
+                e= sifind( &sf, si_look[i].key, si_look[i].stid,
+                           si_look[i].mjd, si_look[i].day );
+                k= si_look[i].rec;
+                if( k < 0 || e == NULL ) {
+                        if( k >= 0 || e != NULL )
+                                nworse++;
+                        continue;
+                }
+                if( e->off != off[k] ) {
+                        nworse++;
+                        continue;
+                }
+                if( si_rec[k].key != 'C' ) {
+                        if( sigetC( &sf, e, &cdi, &crd ) == 0 )
+                                nworse++;
+                        continue;
+                }
+                if( sigetC( &sf, e, &cdi, &crd ) != 0
+                    || cdi.size != 288 || cdi.modmjd != 61000
+                    || cdi.modday != 0.75 || cdi.type != 0
+                    || cdi.valmjd != si_rec[k].mjd
+                    || cdi.valday != si_rec[k].day || cdi.key != 'C'
+                    || memcmp( cdi.id, si_rec[k].stid, 6 ) != 0
+                    || cdi.seq != si_rec[k].stid[6]
+                    || crd.x != si_rec[k].x || crd.vzsig != si_rec[k].x + 0.011
+                    || crd.refday != 0.5 || crd.refmjd != 51544
+                    || memcmp( crd.frame, "ITRF14 ", 7 ) != 0
+                    || memcmp( crd.domes, "40104M002", 9 ) != 0
+                    || memcmp( crd.plate, "NOAM", 4 ) != 0
+                    || memcmp( crd.sitename, "Algonquin Park  ", 16 ) != 0
+                    || memcmp( crd.comment, "xyzcheck  ", 10 ) != 0 )
+                        nworse++;
+        }
+        siclose( &sf );
+
+        return( nworse );
+}
+
+
+static void siput( char *p, void *v, int n, int swap )
+/********1*********2*********3*********4*********5*********6*********7*********
+ * purpose:         stores a long (n 4) as 4 bytes or a double (n 8) at
+ *                  p, in the other byte order if swap
+ ********1*********2*********3*********4*********5*********6*********7*********/
+{
+        unsigned char c[8];
+        int32_t w;
+        int i;
+
+        if( n == 4 ) {
+                w= (int32_t)*(long *)v;
+                memcpy( c, &w, 4 );
+        } else
+                memcpy( c, v, 8 );
+        for( i= 0; i < n; i++ )
+                p[i]= (char)c[swap ? n - 1 - i : i];
+}
+
+
+static int dmscheck( int out, int *nprec )
+/********1*********2*********3*********4*********5*********6*********7*********
+ * purpose:         converts dms_ang[] by degdmsv at each prec from 0
+ *                  to DMS_maxprec (out 0) or of dms_prec[] (out 1),
+ *                  prints them and compares with dmsfmt at that prec.
+ *                  *nprec gets the number of precs.  Returns the
+ *                  number of angles whose texts differ.
+ ********1*********2*********3*********4*********5*********6*********7*********/
+{
+        char fmt[40];
+        char txt[40];
+        double sec[DMS_nang];
+        int deg[DMS_nang];
+        int min[DMS_nang];
+        int i;
+        int k;
+        int nworse= 0;
+        int pc;
+        int prec;
+
+        *nprec= out == 0 ? DMS_maxprec + 1 : 4;
+        for( k= 0; k < *nprec; k++ ) {
+                prec= out == 0 ? k : dms_prec[k];
+                pc= prec < 0 ? 0 : prec > DMS_maxprec ? DMS_maxprec : prec;
+                degdmsv( DMS_nang, dms_ang, prec, deg, min, sec );
+                for( i= 0; i < DMS_nang; i++ ) {
+                        if( dms_ang[i] < 0 && deg[i] == 0 )
+                                snprintf( txt, sizeof(txt), "%*s %2d %*.*f",
+                                          DMS_wdeg, "-0", min[i],
+                                          pc > 0 ? pc + 3 : 2, pc, sec[i] );
+                        else
+                                snprintf( txt, sizeof(txt), "%*d %2d %*.*f",
+                                          DMS_wdeg, deg[i], min[i],
+                                          pc > 0 ? pc + 3 : 2, pc, sec[i] );
+                        dmsfmt( fmt, sizeof(fmt), dms_ang[i], DMS_wdeg,
+                                prec );
+                        if( strcmp( txt, fmt ) != 0 )
+                                nworse++;
+                }
+        }
+
+        return( nworse );
+}
+
+
+static int memocheck( int lin, double *emax, struct ellipsoid *ell )
+/********1*********2*********3*********4*********5*********6*********7*********
+ * purpose:         looks up each of memo_pt[], it again and it offset
+ *                  by memo_d[] in a memo with cells of MEMO_q, with or
+ *                  without lin; emax[0] gets the largest distance of a
+ *                  point of a memoized cell from its X, Y, Z [q].
+ *                  Returns the number of lookups that go wrong, plus
+ *                  one if plhmstat does not count them all.
+ ********1*********2*********3*********4*********5*********6*********7*********/
+{
+        double e;
+        double plh[3];
+        double ref[3];
+        double xyz[3];
+        double xyzm[3];
+        int i;
+        int k;
+        int n;
+        int nworse= 0;
+        int r;
+        long hit;
+        long miss;
+        long near;
+        struct plh_memo memo;
+
+        emax[0]= 0.0;
+        if( plhminit( &memo, 4*MEMO_n, MEMO_q, lin ) != 0 )
+                return( 1 );
+
+        for( i= 0; i < MEMO_n; i++ ) {
+                memcpy( xyz, memo_pt[i], sizeof(xyz) );
+                xyz2plhe( xyz, ref, ell );
+                if( xyz2plhm( &memo, xyz, plh, ell ) != 2
+                    || memcmp( plh, ref, sizeof(plh) ) != 0 )
+                        nworse++;
+/*
+ *   the repeat: a hit, except beyond the memo
+ */
+                r= xyz2plhm( &memo, xyz, plh, ell );
+                if( r != ( i == MEMO_n - 1 ? 2 : 0 )
+                    || memcmp( plh, ref, sizeof(plh) ) != 0 )
+                        nworse++;
+/*
+ *   the same cell: converted beyond the memo and, with lin, near the
+ *   axis; otherwise from the memoized point, checked by plh2xyze
+ */
+                for( k= 0; k < 3; k++ )
+                        xyz[k]+= memo_d[k];
+                r= xyz2plhm( &memo, xyz, plh, ell );
+                if( i == MEMO_n - 1 || ( lin && i == MEMO_n - 2 ) ) {
+                        xyz2plhe( xyz, ref, ell );
+                        if( r != 2 || memcmp( plh, ref, sizeof(plh) ) != 0 )
+                                nworse++;
+                        continue;
+                }
+                plh2xyze( plh, xyzm, ell );
+                e= sqrt( ( xyzm[0] - xyz[0] )*( xyzm[0] - xyz[0] )
+                         + ( xyzm[1] - xyz[1] )*( xyzm[1] - xyz[1] )
+                         + ( xyzm[2] - xyz[2] )*( xyzm[2] - xyz[2] ) )
+                  / MEMO_q;
+                if( e > emax[0] )
+                        emax[0]= e;
+                if( r != 1 || !( e <= ( lin ? 3.0e-3 : sqrt( 3.0 ) ) ) )
+                        nworse++;
+        }
+
+        plhmstat( &memo, &hit, &near, &miss, &n );
+        if( hit + near + miss != 3*MEMO_n || n != MEMO_n - 1 )
+                nworse++;
+        plhmfree( &memo );
+
+        return( nworse );
+}
+
+
+static int origcheck( char *grid, struct check_method *m, int n,
+                      double **err, double ftol, double htol, double **orig )
+/********1*********2*********3*********4*********5*********6*********7*********
+ * purpose:         checks the n errors err[] of method m against those
+ *                  of the original program, columns m->col, m->col+1 of
+ *                  m->orig (relative to the parent of grid): its max and
+ *                  rms latitude and height errors may exceed those of the
+ *                  original by ftol and htol.  Prints them; returns 1 if
+ *                  the check fails, else 0.
+ ********1*********2*********3*********4*********5*********6*********7*********/
+{
+        char path[512];
+        double e;
+        double emax[2];
+        double esum[2];
+        double omax[2];
+        double osum[2];
+        double tol[2];
+        int i;
+        int k;
+        int nworse= 0;
+
+        snprintf( path, sizeof(path), "%s/../%s", grid, m->orig );
+        if( getcols( path, m->col + 2, MAX_grid, orig ) != n ) {
+                printf("  %-13s no errors of %d points in \"%s\"  FAIL\n",
+                       "(original)", n, path);
+                return( 1 );
+        }
+
+        tol[0]= ftol;
+        tol[1]= htol;
+        for( k= 0; k < 2; k++ ) {
+                emax[k]= esum[k]= omax[k]= osum[k]= 0.0;
+                for( i= 0; i < n; i++ ) {
+                        e= orig[m->col+k][i] * ( k == 0 ? m->ofi : m->oh );
+                        if( fabs( e ) > omax[k] )
+                                omax[k]= fabs( e );
+                        osum[k]+= e*e;
+                        if( !( fabs( err[k][i] ) <= emax[k] ) )
+                                emax[k]= fabs( err[k][i] );
+                        esum[k]+= err[k][i]*err[k][i];
+                }
+                if( !( emax[k] <= omax[k] + tol[k] ) )
+                        nworse++;
+                if( !( sqrt( esum[k]/n ) <= sqrt( osum[k]/n ) + tol[k] ) )
+                        nworse++;
+        }
+        printf("  %-13s %11.4e %11.4e %11.4e %11.4e %6d  %s\n", "(original)",
+               omax[0], sqrt( osum[0]/n ), omax[1], sqrt( osum[1]/n ),
+               nworse, nworse == 0 ? "PASS" : "FAIL");
+
+        return( nworse == 0 ? 0 : 1 );
+}
+
+
+static int putbase( char *path, int n, double **err,
+                    struct check_method *m )
+/********1*********2*********3*********4*********5*********6*********7*********
+ * purpose:         writes the errors of method m as its baseline, in the
+ *                  layout of Tri_Validate_Output/Results.txt.  Returns 0,
+ *                  or -1 if the file cannot be written.
+ ********1*********2*********3*********4*********5*********6*********7*********/
+{
+        int i;
+        FILE *fp;
+
+        if( (fp= fopen( path, "w" )) == NULL )
+                return( -1 );
+
+        fprintf( fp, "ID ,%s_fi(1e6*sec),%s_h(nm)\n", m->name, m->name );
+        for( i= 0; i < n; i++ )
+                fprintf( fp, "%d,%.6e,%.6e\n", i+1, err[0][i], err[1][i] );
+
+        return( fclose( fp ) == 0 ? 0 : -1 );
+}
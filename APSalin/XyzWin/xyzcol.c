@@ -0,0 +1,399 @@
+/* @(#)xyzcol.c         1.0  26/10/18 */
+static char *sccsid= "@(#)xyzcol.c      1.0  26/10/18";
+
+/********1*********2*********3*********4*********5*********6*********7*********
+ * name:            xyzcol
+ * version:         2610.18
+ * written by:      geoData
+ * purpose:         converts coordinate text files <-> column files
+ *
+ * input parameters
+ * -----------------------------
+ * in               text or column file; "-" or none = stdin
+ * out              output file; "-" or none = stdout
+ *
+ * output parameters
+ * -----------------------------
+ *
+ *
+ * local variables and constants
+ * -----------------------------
+ * blk[]            one coded block
+ * c                command-line option
+ * codec            codec of the output columns; < 0 = as the input
+ * col[][]          one block of rows, column by column
+ * custom           ellipsoid given as A,FL with -e
+ * ell              ellipsoid given with -e; NULL = GRS80, or as the
+ *                  column file input
+ * errflg           command-line error/usage print flag
+ * fi               input stream
+ * fo               output stream
+ * hd               header of a column file input
+ * hline            first line of a text input, if it names the columns
+ * ho               header of the output
+ * list             = 1 = list the header of a column file
+ * names            column names given with -n
+ * prec             decimals of text output; < 0 = shortest exact
+ * text             = 1 = write text rather than a column file
+ *
+ * comments:
+ * -----------------------------
+ * A text input has one row per line, values separated by commas and/or
+ * blanks, as the files in geo_4277_Points, Output and Halley_Output.
+ * Its first line, if it is not numeric, gives the column names (e.g.
+ * "ID,fi,lamda,h,...").  Lines with fewer values than the first row
+ * are skipped; extra values are dropped.
+ *
+ * Text output writes each value with the fewest decimals that read
+ * back to the same double (numshort), so text -> column file -> text
+ * -> column file gives identical column files.  -p n writes n decimals
+ * instead, as "%.nf".
+ *
+ * Examples:
+ *   xyzcol -c xor _geo_00_Header.txt geo00.col
+ *   xyzcol -t geo00.col > geo00.txt
+ *   xyz2llh -f XYZ.col -b plh.col
+ *
+ * see also:
+ * -----------------------------
+ * colio.h          layout of a column file
+ *
+ ********1*********2*********3*********4*********5*********6*********7*********
+ *:modification history
+ *:2610.18, GD,  Creation
+ *:2610.18, GD,  -e takes a registry name as well as A,FL
+ ********1*********2*********3*********4*********5*********6*********7********/
+
+/*
+ *  include files
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "physcon.h"
+#include "libgpsC.h"
+
+/*
+ *  function prototypes
+ */
+
+static int getrows( FILE *, int *, char *, double **, long * );
+static int putrows( FILE *, struct col_head *, double **, int, int, int );
+
+/*
+ *  global definitions and variables
+ */
+
+#define MAX_text        ((int)8192)
+
+static char blk[(MAX_col+1)*sizeof(int) + 10*MAX_col*MAX_chunk];
+static char hline[MAX_text];
+static double col[MAX_col][MAX_chunk];
+
+
+
+int main( int argc, char *argv[] )
+{
+  char *codecs[]= { "raw", "delta", "xor" };
+  char *names= NULL;
+  char *pgm;
+  char *ptr;
+  char *vrsn= "1.0 26/10/18";
+  double *cp[MAX_col];
+  int c;
+  int codec= -1;
+  int errflg= 0;
+  int first= 1;
+  int i;
+  int list= 0;
+  int n= 0;
+  int ncol= 0;
+  int prec= -1;
+  int text= 0;
+  long len= 0;
+  long nrow= 0;
+  long nskip= 0;
+  FILE *fi= stdin;
+  FILE *fo= stdout;
+  struct col_head hd;
+  struct col_head ho;
+  struct ellipsoid custom;
+  struct ellipsoid *ell= NULL;
+
+  extern char *optarg;
+  extern int optind;
+  extern int optopt;
+
+/*
+ *   1.0  Parse command line
+ */
+
+  pgm= argv[0];
+  while( (ptr= strpbrk( pgm, "/\\:" )) != NULL )
+    pgm= ptr+1;
+
+  while( (c= getopt(argc, argv, ":c:e:hln:p:t")) != -1 )
+    switch( c ) {
+    case 'c':
+      for( codec= 2; codec >= 0 && strcmp( optarg, codecs[codec] ) != 0; )
+        codec--;
+      if( codec < 0 ) {
+        fprintf(stderr, "%s ERROR: Unknown codec \"%s\"\n", pgm, optarg);
+        errflg++;
+      }
+      break;
+    case 'e':
+      if( (ell= ellparse( optarg, &custom )) == NULL ) {
+        fprintf(stderr, "%s ERROR: Unknown ellipsoid \"%s\"\n", pgm, optarg);
+        errflg++;
+      }
+      break;
+    case 'h':
+      errflg= 1;
+      break;
+    case 'l':
+      list= 1;
+      break;
+    case 'n':
+      names= optarg;
+      break;
+    case 'p':
+      prec= atoi( optarg );
+      break;
+    case 't':
+      text= 1;
+      break;
+    case '?':
+      fprintf(stderr, "%s ERROR: Unrecognized option \"%c\"\n",
+         pgm, optopt);
+      errflg++;
+      break;
+    case ':':
+      errflg++;
+      break;
+    }
+
+  if( errflg || argc - optind > 2 ) {
+    printf("%s(%s): Converts coordinate text files <-> column files\n",
+           pgm, vrsn);
+    printf("Usage: %s [options] [in [out]]\n", pgm );
+    printf("  in, out default to stdin, stdout; in may be text or a column\n");
+    printf("  file.\n");
+    printf("  options:\n");
+    printf("           -c codec of the output columns: raw (default),\n");
+    printf("              delta or xor.\n");
+    printf("           -e ellipsoid of the output, by name or as A,FL\n");
+    printf("              (FL > 1 = 1/f); default GRS80.\n");
+    printf("           -h prints this message.\n");
+    printf("           -l lists the header of a column file.\n");
+    printf("           -n names of the columns, separated by commas.\n");
+    printf("           -p n decimals for -t (default: fewest exact).\n");
+    printf("           -t writes text rather than a column file.\n");
+    exit(1);
+  }
+
+  if( optind < argc && strcmp( argv[optind], "-" ) != 0
+      && (fi= fopen( argv[optind], "rb" )) == NULL ) {
+    fprintf(stderr, "%s ERROR: Cannot open \"%s\"\n", pgm, argv[optind]);
+    exit(1);
+  }
+  optind++;
+  if( list == 0 && optind < argc && strcmp( argv[optind], "-" ) != 0
+      && (fo= fopen( argv[optind], text ? "w" : "wb" )) == NULL ) {
+    fprintf(stderr, "%s ERROR: Cannot create \"%s\"\n", pgm, argv[optind]);
+    exit(1);
+  }
+  setvbuf( fo, NULL, _IOFBF, (size_t)1 << 16 );
+  for( i= 0; i < MAX_col; i++ )
+    cp[i]= col[i];
+
+/*
+ *   2.0  Column file input: list, or read block by block
+ */
+
+  if( (c= getc( fi )) != EOF )
+    ungetc( c, fi );
+  if( c == (unsigned char)COL_magic[0] ) {
+    if( colgethead( fi, &hd ) != 0 ) {
+      fprintf(stderr, "%s ERROR: Not a column file\n", pgm);
+      exit(1);
+    }
+    if( list == 1 ) {
+      printf("ellipsoid %s A= %.4f FL= %.14f\n", hd.ellips, hd.A, hd.FL);
+      printf("byte order %s\n", hd.swap ? "swapped" : "native");
+      for( i= 0; i < hd.ncol; i++ )
+        printf("column %2d %-16s %s\n", i + 1, hd.name[i],
+               codecs[hd.codec[i]]);
+    }
+    colinit( &ho, hd.ncol, names, codec < 0 ? COL_raw : codec,
+             ell != NULL ? ell : ellfind( "GRS80" ) );
+    if( names == NULL )
+      memcpy( ho.name, hd.name, sizeof(ho.name) );
+    if( codec < 0 )
+      memcpy( ho.codec, hd.codec, sizeof(ho.codec) );
+    if( ell == NULL ) {
+      ho.A= hd.A;
+      ho.FL= hd.FL;
+      memcpy( ho.ellips, hd.ellips, sizeof(ho.ellips) );
+    }
+    ho.nrow= -1;
+    if( list == 0 && text == 0 && colputhead( fo, &ho ) != 0 )
+      errflg++;
+
+    while( errflg == 0 && (len= colgetblk( fi, &hd, MAX_col, blk,
+                                           sizeof(blk) )) > 0 ) {
+      if( (n= colunpack( &hd, blk, hd.ncol, cp )) < 0 )
+        break;
+      if( list == 0 ) {
+        if( text == 1 )
+          errflg+= putrows( fo, &ho, cp, n, prec, first );
+        else
+          errflg+= fwrite( blk, 1, colpack( &ho, n, cp, blk ), fo ) == 0;
+      }
+      first= 0;
+      nrow+= n;
+    }
+    if( len < 0 || n < 0 ) {
+      fprintf(stderr, "%s ERROR: Damaged block after row %ld\n", pgm, nrow);
+      exit(1);
+    }
+    if( list == 1 ) {
+      printf("rows %ld (header: %lld)\n", nrow, hd.nrow);
+      exit(0);
+    }
+
+/*
+ *   3.0  Text input
+ */
+
+  } else {
+    if( list == 1 ) {
+      fprintf(stderr, "%s ERROR: Not a column file\n", pgm);
+      exit(1);
+    }
+    while( errflg == 0 && (n= getrows( fi, &ncol, hline, cp, &nskip )) > 0 ) {
+      if( first == 1 ) {
+        colinit( &ho, ncol, names != NULL ? names : hline,
+                 codec < 0 ? COL_raw : codec,
+                 ell != NULL ? ell : ellfind( "GRS80" ) );
+        ho.nrow= -1;
+        if( text == 0 && colputhead( fo, &ho ) != 0 )
+          errflg++;
+      }
+      if( text == 1 )
+        errflg+= putrows( fo, &ho, cp, n, prec, first );
+      else
+        errflg+= fwrite( blk, 1, colpack( &ho, n, cp, blk ), fo ) == 0;
+      first= 0;
+      nrow+= n;
+    }
+  }
+
+/*
+ *   4.0  Fill in the row count when the output can seek
+ */
+
+  if( first == 1 )
+    fprintf(stderr, "%s: no rows\n", pgm);
+  if( text == 0 && first == 0 ) {
+    ho.nrow= nrow;
+    if( fflush( fo ) == 0 && fseek( fo, 0L, SEEK_SET ) == 0 )
+      errflg+= colputhead( fo, &ho ) != 0;
+  }
+  if( fflush( fo ) != 0 || errflg != 0 ) {
+    fprintf(stderr, "%s ERROR: Write failed\n", pgm);
+    exit(1);
+  }
+  if( nskip > 0 )
+    fprintf(stderr, "%s: %ld rows, %ld lines skipped\n", pgm, nrow, nskip);
+
+  exit(0);
+}
+
+
+static int getrows( FILE *fp, int *ncol, char *hline, double **col,
+                    long *nskip )
+/********1*********2*********3*********4*********5*********6*********7*********
+ * purpose:         reads up to MAX_chunk rows of a text file, column by
+ *                  column.  While *ncol is 0 the first numeric line sets
+ *                  it, and the first line if it is not numeric is kept
+ *                  in hline as comma separated names.  Returns the
+ *                  number of rows.
+ ********1*********2*********3*********4*********5*********6*********7*********/
+{
+        static char line[MAX_text];
+        static int nline= 0;
+        char *end;
+        char *ptr;
+        double v[MAX_col];
+        int k;
+        int n= 0;
+        int nv;
+
+        while( n < MAX_chunk && fgets( line, sizeof(line), fp ) != NULL ) {
+                nline++;
+                for( nv= 0, ptr= line; nv < MAX_col; nv++ ) {
+                        while( *ptr == ' ' || *ptr == '\t' || *ptr == ',' )
+                                ptr++;
+                        v[nv]= numscan( ptr, &end );
+                        if( end == ptr )
+                                break;
+                        ptr= end;
+                }
+                if( *ncol == 0 && nv == 0 && nline == 1 ) {
+                        for( ptr= line; *ptr == ' ' || *ptr == '\t'; ptr++ )
+                                ;
+                        for( k= 0; *ptr != '\0' && *ptr != '\r'
+                                   && *ptr != '\n'; ptr++ )
+                                hline[k++]= *ptr == ' ' || *ptr == '\t' ?
+                                            ',' : *ptr;
+                        hline[k]= '\0';
+                        continue;
+                }
+                if( *ncol == 0 && nv > 0 )
+                        *ncol= nv;
+                if( nv == 0 || nv < *ncol ) {
+                        (*nskip)++;
+                        continue;
+                }
+                for( k= 0; k < *ncol; k++ )
+                        col[k][n]= v[k];
+                n++;
+        }
+
+        return( n );
+}
+
+
+static int putrows( FILE *fp, struct col_head *hd, double **col, int n,
+                    int prec, int head )
+/********1*********2*********3*********4*********5*********6*********7*********
+ * purpose:         writes n rows as comma separated text, with prec
+ *                  decimals or, if prec < 0, the fewest that read back
+ *                  exactly; head = 1 writes the column names first.
+ *                  Returns 0, 1 on a write error.
+ ********1*********2*********3*********4*********5*********6*********7*********/
+{
+        char buf[512];
+        int i;
+        int k;
+
+        if( head == 1 ) {
+                for( k= 0; k < hd->ncol; k++ )
+                        fprintf( fp, k ? ",%s" : "%s", hd->name[k] );
+                putc( '\n', fp );
+        }
+        for( i= 0; i < n; i++ )
+                for( k= 0; k < hd->ncol; k++ ) {
+                        if( prec < 0 )
+                                numshort( buf, sizeof(buf), col[k][i] );
+                        else
+                                numfix( buf, sizeof(buf), col[k][i], 0, prec );
+                        fputs( buf, fp );
+                        putc( k < hd->ncol - 1 ? ',' : '\n', fp );
+                }
+
+        return( ferror( fp ) ? 1 : 0 );
+}
@@ -0,0 +1,235 @@
+/*  @(#)xyzmap.c        1.0  26/10/18  */
+static char *sccsid= "@(#)xyzmap.c      1.0  26/10/18";
+/*
+ *  include files
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include "libgpsC.h"
+
+/*
+ *  function prototypes
+ */
+
+void mapclose( struct xyz_map * );
+int mapchunk( struct xyz_map *, struct xyz_chunk *, long * );
+int mapopen( FILE *, struct xyz_map * );
+long nlscan( char *, long, int, int * );
+long nlscan_avx2( char *, long, int, int * );
+
+/*
+ *  global definitions and variables
+ */
+
+
+int mapopen( FILE *fp, struct xyz_map *map )
+/********1*********2*********3*********4*********5*********6*********7*********
+ * name:            mapopen
+ * version:         2610.18
+ * written by:      geoData
+ * purpose:         maps the rest of an input stream into memory
+ *
+ * input parameters
+ * ----------------
+ * fp               input stream
+ *
+ * output parameters
+ * -----------------
+ * map              the mapping, positioned where fp is
+ *
+ * returns 0 if the stream is mapped, -1 if it must be read with
+ * getchunk (pipe, terminal, empty file or mmap failure)
+ *
+ * comments:
+ * ------------------------------
+ * Only regular files are mapped; stdin redirected from a file is one.
+ * The pages are read in by the kernel as the chunks touch them, so the
+ * conversion starts at once and the file is held only in the page
+ * cache, not copied again into xyz_chunk.raw.
+ *
+ ********1*********2*********3*********4*********5*********6*********7*********
+ *:modification history
+ *:2610.18, GD, Creation
+ ********1*********2*********3*********4*********5*********6*********7*********/
+
+{
+        struct stat st;
+        void *base;
+        long pos;
+
+        map->base= NULL;
+        map->size= 0;
+        map->pos= 0;
+
+        if( fstat( fileno( fp ), &st ) != 0 || !S_ISREG( st.st_mode )
+            || st.st_size <= 0 || (pos= ftell( fp )) < 0 )
+                return( -1 );
+
+        base= mmap( NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE,
+                    fileno( fp ), 0 );
+        if( base == MAP_FAILED )
+                return( -1 );
+        (void)madvise( base, (size_t)st.st_size, MADV_SEQUENTIAL );
+
+        map->base= (char *)base;
+        map->size= (long)st.st_size;
+        map->pos= pos;
+
+        return( 0 );
+}
+
+
+int mapchunk( struct xyz_map *map, struct xyz_chunk *chk, long *lineno )
+/********1*********2*********3*********4*********5*********6*********7*********
+ * name:            mapchunk
+ * version:         2610.18
+ * written by:      geoData
+ * purpose:         the next chunk of lines of a mapped file; getchunk
+ *                  without the copy
+ *
+ * input parameters
+ * ----------------
+ * map              mapped file
+ * lineno           number of lines read so far
+ *
+ * output parameters
+ * -----------------
+ * chk              text points to up to MAX_chunk lines in the mapping,
+ *                  each ending in '\n'
+ * map              pos is advanced past them
+ * lineno           number of lines read so far
+ *
+ * returns the number of lines in the chunk; 0 at end of file
+ *
+ * calls:
+ * ------------------------------
+ * nlscan           finds the end of the MAX_chunk-th line
+ *
+ * comments:
+ * ------------------------------
+ * A last line without '\n' is the only text copied: it goes into raw,
+ * cut to MAX_line - 1 and counted in nlong as in getchunk, so the parser
+ * never reads past the end of the mapping.  Other lines are parsed in
+ * place, whatever their length.
+ *
+ ********1*********2*********3*********4*********5*********6*********7*********
+ *:modification history
+ *:2610.18, GD, Creation
+ *:2610.18, GD, Count a last line too long in nlong
+ ********1*********2*********3*********4*********5*********6*********7*********/
+
+{
+        int nl;
+        long len;
+        long rest= map->size - map->pos;
+
+        chk->first= *lineno + 1;
+        chk->nline= 0;
+        chk->nlong= 0;
+        if( rest <= 0 )
+                return( 0 );
+
+        len= nlscan( map->base + map->pos, rest, MAX_chunk, &nl );
+        if( nl == 0 ) {
+                len= rest;
+                if( len > MAX_line - 1 ) {
+                        len= MAX_line - 1;
+                        chk->nlong= 1;
+                }
+                memcpy( chk->raw, map->base + map->pos, (size_t)len );
+                chk->raw[len++]= '\n';
+                chk->raw[len]= '\0';
+                chk->text= chk->raw;
+                chk->ntext= len;
+                chk->nline= 1;
+                map->pos= map->size;
+        } else {
+                chk->text= map->base + map->pos;
+                chk->ntext= len;
+                chk->nline= nl;
+                map->pos+= len;
+        }
+        *lineno+= chk->nline;
+
+        return( chk->nline );
+}
+
+
+void mapclose( struct xyz_map *map )
+/********1*********2*********3*********4*********5*********6*********7*********
+ * name:            mapclose
+ * version:         2610.18
+ * written by:      geoData
+ * purpose:         unmaps a file mapped by mapopen
+ *
+ ********1*********2*********3*********4*********5*********6*********7*********
+ *:modification history
+ *:2610.18, GD, Creation
+ ********1*********2*********3*********4*********5*********6*********7*********/
+
+{
+        if( map->base != NULL )
+                munmap( map->base, (size_t)map->size );
+        map->base= NULL;
+        map->size= 0;
+        map->pos= 0;
+}
+
+
+long nlscan( char *buf, long n, int max, int *count )
+/********1*********2*********3*********4*********5*********6*********7*********
+ * name:            nlscan
+ * version:         2610.18
+ * written by:      geoData
+ * purpose:         finds the end of the max-th line of a buffer
+ *
+ * input parameters
+ * ----------------
+ * buf              text
+ * n                length of buf [char]
+ * max              number of lines wanted
+ *
+ * output parameters
+ * -----------------
+ * count            number of complete lines found, <= max
+ *
+ * returns the length of those count lines, up to and including the
+ * last '\n'; 0 if buf holds no '\n'
+ *
+ * calls:
+ * ------------------------------
+ * nlscan_avx2      AVX2 kernel (xyzmapa.c)
+ * simd_level       vector instruction level of this processor
+ *
+ * comments:
+ * ------------------------------
+ * With AVX2, 32 bytes are compared with '\n' at once and the lines
+ * counted by the population count of the mask; otherwise memchr
+ * finds one line at a time.
+ *
+ ********1*********2*********3*********4*********5*********6*********7*********
+ *:modification history
+ *:2610.18, GD, Creation
+ ********1*********2*********3*********4*********5*********6*********7*********/
+
+{
+        char *end= buf + n;
+        char *nl;
+        char *ptr= buf;
+
+        if( simd_level() >= 1 )
+                return( nlscan_avx2( buf, n, max, count ) );
+
+        *count= 0;
+        while( *count < max
+               && (nl= (char *)memchr( ptr, '\n', end - ptr )) != NULL ) {
+                ptr= nl + 1;
+                (*count)++;
+        }
+
+        return( ptr - buf );
+}
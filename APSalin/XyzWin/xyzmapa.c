@@ -0,0 +1,102 @@
+/*  @(#)xyzmapa.c       1.0  26/10/18  */
+static char *sccsid= "@(#)xyzmapa.c     1.0  26/10/18";
+/*
+ *  include files
+ */
+
+#include <string.h>
+#include "libgpsC.h"
+#include "vmath.h"
+
+/*
+ *  function prototypes
+ */
+
+long nlscan_avx2( char *, long, int, int * );
+
+/*
+ *  global definitions and variables
+ */
+
+
+#ifdef __AVX2__
+
+long nlscan_avx2( char *buf, long n, int max, int *count )
+/********1*********2*********3*********4*********5*********6*********7*********
+ * name:            nlscan_avx2
+ * version:         2610.18
+ * written by:      geoData
+ * purpose:         AVX2 kernel of nlscan; 32 bytes at a time
+ *
+ * input parameters
+ * ----------------
+ * see nlscan
+ *
+ * output parameters
+ * -----------------
+ * see nlscan
+ *
+ * comments:
+ * ------------------------------
+ * This file must be compiled with -mavx2.  It is only called after
+ * simd_level() has checked the processor.  Each block of 32 bytes
+ * gives a bit mask of its '\n's; the block holding the max-th one is
+ * the only one searched bit by bit.
+ *
+ ********1*********2*********3*********4*********5*********6*********7*********
+ *:modification history
+ *:2610.18, GD, Creation
+ ********1*********2*********3*********4*********5*********6*********7*********/
+
+{
+        __m256i nl= _mm256_set1_epi8( '\n' );
+        int c= 0;
+        int k;
+        long i;
+        long last= 0;
+        unsigned int m;
+
+        for( i= 0; i + 32 <= n; i+= 32 ) {
+                m= (unsigned int)_mm256_movemask_epi8( _mm256_cmpeq_epi8(
+                        _mm256_loadu_si256( (__m256i *)(buf + i) ), nl ) );
+                if( m == 0 )
+                        continue;
+                k= __builtin_popcount( m );
+                if( c + k >= max ) {
+                        for( k= max - c; k > 1; k-- )
+                                m&= m - 1;
+                        *count= max;
+                        return( i + __builtin_ctz( m ) + 1 );
+                }
+                c+= k;
+                last= i + 32 - __builtin_clz( m );
+        }
+        for( ; i < n && c < max; i++ )
+                if( buf[i] == '\n' ) {
+                        c++;
+                        last= i + 1;
+                }
+        *count= c;
+
+        return( last );
+}
+
+#else
+
+long nlscan_avx2( char *buf, long n, int max, int *count )
+{
+        char *end= buf + n;
+        char *nl;
+        char *ptr= buf;
+
+        *count= 0;
+        while( *count < max
+               && (nl= (char *)memchr( ptr, '\n', end - ptr )) != NULL ) {
+                ptr= nl + 1;
+                (*count)++;
+        }
+
+        return( ptr - buf );
+}
+
+#endif /* __AVX2__ */